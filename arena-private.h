@@ -0,0 +1,35 @@
+#ifndef _LPJS_ARENA_PRIVATE_H_
+#define _LPJS_ARENA_PRIVATE_H_
+
+#include "arena.h"
+
+/*
+ *  Blocks are never returned to the system until arena_free().
+ *  arena_reset() just rewinds to the first block, so once the
+ *  arena has grown to its working size, arena_alloc() never
+ *  calls malloc().
+ */
+
+typedef struct arena_block
+{
+    struct arena_block  *next;
+    size_t              size;       // Bytes available after header
+    size_t              used;
+}   arena_block_t;
+
+// Allocations start after the header, padded to keep them aligned
+#define ARENA_HEADER_SIZE \
+    ((sizeof(arena_block_t) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+#define ARENA_BLOCK_DATA(block) ((char *)(block) + ARENA_HEADER_SIZE)
+
+struct arena
+{
+    size_t          block_size;     // Minimum size of new blocks
+    arena_block_t   *first;
+    arena_block_t   *current;
+    size_t          in_use;         // Bytes allocated since last reset
+    size_t          high_water;     // Max in_use since arena_init()
+    size_t          reserved;       // Total bytes in all blocks
+};
+
+#endif  // _LPJS_ARENA_PRIVATE_H_
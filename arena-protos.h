@@ -0,0 +1,7 @@
+/* arena.c */
+arena_t *arena_new(size_t block_size);
+void arena_init(arena_t *arena, size_t block_size);
+void *arena_alloc(arena_t *arena, size_t bytes);
+void arena_reset(arena_t *arena);
+void arena_free(arena_t **arena);
+void arena_get_usage(arena_t *arena, size_t *high_water, size_t *reserved);
@@ -0,0 +1,203 @@
+#include <stdio.h>
+#include <stdlib.h>         // malloc()
+#include <sysexits.h>
+
+#include "arena-private.h"
+#include "misc.h"           // lpjs_log()
+
+
+/***************************************************************************
+ *  Description:
+ *      Create a new, empty arena.  No memory is reserved for
+ *      allocations until the first arena_alloc().
+ *
+ *      block_size is the minimum size of each block of memory
+ *      requested from malloc().  It should be large enough to hold
+ *      everything allocated between arena_reset() calls under typical
+ *      conditions, so the arena settles into a single block.
+ *
+ *  Returns:
+ *      Pointer to the new arena.  Terminates the process if malloc()
+ *      fails, so no check is required.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+arena_t *arena_new(size_t block_size)
+
+{
+    arena_t *arena;
+
+    if ( (arena = malloc(sizeof(*arena))) == NULL )
+    {
+        lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
+        exit(EX_UNAVAILABLE);
+    }
+    arena_init(arena, block_size);
+    return arena;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Initialize an arena structure.  Must not be used on an arena
+ *      that already holds blocks, or they will be leaked.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    arena_init(arena_t *arena, size_t block_size)
+
+{
+    arena->block_size = block_size;
+    arena->first = arena->current = NULL;
+    arena->in_use = arena->high_water = arena->reserved = 0;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Allocate bytes from the arena, aligned to ARENA_ALIGN.
+ *      The memory remains valid until the next arena_reset() or
+ *      arena_free(), and must not be passed to free().
+ *
+ *      Blocks left over from before the last arena_reset() are reused
+ *      before new ones are requested from malloc().  A request larger
+ *      than the arena's block size gets a block of its own.
+ *
+ *  Returns:
+ *      Pointer to the allocated memory.  Terminates the process if
+ *      malloc() fails, so no check is required.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    *arena_alloc(arena_t *arena, size_t bytes)
+
+{
+    arena_block_t   *block, *new_block;
+    size_t          size;
+    void            *mem;
+
+    bytes = (bytes + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+    // Look for room in the current block, then any left from a reset
+    for (block = arena->current; block != NULL; block = block->next)
+    {
+        if ( block->size - block->used >= bytes )
+            break;
+        // Treat as full if a normal request doesn't fit
+        if ( (bytes <= arena->block_size) && (block->next != NULL) )
+            arena->current = block->next;
+    }
+
+    if ( block == NULL )
+    {
+        size = bytes > arena->block_size ? bytes : arena->block_size;
+        if ( (new_block = malloc(ARENA_HEADER_SIZE + size)) == NULL )
+        {
+            lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
+            exit(EX_UNAVAILABLE);
+        }
+        new_block->next = NULL;
+        new_block->size = size;
+        new_block->used = 0;
+        arena->reserved += size;
+
+        // Append, so that blocks are reused in order after a reset
+        if ( arena->first == NULL )
+            arena->first = new_block;
+        else
+        {
+            for (block = arena->current; block->next != NULL;
+                 block = block->next)
+                ;
+            block->next = new_block;
+        }
+        block = new_block;
+        // Oversized blocks are usually full, so keep filling current
+        if ( (arena->current == NULL) || (size == arena->block_size) )
+            arena->current = new_block;
+    }
+
+    mem = ARENA_BLOCK_DATA(block) + block->used;
+    block->used += bytes;
+    arena->in_use += bytes;
+    if ( arena->in_use > arena->high_water )
+        arena->high_water = arena->in_use;
+
+    return mem;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Release everything allocated from the arena, keeping the blocks
+ *      for reuse.  All pointers returned by arena_alloc() since the
+ *      last reset become invalid.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    arena_reset(arena_t *arena)
+
+{
+    arena_block_t   *block;
+
+    for (block = arena->first; block != NULL; block = block->next)
+        block->used = 0;
+    arena->current = arena->first;
+    arena->in_use = 0;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Return all blocks and the arena structure itself to the system
+ *      and set *arena to NULL.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    arena_free(arena_t **arena)
+
+{
+    arena_block_t   *block, *next;
+
+    for (block = (*arena)->first; block != NULL; block = next)
+    {
+        next = block->next;
+        free(block);
+    }
+    free(*arena);
+    *arena = NULL;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Report the most memory ever in use between resets and the total
+ *      reserved in blocks, for sizing the arena and watching for
+ *      unexpected growth.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    arena_get_usage(arena_t *arena, size_t *high_water, size_t *reserved)
+
+{
+    *high_water = arena->high_water;
+    *reserved = arena->reserved;
+}
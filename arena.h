@@ -0,0 +1,13 @@
+#ifndef _LPJS_ARENA_H_
+#define _LPJS_ARENA_H_
+
+#include <stddef.h>     // size_t
+
+typedef struct arena arena_t;
+
+// Allocations are aligned for any scalar type
+#define ARENA_ALIGN     16
+
+#include "arena-protos.h"
+
+#endif  // _LPJS_ARENA_H_
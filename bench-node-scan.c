@@ -0,0 +1,183 @@
+/***************************************************************************
+ *  Description:
+ *      Benchmark the cost of scanning the node list for nodes that can
+ *      run a job, comparing the per-node_t checks formerly done by
+ *      lpjs_match_nodes() with node_list_find_fits() on the hot table.
+ *
+ *      Run via "make bench".  Results depend heavily on CFLAGS.
+ *      The fit check kernel is meant to be vectorized, which requires
+ *      -O3 with gcc or -O2 with clang.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sysexits.h>
+#include <time.h>
+
+#include "node-list.h"
+#include "misc.h"
+
+#define BENCH_CHECKS_PER_SIZE   100000000UL
+
+static double  bench_seconds(void);
+static node_list_t *bench_build_list(unsigned node_count);
+static unsigned long bench_scan_nodes(node_list_t *node_list,
+				      unsigned processors, size_t MiB);
+static unsigned long bench_scan_hot(node_list_t *node_list,
+				    unsigned processors, size_t MiB);
+
+int     main(int argc, char *argv[])
+
+{
+    static unsigned sizes[] = { 1000, 10000, 100000 };
+    extern FILE     *Log_stream;
+    node_list_t     *node_list;
+    unsigned        s, reps, r;
+    unsigned long   fits_nodes, fits_hot;
+    double          start, node_time, hot_time;
+
+    Log_stream = stderr;
+    srandom(1);
+
+    printf("%8s %8s %12s %12s %8s\n",
+	   "Nodes", "Fits", "node_t ns", "Hot ns", "Speedup");
+    for (s = 0; s < sizeof(sizes) / sizeof(*sizes); ++s)
+    {
+	node_list = bench_build_list(sizes[s]);
+	reps = BENCH_CHECKS_PER_SIZE / sizes[s];
+
+	// Typical small job: 4 processors, 2 GiB
+	start = bench_seconds();
+	for (r = fits_nodes = 0; r < reps; ++r)
+	    fits_nodes += bench_scan_nodes(node_list, 4, 2048);
+	node_time = bench_seconds() - start;
+
+	start = bench_seconds();
+	for (r = fits_hot = 0; r < reps; ++r)
+	    fits_hot += bench_scan_hot(node_list, 4, 2048);
+	hot_time = bench_seconds() - start;
+
+	if ( fits_nodes != fits_hot )
+	{
+	    fprintf(stderr, "Bug: Scans disagree: %lu vs %lu fits.\n",
+		    fits_nodes, fits_hot);
+	    return EX_SOFTWARE;
+	}
+
+	// Per full scan of the list
+	printf("%8u %8lu %12.0f %12.0f %7.1fx\n",
+	       sizes[s], fits_hot / reps,
+	       node_time / reps * 1e9, hot_time / reps * 1e9,
+	       node_time / hot_time);
+	node_list_free(&node_list);
+    }
+
+    return EX_OK;
+}
+
+
+static double  bench_seconds(void)
+
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+/*
+ *  Mostly busy cluster: About 5% of nodes have room for the job,
+ *  and a few are down or paused.
+ */
+
+static node_list_t *bench_build_list(unsigned node_count)
+
+{
+    // Terminates process if malloc() fails, no check required
+    node_list_t *node_list = node_list_new();
+    node_t      *node;
+    unsigned    c;
+    char        hostname[64];
+
+    node_list_enable_hot_table(node_list);
+    for (c = 0; c < node_count; ++c)
+    {
+	node = node_new();
+	snprintf(hostname, sizeof(hostname), "compute-%06u", c);
+	node_set_hostname(node, strdup(hostname));
+	node_set_processors(node, 32);
+	node_set_phys_MiB(node, 131072);
+	if ( random() % 20 == 0 )
+	    node_set_processors_used(node, random() % 32);
+	else
+	    node_set_processors_used(node, 30 + random() % 3);
+	node_set_phys_MiB_used(node, random() % 131072);
+	switch(random() % 50)
+	{
+	    case    0:
+		node_set_state(node, "down");
+		break;
+	    case    1:
+		node_set_state(node, "paused");
+		break;
+	    default:
+		node_set_state(node, "up");
+	}
+	node_list_add_compute_node(node_list, node);
+    }
+    return node_list;
+}
+
+
+/*
+ *  Equivalent of the checks done through node_t accessors by
+ *  lpjs_match_nodes() before the hot table.
+ */
+
+static unsigned long bench_scan_nodes(node_list_t *node_list,
+				      unsigned processors, size_t MiB)
+
+{
+    unsigned        c;
+    unsigned long   fits = 0;
+    node_t          *node;
+
+    for (c = 0; c < node_list_get_compute_node_count(node_list); ++c)
+    {
+	node = node_list_get_compute_nodes_ae(node_list, c);
+	if ( (strcmp(node_get_state(node), "up") == 0) &&
+	     (node_get_processors(node) - node_get_processors_used(node)
+		>= processors) &&
+	     (node_get_phys_MiB(node) - node_get_phys_MiB_used(node) >= MiB) )
+	    ++fits;
+    }
+    return fits;
+}
+
+
+static unsigned long bench_scan_hot(node_list_t *node_list,
+				    unsigned processors, size_t MiB)
+
+{
+    static unsigned matches[NODE_LIST_FIT_BLOCK];
+    unsigned        start, count, node_count;
+    unsigned long   fits = 0;
+
+    // Collect all matches, a block's worth at a time
+    node_count = node_list_get_compute_node_count(node_list);
+    for (start = 0; start < node_count; start = matches[count - 1] + 1)
+    {
+	count = node_list_find_fits(node_list, start, processors, MiB, 0,
+				    matches, NODE_LIST_FIT_BLOCK);
+	if ( count == 0 )
+	    break;
+	fits += count;
+    }
+    return fits;
+}
@@ -0,0 +1,256 @@
+/***************************************************************************
+ *  Description:
+ *      Benchmark the message protocol: lpjs_send_munge(),
+ *      lpjs_recv_munge(), framing, and acknowledgements, over
+ *      socketpair() and TCP loopback.  Each message waits for its
+ *      acknowledgement, as in normal operation, so latency is a full
+ *      round trip.
+ *
+ *      The mock credential backend (cred.h) is used by default, so
+ *      this runs without munged and measures protocol overhead alone.
+ *      Use -m to include the cost of munge.
+ *
+ *      Run via "make bench".
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sysexits.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "node-list.h"
+#include "network.h"
+#include "cred.h"
+#include "misc.h"
+#include "lpjs.h"
+
+typedef struct
+{
+    const char  *name;
+    size_t      size;
+    unsigned    count;
+}   bench_payload_t;
+
+static double  bench_seconds(void);
+static int  bench_socketpair(int fds[2]);
+static int  bench_tcp_pair(int fds[2]);
+static int  bench_run(const char *transport, int fds[2],
+		      const bench_payload_t *payload);
+static void bench_receive(int msg_fd);
+static int  bench_compare(const void *a, const void *b);
+
+int     main(int argc, char *argv[])
+
+{
+    static bench_payload_t  payloads[] =
+    {
+	{ "64 B", 64, 20000 },
+	{ "16 KiB", 16 * 1024, 5000 },
+	{ "512 KiB", LPJS_SCRIPT_SIZE_MAX, 200 }
+    };
+    extern FILE     *Log_stream;
+    int             fds[2], status = EX_OK;
+    unsigned        p;
+
+    if ( (argc == 2) && (strcmp(argv[1], "-m") == 0) )
+	lpjs_cred_set_backend(&Cred_munge);
+    else if ( argc == 1 )
+	lpjs_cred_set_backend(&Cred_mock);
+    else
+    {
+	fprintf(stderr, "Usage: %s [-m]\n", argv[0]);
+	return EX_USAGE;
+    }
+
+    Log_stream = stderr;
+    // Report a receiver that dies as a send error, not a signal
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("Credentials: %s\n\n", lpjs_cred_backend_name());
+    printf("%-10s %8s %7s %9s %8s %8s %8s %8s %8s\n",
+	   "Transport", "Payload", "Msgs", "Msgs/s", "MiB/s",
+	   "p50 us", "p90 us", "p99 us", "Max us");
+    for (p = 0; p < sizeof(payloads) / sizeof(*payloads); ++p)
+    {
+	if ( (bench_socketpair(fds) != 0) ||
+	     (bench_run("socketpair", fds, payloads + p) != 0) )
+	    status = EX_IOERR;
+	if ( (bench_tcp_pair(fds) != 0) ||
+	     (bench_run("tcp", fds, payloads + p) != 0) )
+	    status = EX_IOERR;
+    }
+
+    return status;
+}
+
+
+static double  bench_seconds(void)
+
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+static int  bench_socketpair(int fds[2])
+
+{
+    if ( socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0 )
+    {
+	perror("bench-protocol: socketpair() failed");
+	return -1;
+    }
+    return 0;
+}
+
+
+/*
+ *  Connected TCP sockets on 127.0.0.1, with default options like
+ *  the daemons use
+ */
+
+static int  bench_tcp_pair(int fds[2])
+
+{
+    struct sockaddr_in  address;
+    socklen_t           address_len = sizeof(address);
+    int                 listen_fd;
+
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;   // Any free port
+    if ( ((listen_fd = socket(PF_INET, SOCK_STREAM, 0)) < 0) ||
+	 (bind(listen_fd, (struct sockaddr *)&address, sizeof(address)) != 0) ||
+	 (listen(listen_fd, 1) != 0) ||
+	 (getsockname(listen_fd, (struct sockaddr *)&address,
+		      &address_len) != 0) ||
+	 ((fds[0] = socket(PF_INET, SOCK_STREAM, 0)) < 0) ||
+	 (connect(fds[0], (struct sockaddr *)&address, address_len) != 0) ||
+	 ((fds[1] = accept(listen_fd, NULL, NULL)) < 0) )
+    {
+	perror("bench-protocol: TCP loopback setup failed");
+	return -1;
+    }
+    close(listen_fd);
+    return 0;
+}
+
+
+/*
+ *  Send payload->count messages from fds[0] to a receiver process
+ *  on fds[1], and report throughput and latency
+ */
+
+static int  bench_run(const char *transport, int fds[2],
+		      const bench_payload_t *payload)
+
+{
+    char        *msg;
+    double      *latency, start, end, elapsed = 0.0;
+    unsigned    c, warmup = payload->count / 100;
+    pid_t       pid;
+    int         status = 0;
+
+    if ( (pid = fork()) == 0 )
+    {
+	close(fds[0]);
+	bench_receive(fds[1]);
+	_exit(0);
+    }
+    close(fds[1]);
+
+    if ( ((msg = malloc(payload->size + 1)) == NULL) ||
+	 ((latency = malloc(payload->count * sizeof(*latency))) == NULL) )
+    {
+	fprintf(stderr, "bench-protocol: malloc() failed.\n");
+	exit(EX_UNAVAILABLE);
+    }
+    // Script-like text, never starting with LPJS_EOT
+    for (c = 0; c < payload->size; ++c)
+	msg[c] = "#!/bin/sh -e\nlpjs submit x\n"[c % 27];
+    msg[payload->size] = '\0';
+
+    for (c = 0; c < warmup + payload->count; ++c)
+    {
+	start = bench_seconds();
+	if ( lpjs_send_munge_bin(fds[0], msg, payload->size, lpjs_no_close)
+		!= LPJS_MSG_SENT )
+	{
+	    fprintf(stderr, "bench-protocol: Send failed.\n");
+	    status = -1;
+	    break;
+	}
+	end = bench_seconds();
+	if ( c >= warmup )
+	{
+	    latency[c - warmup] = end - start;
+	    elapsed += end - start;
+	}
+    }
+    lpjs_send_munge(fds[0], LPJS_EOT_MSG, lpjs_no_close);
+    close(fds[0]);
+    waitpid(pid, NULL, 0);
+
+    if ( status == 0 )
+    {
+	qsort(latency, payload->count, sizeof(*latency), bench_compare);
+	printf("%-10s %8s %7u %9.0f %8.1f %8.1f %8.1f %8.1f %8.1f\n",
+	       transport, payload->name, payload->count,
+	       payload->count / elapsed,
+	       payload->count * payload->size / elapsed / (1024 * 1024),
+	       latency[payload->count / 2] * 1e6,
+	       latency[payload->count * 9 / 10] * 1e6,
+	       latency[payload->count * 99 / 100] * 1e6,
+	       latency[payload->count - 1] * 1e6);
+    }
+    free(msg);
+    free(latency);
+    return status;
+}
+
+
+/*
+ *  Receive and acknowledge messages until EOT
+ */
+
+static void bench_receive(int msg_fd)
+
+{
+    char        *payload;
+    uid_t       uid;
+    gid_t       gid;
+    bool        eot;
+
+    while ( lpjs_recv_munge(msg_fd, &payload, 0, 0, &uid, &gid,
+			    lpjs_no_close) > 0 )
+    {
+	eot = payload[0] == LPJS_EOT;
+	free(payload);
+	if ( eot )
+	    break;
+    }
+    close(msg_fd);
+}
+
+
+static int  bench_compare(const void *a, const void *b)
+
+{
+    double  x = *(const double *)a, y = *(const double *)b;
+
+    return x < y ? -1 : x > y;
+}
@@ -0,0 +1,7 @@
+/* buff.c */
+lpjs_buff_t *lpjs_buff_get(size_t size);
+void lpjs_buff_put(lpjs_buff_t **buff);
+void lpjs_buff_reserve(lpjs_buff_t *buff, size_t size);
+void lpjs_buff_append(lpjs_buff_t *buff, const void *data, size_t len);
+int lpjs_buff_vprintf(lpjs_buff_t *buff, const char *format, va_list ap);
+int lpjs_buff_printf(lpjs_buff_t *buff, const char *format, ...);
@@ -0,0 +1,201 @@
+#include <stdio.h>
+#include <stdlib.h>         // malloc(), realloc()
+#include <string.h>         // memcpy()
+#include <stdarg.h>
+#include <sysexits.h>
+
+#include "buff.h"
+#include "misc.h"           // lpjs_log()
+
+/*
+ *  Buffers returned by lpjs_buff_put(), available to lpjs_buff_get().
+ *  lpjs daemons are single-threaded, so no locking is needed.
+ */
+
+static lpjs_buff_t  *Pool[LPJS_BUFF_POOL_MAX];
+static unsigned     Pool_count = 0;
+
+
+/***************************************************************************
+ *  Description:
+ *      Get an empty buffer with room for at least size bytes plus a
+ *      '\0', reusing one from the pool if possible
+ *
+ *  Returns:
+ *      Pointer to the buffer.  Terminates the process if malloc()
+ *      fails, so no check is required.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+lpjs_buff_t *lpjs_buff_get(size_t size)
+
+{
+    lpjs_buff_t *buff;
+
+    if ( Pool_count > 0 )
+	buff = Pool[--Pool_count];
+    else
+    {
+	if ( (buff = malloc(sizeof(*buff))) == NULL )
+	{
+	    lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
+	    exit(EX_UNAVAILABLE);
+	}
+	buff->data = NULL;
+	buff->size = 0;
+    }
+    buff->len = 0;
+    lpjs_buff_reserve(buff, size < LPJS_BUFF_INITIAL_SIZE ?
+			    LPJS_BUFF_INITIAL_SIZE : size);
+    *buff->data = '\0';
+    return buff;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Return a buffer from lpjs_buff_get() to the pool and set *buff
+ *      to NULL.  Unusually large buffers are freed instead, so one
+ *      big message doesn't pin its memory for the life of the process.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    lpjs_buff_put(lpjs_buff_t **buff)
+
+{
+    if ( *buff == NULL )
+	return;
+
+    if ( (Pool_count < LPJS_BUFF_POOL_MAX) &&
+	 ((*buff)->size <= LPJS_BUFF_POOL_SIZE_MAX) )
+	Pool[Pool_count++] = *buff;
+    else
+    {
+	free((*buff)->data);
+	free(*buff);
+    }
+    *buff = NULL;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Make room for at least size bytes of content plus a '\0'.
+ *      Existing content is preserved.  Capacity is at least doubled
+ *      when growing, so appending n bytes costs O(n) overall.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    lpjs_buff_reserve(lpjs_buff_t *buff, size_t size)
+
+{
+    size_t  new_size;
+    char    *new_data;
+
+    if ( size + 1 <= buff->size )
+	return;
+
+    new_size = buff->size * 2;
+    if ( new_size < size + 1 )
+	new_size = size + 1;
+    if ( (new_data = realloc(buff->data, new_size)) == NULL )
+    {
+	lpjs_log("%s(): Error: realloc(%zu) failed.\n", __FUNCTION__, new_size);
+	exit(EX_UNAVAILABLE);
+    }
+    buff->data = new_data;
+    buff->size = new_size;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Append len bytes of data to the buffer
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    lpjs_buff_append(lpjs_buff_t *buff, const void *data, size_t len)
+
+{
+    lpjs_buff_reserve(buff, buff->len + len);
+    memcpy(buff->data + buff->len, data, len);
+    buff->len += len;
+    buff->data[buff->len] = '\0';
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Append formatted text to the buffer, growing it as needed
+ *
+ *  Returns:
+ *      Number of characters appended, or a negative value if the
+ *      format is invalid
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     lpjs_buff_vprintf(lpjs_buff_t *buff, const char *format, va_list ap)
+
+{
+    va_list ap2;
+    int     len;
+
+    // May need a second pass after growing the buffer
+    va_copy(ap2, ap);
+    len = vsnprintf(buff->data + buff->len, buff->size - buff->len,
+		    format, ap);
+    if ( (len >= 0) && ((size_t)len >= buff->size - buff->len) )
+    {
+	lpjs_buff_reserve(buff, buff->len + len);
+	vsnprintf(buff->data + buff->len, buff->size - buff->len,
+		  format, ap2);
+    }
+    va_end(ap2);
+
+    if ( len < 0 )
+	buff->data[buff->len] = '\0';
+    else
+	buff->len += len;
+    return len;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Append formatted text to the buffer, growing it as needed
+ *
+ *  Returns:
+ *      Number of characters appended, or a negative value if the
+ *      format is invalid
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     lpjs_buff_printf(lpjs_buff_t *buff, const char *format, ...)
+
+{
+    va_list ap;
+    int     len;
+
+    va_start(ap, format);
+    len = lpjs_buff_vprintf(buff, format, ap);
+    va_end(ap);
+    return len;
+}
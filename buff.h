@@ -0,0 +1,32 @@
+#ifndef _LPJS_BUFF_H_
+#define _LPJS_BUFF_H_
+
+#include <stddef.h>     // size_t
+#include <stdarg.h>     // va_list
+
+/*
+ *  Growable heap buffers for messages whose size is not known in
+ *  advance, such as job scripts and received frames.  Buffers are
+ *  kept in a small pool by lpjs_buff_put(), so steady-state traffic
+ *  reuses memory instead of calling malloc() for every message, and
+ *  large messages don't need large stack arrays.
+ *
+ *  data is always '\0'-terminated after len bytes, so text messages
+ *  can be used as C strings in place.
+ */
+
+typedef struct
+{
+    char    *data;
+    size_t  len;
+    size_t  size;       // Allocated, including room for '\0'
+}   lpjs_buff_t;
+
+#define LPJS_BUFF_INITIAL_SIZE  4096
+// Buffers kept for reuse, and the largest kept
+#define LPJS_BUFF_POOL_MAX      8
+#define LPJS_BUFF_POOL_SIZE_MAX (1024 * 1024)
+
+#include "buff-protos.h"
+
+#endif  // _LPJS_BUFF_H_
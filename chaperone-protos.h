@@ -1,7 +1,7 @@
 /* chaperone.c */
-int lpjs_job_start_notice(int msg_fd, const char *hostname, const char *job_id, pid_t job_pid);
+int lpjs_job_start_notice(int msg_fd, const char *outgoing_msg);
 int lpjs_job_start_notice_loop(node_list_t *node_list, const char *hostname, const char *job_id, pid_t job_pid);
-int lpjs_chaperone_completion(int msg_fd, const char *hostname, const char *job_id, int status, size_t peak_rss);
+int lpjs_chaperone_completion(int msg_fd, const char *outgoing_msg);
 int lpjs_chaperone_completion_loop(node_list_t *node_list, const char *hostname, const char *job_id, int status, size_t peak_rss);
 void chaperone_cancel_handler(int s2);
 void chaperone_lost_connection_handler(int s2);
@@ -286,6 +286,8 @@ int     main (int argc, char *argv[])
 
 /***************************************************************************
  *  Description:
+ *      Send a job start notice built by lpjs_job_start_notice_loop()
+ *      on msg_fd and await authorization
  *  
  *  Returns:
  *      LPJS_SUCCESS, etc.
@@ -293,26 +295,19 @@ int     main (int argc, char *argv[])
  *  History: 
  *  Date        Name        Modification
  *  ~2024-05-01 Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Take message from caller
  ***************************************************************************/
 
-int     lpjs_job_start_notice(int msg_fd,
-			       const char *hostname, const char *job_id,
-			       pid_t job_pid)
+int     lpjs_job_start_notice(int msg_fd, const char *outgoing_msg)
 
 {
-    char        outgoing_msg[LPJS_MSG_LEN_MAX + 1],
-		*munge_payload;
+    char        *munge_payload;
     ssize_t     bytes;
     uid_t       uid;
     gid_t       gid;
     extern FILE *Log_stream;
     
     /* Send a message to the server */
-    /* Need to send \0, so xt_dprintf() doesn't work here */
-    // FIXME: chaperone pid is redundant to compd fork verification
-    snprintf(outgoing_msg, LPJS_MSG_LEN_MAX + 1,
-	    "%c%s %s %u %d", LPJS_DISPATCHD_REQUEST_JOB_STARTED,
-	    hostname, job_id, getpid(), job_pid);
     lpjs_log("%s(): Sending new PIDs to dispatchd:\n", __FUNCTION__);
     lpjs_debug("%s(): msg = %s\n", __FUNCTION__, outgoing_msg + 1);
     if ( lpjs_send_munge(msg_fd, outgoing_msg, close) != LPJS_MSG_SENT )
@@ -350,7 +345,8 @@ int     lpjs_job_start_notice(int msg_fd,
 
 /***************************************************************************
  *  Description:
- *      Connect to dispatchd and send job start notification.
+ *      Send job start notification through lpjs_compd's local socket
+ *      if possible, otherwise by connecting to dispatchd.
  *      Retry indefinitely if failure occurs.
  *
  *  Returns:
@@ -359,6 +355,7 @@ int     lpjs_job_start_notice(int msg_fd,
  *  History: 
  *  Date        Name        Modification
  *  2024-01-23  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Try lpjs_send_via_compd() first
  ***************************************************************************/
 
 int     lpjs_job_start_notice_loop(node_list_t *node_list,
@@ -368,6 +365,20 @@ int     lpjs_job_start_notice_loop(node_list_t *node_list,
 {
     int     msg_fd,
 	    status;
+    char    outgoing_msg[LPJS_MSG_LEN_MAX + 1];
+    
+    /* Need to send \0, so xt_dprintf() doesn't work here */
+    // FIXME: chaperone pid is redundant to compd fork verification
+    snprintf(outgoing_msg, LPJS_MSG_LEN_MAX + 1,
+	    "%c%s %s %u %d", LPJS_DISPATCHD_REQUEST_JOB_STARTED,
+	    hostname, job_id, getpid(), job_pid);
+    
+    // Our compd forwards it on its connection to dispatchd
+    if ( lpjs_send_via_compd(outgoing_msg) == LPJS_MSG_SENT )
+    {
+	lpjs_debug("%s(): Start notice forwarded by compd.\n", __FUNCTION__);
+	return LPJS_SUCCESS;
+    }
     
     /*
      *  Retry socket connection and job start request indefinitely.
@@ -388,7 +399,7 @@ int     lpjs_job_start_notice_loop(node_list_t *node_list,
 	}
 	else
 	{
-	    status = lpjs_job_start_notice(msg_fd, hostname, job_id, job_pid);
+	    status = lpjs_job_start_notice(msg_fd, outgoing_msg);
 	    if ( status != LPJS_SUCCESS )
 	    {
 		lpjs_log("%s(): Error: Chaperone start notice failed.\n",
@@ -417,19 +428,13 @@ int     lpjs_job_start_notice_loop(node_list_t *node_list,
  *  History: 
  *  Date        Name        Modification
  *  2024-05-04  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Take message from caller
  ***************************************************************************/
 
-int     lpjs_chaperone_completion(int msg_fd, const char *hostname,
-				  const char *job_id, int status,
-				  size_t peak_rss)
+int     lpjs_chaperone_completion(int msg_fd, const char *outgoing_msg)
 
 {
-    char    outgoing_msg[LPJS_MSG_LEN_MAX + 1];
-    
     /* Send job completion message to dispatchd */
-    snprintf(outgoing_msg, LPJS_MSG_LEN_MAX + 1, "%c%s %s %d %zu\n",
-	     LPJS_DISPATCHD_REQUEST_JOB_COMPLETE, hostname,
-	     job_id, status, peak_rss);
     if ( lpjs_send_munge(msg_fd, outgoing_msg, close) != LPJS_MSG_SENT )
     {
 	lpjs_log("%s(): Error: Failed to send message to dispatchd: %s",
@@ -443,7 +448,8 @@ int     lpjs_chaperone_completion(int msg_fd, const char *hostname,
 
 /***************************************************************************
  *  Description:
- *      Connect to dispatchd and send job completion request.
+ *      Send job completion report through lpjs_compd's local socket
+ *      if possible, otherwise by connecting to dispatchd.
  *      Retry indefinitely if failure occurs.
  *
  *  Returns:
@@ -452,6 +458,7 @@ int     lpjs_chaperone_completion(int msg_fd, const char *hostname,
  *  History: 
  *  Date        Name        Modification
  *  2024-05-04  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Try lpjs_send_via_compd() first
  ***************************************************************************/
 
 int     lpjs_chaperone_completion_loop(node_list_t *node_list,
@@ -461,6 +468,18 @@ int     lpjs_chaperone_completion_loop(node_list_t *node_list,
 
 {
     int     msg_fd;
+    char    outgoing_msg[LPJS_MSG_LEN_MAX + 1];
+    
+    snprintf(outgoing_msg, LPJS_MSG_LEN_MAX + 1, "%c%s %s %d %zu\n",
+	     LPJS_DISPATCHD_REQUEST_JOB_COMPLETE, hostname,
+	     job_id, status, peak_rss);
+    
+    // Our compd forwards it on its connection to dispatchd
+    if ( lpjs_send_via_compd(outgoing_msg) == LPJS_MSG_SENT )
+    {
+	lpjs_log("%s(): Completion report forwarded by compd.\n", __FUNCTION__);
+	return 0;
+    }
     
     // Retry socket connection and message send indefinitely
     do
@@ -476,8 +495,7 @@ int     lpjs_chaperone_completion_loop(node_list_t *node_list,
 	}
 	else
 	{
-	    status = lpjs_chaperone_completion(msg_fd, hostname, job_id,
-						status, peak_rss);
+	    status = lpjs_chaperone_completion(msg_fd, outgoing_msg);
 	    if ( status != EX_OK )
 	    {
 		lpjs_log("%s(): Error: Message send failed.\n",
@@ -0,0 +1,5 @@
+/* cleaner.c */
+void lpjs_cleaner_add(const char *parent, unsigned long job_id);
+size_t lpjs_cleaner_queued(void);
+void lpjs_cleaner_run(size_t max_dirs);
+void lpjs_cleaner_get_stats(unsigned long *removed, unsigned long *failed);
@@ -0,0 +1,215 @@
+#include <stdio.h>
+#include <stdlib.h>         // realloc()
+#include <string.h>         // strcmp(), strerror()
+#include <errno.h>
+#include <unistd.h>         // unlinkat(), close()
+#include <fcntl.h>          // open(), openat()
+#include <dirent.h>         // fdopendir()
+#include <sysexits.h>
+
+#include "cleaner.h"
+#include "misc.h"           // lpjs_log()
+
+/*
+ *  FIFO of spool directories to remove.  Entries before Head are done.
+ *  dispatchd is single-threaded, so no locking is needed.
+ */
+
+typedef struct
+{
+    const char      *parent;    // LPJS_PENDING_DIR or LPJS_RUNNING_DIR
+    unsigned long   job_id;
+}   cleaner_entry_t;
+
+static cleaner_entry_t  *Queue = NULL;
+static size_t           Head = 0,
+			Count = 0,
+			Slots = 0;
+static unsigned long    Removed = 0,
+			Failed = 0;
+
+
+/***************************************************************************
+ *  Description:
+ *      Queue removal of parent/job_id.  parent must remain valid until
+ *      the directory is removed, e.g. LPJS_PENDING_DIR.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    lpjs_cleaner_add(const char *parent, unsigned long job_id)
+
+{
+    cleaner_entry_t *new_queue;
+
+    // Reuse the space of finished entries before growing
+    if ( (Count == Slots) && (Head > 0) )
+    {
+	memmove(Queue, Queue + Head, (Count - Head) * sizeof(*Queue));
+	Count -= Head;
+	Head = 0;
+    }
+    if ( Count == Slots )
+    {
+	Slots = Slots == 0 ? LPJS_CLEANER_BATCH : Slots * 2;
+	if ( (new_queue = realloc(Queue, Slots * sizeof(*Queue))) == NULL )
+	{
+	    lpjs_log("%s(): Error: realloc() failed.\n", __FUNCTION__);
+	    exit(EX_UNAVAILABLE);
+	}
+	Queue = new_queue;
+    }
+    Queue[Count].parent = parent;
+    Queue[Count].job_id = job_id;
+    ++Count;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Get the number of directories awaiting removal
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+size_t  lpjs_cleaner_queued(void)
+
+{
+    return Count - Head;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Remove name under parent_fd, recursively if it is a directory.
+ *      Symbolic links are removed, not followed.
+ *
+ *  Returns:
+ *      0 on success or if name does not exist, -1 otherwise
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static int  cleaner_remove_tree(int parent_fd, const char *name, int depth)
+
+{
+    int             fd,
+		    status = 0;
+    DIR             *dir;
+    struct dirent   *entry;
+
+    if ( (fd = openat(parent_fd, name, O_RDONLY|O_DIRECTORY|O_NOFOLLOW)) == -1 )
+    {
+	if ( errno == ENOENT )
+	    return 0;
+	if ( (errno != ENOTDIR) && (errno != ELOOP) )
+	    return -1;
+	// Regular file or symbolic link
+	if ( (unlinkat(parent_fd, name, 0) != 0) && (errno != ENOENT) )
+	    return -1;
+	return 0;
+    }
+    if ( depth >= LPJS_CLEANER_DEPTH_MAX )
+    {
+	close(fd);
+	errno = ENAMETOOLONG;
+	return -1;
+    }
+    if ( (dir = fdopendir(fd)) == NULL )
+    {
+	close(fd);
+	return -1;
+    }
+
+    while ( (entry = readdir(dir)) != NULL )
+    {
+	if ( (strcmp(entry->d_name, ".") != 0) &&
+	     (strcmp(entry->d_name, "..") != 0) &&
+	     (cleaner_remove_tree(dirfd(dir), entry->d_name, depth + 1) != 0) )
+	    status = -1;
+    }
+    closedir(dir);  // Closes fd as well
+
+    if ( (status == 0) && (unlinkat(parent_fd, name, AT_REMOVEDIR) != 0) &&
+	 (errno != ENOENT) )
+	status = -1;
+    return status;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Remove up to max_dirs queued directories.  Failures are logged
+ *      and counted, and not retried.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    lpjs_cleaner_run(size_t max_dirs)
+
+{
+    const char  *parent_path = NULL;
+    char        name[32];
+    int         parent_fd = -1,
+		parent_errno = 0;
+    size_t      done;
+
+    for (done = 0; (done < max_dirs) && (Head < Count); ++done, ++Head)
+    {
+	// Consecutive entries usually share a parent, keep it open
+	if ( Queue[Head].parent != parent_path )
+	{
+	    if ( parent_fd != -1 )
+		close(parent_fd);
+	    parent_path = Queue[Head].parent;
+	    parent_fd = open(parent_path, O_RDONLY|O_DIRECTORY);
+	    parent_errno = errno;
+	}
+
+	snprintf(name, sizeof(name), "%lu", Queue[Head].job_id);
+	if ( parent_fd == -1 )
+	    errno = parent_errno;
+	if ( (parent_fd != -1) &&
+	     (cleaner_remove_tree(parent_fd, name, 0) == 0) )
+	    ++Removed;
+	else
+	{
+	    lpjs_log("%s(): Error: Cannot remove %s/%s: %s\n", __FUNCTION__,
+		     parent_path, name, strerror(errno));
+	    ++Failed;
+	}
+    }
+    if ( parent_fd != -1 )
+	close(parent_fd);
+
+    if ( Head == Count )
+	Head = Count = 0;
+    if ( done > 0 )
+	lpjs_debug("%s(): Cleaned %zu directories, %zu queued.\n",
+		   __FUNCTION__, done, Count - Head);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Get the number of directories removed and failed since startup
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    lpjs_cleaner_get_stats(unsigned long *removed, unsigned long *failed)
+
+{
+    *removed = Removed;
+    *failed = Failed;
+}
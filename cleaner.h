@@ -0,0 +1,22 @@
+#ifndef _LPJS_CLEANER_H_
+#define _LPJS_CLEANER_H_
+
+#include <stddef.h>     // size_t
+
+/*
+ *  Removal of exported spool directories for jobs that have left the
+ *  queue.  Directories are queued by lpjs_cleaner_add() and removed
+ *  in batches by lpjs_cleaner_run() when dispatchd is idle, using
+ *  openat(), fdopendir() and unlinkat() rather than forking rm -rf.
+ */
+
+// Directories removed per call to lpjs_cleaner_run()
+#define LPJS_CLEANER_BATCH      64
+// Clean even when busy once this many are queued
+#define LPJS_CLEANER_QUEUE_MAX  4096
+// Deeper trees are left for the sysadmin
+#define LPJS_CLEANER_DEPTH_MAX  16
+
+#include "cleaner-protos.h"
+
+#endif  // _LPJS_CLEANER_H_
@@ -1,3 +1,5 @@
 /* config.c */
 int lpjs_load_config(node_list_t *node_list, int flags, FILE *error_stream);
+int lpjs_parse_config(node_list_t *node_list, int flags, FILE *error_stream);
+int lpjs_reload_config(node_list_t *node_list, char *report, size_t report_len);
 int lpjs_load_compute_config(node_list_t *node_list, FILE *input_stream, const char *conf_file);
@@ -30,6 +30,39 @@
 
 int     lpjs_load_config(node_list_t *node_list, int flags, FILE *error_stream)
 
+{
+    int     status;
+    
+    node_list_init(node_list);
+    if ( (status = lpjs_parse_config(node_list, flags, error_stream))
+            != LPJS_SUCCESS )
+        exit(status == LPJS_READ_FAILED ? EX_NOINPUT : EX_DATAERR);
+    if ( flags == LPJS_CONFIG_ALL )
+        fprintf(error_stream, "%u compute nodes found.\n",
+                node_list_get_compute_node_count(node_list));
+    return status;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Parse etc/lpjs/config into node_list, which must be initialized
+ *      by the caller.  Unlike lpjs_load_config(), this function does
+ *      not terminate the process on errors, so it can be used to reload
+ *      the config in a running daemon.
+ *
+ *  Returns:
+ *      LPJS_SUCCESS, LPJS_READ_FAILED if the file cannot be opened,
+ *      or LPJS_CONFIG_INVALID
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2021-09-23  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Factor out of lpjs_load_config()
+ ***************************************************************************/
+
+int     lpjs_parse_config(node_list_t *node_list, int flags, FILE *error_stream)
+
 {
     FILE    *config_fp;
     char    field[LPJS_FIELD_MAX + 1];
@@ -41,9 +74,13 @@ int     lpjs_load_config(node_list_t *node_list, int flags, FILE *error_stream)
     if ( (config_fp = fopen(config_file, "r")) == NULL )
     {
         fprintf(error_stream, "Cannot open %s.\n", config_file);
-        exit(EX_NOINPUT);
+        return LPJS_READ_FAILED;
     }
-    node_list_init(node_list);
+    
+    // dispatchd's node list owns the nodes and holds the scheduling table
+    if ( flags == LPJS_CONFIG_ALL )
+        node_list_enable_hot_table(node_list);
+    
     while ( ((delim = xt_dsv_read_field(config_fp, field, LPJS_FIELD_MAX + 1,
                                      " \t", &len)) != EOF) )
     {
@@ -56,7 +93,8 @@ int     lpjs_load_config(node_list_t *node_list, int flags, FILE *error_stream)
                  != '\n' )
             {
                 fprintf(error_stream, "load_config(): 'head' must be followed by a single hostname.\n");
-                exit(EX_DATAERR);
+                fclose(config_fp);
+                return LPJS_CONFIG_INVALID;
             }
 
             // FIXME: Check malloc() and sanity
@@ -73,7 +111,14 @@ int     lpjs_load_config(node_list_t *node_list, int flags, FILE *error_stream)
             if ( delim != EOF )
             {
                 if ( flags == LPJS_CONFIG_ALL )
-                    lpjs_load_compute_config(node_list, config_fp, config_file);
+                {
+                    if ( lpjs_load_compute_config(node_list, config_fp,
+                                                  config_file) != LPJS_SUCCESS )
+                    {
+                        fclose(config_fp);
+                        return LPJS_CONFIG_INVALID;
+                    }
+                }
                 else
                     xt_dsv_skip_rest_of_line(config_fp);
             }
@@ -84,11 +129,61 @@ int     lpjs_load_config(node_list_t *node_list, int flags, FILE *error_stream)
             xt_dsv_skip_rest_of_line(config_fp);
         }
     }
-    if ( flags == LPJS_CONFIG_ALL )
-        fprintf(error_stream, "%u compute nodes found.\n",
-                node_list_get_compute_node_count(node_list));
     fclose(config_fp);
-    return delim;
+    return LPJS_SUCCESS;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Re-read etc/lpjs/config and apply changes to the live node list
+ *      used by dispatchd.  Running jobs and compd connections on nodes
+ *      that remain in the config are not affected.  If the new config
+ *      is invalid, the live node list is left untouched.
+ *
+ *  Arguments:
+ *      node_list   Live node list
+ *      report      Buffer for a one-line summary to send to the requester
+ *      report_len  Size of report buffer
+ *
+ *  Returns:
+ *      LPJS_SUCCESS, or the error from lpjs_parse_config()
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     lpjs_reload_config(node_list_t *node_list, char *report,
+                           size_t report_len)
+
+{
+    extern FILE *Log_stream;
+    // Terminates process if malloc() fails, no check required
+    node_list_t *config_list = node_list_new();
+    unsigned    added, updated, removed, paused;
+    int         status;
+    
+    lpjs_log("%s(): Reloading config...\n", __FUNCTION__);
+    if ( (status = lpjs_parse_config(config_list, LPJS_CONFIG_ALL,
+                                     Log_stream)) != LPJS_SUCCESS )
+    {
+        lpjs_log("%s(): Error: Config not reloaded.\n", __FUNCTION__);
+        snprintf(report, report_len,
+                 "Error reloading config.  See dispatchd log.\n");
+        node_list_free(&config_list);
+        return status;
+    }
+    
+    node_list_merge_config(node_list, config_list,
+                           &added, &updated, &removed, &paused);
+    node_list_free(&config_list);
+    
+    snprintf(report, report_len,
+             "Config reloaded: %u added, %u updated, %u removed, %u paused for removal.\n",
+             added, updated, removed, paused);
+    lpjs_log("%s(): %s", __FUNCTION__, report);
+    return LPJS_SUCCESS;
 }
 
 
@@ -146,7 +241,7 @@ int     lpjs_load_compute_config(node_list_t *node_list, FILE *input_stream,
             {
                 lpjs_log("%s(): pmem specifier '%s':\n", __FUNCTION__, field);
                 lpjs_log("%s(): Requires a decimal number followed by MB, MiB, GB, or GiB.\n", __FUNCTION__);
-                exit(EX_DATAERR);
+                return LPJS_CONFIG_INVALID;
             }
             lpjs_debug("%s(): pmem override = %zu\n", __FUNCTION__, pmem);
         }
@@ -156,7 +251,7 @@ int     lpjs_load_compute_config(node_list_t *node_list, FILE *input_stream,
             if ( *end != '\0' )
             {
                 lpjs_log("%s(): Invalid proc count: %s\n", __FUNCTION__, field);
-                exit(EX_DATAERR);
+                return LPJS_CONFIG_INVALID;
             }
             lpjs_debug("%s(): processors override = %zu\n", __FUNCTION__, pmem);
         }
@@ -169,7 +264,7 @@ int     lpjs_load_compute_config(node_list_t *node_list, FILE *input_stream,
     {
         lpjs_log("%s(): Error: Unexpected EOF reading %s.\n",
                 __FUNCTION__, conf_file);
-        exit(EX_DATAERR);
+        return LPJS_CONFIG_INVALID;
     }
     
     // Terminates process if malloc() fails, no check required
@@ -187,5 +282,5 @@ int     lpjs_load_compute_config(node_list_t *node_list, FILE *input_stream,
     node_set_hostname(node, strdup(hostname));
     node_list_add_compute_node(node_list, node);
 
-    return 0;   // NL_OK?
+    return LPJS_SUCCESS;
 }
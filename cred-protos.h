@@ -0,0 +1,6 @@
+/* cred.c */
+void lpjs_cred_set_backend(const lpjs_cred_backend_t *backend);
+const char *lpjs_cred_backend_name(void);
+int lpjs_cred_encode(char **cred, const void *msg, size_t msg_len);
+int lpjs_cred_encode_for(char **cred, const void *msg, size_t msg_len, uid_t reader_uid);
+int lpjs_cred_decode(const char *cred, void **payload, int *payload_len, uid_t *uid, gid_t *gid);
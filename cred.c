@@ -0,0 +1,299 @@
+#include <stdio.h>
+#include <stdlib.h>         // malloc()
+#include <string.h>         // strlen(), strncmp()
+#include <unistd.h>         // getuid(), getgid()
+#include <sysexits.h>
+#include <stdint.h>         // uint32_t
+#include <limits.h>         // INT_MAX
+
+#include "cred.h"
+#include "misc.h"           // lpjs_log()
+
+static int  cred_munge_encode(char **cred, const void *msg, int msg_len,
+			      uid_t reader_uid);
+static int  cred_munge_decode(const char *cred, void **payload,
+			      int *payload_len, uid_t *uid, gid_t *gid);
+static int  cred_mock_encode(char **cred, const void *msg, int msg_len,
+			     uid_t reader_uid);
+static int  cred_mock_decode(const char *cred, void **payload,
+			     int *payload_len, uid_t *uid, gid_t *gid);
+
+const lpjs_cred_backend_t   Cred_munge =
+{
+    "munge", cred_munge_encode, cred_munge_decode
+};
+
+const lpjs_cred_backend_t   Cred_mock =
+{
+    "mock", cred_mock_encode, cred_mock_decode
+};
+
+static const lpjs_cred_backend_t    *Backend = &Cred_munge;
+
+static const char   Base64[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+
+/***************************************************************************
+ *  Description:
+ *      Select the credential backend for all later messages, e.g.
+ *      &Cred_mock in benchmarks
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    lpjs_cred_set_backend(const lpjs_cred_backend_t *backend)
+
+{
+    Backend = backend;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Name of the current backend, for reports
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+const char  *lpjs_cred_backend_name(void)
+
+{
+    return Backend->name;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Wrap msg in a credential using the current backend
+ *
+ *  Returns:
+ *      LPJS_CRED_OK or a munge_err_t error code
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     lpjs_cred_encode(char **cred, const void *msg, size_t msg_len)
+
+{
+    return lpjs_cred_encode_for(cred, msg, msg_len, LPJS_CRED_ANY_UID);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Wrap msg in a credential that only reader_uid can decode, or
+ *      anyone if reader_uid is LPJS_CRED_ANY_UID.  Use this for
+ *      payloads that must stay secret, such as session nonces.
+ *
+ *  Returns:
+ *      LPJS_CRED_OK or a munge_err_t error code
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     lpjs_cred_encode_for(char **cred, const void *msg, size_t msg_len,
+			     uid_t reader_uid)
+
+{
+    if ( msg_len > INT_MAX )
+	return EMUNGE_BAD_LENGTH;
+    return Backend->encode(cred, msg, msg_len, reader_uid);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Verify a credential and extract its payload and the sender's
+ *      uid and gid using the current backend
+ *
+ *  Returns:
+ *      LPJS_CRED_OK or a munge_err_t error code
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     lpjs_cred_decode(const char *cred, void **payload, int *payload_len,
+			 uid_t *uid, gid_t *gid)
+
+{
+    return Backend->decode(cred, payload, payload_len, uid, gid);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Encode with munge.  Without a UID restriction, munged decodes
+ *      the credential for any local user, replays included.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Support UID restriction
+ ***************************************************************************/
+
+static int  cred_munge_encode(char **cred, const void *msg, int msg_len,
+			      uid_t reader_uid)
+
+{
+    munge_ctx_t ctx;
+    munge_err_t status;
+
+    if ( reader_uid == LPJS_CRED_ANY_UID )
+	return munge_encode(cred, NULL, msg, msg_len);
+
+    if ( (ctx = munge_ctx_create()) == NULL )
+	return EMUNGE_NO_MEMORY;
+    if ( (status = munge_ctx_set(ctx, MUNGE_OPT_UID_RESTRICTION, reader_uid))
+	    == EMUNGE_SUCCESS )
+	status = munge_encode(cred, ctx, msg, msg_len);
+    munge_ctx_destroy(ctx);
+    return status;
+}
+
+
+static int  cred_munge_decode(const char *cred, void **payload,
+			      int *payload_len, uid_t *uid, gid_t *gid)
+
+{
+    return munge_decode(cred, NULL, payload, payload_len, uid, gid);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Mock credential: LPJS_CRED_MOCK_PREFIX, the base64-encoded
+ *      message, and ':'.  Base64 makes it about the size of a munge
+ *      credential, so framing costs are realistic.  reader_uid is
+ *      ignored, as anyone can decode a mock credential.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Accept reader_uid
+ ***************************************************************************/
+
+static int  cred_mock_encode(char **cred, const void *msg, int msg_len,
+			     uid_t reader_uid)
+
+{
+    const unsigned char *in = msg;
+    size_t      prefix_len = strlen(LPJS_CRED_MOCK_PREFIX);
+    char        *out;
+    uint32_t    bits;
+    int         c, n;
+
+    if ( (*cred = malloc(prefix_len + (msg_len + 2) / 3 * 4 + 2)) == NULL )
+    {
+	lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
+	exit(EX_UNAVAILABLE);
+    }
+    memcpy(*cred, LPJS_CRED_MOCK_PREFIX, prefix_len);
+    out = *cred + prefix_len;
+    for (c = 0; c < msg_len; c += 3)
+    {
+	n = msg_len - c < 3 ? msg_len - c : 3;
+	bits = (uint32_t)in[c] << 16;
+	if ( n > 1 )
+	    bits |= in[c + 1] << 8;
+	if ( n > 2 )
+	    bits |= in[c + 2];
+	*out++ = Base64[bits >> 18 & 63];
+	*out++ = Base64[bits >> 12 & 63];
+	*out++ = n > 1 ? Base64[bits >> 6 & 63] : '=';
+	*out++ = n > 2 ? Base64[bits & 63] : '=';
+    }
+    *out++ = ':';
+    *out = '\0';
+    return LPJS_CRED_OK;
+}
+
+
+static int  cred_base64_value(char ch)
+
+{
+    if ( (ch >= 'A') && (ch <= 'Z') )
+	return ch - 'A';
+    else if ( (ch >= 'a') && (ch <= 'z') )
+	return ch - 'a' + 26;
+    else if ( (ch >= '0') && (ch <= '9') )
+	return ch - '0' + 52;
+    else if ( ch == '+' )
+	return 62;
+    else if ( ch == '/' )
+	return 63;
+    else
+	return -1;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Decode a mock credential.  Anyone can forge one, so the
+ *      sender is assumed to be the current user.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static int  cred_mock_decode(const char *cred, void **payload,
+			     int *payload_len, uid_t *uid, gid_t *gid)
+
+{
+    size_t          prefix_len = strlen(LPJS_CRED_MOCK_PREFIX),
+		    len = strlen(cred);
+    const char      *in;
+    unsigned char   *out;
+    uint32_t        bits;
+    size_t          c;
+    int             k, value;
+
+    if ( (strncmp(cred, LPJS_CRED_MOCK_PREFIX, prefix_len) != 0) ||
+	 (len < prefix_len + 1) || (cred[len - 1] != ':') ||
+	 ((len - prefix_len - 1) % 4 != 0) )
+	return EMUNGE_BAD_CRED;
+
+    in = cred + prefix_len;
+    len -= prefix_len + 1;
+    if ( (*payload = out = malloc(len / 4 * 3 + 1)) == NULL )
+    {
+	lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
+	exit(EX_UNAVAILABLE);
+    }
+    for (c = 0; c < len; c += 4)
+    {
+	for (bits = 0, k = 0; k < 4; ++k)
+	{
+	    if ( in[c + k] == '=' )
+		bits <<= 6;
+	    else if ( (value = cred_base64_value(in[c + k])) >= 0 )
+		bits = bits << 6 | value;
+	    else
+	    {
+		free(*payload);
+		return EMUNGE_BAD_CRED;
+	    }
+	}
+	*out++ = bits >> 16;
+	if ( in[c + 2] != '=' )
+	    *out++ = bits >> 8;
+	if ( in[c + 3] != '=' )
+	    *out++ = bits;
+    }
+    *out = '\0';
+    *payload_len = out - (unsigned char *)*payload;
+    *uid = getuid();
+    *gid = getgid();
+    return LPJS_CRED_OK;
+}
@@ -0,0 +1,39 @@
+#ifndef _LPJS_CRED_H_
+#define _LPJS_CRED_H_
+
+#include <sys/types.h>  // uid_t, gid_t
+#include <munge.h>
+
+/*
+ *  Credential backend used by lpjs_send_munge() and lpjs_recv_munge()
+ *  on connections without a session or kernel credentials.  The
+ *  default is munge.  Cred_mock encodes messages the same way but
+ *  without authentication, so protocol overhead can be measured on
+ *  machines without munged.  It must never be used by the daemons.
+ *
+ *  Status codes are munge_err_t, so munge_strerror() works for any
+ *  backend.  Credentials are '\0'-terminated strings, and decoded
+ *  payloads are '\0'-terminated, both allocated with malloc().
+ */
+
+typedef struct
+{
+    const char  *name;
+    int         (*encode)(char **cred, const void *msg, int msg_len,
+			  uid_t reader_uid);
+    int         (*decode)(const char *cred, void **payload, int *payload_len,
+			  uid_t *uid, gid_t *gid);
+}   lpjs_cred_backend_t;
+
+#define LPJS_CRED_OK        EMUNGE_SUCCESS
+#define LPJS_CRED_INVALID   EMUNGE_CRED_INVALID
+// No restriction on who may decode, see lpjs_cred_encode_for()
+#define LPJS_CRED_ANY_UID   MUNGE_UID_ANY
+
+#define LPJS_CRED_MOCK_PREFIX   "MOCK:"
+
+extern const lpjs_cred_backend_t    Cred_munge, Cred_mock;
+
+#include "cred-protos.h"
+
+#endif  // _LPJS_CRED_H_
@@ -0,0 +1,10 @@
+/* history.c */
+void history_usage(const char *arg0);
+int history_parse_date(const char *date, time_t *time);
+int history_print(const history_record_t *record, void *arg);
+int history_add(const history_record_t *record, void *arg);
+void history_print_summary(const history_summary_t *summary);
+void history_format_duration(char *buff, size_t size, time_t seconds);
+int history_parse_old(char *line, struct tm *tm, history_record_t *record, char *node, char *user);
+void history_free_strings(history_record_t *records, size_t count);
+int history_import(const char *path);
@@ -0,0 +1,492 @@
+/***************************************************************************
+ *  Description:
+ *      Show the job history, or import a job-history file written
+ *      by older versions of lpjs_dispatchd.  Records are read directly
+ *      from LPJS_HISTORY_DIR, so dispatchd need not be running.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2024-02-20  Jason Bacon Begin as a shell script
+ *  2026-10-19  Jason Bacon Read segmented history, add --import
+ *  2026-10-19  Jason Bacon Add filters and --summary
+ ***************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+#include <limits.h>         // PATH_MAX
+#include <sysexits.h>
+#include <stdbool.h>
+#include <unistd.h>         // getcwd()
+#include <sys/stat.h>       // fstat()
+
+#include "lpjs.h"
+#include "job-history.h"
+#include "misc.h"
+
+#define HISTORY_FIELD_MAX   256
+
+// Output format
+typedef enum
+{
+    HISTORY_SHORT,
+    HISTORY_LONG,
+    HISTORY_SUMMARY
+}   history_format_t;
+
+// Totals for --summary
+typedef struct
+{
+    size_t          jobs,
+		    failed,
+		    peak_rss,
+		    timed;          // Jobs with a known run time
+    unsigned long   peak_rss_job_id;
+    unsigned        min_processors,
+		    max_processors;
+    time_t          min_run_time,
+		    max_run_time;
+    double          total_run_time;
+}   history_summary_t;
+
+#include "history-protos.h"
+
+int     main(int argc,char *argv[])
+
+{
+    extern FILE         *Log_stream;
+    history_query_t     query;
+    history_summary_t   summary = { 0 };
+    history_format_t    format = HISTORY_SHORT;
+    char                script[PATH_MAX + 1];
+    int                 arg, status;
+
+    // Shared functions may use lpjs_log
+    Log_stream = stderr;
+
+    if ( (argc >= 2) && (argc <= 3) && (strcmp(argv[1], "--import") == 0) )
+	return history_import(argc == 3 ? argv[2] : LPJS_JOB_HISTORY);
+
+    lpjs_history_query_init(&query);
+    for (arg = 1; arg < argc; ++arg)
+    {
+	if ( strcmp(argv[arg], "--long") == 0 )
+	    format = HISTORY_LONG;
+	else if ( strcmp(argv[arg], "--summary") == 0 )
+	    format = HISTORY_SUMMARY;
+	else if ( strcmp(argv[arg], "--failed") == 0 )
+	    query.failed = true;
+	else if ( arg + 1 == argc )
+	    history_usage(argv[0]);
+	else if ( strcmp(argv[arg], "--user") == 0 )
+	    query.user = argv[++arg];
+	else if ( strcmp(argv[arg], "--node") == 0 )
+	    query.node = argv[++arg];
+	else if ( strcmp(argv[arg], "--script") == 0 )
+	{
+	    // Scripts are recorded by absolute path
+	    query.script = argv[++arg];
+	    if ( (*query.script != '/') &&
+		 (getcwd(script, sizeof(script)) != NULL) )
+	    {
+		if ( strncmp(query.script, "./", 2) == 0 )
+		    query.script += 2;
+		snprintf(script + strlen(script), sizeof(script) - strlen(script),
+			 "/%s", query.script);
+		query.script = script;
+	    }
+	}
+	else if ( strcmp(argv[arg], "--since") == 0 )
+	{
+	    if ( history_parse_date(argv[++arg], &query.since) != 0 )
+		history_usage(argv[0]);
+	}
+	else if ( strcmp(argv[arg], "--until") == 0 )
+	{
+	    // Through the end of the day
+	    if ( history_parse_date(argv[++arg], &query.until) != 0 )
+		history_usage(argv[0]);
+	    query.until += 24 * 60 * 60 - 1;
+	}
+	else
+	    history_usage(argv[0]);
+    }
+
+    if ( format == HISTORY_SUMMARY )
+    {
+	query.columns = LPJS_HISTORY_COLUMN(LPJS_HISTORY_JOB_ID) |
+			LPJS_HISTORY_COLUMN(LPJS_HISTORY_EXIT_STATUS) |
+			LPJS_HISTORY_COLUMN(LPJS_HISTORY_PEAK_RSS) |
+			LPJS_HISTORY_COLUMN(LPJS_HISTORY_PROCESSORS) |
+			LPJS_HISTORY_COLUMN(LPJS_HISTORY_RUN_TIME);
+	status = lpjs_history_scan(&query, history_add, &summary);
+    }
+    else
+	status = lpjs_history_scan(&query, history_print, &format);
+    if ( status != 0 )
+    {
+	fprintf(stderr, "%s: Cannot read %s: %s\n", argv[0],
+		LPJS_HISTORY_DIR, strerror(errno));
+	return EX_NOINPUT;
+    }
+    if ( format == HISTORY_SUMMARY )
+	history_print_summary(&summary);
+    return EX_OK;
+}
+
+
+void    history_usage(const char *arg0)
+
+{
+    fprintf(stderr, "Usage: %s [--long | --summary] [--user user] [--node node]\n"
+		    "        [--script script] [--failed]"
+		    " [--since YYYY-MM-DD] [--until YYYY-MM-DD]\n", arg0);
+    fprintf(stderr, "       %s --import [job-history-file]\n", arg0);
+    exit(EX_USAGE);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Convert YYYY-MM-DD to the start of that day, local time
+ *
+ *  Returns:
+ *      0 on success, -1 if date is malformed
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     history_parse_date(const char *date, time_t *time)
+
+{
+    struct tm   tm = { 0 };
+    int         end = 0;
+
+    if ( (sscanf(date, "%d-%d-%d%n", &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+		 &end) != 3) || (date[end] != '\0') ||
+	 (tm.tm_mon < 1) || (tm.tm_mon > 12) ||
+	 (tm.tm_mday < 1) || (tm.tm_mday > 31) )
+	return -1;
+    tm.tm_year -= 1900;
+    --tm.tm_mon;
+    tm.tm_isdst = -1;
+    return (*time = mktime(&tm)) == -1 ? -1 : 0;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Print one record, in the format of the old job-history file
+ *      or as name=value pairs
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Show start and run time in long format
+ ***************************************************************************/
+
+int     history_print(const history_record_t *record, void *arg)
+
+{
+    history_format_t    format = *(history_format_t *)arg;
+    char                date[32], start[48], run_time[32];
+    time_t              start_time;
+
+    if ( format == HISTORY_LONG )
+    {
+	strftime(date, sizeof(date), "date=%Y-%m-%d time=%H:%M:%S",
+		 localtime(&record->time));
+	if ( record->run_time >= 0 )
+	{
+	    start_time = record->time - record->run_time;
+	    strftime(start, sizeof(start),
+		     "start-date=%Y-%m-%d start-time=%H:%M:%S",
+		     localtime(&start_time));
+	    history_format_duration(run_time, sizeof(run_time),
+				    record->run_time);
+	}
+	else
+	{
+	    snprintf(start, sizeof(start),
+		     "start-date=unknown start-time=unknown");
+	    snprintf(run_time, sizeof(run_time), "unknown");
+	}
+	printf("%s %s run-time=%s job-id=%lu exit-status=%d peak-pmem=%zuMiB"
+	       " pmem-per-processor=%zuMiB processors-per-job=%u"
+	       " threads-per-process=%u compute-node=%s user=%s script=%s\n",
+	       date, start, run_time, record->job_id, record->exit_status,
+	       record->peak_rss / 1024, record->pmem_mib,
+	       record->processors, record->threads,
+	       record->node, record->user, record->script);
+    }
+    else
+    {
+	// pmem is reported in KiB, like peak RSS
+	strftime(date, sizeof(date), "%m-%d %H:%M:%S",
+		 localtime(&record->time));
+	printf("%s %lu %d %zu %zu %u %u %s %s %s\n",
+	       date, record->job_id, record->exit_status,
+	       record->peak_rss, record->pmem_mib * 1024,
+	       record->processors, record->threads,
+	       record->node, record->user, record->script);
+    }
+    return 0;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Add one record to the totals for --summary
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     history_add(const history_record_t *record, void *arg)
+
+{
+    history_summary_t   *summary = arg;
+
+    if ( (summary->jobs == 0) ||
+	 (record->processors < summary->min_processors) )
+	summary->min_processors = record->processors;
+    if ( record->processors > summary->max_processors )
+	summary->max_processors = record->processors;
+    ++summary->jobs;
+    if ( record->exit_status != 0 )
+	++summary->failed;
+    if ( (summary->jobs == 1) || (record->peak_rss > summary->peak_rss) )
+    {
+	summary->peak_rss = record->peak_rss;
+	summary->peak_rss_job_id = record->job_id;
+    }
+    if ( record->run_time >= 0 )
+    {
+	if ( (summary->timed == 0) ||
+	     (record->run_time < summary->min_run_time) )
+	    summary->min_run_time = record->run_time;
+	if ( record->run_time > summary->max_run_time )
+	    summary->max_run_time = record->run_time;
+	summary->total_run_time += record->run_time;
+	++summary->timed;
+    }
+    return 0;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Print the totals for --summary.  lpjs peak-mem parses the
+ *      "Peak RSS:" line.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    history_print_summary(const history_summary_t *summary)
+
+{
+    char    min[32], mean[32], max[32];
+
+    printf("Jobs: %zu\n", summary->jobs);
+    if ( summary->jobs == 0 )
+	return;
+    printf("Failed: %zu\n", summary->failed);
+    printf("Peak RSS: %zu KiB (job %lu)\n", summary->peak_rss,
+	   summary->peak_rss_job_id);
+    if ( summary->min_processors == summary->max_processors )
+	printf("Processors per job: %u\n", summary->min_processors);
+    else
+	printf("Processors per job: %u to %u\n", summary->min_processors,
+	       summary->max_processors);
+    if ( summary->timed == 0 )
+	printf("Run time: unknown\n");
+    else
+    {
+	history_format_duration(min, sizeof(min), summary->min_run_time);
+	history_format_duration(mean, sizeof(mean),
+				summary->total_run_time / summary->timed);
+	history_format_duration(max, sizeof(max), summary->max_run_time);
+	printf("Run time: %s min, %s mean, %s max\n", min, mean, max);
+    }
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Format seconds as H:MM:SS
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    history_format_duration(char *buff, size_t size, time_t seconds)
+
+{
+    snprintf(buff, size, "%lld:%02lld:%02lld", (long long)seconds / 3600,
+	     (long long)seconds / 60 % 60, (long long)seconds % 60);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Parse a line of an old job-history file, which has no year:
+ *
+ *      mm-dd HH:MM:SS job-id status peak-KiB pmem-KiB procs threads
+ *          node user script
+ *
+ *  Returns:
+ *      0 on success, -1 if the line is malformed
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     history_parse_old(char *line, struct tm *tm, history_record_t *record,
+			  char *node, char *user)
+
+{
+    size_t  pmem_kib;
+    int     script_start = -1;
+
+    memset(tm, 0, sizeof(*tm));
+    sscanf(line, "%d-%d %d:%d:%d %lu %d %zu %zu %u %u %255s %255s %n",
+	   &tm->tm_mon, &tm->tm_mday, &tm->tm_hour, &tm->tm_min, &tm->tm_sec,
+	   &record->job_id, &record->exit_status, &record->peak_rss,
+	   &pmem_kib, &record->processors, &record->threads,
+	   node, user, &script_start);
+    if ( script_start == -1 )
+	return -1;
+    --tm->tm_mon;
+    tm->tm_isdst = -1;
+    record->pmem_mib = pmem_kib / 1024;
+    record->node = node;
+    record->user = user;
+    record->script = line + script_start;
+    record->run_time = -1;  // Not recorded by older versions
+    line[strcspn(line, "\n")] = '\0';
+    return 0;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Free the strings of imported records
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    history_free_strings(history_record_t *records, size_t count)
+
+{
+    for (size_t c = 0; c < count; ++c)
+    {
+	free((char *)records[c].node);
+	free((char *)records[c].user);
+	free((char *)records[c].script);
+    }
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Convert an old job-history file to archive segments.  The
+ *      file is left in place.  Lines have no year, so the last is
+ *      assumed to be from the year the file was last modified, and
+ *      the year is counted back from there at each point where the
+ *      month goes backward.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     history_import(const char *path)
+
+{
+    FILE                *fp;
+    struct stat         st;
+    struct tm           tm;
+    history_record_t    *records;
+    char                line[PATH_MAX + 2 * HISTORY_FIELD_MAX + 128],
+			node[HISTORY_FIELD_MAX], user[HISTORY_FIELD_MAX];
+    int                 year, previous_month = 0;
+    size_t              count = 0, total = 0, skipped = 0;
+
+    if ( ((fp = fopen(path, "r")) == NULL) || (fstat(fileno(fp), &st) != 0) )
+    {
+	fprintf(stderr, "Cannot open %s: %s\n", path, strerror(errno));
+	return EX_NOINPUT;
+    }
+    year = localtime(&st.st_mtime)->tm_year;
+
+    // First pass: count back to the year of the first line
+    while ( fgets(line, sizeof(line), fp) != NULL )
+    {
+	if ( history_parse_old(line, &tm, &(history_record_t){0}, node, user) != 0 )
+	    continue;
+	if ( tm.tm_mon < previous_month )
+	    --year;
+	previous_month = tm.tm_mon;
+    }
+    rewind(fp);
+
+    if ( (records = malloc(LPJS_HISTORY_HOT_RECORDS * sizeof(*records))) == NULL )
+    {
+	fprintf(stderr, "%s(): malloc() failed.\n", __FUNCTION__);
+	return EX_UNAVAILABLE;
+    }
+
+    previous_month = 0;
+    while ( fgets(line, sizeof(line), fp) != NULL )
+    {
+	if ( history_parse_old(line, &tm, &records[count], node, user) != 0 )
+	{
+	    ++skipped;
+	    continue;
+	}
+	if ( tm.tm_mon < previous_month )
+	    ++year;
+	previous_month = tm.tm_mon;
+	tm.tm_year = year;
+	records[count].time = mktime(&tm);
+	if ( ((records[count].node = strdup(node)) == NULL) ||
+	     ((records[count].user = strdup(user)) == NULL) ||
+	     ((records[count].script = strdup(records[count].script)) == NULL) )
+	{
+	    fprintf(stderr, "%s(): strdup() failed.\n", __FUNCTION__);
+	    return EX_UNAVAILABLE;
+	}
+	if ( ++count == LPJS_HISTORY_HOT_RECORDS )
+	{
+	    if ( lpjs_history_write_segment(records, count) != 0 )
+		return EX_CANTCREAT;
+	    history_free_strings(records, count);
+	    total += count;
+	    count = 0;
+	}
+    }
+    fclose(fp);
+
+    if ( lpjs_history_write_segment(records, count) != 0 )
+	return EX_CANTCREAT;
+    history_free_strings(records, count);
+    total += count;
+    free(records);
+
+    printf("Imported %zu records from %s, skipped %zu malformed lines.\n",
+	   total, path, skipped);
+    printf("%s may now be removed.  Importing it again would duplicate the records.\n",
+	   path);
+    return EX_OK;
+}
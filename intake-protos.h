@@ -0,0 +1,4 @@
+/* intake.c */
+void lpjs_intake_add(job_t *job);
+size_t lpjs_intake_queued(void);
+job_t *lpjs_intake_next(void);
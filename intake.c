@@ -0,0 +1,97 @@
+#include <stdio.h>
+#include <stdlib.h>         // realloc()
+#include <string.h>         // memmove()
+#include <sysexits.h>
+
+#include "intake.h"
+#include "misc.h"           // lpjs_log()
+
+/*
+ *  FIFO of acknowledged jobs awaiting the pending list.  Entries
+ *  before Head are done.  dispatchd is single-threaded, so no locking
+ *  is needed.
+ */
+
+static job_t    **Queue = NULL;
+static size_t   Head = 0,
+		Count = 0,
+		Slots = 0;
+
+
+/***************************************************************************
+ *  Description:
+ *      Queue a journaled job for the pending list.  The intake owns
+ *      job until lpjs_intake_next() returns it.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    lpjs_intake_add(job_t *job)
+
+{
+    job_t   **new_queue;
+
+    // Reuse the space of finished entries before growing
+    if ( (Count == Slots) && (Head > 0) )
+    {
+	memmove(Queue, Queue + Head, (Count - Head) * sizeof(*Queue));
+	Count -= Head;
+	Head = 0;
+    }
+    if ( Count == Slots )
+    {
+	Slots = Slots == 0 ? LPJS_INTAKE_BATCH : Slots * 2;
+	if ( (new_queue = realloc(Queue, Slots * sizeof(*Queue))) == NULL )
+	{
+	    lpjs_log("%s(): Error: realloc() failed.\n", __FUNCTION__);
+	    exit(EX_UNAVAILABLE);
+	}
+	Queue = new_queue;
+    }
+    Queue[Count++] = job;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Get the number of jobs awaiting the pending list
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+size_t  lpjs_intake_queued(void)
+
+{
+    return Count - Head;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Remove the oldest job from the intake.  The caller takes
+ *      ownership of it.
+ *
+ *  Returns:
+ *      The job, or NULL if the intake is empty
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+job_t   *lpjs_intake_next(void)
+
+{
+    job_t   *job;
+
+    if ( Head == Count )
+	return NULL;
+    job = Queue[Head++];
+    if ( Head == Count )
+	Head = Count = 0;
+    return job;
+}
@@ -0,0 +1,27 @@
+#ifndef _LPJS_INTAKE_H_
+#define _LPJS_INTAKE_H_
+
+#include <stddef.h>     // size_t
+
+#ifndef _LPJS_JOB_H_
+#include "job.h"
+#endif
+
+/*
+ *  New jobs that are journaled and acknowledged, but not yet on the
+ *  pending list.  lpjs_submit() queues them with lpjs_intake_add()
+ *  and replies, and dispatchd moves them to the pending list in
+ *  batches when idle.  The journal holds them, so nothing is lost if
+ *  dispatchd exits with jobs in the intake.
+ */
+
+// Jobs moved to the pending list per idle moment
+#define LPJS_INTAKE_BATCH       256
+// Drain even when busy once this many are queued
+#define LPJS_INTAKE_QUEUE_MAX   4096
+// Submissions wait for the intake to drain beyond this
+#define LPJS_INTAKE_LIMIT       65536
+
+#include "intake-protos.h"
+
+#endif  // _LPJS_INTAKE_H_
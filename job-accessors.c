@@ -320,6 +320,41 @@ job_state_t    job_get_state(job_t *job_ptr)
 }
 
 
+/***************************************************************************
+ *  Library:
+ *      #include <job.h>
+ *      
+ *
+ *  Description:
+ *      Accessor for start_time member in a job_t structure.
+ *      Use this function to get start_time in a job_t object
+ *      from non-member functions.
+ *
+ *  Arguments:
+ *      job_ptr         Pointer to the structure to set
+ *
+ *  Returns:
+ *      Value of the structure member start_time, 0 if the job
+ *      has not started.
+ *
+ *  Examples:
+ *      job_t           job;
+ *      time_t          start_time;
+ *
+ *      start_time = job_get_start_time(&job);
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+time_t  job_get_start_time(job_t *job_ptr)
+
+{
+    return job_ptr->start_time;
+}
+
+
 /***************************************************************************
  *  Library:
  *      #include <job.h>
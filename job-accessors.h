@@ -19,6 +19,7 @@ size_t job_get_phys_mib_per_processor(job_t *job_ptr);
 pid_t job_get_chaperone_pid(job_t *job_ptr);
 pid_t job_get_job_pid(job_t *job_ptr);
 job_state_t job_get_state(job_t *job_ptr);
+time_t job_get_start_time(job_t *job_ptr);
 char *job_get_user_name(job_t *job_ptr);
 char job_get_user_name_ae(job_t *job_ptr, size_t c);
 char *job_get_primary_group_name(job_t *job_ptr);
@@ -0,0 +1,6 @@
+/* job-history.c */
+int lpjs_history_write_segment(history_record_t *records, size_t count);
+void lpjs_history_query_init(history_query_t *query);
+int lpjs_history_scan(const history_query_t *query, history_visit_t visit, void *arg);
+int lpjs_history_open(void);
+int lpjs_history_append(const history_record_t *record);
@@ -0,0 +1,1745 @@
+#include <stdio.h>
+#include <stdlib.h>         // malloc(), realloc(), free(), qsort()
+#include <string.h>         // strcmp(), strerror(), memcpy()
+#include <stdbool.h>
+#include <errno.h>
+#include <unistd.h>         // write(), pread(), fsync(), close(), unlink()
+#include <fcntl.h>          // open()
+#include <dirent.h>         // opendir()
+#include <stdint.h>         // INT64_MAX
+#include <sysexits.h>
+#include <limits.h>         // PATH_MAX
+#include <sys/stat.h>       // fstat()
+#include <arpa/inet.h>      // htonl(), ntohl()
+
+#include "lpjs.h"
+#include "job-history.h"
+#include "buff.h"
+#include "lz.h"
+#include "misc.h"           // lpjs_log()
+
+/*
+ *  Hot segment state.  dispatchd is the only writer and is
+ *  single-threaded, so no locking is needed.
+ */
+
+static int      Hot_fd = -1;
+static size_t   Hot_records = 0;
+
+// Lines of a hot segment, parsed in place
+typedef struct
+{
+    char                *text;
+    history_record_t    *records;
+    size_t              count;
+}   history_hot_t;
+
+// Distinct strings of a column being encoded
+typedef struct
+{
+    const char  **strings;      // In order of first use
+    size_t      *indexes;       // Index in strings of each record
+    size_t      count;
+}   history_dict_t;
+
+// A column loaded by history_load_column()
+typedef struct
+{
+    int64_t     *values;        // Numeric columns
+    char        **strings;      // Dictionary of string columns
+    size_t      string_count;
+    uint32_t    *indexes;       // Dictionary index of each record
+    char        *text;          // Dictionary strings, '\0'-terminated
+}   history_column_t;
+
+// String columns in LPJS_HISTORY_INDEX, in order
+#define HISTORY_INDEX_STRINGS   3
+// Length + CRC-32 of each index entry
+#define HISTORY_INDEX_FRAME_LEN 8
+static const unsigned   History_index_columns[HISTORY_INDEX_STRINGS] =
+			{ LPJS_HISTORY_USER, LPJS_HISTORY_NODE,
+			  LPJS_HISTORY_SCRIPT };
+
+// An entry of LPJS_HISTORY_INDEX, strings point into the loaded file
+typedef struct
+{
+    const char  *name;
+    time_t      min_time,
+		max_time;
+    size_t      string_counts[HISTORY_INDEX_STRINGS];
+    const char  **strings[HISTORY_INDEX_STRINGS];
+}   history_index_entry_t;
+
+typedef struct
+{
+    char                    *text;
+    history_index_entry_t   *entries;
+    size_t                  count,
+			    len,
+			    valid_len;      // Through the last good entry
+}   history_index_t;
+
+
+/***************************************************************************
+ *  Description:
+ *      Append an unsigned LEB128 varint to buff
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static void history_put_varint(lpjs_buff_t *buff, uint64_t value)
+
+{
+    unsigned char   bytes[10];
+    size_t          len = 0;
+
+    while ( value >= 0x80 )
+    {
+	bytes[len++] = (value & 0x7f) | 0x80;
+	value >>= 7;
+    }
+    bytes[len++] = value;
+    lpjs_buff_append(buff, bytes, len);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Decode a varint at *p and advance *p past it
+ *
+ *  Returns:
+ *      0 on success, -1 if it runs past end
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static int  history_get_varint(const unsigned char **p,
+			       const unsigned char *end, uint64_t *value)
+
+{
+    unsigned    shift;
+
+    *value = 0;
+    for (shift = 0; (*p < end) && (shift < 64); shift += 7)
+    {
+	*value |= (uint64_t)(**p & 0x7f) << shift;
+	if ( (*(*p)++ & 0x80) == 0 )
+	    return 0;
+    }
+    return -1;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Map signed values to unsigned so that small magnitudes give
+ *      short varints, and back
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static uint64_t history_zigzag(int64_t value)
+
+{
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static int64_t  history_unzigzag(uint64_t value)
+
+{
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Store and load header integers in network byte order
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static void history_put_u32(unsigned char *p, uint32_t value)
+
+{
+    value = htonl(value);
+    memcpy(p, &value, 4);
+}
+
+static uint32_t history_get_u32(const unsigned char *p)
+
+{
+    uint32_t    value;
+
+    memcpy(&value, p, 4);
+    return ntohl(value);
+}
+
+static void history_put_time(unsigned char *p, time_t time)
+
+{
+    history_put_u32(p, (uint64_t)time >> 32);
+    history_put_u32(p + 4, (uint64_t)time & 0xffffffff);
+}
+
+static time_t   history_get_time(const unsigned char *p)
+
+{
+    return (time_t)(int64_t)(((uint64_t)history_get_u32(p) << 32) |
+			     history_get_u32(p + 4));
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Get or set a numeric column of a record
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static int64_t  history_get_number(const history_record_t *record,
+				   unsigned column)
+
+{
+    switch(column)
+    {
+	case LPJS_HISTORY_TIME:
+	    return record->time;
+	case LPJS_HISTORY_JOB_ID:
+	    return record->job_id;
+	case LPJS_HISTORY_EXIT_STATUS:
+	    return record->exit_status;
+	case LPJS_HISTORY_PEAK_RSS:
+	    return record->peak_rss;
+	case LPJS_HISTORY_PMEM:
+	    return record->pmem_mib;
+	case LPJS_HISTORY_PROCESSORS:
+	    return record->processors;
+	case LPJS_HISTORY_THREADS:
+	    return record->threads;
+	case LPJS_HISTORY_RUN_TIME:
+	    return record->run_time;
+    }
+    return 0;
+}
+
+static void history_set_number(history_record_t *record, unsigned column,
+			       int64_t value)
+
+{
+    switch(column)
+    {
+	case LPJS_HISTORY_TIME:
+	    record->time = value;
+	    break;
+	case LPJS_HISTORY_JOB_ID:
+	    record->job_id = value;
+	    break;
+	case LPJS_HISTORY_EXIT_STATUS:
+	    record->exit_status = value;
+	    break;
+	case LPJS_HISTORY_PEAK_RSS:
+	    record->peak_rss = value;
+	    break;
+	case LPJS_HISTORY_PMEM:
+	    record->pmem_mib = value;
+	    break;
+	case LPJS_HISTORY_PROCESSORS:
+	    record->processors = value;
+	    break;
+	case LPJS_HISTORY_THREADS:
+	    record->threads = value;
+	    break;
+	case LPJS_HISTORY_RUN_TIME:
+	    record->run_time = value;
+	    break;
+    }
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Get the address of a string column of a record
+ *
+ *  Returns:
+ *      Address of the column, or NULL if column is numeric
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static const char   **history_string(history_record_t *record,
+				     unsigned column)
+
+{
+    switch(column)
+    {
+	case LPJS_HISTORY_NODE:
+	    return &record->node;
+	case LPJS_HISTORY_USER:
+	    return &record->user;
+	case LPJS_HISTORY_SCRIPT:
+	    return &record->script;
+    }
+    return NULL;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Whether a column is delta-encoded
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static bool history_delta_column(unsigned column)
+
+{
+    return (column == LPJS_HISTORY_TIME) || (column == LPJS_HISTORY_JOB_ID);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Collect the distinct values of a string column of count records,
+ *      and the index of each record's value among them
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static void history_dict_build(history_dict_t *dict,
+			       history_record_t *records, size_t count,
+			       unsigned column)
+
+{
+    size_t      *slots,     // Hash table of indexes + 1, 0 if empty
+		slot_count, slot, c;
+    uint32_t    hash;
+    const char  *string, *p;
+
+    // A power of 2 at least twice count, so probe sequences stay short
+    for (slot_count = 1; slot_count < count * 2; slot_count *= 2)
+	;
+    dict->count = 0;
+    dict->strings = malloc((count + 1) * sizeof(*dict->strings));
+    dict->indexes = malloc((count + 1) * sizeof(*dict->indexes));
+    slots = calloc(slot_count, sizeof(*slots));
+    if ( (dict->strings == NULL) || (dict->indexes == NULL) || (slots == NULL) )
+    {
+	lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
+	exit(EX_UNAVAILABLE);
+    }
+
+    for (c = 0; c < count; ++c)
+    {
+	if ( (string = *history_string(&records[c], column)) == NULL )
+	    string = "";
+	hash = 2166136261u;     // FNV-1a
+	for (p = string; *p != '\0'; ++p)
+	    hash = (hash ^ (unsigned char)*p) * 16777619u;
+	for (slot = hash & (slot_count - 1); (slots[slot] != 0) &&
+	     (strcmp(dict->strings[slots[slot] - 1], string) != 0);
+	     slot = (slot + 1) & (slot_count - 1))
+	    ;
+	if ( slots[slot] == 0 )
+	{
+	    dict->strings[dict->count] = string;
+	    slots[slot] = ++dict->count;
+	}
+	dict->indexes[c] = slots[slot] - 1;
+    }
+    free(slots);
+}
+
+
+static void history_dict_free(history_dict_t *dict)
+
+{
+    free(dict->strings);
+    free(dict->indexes);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Encode one column of count records into buff.  dict is the
+ *      result of history_dict_build() for string columns.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static void history_encode_column(lpjs_buff_t *buff,
+				  history_record_t *records, size_t count,
+				  unsigned column, history_dict_t *dict)
+
+{
+    size_t          c;
+    int64_t         value, previous = 0;
+
+    if ( history_string(records, column) == NULL )
+    {
+	for (c = 0; c < count; ++c)
+	{
+	    value = history_get_number(&records[c], column);
+	    if ( history_delta_column(column) )
+	    {
+		history_put_varint(buff, history_zigzag(value - previous));
+		previous = value;
+	    }
+	    else
+		history_put_varint(buff, history_zigzag(value));
+	}
+	return;
+    }
+
+    history_put_varint(buff, dict->count);
+    for (c = 0; c < dict->count; ++c)
+    {
+	history_put_varint(buff, strlen(dict->strings[c]));
+	lpjs_buff_append(buff, dict->strings[c], strlen(dict->strings[c]));
+    }
+    for (c = 0; c < count; ++c)
+	history_put_varint(buff, dict->indexes[c]);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Append an entry for an archive segment to LPJS_HISTORY_INDEX,
+ *      in one write() so that concurrent appends don't interleave
+ *
+ *  Returns:
+ *      0 on success, -1 on failure
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static int  history_index_append(const char *name,
+				 time_t min_time, time_t max_time,
+				 const char **strings[],
+				 const size_t string_counts[])
+
+{
+    lpjs_buff_t *entry;
+    size_t      k, c;
+    int         fd, status = 0;
+
+    entry = lpjs_buff_get(LPJS_BUFF_INITIAL_SIZE);
+    // Length and CRC-32, filled in below
+    lpjs_buff_append(entry, "\0\0\0\0\0\0\0\0", HISTORY_INDEX_FRAME_LEN);
+    lpjs_buff_append(entry, name, strlen(name) + 1);
+    history_put_varint(entry, history_zigzag(min_time));
+    history_put_varint(entry, history_zigzag(max_time));
+    for (k = 0; k < HISTORY_INDEX_STRINGS; ++k)
+    {
+	history_put_varint(entry, string_counts[k]);
+	for (c = 0; c < string_counts[k]; ++c)
+	    lpjs_buff_append(entry, strings[k][c], strlen(strings[k][c]) + 1);
+    }
+    history_put_u32((unsigned char *)entry->data,
+		    entry->len - HISTORY_INDEX_FRAME_LEN);
+    history_put_u32((unsigned char *)entry->data + 4,
+		    lpjs_crc32(entry->data + HISTORY_INDEX_FRAME_LEN,
+			       entry->len - HISTORY_INDEX_FRAME_LEN));
+
+    if ( ((fd = open(LPJS_HISTORY_INDEX, O_WRONLY|O_APPEND|O_CREAT, 0644)) == -1) ||
+	 (write(fd, entry->data, entry->len) != (ssize_t)entry->len) )
+    {
+	lpjs_log("%s(): Error: Cannot write %s: %s\n", __FUNCTION__,
+		 LPJS_HISTORY_INDEX, strerror(errno));
+	status = -1;
+    }
+    if ( fd != -1 )
+	close(fd);
+    lpjs_buff_put(&entry);
+    return status;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Write count records to a new archive segment and index it.
+ *      The file is written under a temporary name, fsync()ed and
+ *      renamed into place, so readers never see a partial segment.
+ *
+ *  Returns:
+ *      0 on success, -1 on failure
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Index the segment
+ *  2026-10-19  Jason Bacon Make room for the temp file suffix
+ ***************************************************************************/
+
+int     lpjs_history_write_segment(history_record_t *records, size_t count)
+
+{
+    unsigned char   header[LPJS_HISTORY_HEADER_LEN +
+			   LPJS_HISTORY_COLUMNS * LPJS_HISTORY_DIR_ENTRY_LEN],
+		    *entry;
+    history_dict_t  dicts[HISTORY_INDEX_STRINGS];
+    const char      **strings[HISTORY_INDEX_STRINGS];
+    size_t          string_counts[HISTORY_INDEX_STRINGS];
+    lpjs_buff_t     *raw, *columns;
+    char            name[64], path[PATH_MAX + 1],
+		    temp_path[PATH_MAX + 5];    // path + ".tmp"
+    time_t          min_time, max_time;
+    size_t          c, k, offset;
+    ssize_t         stored;
+    unsigned        column;
+    int             fd, status = 0;
+
+    if ( count == 0 )
+	return 0;
+
+    min_time = max_time = records[0].time;
+    for (c = 1; c < count; ++c)
+    {
+	if ( records[c].time < min_time )
+	    min_time = records[c].time;
+	if ( records[c].time > max_time )
+	    max_time = records[c].time;
+    }
+
+    memcpy(header, LPJS_HISTORY_MAGIC, 4);
+    header[4] = LPJS_HISTORY_VERSION;
+    header[5] = LPJS_HISTORY_COLUMNS;
+    header[6] = header[7] = 0;
+    history_put_u32(header + 8, count);
+    history_put_time(header + 12, min_time);
+    history_put_time(header + 20, max_time);
+
+    // String columns are all in the index
+    for (k = 0; k < HISTORY_INDEX_STRINGS; ++k)
+	history_dict_build(&dicts[k], records, count, History_index_columns[k]);
+
+    raw = lpjs_buff_get(LPJS_BUFF_INITIAL_SIZE);
+    columns = lpjs_buff_get(LPJS_BUFF_INITIAL_SIZE);
+    offset = sizeof(header);
+    for (column = 0; column < LPJS_HISTORY_COLUMNS; ++column)
+    {
+	for (k = 0; (k < HISTORY_INDEX_STRINGS) &&
+		    (History_index_columns[k] != column); ++k)
+	    ;
+	raw->len = 0;
+	history_encode_column(raw, records, count, column,
+			      k < HISTORY_INDEX_STRINGS ? &dicts[k] : NULL);
+	lpjs_buff_reserve(columns, columns->len + LZ_COMPRESS_BOUND(raw->len));
+	stored = lz_compress(raw->data, raw->len, columns->data + columns->len,
+			     columns->size - columns->len);
+	if ( (stored < 0) || ((size_t)stored >= raw->len) )
+	{
+	    lpjs_buff_append(columns, raw->data, raw->len);
+	    stored = raw->len;
+	}
+	else
+	    columns->len += stored;
+
+	entry = header + LPJS_HISTORY_HEADER_LEN +
+		column * LPJS_HISTORY_DIR_ENTRY_LEN;
+	history_put_u32(entry, offset);
+	history_put_u32(entry + 4, stored);
+	history_put_u32(entry + 8, raw->len);
+	offset += stored;
+    }
+    lpjs_buff_put(&raw);
+
+    // Zero-padded time sorts segments in time order
+    snprintf(name, sizeof(name), "%010lld-%lu%s",
+	     (long long)records[0].time, records[0].job_id,
+	     LPJS_HISTORY_SEGMENT_SUFFIX);
+    snprintf(path, sizeof(path), "%s/%s", LPJS_HISTORY_DIR, name);
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+    if ( (fd = open(temp_path, O_WRONLY|O_CREAT|O_TRUNC, 0644)) == -1 )
+    {
+	lpjs_log("%s(): Error: Cannot create %s: %s\n", __FUNCTION__,
+		 temp_path, strerror(errno));
+	status = -1;
+    }
+    else
+    {
+	if ( (write(fd, header, sizeof(header)) != sizeof(header)) ||
+	     (write(fd, columns->data, columns->len) != (ssize_t)columns->len) ||
+	     (fsync(fd) != 0) )
+	{
+	    lpjs_log("%s(): Error: Cannot write %s: %s\n", __FUNCTION__,
+		     temp_path, strerror(errno));
+	    status = -1;
+	}
+	close(fd);
+	if ( (status == 0) && (rename(temp_path, path) != 0) )
+	{
+	    lpjs_log("%s(): Error: Cannot rename %s: %s\n", __FUNCTION__,
+		     temp_path, strerror(errno));
+	    status = -1;
+	}
+	if ( status != 0 )
+	    unlink(temp_path);
+    }
+    lpjs_buff_put(&columns);
+
+    // A segment missing from the index is still found, just more slowly
+    if ( status == 0 )
+    {
+	for (k = 0; k < HISTORY_INDEX_STRINGS; ++k)
+	{
+	    strings[k] = dicts[k].strings;
+	    string_counts[k] = dicts[k].count;
+	}
+	history_index_append(name, min_time, max_time, strings, string_counts);
+	lpjs_debug("%s(): Archived %zu records to %s.\n", __FUNCTION__,
+		   count, path);
+    }
+    for (k = 0; k < HISTORY_INDEX_STRINGS; ++k)
+	history_dict_free(&dicts[k]);
+    return status;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Parse a hot segment line in place.  Strings in record point
+ *      into line.  Lines without the later columns get their defaults.
+ *
+ *  Returns:
+ *      0 on success, -1 if the line is malformed
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static int  history_parse_line(char *line, history_record_t *record)
+
+{
+    char        *fields[LPJS_HISTORY_COLUMNS], *end;
+    unsigned    column, field_count;
+
+    for (field_count = 1, fields[0] = line;
+	 (field_count < LPJS_HISTORY_COLUMNS) &&
+	 ((line = strchr(line, '\t')) != NULL); ++field_count)
+    {
+	*line++ = '\0';
+	fields[field_count] = line;
+    }
+    if ( field_count < LPJS_HISTORY_RUN_TIME )
+	return -1;
+
+    record->run_time = -1;
+    for (column = 0; column < field_count; ++column)
+    {
+	if ( history_string(record, column) != NULL )
+	    *history_string(record, column) = fields[column];
+	else
+	{
+	    history_set_number(record, column,
+			       strtoll(fields[column], &end, 10));
+	    if ( (*end != '\0') || (end == fields[column]) )
+		return -1;
+	}
+    }
+    return 0;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Load and parse a hot segment.  Malformed lines, such as one
+ *      cut short by a crash, are skipped.
+ *
+ *  Returns:
+ *      0 on success or if path does not exist, -1 otherwise
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static int  history_load_hot(const char *path, history_hot_t *hot)
+
+{
+    struct stat st;
+    int         fd;
+    ssize_t     bytes;
+    size_t      lines;
+    char        *line, *end;
+
+    hot->text = NULL;
+    hot->records = NULL;
+    hot->count = 0;
+    if ( (fd = open(path, O_RDONLY)) == -1 )
+	return errno == ENOENT ? 0 : -1;
+    if ( fstat(fd, &st) != 0 )
+    {
+	close(fd);
+	return -1;
+    }
+    if ( (hot->text = malloc(st.st_size + 1)) == NULL )
+    {
+	lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
+	exit(EX_UNAVAILABLE);
+    }
+    bytes = read(fd, hot->text, st.st_size);
+    close(fd);
+    if ( bytes < 0 )
+	return -1;
+    hot->text[bytes] = '\0';
+
+    for (lines = 0, line = hot->text; (line = strchr(line, '\n')) != NULL;
+	 ++line)
+	++lines;
+    if ( (hot->records = calloc(lines + 1, sizeof(*hot->records))) == NULL )
+    {
+	lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
+	exit(EX_UNAVAILABLE);
+    }
+
+    // An unterminated last line was cut short, ignore it
+    for (line = hot->text; (end = strchr(line, '\n')) != NULL; line = end + 1)
+    {
+	*end = '\0';
+	if ( history_parse_line(line, &hot->records[hot->count]) == 0 )
+	    ++hot->count;
+	else
+	    lpjs_log("%s(): Skipping malformed record in %s.\n",
+		     __FUNCTION__, path);
+    }
+    return 0;
+}
+
+
+static void history_free_hot(history_hot_t *hot)
+
+{
+    free(hot->text);
+    free(hot->records);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Convert LPJS_HISTORY_SEALING to archive segments and remove it
+ *
+ *  Returns:
+ *      0 on success, -1 on failure, in which case it is left for
+ *      the next attempt
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static int  history_archive_sealing(void)
+
+{
+    history_hot_t   hot;
+    size_t          c, n;
+    int             status = 0;
+
+    if ( history_load_hot(LPJS_HISTORY_SEALING, &hot) != 0 )
+    {
+	lpjs_log("%s(): Error: Cannot read %s: %s\n", __FUNCTION__,
+		 LPJS_HISTORY_SEALING, strerror(errno));
+	return -1;
+    }
+    for (c = 0; (c < hot.count) && (status == 0); c += n)
+    {
+	n = hot.count - c;
+	if ( n > LPJS_HISTORY_HOT_RECORDS )
+	    n = LPJS_HISTORY_HOT_RECORDS;
+	status = lpjs_history_write_segment(hot.records + c, n);
+    }
+    history_free_hot(&hot);
+    if ( (status == 0) && (unlink(LPJS_HISTORY_SEALING) != 0) &&
+	 (errno != ENOENT) )
+	status = -1;
+    return status;
+}
+
+
+static int  history_name_cmp(const void *a, const void *b)
+
+{
+    return strcmp(*(char * const *)a, *(char * const *)b);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      List the archive segments in name order, which is time order
+ *
+ *  Returns:
+ *      Array of names to be freed with history_free_names(), or NULL
+ *      if LPJS_HISTORY_DIR is unreadable
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static char **history_list_segments(size_t *count)
+
+{
+    DIR             *dir;
+    struct dirent   *entry;
+    char            **names, **new_names;
+    size_t          slots = 64, len,
+		    suffix_len = strlen(LPJS_HISTORY_SEGMENT_SUFFIX);
+
+    *count = 0;
+    if ( (dir = opendir(LPJS_HISTORY_DIR)) == NULL )
+	return NULL;
+    if ( (names = malloc(slots * sizeof(*names))) == NULL )
+    {
+	lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
+	exit(EX_UNAVAILABLE);
+    }
+    while ( (entry = readdir(dir)) != NULL )
+    {
+	len = strlen(entry->d_name);
+	if ( (len <= suffix_len) ||
+	     (strcmp(entry->d_name + len - suffix_len,
+		     LPJS_HISTORY_SEGMENT_SUFFIX) != 0) )
+	    continue;
+	if ( *count == slots )
+	{
+	    slots *= 2;
+	    if ( (new_names = realloc(names, slots * sizeof(*names))) == NULL )
+	    {
+		lpjs_log("%s(): Error: realloc() failed.\n", __FUNCTION__);
+		exit(EX_UNAVAILABLE);
+	    }
+	    names = new_names;
+	}
+	if ( (names[(*count)++] = strdup(entry->d_name)) == NULL )
+	{
+	    lpjs_log("%s(): Error: strdup() failed.\n", __FUNCTION__);
+	    exit(EX_UNAVAILABLE);
+	}
+    }
+    closedir(dir);
+    qsort(names, *count, sizeof(*names), history_name_cmp);
+    return names;
+}
+
+
+static void history_free_names(char **names, size_t count)
+
+{
+    while ( count > 0 )
+	free(names[--count]);
+    free(names);
+}
+
+
+static int  history_entry_cmp(const void *a, const void *b)
+
+{
+    return strcmp(((const history_index_entry_t *)a)->name,
+		  ((const history_index_entry_t *)b)->name);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Load LPJS_HISTORY_INDEX, sorted by segment name.  A damaged
+ *      entry, e.g. cut short by a crash, ends the index, and the
+ *      segments after it are scanned instead until history_reindex()
+ *      replaces it.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static void history_load_index(history_index_t *index)
+
+{
+    history_index_entry_t   *entry, *new_entries;
+    struct stat             st;
+    const char              *p, *end, *next;
+    uint64_t                value;
+    size_t                  slots = 0, len, k, c;
+    ssize_t                 bytes = -1;
+    int                     fd;
+
+    index->text = NULL;
+    index->entries = NULL;
+    index->count = index->len = index->valid_len = 0;
+    if ( (fd = open(LPJS_HISTORY_INDEX, O_RDONLY)) == -1 )
+	return;
+    if ( (fstat(fd, &st) == 0) &&
+	 ((index->text = malloc(st.st_size + 1)) != NULL) )
+	bytes = read(fd, index->text, st.st_size);
+    close(fd);
+    if ( bytes < 0 )
+	return;
+    index->len = bytes;
+
+    for (p = index->text, end = p + bytes;
+	 end - p >= HISTORY_INDEX_FRAME_LEN; p = next)
+    {
+	len = history_get_u32((const unsigned char *)p);
+	if ( (len > (size_t)(end - p - HISTORY_INDEX_FRAME_LEN)) ||
+	     (lpjs_crc32(p + HISTORY_INDEX_FRAME_LEN, len) !=
+	      history_get_u32((const unsigned char *)p + 4)) )
+	    break;
+	next = p + HISTORY_INDEX_FRAME_LEN + len;
+	if ( index->count == slots )
+	{
+	    slots = slots == 0 ? 64 : slots * 2;
+	    new_entries = realloc(index->entries,
+				  slots * sizeof(*index->entries));
+	    if ( new_entries == NULL )
+	    {
+		lpjs_log("%s(): Error: realloc() failed.\n", __FUNCTION__);
+		exit(EX_UNAVAILABLE);
+	    }
+	    index->entries = new_entries;
+	}
+	entry = &index->entries[index->count];
+	memset(entry, 0, sizeof(*entry));
+
+	// Strings are '\0'-terminated, so point to them in place
+	p += HISTORY_INDEX_FRAME_LEN;
+	entry->name = p;
+	if ( (p = memchr(p, '\0', next - p)) == NULL )
+	    break;
+	++p;
+	if ( history_get_varint((const unsigned char **)&p,
+				(const unsigned char *)next, &value) != 0 )
+	    break;
+	entry->min_time = history_unzigzag(value);
+	if ( history_get_varint((const unsigned char **)&p,
+				(const unsigned char *)next, &value) != 0 )
+	    break;
+	entry->max_time = history_unzigzag(value);
+	for (k = 0; k < HISTORY_INDEX_STRINGS; ++k)
+	{
+	    if ( (history_get_varint((const unsigned char **)&p,
+				     (const unsigned char *)next, &value) != 0) ||
+		 (value > (uint64_t)(next - p)) )
+		break;
+	    entry->string_counts[k] = value;
+	    if ( (entry->strings[k] = malloc((value + 1) *
+					     sizeof(*entry->strings[k]))) == NULL )
+	    {
+		lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
+		exit(EX_UNAVAILABLE);
+	    }
+	    for (c = 0; (c < value) && (p != NULL); ++c)
+	    {
+		entry->strings[k][c] = p;
+		if ( (p = memchr(p, '\0', next - p)) != NULL )
+		    ++p;
+	    }
+	    if ( p == NULL )
+		break;
+	}
+	if ( k < HISTORY_INDEX_STRINGS )
+	{
+	    for (c = 0; c <= k && c < HISTORY_INDEX_STRINGS; ++c)
+		free(entry->strings[c]);
+	    break;
+	}
+	++index->count;
+	index->valid_len = next - index->text;
+    }
+    if ( index->count > 0 )
+	qsort(index->entries, index->count, sizeof(*index->entries),
+	      history_entry_cmp);
+}
+
+
+static void history_free_index(history_index_t *index)
+
+{
+    size_t  c, k;
+
+    for (c = 0; c < index->count; ++c)
+	for (k = 0; k < HISTORY_INDEX_STRINGS; ++k)
+	    free(index->entries[c].strings[k]);
+    free(index->entries);
+    free(index->text);
+}
+
+
+static history_index_entry_t *history_index_find(history_index_t *index,
+						 const char *name)
+
+{
+    history_index_entry_t   key = { .name = name };
+
+    if ( index->count == 0 )
+	return NULL;
+    return bsearch(&key, index->entries, index->count,
+		   sizeof(*index->entries), history_entry_cmp);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Read and decode one column of an archive segment
+ *
+ *  Returns:
+ *      0 on success, -1 if the column is unreadable or corrupt
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static int  history_load_column(int fd, const unsigned char *header,
+				unsigned column, history_column_t *loaded)
+
+{
+    const unsigned char *entry = header + LPJS_HISTORY_HEADER_LEN +
+				 column * LPJS_HISTORY_DIR_ENTRY_LEN;
+    uint32_t            count = history_get_u32(header + 8),
+			offset = history_get_u32(entry),
+			stored_len = history_get_u32(entry + 4),
+			raw_len = history_get_u32(entry + 8);
+    unsigned char       *stored, *raw;
+    const unsigned char *p, *end;
+    uint64_t            value, dict_count, len;
+    int64_t             previous = 0;
+    size_t              c;
+    char                *text;
+    int                 status = -1;
+
+    memset(loaded, 0, sizeof(*loaded));
+    if ( ((stored = malloc(stored_len + 1)) == NULL) ||
+	 ((raw = malloc(raw_len + 1)) == NULL) )
+    {
+	lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
+	exit(EX_UNAVAILABLE);
+    }
+    if ( (pread(fd, stored, stored_len, offset) != (ssize_t)stored_len) ||
+	 ((stored_len != raw_len) &&
+	  (lz_decompress(stored, stored_len, raw, raw_len) != (ssize_t)raw_len)) )
+    {
+	free(stored);
+	free(raw);
+	return -1;
+    }
+    if ( stored_len == raw_len )
+	memcpy(raw, stored, raw_len);
+    free(stored);
+    p = raw;
+    end = raw + raw_len;
+
+    if ( (column != LPJS_HISTORY_NODE) && (column != LPJS_HISTORY_USER) &&
+	 (column != LPJS_HISTORY_SCRIPT) )
+    {
+	if ( (loaded->values = malloc((count + 1) * sizeof(*loaded->values))) == NULL )
+	{
+	    lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
+	    exit(EX_UNAVAILABLE);
+	}
+	for (c = 0; c < count; ++c)
+	{
+	    if ( history_get_varint(&p, end, &value) != 0 )
+		goto done;
+	    loaded->values[c] = history_unzigzag(value);
+	    if ( history_delta_column(column) )
+		previous = loaded->values[c] += previous;
+	}
+	status = 0;
+	goto done;
+    }
+
+    // Dictionary strings, each followed by '\0' instead of a length
+    if ( (history_get_varint(&p, end, &dict_count) != 0) ||
+	 (dict_count > raw_len) )
+	goto done;
+    loaded->string_count = dict_count;
+    loaded->strings = malloc((dict_count + 1) * sizeof(*loaded->strings));
+    loaded->indexes = malloc((count + 1) * sizeof(*loaded->indexes));
+    loaded->text = text = malloc(raw_len + dict_count + 1);
+    if ( (loaded->strings == NULL) || (loaded->indexes == NULL) ||
+	 (loaded->text == NULL) )
+    {
+	lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
+	exit(EX_UNAVAILABLE);
+    }
+    for (c = 0; c < dict_count; ++c)
+    {
+	if ( (history_get_varint(&p, end, &len) != 0) ||
+	     (len > (uint64_t)(end - p)) )
+	    goto done;
+	loaded->strings[c] = text;
+	memcpy(text, p, len);
+	text[len] = '\0';
+	text += len + 1;
+	p += len;
+    }
+    for (c = 0; c < count; ++c)
+    {
+	if ( (history_get_varint(&p, end, &value) != 0) ||
+	     (value >= dict_count) )
+	    goto done;
+	loaded->indexes[c] = value;
+    }
+    status = 0;
+
+done:
+    free(raw);
+    return status;
+}
+
+
+static void history_free_column(history_column_t *loaded)
+
+{
+    free(loaded->values);
+    free(loaded->strings);
+    free(loaded->indexes);
+    free(loaded->text);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Open an archive segment and read its header and column directory
+ *
+ *  Returns:
+ *      File descriptor, or -1 if the segment is unreadable, which is
+ *      reported
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static int  history_open_segment(const char *path, unsigned char *header,
+				 size_t header_size)
+
+{
+    ssize_t bytes;
+    int     fd;
+
+    if ( (fd = open(path, O_RDONLY)) == -1 )
+    {
+	lpjs_log("%s(): Error: Cannot open %s: %s\n", __FUNCTION__,
+		 path, strerror(errno));
+	return -1;
+    }
+
+    // Older segments have fewer columns
+    bytes = read(fd, header, header_size);
+    if ( (bytes < LPJS_HISTORY_HEADER_LEN) ||
+	 (memcmp(header, LPJS_HISTORY_MAGIC, 4) != 0) ||
+	 (header[4] != LPJS_HISTORY_VERSION) ||
+	 (header[5] > LPJS_HISTORY_COLUMNS) ||
+	 (bytes < LPJS_HISTORY_HEADER_LEN +
+		  header[5] * LPJS_HISTORY_DIR_ENTRY_LEN) )
+    {
+	lpjs_log("%s(): Error: %s is not a history segment.\n",
+		 __FUNCTION__, path);
+	close(fd);
+	return -1;
+    }
+    return fd;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Check whether a value of a string column is among the distinct
+ *      values listed for a segment
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static bool history_has_string(const char **strings, size_t count,
+			       const char *string)
+
+{
+    size_t  c;
+
+    for (c = 0; c < count; ++c)
+	if ( strcmp(strings[c], string) == 0 )
+	    return true;
+    return false;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Get the string a query requires in a column, or NULL if any
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static const char   *history_query_string(const history_query_t *query,
+					  unsigned column)
+
+{
+    switch(column)
+    {
+	case LPJS_HISTORY_USER:
+	    return query->user;
+	case LPJS_HISTORY_NODE:
+	    return query->node;
+	case LPJS_HISTORY_SCRIPT:
+	    return query->script;
+    }
+    return NULL;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Check whether an index entry rules out any match in its segment
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static bool history_entry_excludes(const history_index_entry_t *entry,
+				   const history_query_t *query)
+
+{
+    const char  *string;
+    size_t      k;
+
+    if ( (entry->max_time < query->since) || (entry->min_time > query->until) )
+	return true;
+    for (k = 0; k < HISTORY_INDEX_STRINGS; ++k)
+    {
+	string = history_query_string(query, History_index_columns[k]);
+	if ( (string != NULL) &&
+	     ! history_has_string(entry->strings[k], entry->string_counts[k],
+				  string) )
+	    return true;
+    }
+    return false;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Visit the records of an archive segment that match query.
+ *      Only the columns used by the filters are loaded at first,
+ *      and the rest only if some record matches.
+ *
+ *  Returns:
+ *      The nonzero return value of visit, or 0.  An unreadable
+ *      segment is reported and skipped, so one damaged file does not
+ *      hide the rest of the history.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Filter by query, load filter columns first
+ ***************************************************************************/
+
+static int  history_scan_segment(const char *path,
+				 const history_query_t *query,
+				 history_visit_t visit, void *arg)
+
+{
+    unsigned char       header[LPJS_HISTORY_HEADER_LEN +
+			       LPJS_HISTORY_COLUMNS * LPJS_HISTORY_DIR_ENTRY_LEN];
+    history_column_t    loaded[LPJS_HISTORY_COLUMNS];
+    history_record_t    record;
+    const char          *string;
+    size_t              count, c, m, match_count = 0,
+			*matches = NULL,
+			wanted[LPJS_HISTORY_COLUMNS];
+    unsigned            column, stored_columns, filter_columns,
+			loaded_columns = 0;
+    int                 fd, status = 0;
+
+    if ( (fd = history_open_segment(path, header, sizeof(header))) == -1 )
+	return 0;
+    stored_columns = header[5];
+    count = history_get_u32(header + 8);
+
+    // Skip the whole segment if its time range is outside the query
+    if ( (history_get_time(header + 20) < query->since) ||
+	 (history_get_time(header + 12) > query->until) )
+    {
+	close(fd);
+	return 0;
+    }
+
+    filter_columns = LPJS_HISTORY_COLUMN(LPJS_HISTORY_TIME);
+    if ( query->failed )
+	filter_columns |= LPJS_HISTORY_COLUMN(LPJS_HISTORY_EXIT_STATUS);
+    for (column = 0; column < LPJS_HISTORY_COLUMNS; ++column)
+	if ( history_query_string(query, column) != NULL )
+	    filter_columns |= LPJS_HISTORY_COLUMN(column);
+
+    for (column = 0; column < stored_columns; ++column)
+    {
+	if ( ! (filter_columns & LPJS_HISTORY_COLUMN(column)) )
+	    continue;
+	loaded_columns |= LPJS_HISTORY_COLUMN(column);
+	if ( (status = history_load_column(fd, header, column,
+					   &loaded[column])) != 0 )
+	    goto corrupt;
+
+	// Compare dictionary indexes rather than strings for each record
+	if ( (string = history_query_string(query, column)) != NULL )
+	{
+	    for (c = 0; (c < loaded[column].string_count) &&
+			(strcmp(loaded[column].strings[c], string) != 0); ++c)
+		;
+	    if ( c == loaded[column].string_count )
+		goto done;
+	    wanted[column] = c;
+	}
+    }
+
+    if ( (matches = malloc((count + 1) * sizeof(*matches))) == NULL )
+    {
+	lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
+	exit(EX_UNAVAILABLE);
+    }
+    for (c = 0; c < count; ++c)
+    {
+	if ( (loaded[LPJS_HISTORY_TIME].values[c] < query->since) ||
+	     (loaded[LPJS_HISTORY_TIME].values[c] > query->until) ||
+	     (query->failed &&
+	      (loaded[LPJS_HISTORY_EXIT_STATUS].values[c] == 0)) )
+	    continue;
+	for (column = LPJS_HISTORY_NODE; column <= LPJS_HISTORY_SCRIPT; ++column)
+	    if ( (history_query_string(query, column) != NULL) &&
+		 (loaded[column].indexes[c] != wanted[column]) )
+		break;
+	if ( column > LPJS_HISTORY_SCRIPT )
+	    matches[match_count++] = c;
+    }
+    if ( match_count == 0 )
+	goto done;
+
+    for (column = 0; column < stored_columns; ++column)
+    {
+	if ( (query->columns & LPJS_HISTORY_COLUMN(column)) &&
+	     ! (loaded_columns & LPJS_HISTORY_COLUMN(column)) )
+	{
+	    loaded_columns |= LPJS_HISTORY_COLUMN(column);
+	    if ( (status = history_load_column(fd, header, column,
+					       &loaded[column])) != 0 )
+		goto corrupt;
+	}
+    }
+
+    for (m = 0; (m < match_count) && (status == 0); ++m)
+    {
+	c = matches[m];
+	memset(&record, 0, sizeof(record));
+	// Requested, but not in a segment written by an older version
+	if ( query->columns & LPJS_HISTORY_COLUMN(LPJS_HISTORY_RUN_TIME) )
+	    record.run_time = -1;
+	for (column = 0; column < stored_columns; ++column)
+	{
+	    if ( ! (loaded_columns & LPJS_HISTORY_COLUMN(column)) )
+		continue;
+	    if ( loaded[column].values != NULL )
+		history_set_number(&record, column, loaded[column].values[c]);
+	    else
+		*history_string(&record, column) =
+		    loaded[column].strings[loaded[column].indexes[c]];
+	}
+	status = visit(&record, arg);
+    }
+    goto done;
+
+corrupt:
+    lpjs_log("%s(): Error: %s is corrupt.\n", __FUNCTION__, path);
+    status = 0;
+
+done:
+    close(fd);
+    free(matches);
+    for (column = 0; column < stored_columns; ++column)
+	if ( loaded_columns & LPJS_HISTORY_COLUMN(column) )
+	    history_free_column(&loaded[column]);
+    return status;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Check whether a record from a hot segment matches query
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static bool history_record_matches(history_record_t *record,
+				   const history_query_t *query)
+
+{
+    const char  *string;
+    unsigned    column;
+
+    if ( (record->time < query->since) || (record->time > query->until) ||
+	 (query->failed && (record->exit_status == 0)) )
+	return false;
+    for (column = LPJS_HISTORY_NODE; column <= LPJS_HISTORY_SCRIPT; ++column)
+	if ( ((string = history_query_string(query, column)) != NULL) &&
+	     (strcmp(*history_string(record, column), string) != 0) )
+	    return false;
+    return true;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Visit the records of a hot segment that match query
+ *
+ *  Returns:
+ *      The nonzero return value of visit, or 0
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Filter by query
+ ***************************************************************************/
+
+static int  history_scan_hot(const char *path, const history_query_t *query,
+			     history_visit_t visit, void *arg)
+
+{
+    history_hot_t   hot;
+    size_t          c;
+    int             status = 0;
+
+    if ( history_load_hot(path, &hot) != 0 )
+    {
+	lpjs_log("%s(): Error: Cannot read %s: %s\n", __FUNCTION__,
+		 path, strerror(errno));
+	history_free_hot(&hot);
+	return 0;
+    }
+    for (c = 0; (c < hot.count) && (status == 0); ++c)
+	if ( history_record_matches(&hot.records[c], query) )
+	    status = visit(&hot.records[c], arg);
+    history_free_hot(&hot);
+    return status;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Initialize a query matching all records and reading all columns
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    lpjs_history_query_init(history_query_t *query)
+
+{
+    query->columns = LPJS_HISTORY_ALL_COLUMNS;
+    query->since = LPJS_HISTORY_TIME_MIN;
+    query->until = LPJS_HISTORY_TIME_MAX;
+    query->user = query->node = query->script = NULL;
+    query->failed = false;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Call visit() for each history record matching query, oldest
+ *      first.  Segments ruled out by the index are not opened.
+ *
+ *  Returns:
+ *      0 on success, -1 if LPJS_HISTORY_DIR is unreadable, or the
+ *      nonzero return value of visit
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Take a query, use the index
+ ***************************************************************************/
+
+int     lpjs_history_scan(const history_query_t *query,
+			  history_visit_t visit, void *arg)
+
+{
+    history_index_t         index;
+    history_index_entry_t   *entry;
+    char                    **names, path[PATH_MAX + 1];
+    size_t                  count, c;
+    int                     status = 0;
+
+    if ( (names = history_list_segments(&count)) == NULL )
+	return errno == ENOENT ? 0 : -1;
+    history_load_index(&index);
+
+    for (c = 0; (c < count) && (status == 0); ++c)
+    {
+	entry = history_index_find(&index, names[c]);
+	if ( (entry != NULL) && history_entry_excludes(entry, query) )
+	    continue;
+	snprintf(path, sizeof(path), "%s/%s", LPJS_HISTORY_DIR, names[c]);
+	status = history_scan_segment(path, query, visit, arg);
+    }
+    history_free_index(&index);
+    history_free_names(names, count);
+
+    if ( status == 0 )
+	status = history_scan_hot(LPJS_HISTORY_SEALING, query, visit, arg);
+    if ( status == 0 )
+	status = history_scan_hot(LPJS_HISTORY_HOT, query, visit, arg);
+    return status;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Index the archive segments missing from LPJS_HISTORY_INDEX,
+ *      such as those written by history --import or by a dispatchd
+ *      that crashed before indexing
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static void history_reindex(void)
+
+{
+    history_index_t     index;
+    history_column_t    loaded[HISTORY_INDEX_STRINGS];
+    unsigned char       header[LPJS_HISTORY_HEADER_LEN +
+			       LPJS_HISTORY_COLUMNS * LPJS_HISTORY_DIR_ENTRY_LEN];
+    const char          **strings[HISTORY_INDEX_STRINGS];
+    size_t              string_counts[HISTORY_INDEX_STRINGS];
+    char                **names, path[PATH_MAX + 1];
+    size_t              count, c, k;
+    int                 fd, status;
+
+    if ( (names = history_list_segments(&count)) == NULL )
+	return;
+    history_load_index(&index);
+
+    // Drop a damaged tail, so that entries appended below are readable
+    if ( (index.valid_len < index.len) &&
+	 (truncate(LPJS_HISTORY_INDEX, index.valid_len) != 0) )
+	lpjs_log("%s(): Error: Cannot truncate %s: %s\n", __FUNCTION__,
+		 LPJS_HISTORY_INDEX, strerror(errno));
+
+    for (c = 0; c < count; ++c)
+    {
+	if ( history_index_find(&index, names[c]) != NULL )
+	    continue;
+	snprintf(path, sizeof(path), "%s/%s", LPJS_HISTORY_DIR, names[c]);
+	if ( (fd = history_open_segment(path, header, sizeof(header))) == -1 )
+	    continue;
+	for (k = 0, status = 0; k < HISTORY_INDEX_STRINGS; ++k)
+	{
+	    if ( status == 0 )
+		status = history_load_column(fd, header,
+					     History_index_columns[k],
+					     &loaded[k]);
+	    else
+		memset(&loaded[k], 0, sizeof(loaded[k]));
+	    strings[k] = (const char **)loaded[k].strings;
+	    string_counts[k] = loaded[k].string_count;
+	}
+	close(fd);
+	if ( status == 0 )
+	{
+	    history_index_append(names[c], history_get_time(header + 12),
+				 history_get_time(header + 20),
+				 strings, string_counts);
+	    lpjs_log("%s(): Indexed %s.\n", __FUNCTION__, names[c]);
+	}
+	else
+	    lpjs_log("%s(): Error: %s is corrupt.\n", __FUNCTION__, path);
+	for (k = 0; k < HISTORY_INDEX_STRINGS; ++k)
+	    history_free_column(&loaded[k]);
+    }
+    history_free_index(&index);
+    history_free_names(names, count);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Open the hot segment for appending, first archiving a segment
+ *      left sealing by a crash and indexing unindexed segments.
+ *      Called by dispatchd at startup.
+ *
+ *  Returns:
+ *      0 on success, -1 on failure
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Index segments
+ ***************************************************************************/
+
+int     lpjs_history_open(void)
+
+{
+    char    buff[65536], *p;
+    ssize_t bytes;
+
+    if ( access(LPJS_HISTORY_SEALING, F_OK) == 0 )
+	history_archive_sealing();
+    history_reindex();
+
+    if ( (Hot_fd = open(LPJS_HISTORY_HOT, O_RDWR|O_APPEND|O_CREAT, 0644)) == -1 )
+    {
+	lpjs_log("%s(): Error: Cannot open %s: %s\n", __FUNCTION__,
+		 LPJS_HISTORY_HOT, strerror(errno));
+	return -1;
+    }
+
+    // Count records to know when to seal
+    Hot_records = 0;
+    while ( (bytes = read(Hot_fd, buff, sizeof(buff))) > 0 )
+	for (p = buff; (p = memchr(p, '\n', buff + bytes - p)) != NULL; ++p)
+	    ++Hot_records;
+    return 0;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Move the hot segment aside, start a new one, and archive the
+ *      old one
+ *
+ *  Returns:
+ *      0 on success, -1 on failure
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Index imported segments too
+ ***************************************************************************/
+
+static int  history_seal(void)
+
+{
+    int     fd;
+
+    // Retry an archive that failed earlier, rather than overwrite it
+    if ( (access(LPJS_HISTORY_SEALING, F_OK) == 0) &&
+	 (history_archive_sealing() != 0) )
+	return -1;
+
+    if ( rename(LPJS_HISTORY_HOT, LPJS_HISTORY_SEALING) != 0 )
+    {
+	lpjs_log("%s(): Error: Cannot rename %s: %s\n", __FUNCTION__,
+		 LPJS_HISTORY_HOT, strerror(errno));
+	return -1;
+    }
+    if ( (fd = open(LPJS_HISTORY_HOT, O_RDWR|O_APPEND|O_CREAT, 0644)) == -1 )
+    {
+	lpjs_log("%s(): Error: Cannot create %s: %s\n", __FUNCTION__,
+		 LPJS_HISTORY_HOT, strerror(errno));
+	rename(LPJS_HISTORY_SEALING, LPJS_HISTORY_HOT);
+	return -1;
+    }
+    close(Hot_fd);
+    Hot_fd = fd;
+    Hot_records = 0;
+    if ( history_archive_sealing() != 0 )
+	return -1;
+    history_reindex();
+    return 0;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Replace tabs and newlines in a field of the hot segment
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static void history_sanitize(char *start)
+
+{
+    for (; *start != '\0'; ++start)
+	if ( (*start == '\t') || (*start == '\n') )
+	    *start = ' ';
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Append a record to the hot segment, archiving it when full
+ *
+ *  Returns:
+ *      0 on success, -1 on failure
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Add run time
+ ***************************************************************************/
+
+int     lpjs_history_append(const history_record_t *record)
+
+{
+    lpjs_buff_t *line;
+    const char  *strings[] = { record->node, record->user, record->script };
+    size_t      start, c;
+    int         status = 0;
+
+    if ( Hot_fd == -1 )
+	return -1;
+
+    line = lpjs_buff_get(LPJS_BUFF_INITIAL_SIZE);
+    lpjs_buff_printf(line, "%lld\t%lu\t%d\t%zu\t%zu\t%u\t%u\t",
+		     (long long)record->time, record->job_id,
+		     record->exit_status, record->peak_rss, record->pmem_mib,
+		     record->processors, record->threads);
+    for (c = 0; c < 3; ++c)
+    {
+	start = line->len;
+	lpjs_buff_printf(line, "%s", strings[c]);
+	history_sanitize(line->data + start);
+	lpjs_buff_append(line, "\t", 1);
+    }
+    lpjs_buff_printf(line, "%lld\n", (long long)record->run_time);
+
+    // One write() with O_APPEND, so a crash can only cut the last line
+    if ( write(Hot_fd, line->data, line->len) != (ssize_t)line->len )
+    {
+	lpjs_log("%s(): Error: Cannot write %s: %s\n", __FUNCTION__,
+		 LPJS_HISTORY_HOT, strerror(errno));
+	status = -1;
+    }
+    lpjs_buff_put(&line);
+
+    if ( (status == 0) && (++Hot_records >= LPJS_HISTORY_HOT_RECORDS) )
+	history_seal();
+    return status;
+}
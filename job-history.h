@@ -0,0 +1,130 @@
+#ifndef _LPJS_JOB_HISTORY_H_
+#define _LPJS_JOB_HISTORY_H_
+
+#include <stddef.h>     // size_t
+#include <stdint.h>     // uint32_t
+#include <time.h>       // time_t
+
+#ifndef true
+#include <stdbool.h>
+#endif
+
+/*
+ *  The job history is a directory of segments.  Completed jobs are
+ *  appended as tab-separated lines to the hot segment, one write()
+ *  each.  When it reaches LPJS_HISTORY_HOT_RECORDS, it is renamed to
+ *  LPJS_HISTORY_SEALING and converted to a columnar archive segment,
+ *  named by the time and job ID of its first record, so that listing
+ *  the directory in name order gives the history in time order.  The
+ *  conversion is repeated at startup if dispatchd died during it,
+ *  producing the same file again.
+ *
+ *  An archive segment is a header, a column directory and the columns:
+ *
+ *      [magic] [version] [column count] [record count]
+ *      [min time] [max time]
+ *      [offset] [stored length] [raw length]   one per column
+ *      [column]...
+ *
+ *  Integers in the header are in network byte order.  Columns hold
+ *  one value per record as varints: zigzag-encoded deltas for times
+ *  and job IDs, which ascend, and plain values for the rest.  String
+ *  columns are a dictionary of the distinct strings followed by an
+ *  index per record.  Each column is compressed with lz_compress(),
+ *  and stored as is if it doesn't shrink (stored length == raw length).
+ *
+ *  Columns added by later versions go at the end, so older segments
+ *  simply have fewer, and read as the defaults in history_record_t.
+ *
+ *  LPJS_HISTORY_INDEX holds an entry for each archive segment, with
+ *  its time range and the distinct users, nodes and scripts in it,
+ *  appended when the segment is written:
+ *
+ *      [length] [CRC-32] [name] [min time] [max time]
+ *      [user count] [users...] [node count] [nodes...]
+ *      [script count] [scripts...]
+ *
+ *  length and CRC-32 cover the rest and are in network byte order, as
+ *  in the journal.  The rest are varints and '\0'-terminated strings.
+ *  Queries skip segments whose entry rules them out without opening
+ *  them.  Segments missing from the index, e.g. imported ones, are
+ *  scanned, and indexed when dispatchd starts or next seals the hot
+ *  segment.  Within a segment, the filter columns are loaded first,
+ *  and the rest only if some record matches.
+ */
+
+#define LPJS_HISTORY_HOT            LPJS_HISTORY_DIR "/hot"
+#define LPJS_HISTORY_SEALING        LPJS_HISTORY_DIR "/hot.sealing"
+#define LPJS_HISTORY_INDEX          LPJS_HISTORY_DIR "/index"
+#define LPJS_HISTORY_SEGMENT_SUFFIX ".seg"
+
+// Records per archive segment
+#define LPJS_HISTORY_HOT_RECORDS    65536
+
+#define LPJS_HISTORY_MAGIC          "LPJH"
+#define LPJS_HISTORY_VERSION        1
+
+// Columns, also bit numbers for lpjs_history_scan()
+#define LPJS_HISTORY_TIME           0
+#define LPJS_HISTORY_JOB_ID         1
+#define LPJS_HISTORY_EXIT_STATUS    2
+#define LPJS_HISTORY_PEAK_RSS       3
+#define LPJS_HISTORY_PMEM           4
+#define LPJS_HISTORY_PROCESSORS     5
+#define LPJS_HISTORY_THREADS        6
+#define LPJS_HISTORY_NODE           7
+#define LPJS_HISTORY_USER           8
+#define LPJS_HISTORY_SCRIPT         9
+#define LPJS_HISTORY_RUN_TIME       10
+#define LPJS_HISTORY_COLUMNS        11
+
+// Time range of lpjs_history_scan() covering all records
+#define LPJS_HISTORY_TIME_MIN       ((time_t)0)
+#define LPJS_HISTORY_TIME_MAX       ((time_t)(sizeof(time_t) == 8 ? \
+					     INT64_MAX : INT32_MAX))
+
+#define LPJS_HISTORY_COLUMN(c)      (1u << (c))
+#define LPJS_HISTORY_ALL_COLUMNS    ((1u << LPJS_HISTORY_COLUMNS) - 1)
+
+// Magic, version, column count, record count, min and max time
+#define LPJS_HISTORY_HEADER_LEN     28
+// Offset, stored and raw length of each column
+#define LPJS_HISTORY_DIR_ENTRY_LEN  12
+
+typedef struct
+{
+    time_t          time;           // Completion
+    unsigned long   job_id;
+    int             exit_status;
+    size_t          peak_rss;       // KiB
+    size_t          pmem_mib;       // Requested per processor
+    unsigned        processors;     // Per job
+    unsigned        threads;        // Per process
+    const char      *node;
+    const char      *user;
+    const char      *script;        // Submit directory/script name
+    time_t          run_time;       // Seconds, -1 if unknown
+}   history_record_t;
+
+// Records to visit, see lpjs_history_query_init() for defaults
+typedef struct
+{
+    unsigned        columns;        // LPJS_HISTORY_COLUMN() bits to read
+    time_t          since,          // Completion time range
+		    until;
+    const char      *user,          // NULL matches any
+		    *node,
+		    *script;
+    bool            failed;         // Only nonzero exit status
+}   history_query_t;
+
+/*
+ *  Called by lpjs_history_scan() for each matching record.  Columns
+ *  not requested are 0 or NULL.  Strings are valid only during the call.
+ *  Returns 0 to continue, anything else to stop the scan.
+ */
+typedef int (*history_visit_t)(const history_record_t *record, void *arg);
+
+#include "job-history-protos.h"
+
+#endif  // _LPJS_JOB_HISTORY_H_
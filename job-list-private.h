@@ -6,11 +6,14 @@ extern "C" {
 #endif
 
 #include "job-list.h"
+#include "job-stats.h"
 
 struct job_list
 {
-    size_t  count;
-    job_t   *jobs[JOB_LIST_MAX_JOBS];
+    size_t      count;
+    job_t       *jobs[JOB_LIST_MAX_JOBS];
+    // Updated on add, remove, and job_list_set_job_state(), if not NULL
+    job_stats_t *stats;
 };
 
 #ifdef  __cplusplus
@@ -10,6 +10,7 @@
 #include "job-list-private.h"
 #include "lpjs.h"
 #include "misc.h"           // lpjs_log()
+#include "network.h"        // LPJS_MSG_SENT
 
 
 /***************************************************************************
@@ -54,6 +55,64 @@ void    job_list_init(job_list_t *job_list)
 
 {
     job_list->count = 0;
+    job_list->stats = NULL;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Link a job_stats_t object to the list, so that its totals track
+ *      the jobs in the list.  Several lists may share the same object,
+ *      e.g. pending and running jobs.  Jobs already in the list are
+ *      counted immediately.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    job_list_set_stats(job_list_t *job_list, job_stats_t *stats)
+
+{
+    size_t  c;
+    
+    if ( job_list->stats != NULL )
+	for (c = 0; c < job_list->count; ++c)
+	    job_stats_remove_job(job_list->stats, job_list->jobs[c]);
+    job_list->stats = stats;
+    if ( stats != NULL )
+	for (c = 0; c < job_list->count; ++c)
+	    job_stats_add_job(stats, job_list->jobs[c]);
+}
+
+
+job_stats_t *job_list_get_stats(job_list_t *job_list)
+
+{
+    return job_list->stats;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Change the state of a job in the list, keeping the list's job
+ *      stats up to date.  Use this instead of job_set_state() for any
+ *      job in a list.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    job_list_set_job_state(job_list_t *job_list, job_t *job,
+			       job_state_t state)
+
+{
+    if ( job_list->stats != NULL )
+	job_stats_remove_job(job_list->stats, job);
+    job_set_state(job, state);
+    if ( job_list->stats != NULL )
+	job_stats_add_job(job_list->stats, job);
 }
 
 
@@ -61,40 +120,91 @@ void    job_list_init(job_list_t *job_list)
  *  Description:
  *      Add a job to the queue
  *
+ *      The list is kept sorted by job id at all times, so listings
+ *      never need to sort and lookups can use a binary search.
+ *      Job ids are assigned in increasing order, so new submissions
+ *      are simply appended.  Jobs arriving out of order, e.g. a pending
+ *      job moving to the running list, are inserted in place.
+ *
  *  History: 
  *  Date        Name        Modification
  *  2021-09-28  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Keep list ordered by job id
  ***************************************************************************/
 
 int     job_list_add_job(job_list_t *job_list, job_t *job)
 
 {
-    if ( job_list->count < JOB_LIST_MAX_JOBS )
+    size_t          index;
+    unsigned long   job_id = job_get_job_id(job);
+    
+    if ( job_list->count == JOB_LIST_MAX_JOBS )
     {
-	job_list->jobs[job_list->count++] = job;
-	//lpjs_debug("%s(): Added job id %lu, new count = %u\n", __FUNCTION__,
-	//        job_get_job_id(job), job_list->count);
-    }
-    else
 	lpjs_log("%s(): Error: Maximum job count = %u reached.\n",
 		 __FUNCTION__, JOB_LIST_MAX_JOBS);
+	return 0;   // NL_OK?
+    }
+    
+    if ( (job_list->count == 0) ||
+	 (job_get_job_id(job_list->jobs[job_list->count - 1]) < job_id) )
+	index = job_list->count;
+    else
+    {
+	index = job_list_lower_bound(job_list, job_id);
+	memmove(job_list->jobs + index + 1, job_list->jobs + index,
+		(job_list->count - index) * sizeof(*job_list->jobs));
+    }
+    job_list->jobs[index] = job;
+    ++job_list->count;
+    if ( job_list->stats != NULL )
+	job_stats_add_job(job_list->stats, job);
+    //lpjs_debug("%s(): Added job id %lu, new count = %u\n", __FUNCTION__,
+    //        job_get_job_id(job), job_list->count);
     
     return 0;   // NL_OK?
 }
 
 
-size_t  job_list_find_job_id(job_list_t *job_list, unsigned long job_id)
+/***************************************************************************
+ *  Description:
+ *      Binary search for the first job in the list with an id
+ *      >= job_id.
+ *
+ *  Returns:
+ *      The index of that job, or the job count if there is none
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+size_t  job_list_lower_bound(job_list_t *job_list, unsigned long job_id)
 
 {
-    size_t  c;
+    size_t  low = 0,
+	    high = job_list->count,
+	    mid;
     
-    // FIXME: Use bsearch(), even though this array will never be very large
-    // Must then keep list sorted by job_id
-    for (c = 0; c < job_list->count; ++c)
+    while ( low < high )
     {
-	if ( job_get_job_id(job_list->jobs[c]) == job_id )
-	    return c;
+	mid = low + (high - low) / 2;
+	if ( job_get_job_id(job_list->jobs[mid]) < job_id )
+	    low = mid + 1;
+	else
+	    high = mid;
     }
+    return low;
+}
+
+
+size_t  job_list_find_job_id(job_list_t *job_list, unsigned long job_id)
+
+{
+    size_t  c;
+    
+    c = job_list_lower_bound(job_list, job_id);
+    if ( (c < job_list->count) && (job_get_job_id(job_list->jobs[c]) == job_id) )
+	return c;
     
     return JOB_LIST_NOT_FOUND;
 }
@@ -114,12 +224,13 @@ job_t   *job_list_remove_job(job_list_t *job_list, unsigned long job_id)
     // lpjs_debug("%s(): Removing job %lu from list\n", __FUNCTION__, job_id);
     job = job_list->jobs[job_array_index];
     job_print_full_specs(job, Log_stream);
+    if ( job_list->stats != NULL )
+	job_stats_remove_job(job_list->stats, job);
     
-    for (int c = job_array_index; c < job_list->count - 1; ++c)
-    {
-	fflush(Log_stream);
-	job_list->jobs[c] = job_list->jobs[c + 1];
-    }
+    // Close the gap, preserving order
+    memmove(job_list->jobs + job_array_index,
+	    job_list->jobs + job_array_index + 1,
+	    (job_list->count - job_array_index - 1) * sizeof(*job_list->jobs));
     --job_list->count;
 
     return job;
@@ -128,36 +239,31 @@ job_t   *job_list_remove_job(job_list_t *job_list, unsigned long job_id)
 
 /***************************************************************************
  *  Description:
- *      Send current jobs to msg_fd in human-readable format
+ *      Append current jobs to a streamed response in human-readable
+ *      format.  Frames are pipelined, so send errors may not be
+ *      reported until a later frame or lpjs_stream_finish().
+ *
+ *  Returns:
+ *      LPJS_MSG_SENT on success, another LPJS_* code if msg_fd has failed
  *
  *  History: 
  *  Date        Name        Modification
  *  2021-09-28  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Pipeline, stop at first failure
+ *  2026-10-19  Jason Bacon Append to a stream
  ***************************************************************************/
 
-void    job_list_send_params(int msg_fd, job_list_t *job_list)
+int     job_list_send_params(lpjs_stream_t *stream, job_list_t *job_list)
 
 {
     unsigned    c;
+    int         status;
 
-    job_send_basic_params_header(msg_fd);
+    if ( (status = job_send_basic_params_header(stream)) != LPJS_MSG_SENT )
+	return status;
     for (c = 0; c < job_list->count; ++c)
-	job_send_basic_params(job_list->jobs[c], msg_fd);
-}
-
-
-/***************************************************************************
- *  Description:
- *      Sort job list numerically by job id
- *
- *  History: 
- *  Date        Name        Modification
- *  2024-05-08  Jason Bacon Begin
- ***************************************************************************/
-
-void    job_list_sort(job_list_t *job_list)
-
-{
-    qsort(job_list->jobs, job_list->count, sizeof(job_t *),
-	    (int(*)(const void *, const void *))job_id_cmp);
+	if ( (status = job_send_basic_params(job_list->jobs[c], stream))
+		!= LPJS_MSG_SENT )
+	    return status;
+    return LPJS_MSG_SENT;
 }
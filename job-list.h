@@ -12,6 +12,8 @@
 
 typedef struct job_list job_list_t;
 
+#include "job-stats.h"
+
 #include "job-list-rvs.h"
 #include "job-list-accessors.h"
 #include "job-list-mutators.h"
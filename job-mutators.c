@@ -482,6 +482,50 @@ int     job_set_state(job_t *job_ptr, job_state_t new_state)
 }
 
 
+/***************************************************************************
+ *  Library:
+ *      #include <job.h>
+ *      
+ *
+ *  Description:
+ *      Mutator for start_time member in a job_t structure.
+ *      Use this function to set start_time in a job_t object
+ *      from non-member functions.  This function performs a direct
+ *      assignment for scalar or pointer structure members.
+ *
+ *  Arguments:
+ *      job_ptr         Pointer to the structure to set
+ *      new_start_time  The new value for start_time
+ *
+ *  Returns:
+ *      JOB_DATA_OK if the new value is acceptable and assigned
+ *      JOB_DATA_OUT_OF_RANGE otherwise
+ *
+ *  Examples:
+ *      job_t           job;
+ *
+ *      if ( job_set_start_time(&job, time(NULL)) == JOB_DATA_OK )
+ *      {
+ *      }
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     job_set_start_time(job_t *job_ptr, time_t new_start_time)
+
+{
+    if ( new_start_time < 0 )
+	return JOB_DATA_OUT_OF_RANGE;
+    else
+    {
+	job_ptr->start_time = new_start_time;
+	return JOB_DATA_OK;
+    }
+}
+
+
 /***************************************************************************
  *  Library:
  *      #include <job.h>
@@ -23,6 +23,7 @@ int job_set_phys_mib_per_processor(job_t *job_ptr, size_t new_phys_mib_per_proce
 int job_set_chaperone_pid(job_t *job_ptr, pid_t new_chaperone_pid);
 int job_set_job_pid(job_t *job_ptr, pid_t new_job_pid);
 int job_set_state(job_t *job_ptr, job_state_t new_state);
+int job_set_start_time(job_t *job_ptr, time_t new_start_time);
 int job_set_user_name(job_t *job_ptr, char *new_user_name);
 int job_set_user_name_ae(job_t *job_ptr, size_t c, char new_user_name_element);
 int job_set_user_name_cpy(job_t *job_ptr, char *new_user_name, size_t array_size);
@@ -28,6 +28,7 @@ struct job
     pid_t           chaperone_pid;
     pid_t           job_pid;
     job_state_t     state;
+    time_t          start_time;     // 0 until the job is running
     char            *user_name;
     char            *primary_group_name;
     char            *submit_node;
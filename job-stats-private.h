@@ -0,0 +1,32 @@
+#ifndef _LPJS_JOB_STATS_PRIVATE_H_
+#define _LPJS_JOB_STATS_PRIVATE_H_
+
+#include "job-stats.h"
+
+// Totals for one user or group name
+typedef struct
+{
+    char            *name;      // NULL if slot is empty
+    job_totals_t    by_state[JOB_STATE_COUNT];
+}   job_stats_entry_t;
+
+/*
+ *  Open addressing hash table keyed by name.  Entries are never
+ *  removed, since the set of users on a cluster is small and stable.
+ */
+
+typedef struct
+{
+    size_t              count;
+    size_t              array_size;     // Power of 2
+    job_stats_entry_t   *entries;
+}   job_stats_table_t;
+
+struct job_stats
+{
+    job_totals_t        by_state[JOB_STATE_COUNT];
+    job_stats_table_t   users;
+    job_stats_table_t   groups;
+};
+
+#endif  // _LPJS_JOB_STATS_PRIVATE_H_
@@ -0,0 +1,10 @@
+/* job-stats.c */
+job_stats_t *job_stats_new(void);
+void job_stats_init(job_stats_t *stats);
+void job_stats_free(job_stats_t **stats);
+void job_stats_add_job(job_stats_t *stats, job_t *job);
+void job_stats_remove_job(job_stats_t *stats, job_t *job);
+void job_stats_get_state(job_stats_t *stats, job_state_t state, job_totals_t *totals);
+void job_stats_get_user(job_stats_t *stats, const char *user_name, job_state_t state, job_totals_t *totals);
+void job_stats_get_group(job_stats_t *stats, const char *group_name, job_state_t state, job_totals_t *totals);
+void job_stats_send_summary(int msg_fd, job_stats_t *stats);
@@ -0,0 +1,416 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sysexits.h>
+#include <stdbool.h>
+
+#include "job-stats-private.h"
+#include "network.h"
+#include "stream.h"
+#include "cleaner.h"
+#include "lpjs.h"
+#include "misc.h"           // lpjs_log()
+
+static void job_stats_table_init(job_stats_table_t *table);
+static void job_stats_table_free(job_stats_table_t *table);
+static job_stats_entry_t *job_stats_table_find(job_stats_table_t *table,
+					      const char *name, bool add);
+static void job_stats_adjust(job_stats_t *stats, job_t *job, int sign);
+static void job_stats_totals_adjust(job_totals_t *totals, job_t *job,
+				    int sign);
+static int  job_stats_send_table(lpjs_stream_t *stream, const char *scope,
+				 job_stats_table_t *table);
+
+/***************************************************************************
+ *  Description:
+ *      Create a new job_stats_t object.  Job counts, processors, and
+ *      memory are tracked for the whole cluster and for each user and
+ *      group, broken down by job state.  Totals are updated as jobs
+ *      are added to, removed from, or change state within job lists
+ *      linked to the object by job_list_set_stats(), so queries never
+ *      need to walk the lists.
+ *
+ *  Returns:
+ *      Pointer to the new object.  Terminates the process if malloc()
+ *      fails, so no check is required.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+job_stats_t *job_stats_new(void)
+
+{
+    job_stats_t *stats;
+    
+    if ( (stats = malloc(sizeof(*stats))) == NULL )
+    {
+	lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
+	exit(EX_UNAVAILABLE);
+    }
+    job_stats_init(stats);
+    return stats;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Constructor for job_stats_t
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    job_stats_init(job_stats_t *stats)
+
+{
+    memset(stats->by_state, 0, sizeof(stats->by_state));
+    job_stats_table_init(&stats->users);
+    job_stats_table_init(&stats->groups);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Destructor for job_stats_t
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    job_stats_free(job_stats_t **stats)
+
+{
+    if ( *stats == NULL )
+	return;
+    job_stats_table_free(&(*stats)->users);
+    job_stats_table_free(&(*stats)->groups);
+    free(*stats);
+    *stats = NULL;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Count a job under its current state, or stop counting it.
+ *      The job's user, group, and resource requirements must not
+ *      change while it is counted.  To change its state, remove it,
+ *      set the new state, and add it again.  job_list_set_job_state()
+ *      does this.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    job_stats_add_job(job_stats_t *stats, job_t *job)
+
+{
+    job_stats_adjust(stats, job, 1);
+}
+
+
+void    job_stats_remove_job(job_stats_t *stats, job_t *job)
+
+{
+    job_stats_adjust(stats, job, -1);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Get totals for all jobs in a given state, cluster-wide or for
+ *      one user or group.  Totals are zero for unknown users and groups.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    job_stats_get_state(job_stats_t *stats, job_state_t state,
+			    job_totals_t *totals)
+
+{
+    if ( state >= JOB_STATE_COUNT )
+	memset(totals, 0, sizeof(*totals));
+    else
+	*totals = stats->by_state[state];
+}
+
+
+void    job_stats_get_user(job_stats_t *stats, const char *user_name,
+			   job_state_t state, job_totals_t *totals)
+
+{
+    job_stats_entry_t   *entry;
+    
+    entry = job_stats_table_find(&stats->users, user_name, false);
+    if ( (entry == NULL) || (state >= JOB_STATE_COUNT) )
+	memset(totals, 0, sizeof(*totals));
+    else
+	*totals = entry->by_state[state];
+}
+
+
+void    job_stats_get_group(job_stats_t *stats, const char *group_name,
+			    job_state_t state, job_totals_t *totals)
+
+{
+    job_stats_entry_t   *entry;
+    
+    entry = job_stats_table_find(&stats->groups, group_name, false);
+    if ( (entry == NULL) || (state >= JOB_STATE_COUNT) )
+	memset(totals, 0, sizeof(*totals));
+    else
+	*totals = entry->by_state[state];
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Send a summary of job totals to msg_fd in human-readable format,
+ *      followed by EOT.  Only states with jobs are listed.  Spool
+ *      cleanup counts follow if dispatchd has cleaned any.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Use lpjs_stream_t instead of local buffering
+ *  2026-10-19  Jason Bacon Add spool cleanup counts
+ ***************************************************************************/
+
+void    job_stats_send_summary(int msg_fd, job_stats_t *stats)
+
+{
+    lpjs_stream_t   stream;
+    job_state_t     state;
+    job_totals_t    *totals;
+    unsigned long   removed,
+		    failed;
+    
+    lpjs_stream_init(&stream, msg_fd, lpjs_dispatchd_safe_close);
+    lpjs_stream_printf(&stream, JOB_STATS_SUMMARY_HEADER_FORMAT,
+		       "Scope", "Name", "State", "Jobs", "Procs", "MiB");
+    
+    for (state = 0; state < JOB_STATE_COUNT; ++state)
+    {
+	totals = &stats->by_state[state];
+	lpjs_stream_printf(&stream, JOB_STATS_SUMMARY_FORMAT,
+			   "cluster", "-", job_state_name(state),
+			   totals->jobs, totals->processors, totals->MiB);
+    }
+    
+    job_stats_send_table(&stream, "user", &stats->users);
+    job_stats_send_table(&stream, "group", &stats->groups);
+    
+    lpjs_cleaner_get_stats(&removed, &failed);
+    if ( removed + failed + lpjs_cleaner_queued() > 0 )
+	lpjs_stream_printf(&stream,
+			   "\nSpool cleanup: %lu removed, %lu failed, %zu queued\n",
+			   removed, failed, lpjs_cleaner_queued());
+    
+    if ( lpjs_stream_finish(&stream, true) != LPJS_MSG_SENT )
+	lpjs_log("%s(): Error: Failed to send job summary.\n", __FUNCTION__);
+}
+
+
+static void job_stats_table_init(job_stats_table_t *table)
+
+{
+    table->count = 0;
+    table->array_size = 0;
+    table->entries = NULL;
+}
+
+
+static void job_stats_table_free(job_stats_table_t *table)
+
+{
+    size_t  c;
+    
+    for (c = 0; c < table->array_size; ++c)
+	free(table->entries[c].name);
+    free(table->entries);
+    job_stats_table_init(table);
+}
+
+
+/*
+ *  FNV-1a: Fast and good enough for short user and group names
+ */
+
+static size_t  job_stats_hash(const char *name)
+
+{
+    uint32_t    hash = 2166136261u;
+    
+    while ( *name != '\0' )
+    {
+	hash ^= (unsigned char)*name++;
+	hash *= 16777619u;
+    }
+    return hash;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Find the entry for name, optionally adding it if not present.
+ *      The table is doubled when it becomes 3/4 full.
+ *
+ *  Returns:
+ *      Pointer to the entry, or NULL if not found and add is false
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static job_stats_entry_t *job_stats_table_find(job_stats_table_t *table,
+					      const char *name, bool add)
+
+{
+    size_t              c, mask, old_size;
+    job_stats_entry_t   *entry, *old_entries;
+    
+    if ( table->array_size == 0 )
+    {
+	if ( ! add )
+	    return NULL;
+	table->array_size = JOB_STATS_INITIAL_SIZE;
+	table->entries = calloc(table->array_size, sizeof(*table->entries));
+	if ( table->entries == NULL )
+	{
+	    lpjs_log("%s(): Error: calloc() failed.\n", __FUNCTION__);
+	    exit(EX_UNAVAILABLE);
+	}
+    }
+    
+    mask = table->array_size - 1;
+    for (c = job_stats_hash(name) & mask; table->entries[c].name != NULL;
+	 c = (c + 1) & mask)
+    {
+	if ( strcmp(table->entries[c].name, name) == 0 )
+	    return &table->entries[c];
+    }
+    
+    if ( ! add )
+	return NULL;
+    
+    if ( (table->count + 1) * 4 > table->array_size * 3 )
+    {
+	// Rehash into a table twice the size, then look again
+	old_entries = table->entries;
+	old_size = table->array_size;
+	table->array_size *= 2;
+	table->entries = calloc(table->array_size, sizeof(*table->entries));
+	if ( table->entries == NULL )
+	{
+	    lpjs_log("%s(): Error: calloc() failed.\n", __FUNCTION__);
+	    exit(EX_UNAVAILABLE);
+	}
+	mask = table->array_size - 1;
+	for (c = 0; c < old_size; ++c)
+	{
+	    size_t  slot;
+	    
+	    if ( old_entries[c].name == NULL )
+		continue;
+	    for (slot = job_stats_hash(old_entries[c].name) & mask;
+		 table->entries[slot].name != NULL; slot = (slot + 1) & mask)
+		;
+	    table->entries[slot] = old_entries[c];
+	}
+	free(old_entries);
+	for (c = job_stats_hash(name) & mask; table->entries[c].name != NULL;
+	     c = (c + 1) & mask)
+	    ;
+    }
+    
+    entry = &table->entries[c];
+    if ( (entry->name = strdup(name)) == NULL )
+    {
+	lpjs_log("%s(): Error: strdup() failed.\n", __FUNCTION__);
+	exit(EX_UNAVAILABLE);
+    }
+    memset(entry->by_state, 0, sizeof(entry->by_state));
+    ++table->count;
+    return entry;
+}
+
+
+static void job_stats_adjust(job_stats_t *stats, job_t *job, int sign)
+
+{
+    job_state_t         state = job_get_state(job);
+    job_stats_entry_t   *entry;
+    
+    if ( state >= JOB_STATE_COUNT )
+    {
+	lpjs_log("%s(): Bug: Job %lu has invalid state %u.\n", __FUNCTION__,
+		 job_get_job_id(job), state);
+	return;
+    }
+    
+    job_stats_totals_adjust(&stats->by_state[state], job, sign);
+    entry = job_stats_table_find(&stats->users, job_get_user_name(job), true);
+    job_stats_totals_adjust(&entry->by_state[state], job, sign);
+    entry = job_stats_table_find(&stats->groups,
+				 job_get_primary_group_name(job), true);
+    job_stats_totals_adjust(&entry->by_state[state], job, sign);
+}
+
+
+static void job_stats_totals_adjust(job_totals_t *totals, job_t *job,
+				    int sign)
+
+{
+    unsigned long   processors = job_get_processors_per_job(job);
+    uint64_t        MiB = (uint64_t)processors *
+			  job_get_phys_mib_per_processor(job);
+    
+    if ( sign > 0 )
+    {
+	++totals->jobs;
+	totals->processors += processors;
+	totals->MiB += MiB;
+    }
+    else
+    {
+	--totals->jobs;
+	totals->processors -= processors;
+	totals->MiB -= MiB;
+    }
+}
+
+
+static int  job_stats_send_table(lpjs_stream_t *stream, const char *scope,
+				 job_stats_table_t *table)
+
+{
+    size_t              c;
+    job_state_t         state;
+    job_stats_entry_t   *entry;
+    
+    for (c = 0; c < table->array_size; ++c)
+    {
+	entry = &table->entries[c];
+	if ( entry->name == NULL )
+	    continue;
+	for (state = 0; state < JOB_STATE_COUNT; ++state)
+	{
+	    if ( entry->by_state[state].jobs == 0 )
+		continue;
+	    if ( lpjs_stream_printf(stream, JOB_STATS_SUMMARY_FORMAT,
+				    scope, entry->name, job_state_name(state),
+				    entry->by_state[state].jobs,
+				    entry->by_state[state].processors,
+				    entry->by_state[state].MiB) != LPJS_MSG_SENT )
+		return LPJS_SEND_FAILED;
+	}
+    }
+    return LPJS_MSG_SENT;
+}
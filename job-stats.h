@@ -0,0 +1,28 @@
+#ifndef _LPJS_JOB_STATS_H_
+#define _LPJS_JOB_STATS_H_
+
+#ifndef _LPJS_JOB_H_
+#include "job.h"
+#endif
+
+#include <inttypes.h>     // PRIu64
+
+typedef struct job_stats job_stats_t;
+
+// Aggregate resources of a set of jobs
+typedef struct
+{
+    unsigned long   jobs;
+    unsigned long   processors;
+    uint64_t        MiB;
+}   job_totals_t;
+
+// Initial size of user and group tables.  Must be a power of 2.
+#define JOB_STATS_INITIAL_SIZE  64
+
+#define JOB_STATS_SUMMARY_HEADER_FORMAT "%-8s %-20s %-10s %8s %8s %12s\n"
+#define JOB_STATS_SUMMARY_FORMAT        "%-8s %-20s %-10s %8lu %8lu %12" PRIu64 "\n"
+
+#include "job-stats-protos.h"
+
+#endif  // _LPJS_JOB_STATS_H_
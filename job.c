@@ -7,6 +7,7 @@
 #include <limits.h>     // PATH_MAX
 #include <errno.h>
 #include <fcntl.h>      // open()
+#include <stddef.h>     // offsetof()
 
 #include <xtend/dsv.h>
 #include <xtend/file.h>
@@ -19,6 +20,38 @@
 #include "misc.h"
 #include "realpath-protos.h"
 
+// Indexed by job_state_t
+static char *Job_state_names[JOB_STATE_COUNT] =
+{
+    "pending", "dispatched", "canceled", "running"
+};
+
+/*
+ *  String members sent by job_write_to_wire().  Fields with no
+ *  default must be present in every message.
+ */
+static const struct
+{
+    unsigned    tag;
+    size_t      offset;
+    const char  *default_value;
+}   Job_wire_strings[] =
+{
+    { WIRE_TAG_JOB_USER_NAME, offsetof(job_t, user_name), NULL },
+    { WIRE_TAG_JOB_GROUP_NAME, offsetof(job_t, primary_group_name), NULL },
+    { WIRE_TAG_JOB_SUBMIT_NODE, offsetof(job_t, submit_node), NULL },
+    { WIRE_TAG_JOB_SUBMIT_DIR, offsetof(job_t, submit_dir), NULL },
+    { WIRE_TAG_JOB_SCRIPT_NAME, offsetof(job_t, script_name), NULL },
+    { WIRE_TAG_JOB_COMPUTE_NODE, offsetof(job_t, compute_node), "TBD" },
+    { WIRE_TAG_JOB_LOG_DIR, offsetof(job_t, log_dir), NULL },
+    { WIRE_TAG_JOB_CMD_SEARCH_PATH, offsetof(job_t, cmd_search_path), JOB_NO_PATH },
+    { WIRE_TAG_JOB_PULL_COMMAND, offsetof(job_t, pull_command), JOB_NO_PULL_CMD },
+    { WIRE_TAG_JOB_PUSH_COMMAND, offsetof(job_t, push_command), JOB_NO_PUSH_CMD }
+};
+#define JOB_WIRE_STRINGS    (sizeof(Job_wire_strings) / sizeof(*Job_wire_strings))
+#define JOB_WIRE_MEMBER(job, c) \
+    ((char **)((char *)(job) + Job_wire_strings[c].offset))
+
 /***************************************************************************
  *  Description:
  *  
@@ -67,6 +100,7 @@ void    job_init(job_t *job)
     job->chaperone_pid = 0;
     job->job_pid = 0;
     job->state = JOB_STATE_PENDING;
+    job->start_time = 0;
     job->user_name = NULL;
     job->primary_group_name = NULL;
     job->submit_node = NULL;
@@ -192,33 +226,29 @@ int     job_print_to_string(job_t *job, char *str, size_t buff_size)
 
 /***************************************************************************
  *  Description:
- *      Send job parameters to msg_fd, e.g. in response to lpjs-jobs request
+ *      Append job parameters to a streamed response, e.g. to the
+ *      lpjs jobs command
+ *
+ *  Returns:
+ *      LPJS_MSG_SENT on success, another LPJS_* code if the stream has failed
  *
  *  History: 
  *  Date        Name        Modification
  *  2021-09-28  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Pipeline, return status instead of exiting
+ *  2026-10-19  Jason Bacon Append to a stream instead of one message per job
  ***************************************************************************/
 
-void    job_send_basic_params(job_t *job, int msg_fd)
+int     job_send_basic_params(job_t *job, lpjs_stream_t *stream)
 
 {
-    char    msg[LPJS_MSG_LEN_MAX + 1];
-    
-    snprintf(msg, LPJS_MSG_LEN_MAX + 1, JOB_BASIC_PARAMS_FORMAT,
+    return lpjs_stream_printf(stream, JOB_BASIC_PARAMS_FORMAT,
 	    job->job_id, job->array_index,
 	    job->job_count, job->processors_per_job,
 	    job->threads_per_process, job->phys_mib_per_processor,
 	    job->user_name,
 	    job->script_name,
 	    job->compute_node);
-    
-    // FIXME: Combine into one message
-    // Used by dispatchd to send to lpjs jobs command
-    if ( lpjs_send_munge(msg_fd, msg, lpjs_dispatchd_safe_close) != LPJS_MSG_SENT )
-    {
-	lpjs_log("%s(): Error: Send failed.\n", __FUNCTION__);
-	exit(EX_IOERR);
-    }
 }
 
 
@@ -466,10 +496,18 @@ int     job_parse_script(job_t *job, const char *script_name)
  *      -l
  *
  *  Description:
+ *      Populate a job_t object from a JOB_SPEC_FORMAT string, as
+ *      written by job_print_to_string().  Used for spool files and
+ *      for messages from peers that predate the binary format.
  *  
  *  Arguments:
+ *      job     Job object initialized by job_new()
+ *      string  Text in JOB_SPEC_FORMAT
+ *      end     Set to the first character following the specs
  *
  *  Returns:
+ *      Number of fields read (JOB_SPECS_ITEMS), or -1 if the string
+ *      is malformed
  *
  *  Examples:
  *
@@ -478,26 +516,54 @@ int     job_parse_script(job_t *job, const char *script_name)
  *  Environment
  *
  *  See also:
+ *      job_read_from_wire(3)
  *
  *  History: 
  *  Date        Name        Modification
  *  2024-01-31  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Return -1 on malformed input instead of exiting
  ***************************************************************************/
 
 int     job_read_from_string(job_t *job, const char *string, char **end)
 
 {
+    // Pull and push may contain whitespace and are terminated
+    // by NL, must be last
+    static const char   *delims[JOB_SPEC_STRING_FIELDS] =
+    {
+	" \t", " \t", " \t", " \t", " \t\n",
+	" \t\n", " \t\n", " \t\n", "\n", "\n"
+    };
+    char        **fields[JOB_SPEC_STRING_FIELDS] =
+    {
+	&job->user_name, &job->primary_group_name, &job->submit_node,
+	&job->submit_dir, &job->script_name, &job->compute_node,
+	&job->log_dir, &job->cmd_search_path,
+	&job->pull_command, &job->push_command
+    };
     int         items,
-		tokens;
+		tokens,
+		c;
     const char  *start;
     char        *temp,
-		*p;
+		*p,
+		*field;
+    
+    // Don't leave defaults from job_init() for job_free() to free
+    for (c = 0; c < JOB_SPEC_STRING_FIELDS; ++c)
+	*fields[c] = NULL;
     
     items = sscanf(string, JOB_SPEC_NUMS_FORMAT,
 	    &job->job_id, &job->array_index,
 	    &job->job_count, &job->processors_per_job,
 	    &job->threads_per_process, &job->phys_mib_per_processor,
 	    &job->chaperone_pid, &job->job_pid, &job->state);
+    if ( items != JOB_SPEC_NUMERIC_FIELDS )
+    {
+	lpjs_log("%s(): Error: Malformed numeric fields in job spec string: %s\n",
+		 __FUNCTION__, string);
+	return -1;
+    }
     
     // Skips past numeric fields
     for (start = string, tokens = 0;
@@ -512,7 +578,7 @@ int     job_read_from_string(job_t *job, const char *string, char **end)
     if ( *start == '\0' )
     {
 	lpjs_log("%s(): Error: Malformed job spec string: %s\n", __FUNCTION__, string);
-	exit(EX_DATAERR);
+	return -1;
     }
     
     // Duplicate string fields
@@ -525,80 +591,28 @@ int     job_read_from_string(job_t *job, const char *string, char **end)
     }
     p = temp;
     
-    if ( (job->user_name = strdup(strsep(&p, " \t"))) == NULL )
-    {
-	lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
-	exit(EX_UNAVAILABLE);
-    }
-    ++items;
-    
-    if ( (job->primary_group_name = strdup(strsep(&p, " \t"))) == NULL )
-    {
-	lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
-	exit(EX_UNAVAILABLE);
-    }
-    ++items;
-    
-    if ( (job->submit_node = strdup(strsep(&p, " \t"))) == NULL )
+    for (c = 0; c < JOB_SPEC_STRING_FIELDS; ++c)
     {
-	lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
-	exit(EX_UNAVAILABLE);
-    }
-    ++items;
-    
-    if ( (job->submit_dir = strdup(strsep(&p, " \t"))) == NULL )
-    {
-	lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
-	exit(EX_UNAVAILABLE);
-    }
-    ++items;
-    
-    if ( (job->script_name = strdup(strsep(&p, " \t\n"))) == NULL )
-    {
-	lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
-	exit(EX_UNAVAILABLE);
-    }
-    ++items;
-    
-    if ( (job->compute_node = strdup(strsep(&p, " \t\n"))) == NULL )
-    {
-	lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
-	exit(EX_UNAVAILABLE);
-    }
-    ++items;
-    
-    if ( (job->log_dir = strdup(strsep(&p, " \t\n"))) == NULL )
-    {
-	lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
-	exit(EX_UNAVAILABLE);
-    }
-    ++items;
-    
-    if ( (job->cmd_search_path = strdup(strsep(&p, " \t\n"))) == NULL )
-    {
-	lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
-	exit(EX_UNAVAILABLE);
-    }
-    ++items;
-    
-    // Pull and push may contain whitespace and are terminated
-    // by NL, must be last
-    if ( (job->pull_command = strdup(strsep(&p, "\n"))) == NULL )
-    {
-	lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
-	exit(EX_UNAVAILABLE);
-    }
-    ++items;
-    
-    if ( (job->push_command = strdup(strsep(&p, "\n"))) == NULL )
-    {
-	lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
-	exit(EX_UNAVAILABLE);
+	if ( (field = strsep(&p, delims[c])) == NULL )
+	{
+	    lpjs_log("%s(): Error: Job spec string has %d of %d string fields.\n",
+		     __FUNCTION__, c, JOB_SPEC_STRING_FIELDS);
+	    free(temp);
+	    return -1;
+	}
+	if ( (*fields[c] = strdup(field)) == NULL )
+	{
+	    lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
+	    exit(EX_UNAVAILABLE);
+	}
+	++items;
     }
-    ++items;
     
     // Same offset into original string as we are into temp copy
-    *end = (char *)start + (p - temp);
+    if ( p == NULL )
+	*end = (char *)start + strlen(start);
+    else
+	*end = (char *)start + (p - temp);
     free(temp);
     
     return items;
@@ -666,6 +680,174 @@ int     job_read_from_file(job_t *job, const char *path)
 }
 
 
+/***************************************************************************
+ *  Description:
+ *      Append job parameters to a binary message.  See wire.h.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    job_write_to_wire(job_t *job, wire_writer_t *writer)
+
+{
+    size_t  c;
+
+    wire_put_uint(writer, WIRE_TAG_JOB_ID, job->job_id);
+    wire_put_uint(writer, WIRE_TAG_JOB_ARRAY_INDEX, job->array_index);
+    wire_put_uint(writer, WIRE_TAG_JOB_COUNT, job->job_count);
+    wire_put_uint(writer, WIRE_TAG_JOB_PROCESSORS, job->processors_per_job);
+    wire_put_uint(writer, WIRE_TAG_JOB_THREADS, job->threads_per_process);
+    wire_put_uint(writer, WIRE_TAG_JOB_PHYS_MIB, job->phys_mib_per_processor);
+    wire_put_uint(writer, WIRE_TAG_JOB_CHAPERONE_PID, job->chaperone_pid);
+    wire_put_uint(writer, WIRE_TAG_JOB_PID, job->job_pid);
+    wire_put_uint(writer, WIRE_TAG_JOB_STATE, job->state);
+    // Omitted until running, so dispatch messages don't grow
+    if ( job->start_time != 0 )
+	wire_put_uint(writer, WIRE_TAG_JOB_START_TIME, job->start_time);
+    for (c = 0; c < JOB_WIRE_STRINGS; ++c)
+	wire_put_str(writer, Job_wire_strings[c].tag, *JOB_WIRE_MEMBER(job, c));
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Populate a job_t object from a binary message body, as written
+ *      by job_write_to_wire().  Numeric fields are decoded directly
+ *      from the buffer.  Strings are validated in place and copied
+ *      once into the job, which owns them.  Fields with other tags,
+ *      such as the script, are skipped.
+ *
+ *  Arguments:
+ *      job     Job object initialized by job_new()
+ *      buff    Message body, starting with WIRE_MAGIC
+ *      len     Length of the message body
+ *
+ *  Returns:
+ *      0 on success, -1 if the message is malformed or incompatible
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     job_read_from_wire(job_t *job, const void *buff, size_t len)
+
+{
+    wire_reader_t   reader;
+    wire_field_t    field;
+    uint64_t        val;
+    const char      *strings[JOB_WIRE_STRINGS] = { NULL };
+    size_t          c;
+    int             status;
+
+    // Don't leave defaults from job_init() for job_free() to free
+    for (c = 0; c < JOB_WIRE_STRINGS; ++c)
+	*JOB_WIRE_MEMBER(job, c) = NULL;
+
+    if ( (status = wire_reader_init(&reader, buff, len)) != WIRE_OK )
+    {
+	lpjs_log("%s(): Error: Bad message header, status %d.\n",
+		 __FUNCTION__, status);
+	return -1;
+    }
+
+    while ( (status = wire_next_field(&reader, &field)) == WIRE_OK )
+    {
+	switch(field.tag)
+	{
+	    case    WIRE_TAG_JOB_ID:
+		status = wire_get_uint(&field, &val);
+		job->job_id = val;
+		break;
+	    case    WIRE_TAG_JOB_ARRAY_INDEX:
+		status = wire_get_uint(&field, &val);
+		job->array_index = val;
+		break;
+	    case    WIRE_TAG_JOB_COUNT:
+		status = wire_get_uint(&field, &val);
+		job->job_count = val;
+		break;
+	    case    WIRE_TAG_JOB_PROCESSORS:
+		status = wire_get_uint(&field, &val);
+		job->processors_per_job = val;
+		break;
+	    case    WIRE_TAG_JOB_THREADS:
+		status = wire_get_uint(&field, &val);
+		job->threads_per_process = val;
+		break;
+	    case    WIRE_TAG_JOB_PHYS_MIB:
+		status = wire_get_uint(&field, &val);
+		job->phys_mib_per_processor = val;
+		break;
+	    case    WIRE_TAG_JOB_CHAPERONE_PID:
+		status = wire_get_uint(&field, &val);
+		job->chaperone_pid = val;
+		break;
+	    case    WIRE_TAG_JOB_PID:
+		status = wire_get_uint(&field, &val);
+		job->job_pid = val;
+		break;
+	    case    WIRE_TAG_JOB_STATE:
+		if ( ((status = wire_get_uint(&field, &val)) == WIRE_OK) &&
+		     (val >= JOB_STATE_COUNT) )
+		    status = WIRE_MALFORMED;
+		job->state = val;
+		break;
+	    case    WIRE_TAG_JOB_START_TIME:
+		status = wire_get_uint(&field, &val);
+		job->start_time = val;
+		break;
+	    default:
+		for (c = 0; c < JOB_WIRE_STRINGS; ++c)
+		    if ( Job_wire_strings[c].tag == field.tag )
+			break;
+		if ( c < JOB_WIRE_STRINGS )
+		{
+		    if ( (strings[c] = wire_get_str(&field)) == NULL )
+			status = WIRE_MALFORMED;
+		}
+		else if ( field.tag & WIRE_TAG_CRITICAL )
+		    status = WIRE_UNKNOWN_CRITICAL;
+	}
+	if ( status != WIRE_OK )
+	{
+	    lpjs_log("%s(): Error: Bad field, tag 0x%04x, status %d.\n",
+		     __FUNCTION__, field.tag, status);
+	    return -1;
+	}
+    }
+    if ( status != WIRE_END )
+    {
+	lpjs_log("%s(): Error: Truncated message.\n", __FUNCTION__);
+	return -1;
+    }
+
+    for (c = 0; c < JOB_WIRE_STRINGS; ++c)
+    {
+	if ( strings[c] == NULL )
+	    strings[c] = Job_wire_strings[c].default_value;
+	if ( strings[c] == NULL )
+	{
+	    lpjs_log("%s(): Error: Missing required field, tag 0x%04x.\n",
+		     __FUNCTION__, Job_wire_strings[c].tag);
+	    return -1;
+	}
+    }
+    for (c = 0; c < JOB_WIRE_STRINGS; ++c)
+    {
+	if ( (*JOB_WIRE_MEMBER(job, c) = strdup(strings[c])) == NULL )
+	{
+	    lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
+	    exit(EX_UNAVAILABLE);
+	}
+    }
+
+    return 0;
+}
+
+
 /***************************************************************************
  *  Description:
  *
@@ -706,19 +888,22 @@ void    job_free(job_t **job)
 
 /***************************************************************************
  *  Description:
+ *      Send the column headers for job_send_basic_params()
  *  
  *  Returns:
+ *      LPJS_MSG_SENT on success, another LPJS_* code if msg_fd has failed
  *
  *  History: 
  *  Date        Name        Modification
  *  2024-02-01  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Pipeline, return status
+ *  2026-10-19  Jason Bacon Append to a stream
  ***************************************************************************/
 
-void    job_send_basic_params_header(int msg_fd)
+int     job_send_basic_params_header(lpjs_stream_t *stream)
 
 {
-    // FIXME: Combine into one message
-    lpjs_send_munge(msg_fd, JOB_BASIC_PARAMS_HEADER, lpjs_dispatchd_safe_close);
+    return lpjs_stream_printf(stream, "%s", JOB_BASIC_PARAMS_HEADER);
 }
 
 
@@ -811,5 +996,28 @@ void    job_setenv(job_t *job)
 int     job_id_cmp(job_t **job1, job_t **job2)
 
 {
-    return (*job1)->job_id - (*job2)->job_id;
+    // Subtracting unsigned longs would overflow int
+    return ((*job1)->job_id > (*job2)->job_id) -
+	   ((*job1)->job_id < (*job2)->job_id);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Convert job_state_t to the name used in summaries
+ *
+ *  Returns:
+ *      Name of state, or "invalid"
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+char    *job_state_name(job_state_t state)
+
+{
+    if ( state >= JOB_STATE_COUNT )
+	return "invalid";
+    return Job_state_names[state];
 }
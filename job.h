@@ -37,7 +37,8 @@ typedef enum
     JOB_STATE_PENDING = 0,
     JOB_STATE_DISPATCHED,
     JOB_STATE_CANCELED,
-    JOB_STATE_RUNNING
+    JOB_STATE_RUNNING,
+    JOB_STATE_COUNT     // Number of valid states, not a state
 }   job_state_t;
 
 typedef struct job  job_t;
@@ -50,6 +51,10 @@ typedef struct job  job_t;
 #include <unistd.h>
 #endif
 
+#include <time.h>   // time_t
+
+#include "wire.h"
+#include "stream.h"
 #include "job-rvs.h"
 #include "job-accessors.h"
 #include "job-mutators.h"
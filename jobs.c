@@ -6,6 +6,7 @@
  *  History: 
  *  Date        Name        Modification
  *  2021-09-27  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Advertise compression
  ***************************************************************************/
 
 #include <stdio.h>
@@ -13,6 +14,7 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <sysexits.h>
+#include <stdbool.h>
 
 #include "node-list.h"
 #include "config.h"
@@ -27,10 +29,14 @@ int     main(int argc,char *argv[])
     node_list_t *node_list = node_list_new();
     extern FILE *Log_stream;
     char        outgoing_msg[LPJS_MSG_LEN_MAX + 1];
+    bool        summary = false;
+    size_t      msg_len;
     
-    if (argc != 1)
+    if ( (argc == 2) && (strcmp(argv[1], "summary") == 0) )
+	summary = true;
+    else if (argc != 1)
     {
-	fprintf (stderr, "Usage: %s\n", argv[0]);
+	fprintf (stderr, "Usage: %s [summary]\n", argv[0]);
 	return EX_USAGE;
     }
 
@@ -46,9 +52,12 @@ int     main(int argc,char *argv[])
 	return EX_IOERR;
     }
 
-    outgoing_msg[0] = LPJS_DISPATCHD_REQUEST_JOB_LIST;
-    outgoing_msg[1] = '\0';
-    if ( lpjs_send_munge(msg_fd, outgoing_msg, close) != LPJS_MSG_SENT )
+    // Advertises compression, since job lists can be large
+    msg_len = lpjs_list_request(outgoing_msg, LPJS_MSG_LEN_MAX + 1,
+				summary ? LPJS_DISPATCHD_REQUEST_JOB_SUMMARY :
+				LPJS_DISPATCHD_REQUEST_JOB_LIST);
+    if ( lpjs_send_munge_bin(msg_fd, outgoing_msg, msg_len, close)
+	    != LPJS_MSG_SENT )
     {
 	perror("lpjs-jobs: Failed to send message to dispatch");
 	close(msg_fd);
@@ -56,7 +65,8 @@ int     main(int argc,char *argv[])
     }
 
     lpjs_print_response(msg_fd, "lpjs-jobs");
-    puts("\nJ/S = jobs/submission  P/J = processors/job\nT/P = threads/process  MiB/P = mibibytes/processor\n");
+    if ( ! summary )
+	puts("\nJ/S = jobs/submission  P/J = processors/job\nT/P = threads/process  MiB/P = mibibytes/processor\n");
     close (msg_fd);
 
     return EX_OK;
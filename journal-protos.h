@@ -0,0 +1,20 @@
+/* journal.c */
+_Bool lpjs_journal_exists(void);
+int lpjs_journal_load(job_list_t *pending_jobs, job_list_t *running_jobs, node_list_t *node_list);
+_Bool lpjs_journal_compact_due(void);
+int lpjs_journal_compact(job_list_t *pending_jobs, job_list_t *running_jobs);
+unsigned long lpjs_journal_alloc_job_ids(unsigned long count);
+void lpjs_journal_set_next_job_id(unsigned long job_id);
+int lpjs_journal_submit(job_t *job, const char *script_text);
+void lpjs_journal_begin_group(void);
+int lpjs_journal_commit_group(void);
+void lpjs_journal_drop(unsigned long job_id);
+int lpjs_journal_dispatch(unsigned long job_id, const char *compute_node, pid_t chaperone_pid);
+int lpjs_journal_start(unsigned long job_id, const char *compute_node, pid_t chaperone_pid, pid_t job_pid, time_t start_time);
+int lpjs_journal_adopt(job_t *job);
+int lpjs_journal_cancel(unsigned long job_id);
+int lpjs_journal_complete(unsigned long job_id);
+void lpjs_journal_set_script(unsigned long job_id, const char *script_text);
+const char *lpjs_journal_get_script(unsigned long job_id, unsigned char *hash);
+void lpjs_journal_set_spool_export(_Bool export);
+_Bool lpjs_journal_spool_export(void);
@@ -0,0 +1,1633 @@
+#include <stdio.h>
+#include <stdlib.h>         // realloc(), free()
+#include <string.h>         // memcpy(), memcmp(), strerror()
+#include <errno.h>
+#include <unistd.h>         // write(), fsync(), ftruncate(), close()
+#include <fcntl.h>          // open()
+#include <sysexits.h>
+#include <limits.h>         // PATH_MAX
+#include <sys/stat.h>       // stat()
+#include <arpa/inet.h>      // htonl(), ntohl()
+
+#include <xtend/file.h>     // xt_dprintf()
+
+#include "lpjs.h"
+#include "journal.h"
+#include "wire.h"
+#include "sha256.h"
+#include "buff.h"
+#include "misc.h"           // lpjs_log()
+
+/*
+ *  Scripts of pending jobs, shared by jobs with the same content, such
+ *  as the members of a job array.  Jobs maps job IDs to Scripts and is
+ *  sorted by job ID.  dispatchd is single-threaded, so no locking is
+ *  needed.
+ */
+
+typedef struct
+{
+    unsigned char   hash[SHA256_DIGEST_LEN];
+    char            *text;      // NULL if the slot is free
+    size_t          refs;       // Pending jobs using this script
+    bool            saved;      // Already in the snapshot being written
+}   journal_script_t;
+
+typedef struct
+{
+    unsigned long   job_id;
+    size_t          script;     // Index in Scripts
+}   journal_job_t;
+
+#define JOURNAL_NOT_FOUND   ((size_t)-1)
+
+static int              Journal_fd = -1;
+static uint64_t         Generation = 0;
+static size_t           Journal_bytes = 0,
+			Snapshot_bytes = 0;
+static unsigned long    Next_job_id = 1,
+			Reserved_job_id = 1;    // IDs below are reserved
+static bool             Spool_export = false;
+// Records awaiting lpjs_journal_commit_group(), NULL if not grouping
+static lpjs_buff_t      *Group = NULL;
+
+static journal_script_t *Scripts = NULL;
+static size_t           Script_count = 0,
+			Script_slots = 0;
+static journal_job_t    *Jobs = NULL;
+static size_t           Job_count = 0,
+			Job_slots = 0;
+
+
+/***************************************************************************
+ *  Description:
+ *      Find the position of job_id in Jobs, or where it would be inserted
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static size_t   journal_job_lower_bound(unsigned long job_id)
+
+{
+    size_t  low = 0, high = Job_count, mid;
+
+    while ( low < high )
+    {
+	mid = low + (high - low) / 2;
+	if ( Jobs[mid].job_id < job_id )
+	    low = mid + 1;
+	else
+	    high = mid;
+    }
+    return low;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Find the script used by a pending job
+ *
+ *  Returns:
+ *      Index in Scripts, or JOURNAL_NOT_FOUND
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static size_t   journal_job_script(unsigned long job_id)
+
+{
+    size_t  index = journal_job_lower_bound(job_id);
+
+    if ( (index < Job_count) && (Jobs[index].job_id == job_id) )
+	return Jobs[index].script;
+    return JOURNAL_NOT_FOUND;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Find a script by hash
+ *
+ *  Returns:
+ *      Index in Scripts, or JOURNAL_NOT_FOUND
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static size_t   journal_find_script(const unsigned char *hash)
+
+{
+    size_t  c;
+
+    for (c = 0; c < Script_count; ++c)
+	if ( (Scripts[c].text != NULL) &&
+	     (memcmp(Scripts[c].hash, hash, SHA256_DIGEST_LEN) == 0) )
+	    return c;
+    return JOURNAL_NOT_FOUND;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Add a copy of a script, unless one with the same hash is held
+ *
+ *  Returns:
+ *      Index in Scripts.  Terminates the process if malloc() fails,
+ *      so no check is required.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static size_t   journal_add_script(const char *script_text,
+				   const unsigned char *hash)
+
+{
+    size_t  c;
+
+    if ( (c = journal_find_script(hash)) != JOURNAL_NOT_FOUND )
+	return c;
+
+    // Reuse a slot freed by journal_release_script()
+    for (c = 0; (c < Script_count) && (Scripts[c].text != NULL); ++c)
+	;
+    if ( c == Script_count )
+    {
+	if ( Script_count == Script_slots )
+	{
+	    Script_slots = Script_slots == 0 ? 64 : Script_slots * 2;
+	    if ( (Scripts = realloc(Scripts,
+				    Script_slots * sizeof(*Scripts))) == NULL )
+	    {
+		lpjs_log("%s(): Error: realloc() failed.\n", __FUNCTION__);
+		exit(EX_UNAVAILABLE);
+	    }
+	}
+	++Script_count;
+    }
+
+    if ( (Scripts[c].text = strdup(script_text)) == NULL )
+    {
+	lpjs_log("%s(): Error: strdup() failed.\n", __FUNCTION__);
+	exit(EX_UNAVAILABLE);
+    }
+    memcpy(Scripts[c].hash, hash, SHA256_DIGEST_LEN);
+    Scripts[c].refs = 0;
+    Scripts[c].saved = false;
+    return c;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Drop a job's reference to a script, freeing it if unused
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static void journal_release_script(size_t script)
+
+{
+    if ( --Scripts[script].refs == 0 )
+    {
+	free(Scripts[script].text);
+	Scripts[script].text = NULL;
+    }
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Record that job_id uses a script from journal_add_script()
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static void journal_link_script(unsigned long job_id, size_t script)
+
+{
+    size_t  index = journal_job_lower_bound(job_id);
+
+    ++Scripts[script].refs;
+    if ( (index < Job_count) && (Jobs[index].job_id == job_id) )
+    {
+	journal_release_script(Jobs[index].script);
+	Jobs[index].script = script;
+	return;
+    }
+
+    if ( Job_count == Job_slots )
+    {
+	Job_slots = Job_slots == 0 ? 1024 : Job_slots * 2;
+	if ( (Jobs = realloc(Jobs, Job_slots * sizeof(*Jobs))) == NULL )
+	{
+	    lpjs_log("%s(): Error: realloc() failed.\n", __FUNCTION__);
+	    exit(EX_UNAVAILABLE);
+	}
+    }
+    // Job IDs are assigned in order, so this is usually an append
+    memmove(Jobs + index + 1, Jobs + index,
+	    (Job_count - index) * sizeof(*Jobs));
+    Jobs[index].job_id = job_id;
+    Jobs[index].script = script;
+    ++Job_count;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Forget the script of a job that no longer needs it
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static void journal_unlink_script(unsigned long job_id)
+
+{
+    size_t  index = journal_job_lower_bound(job_id);
+
+    if ( (index == Job_count) || (Jobs[index].job_id != job_id) )
+	return;
+
+    journal_release_script(Jobs[index].script);
+    memmove(Jobs + index, Jobs + index + 1,
+	    (Job_count - index - 1) * sizeof(*Jobs));
+    --Job_count;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Start a record of the given type, with room for size bytes
+ *      of payload.  Add fields with writer, then pass the buffer to
+ *      journal_finish_record().
+ *
+ *  Returns:
+ *      Buffer from lpjs_buff_get()
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static lpjs_buff_t  *journal_new_record(unsigned type, size_t size,
+					wire_writer_t *writer)
+
+{
+    lpjs_buff_t *buff = lpjs_buff_get(LPJS_JOURNAL_FRAME_LEN + size);
+
+    wire_writer_init(writer, buff->data + LPJS_JOURNAL_FRAME_LEN, size);
+    wire_put_uint(writer, WIRE_TAG_JOURNAL_RECORD, type);
+    return buff;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Fill in the length and CRC of a record from journal_new_record()
+ *
+ *  Returns:
+ *      0 on success, -1 if the payload did not fit
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static int  journal_finish_record(lpjs_buff_t *buff, wire_writer_t *writer)
+
+{
+    ssize_t     len;
+    uint32_t    frame[2];
+
+    if ( (len = wire_writer_len(writer)) < 0 )
+    {
+	lpjs_log("%s(): Bug: Record exceeds buffer.\n", __FUNCTION__);
+	return -1;
+    }
+    frame[0] = htonl(len);
+    frame[1] = htonl(lpjs_crc32(writer->buff, len));
+    memcpy(buff->data, frame, LPJS_JOURNAL_FRAME_LEN);
+    buff->len = LPJS_JOURNAL_FRAME_LEN + len;
+    return 0;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Build a header record for a journal or snapshot.  It carries
+ *      the end of the reserved job IDs, so that reservations survive
+ *      compaction.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Save reserved job IDs
+ ***************************************************************************/
+
+static lpjs_buff_t  *journal_header_record(uint64_t generation,
+					   wire_writer_t *writer)
+
+{
+    lpjs_buff_t *buff = journal_new_record(LPJS_JOURNAL_HEADER, 64, writer);
+
+    wire_put_uint(writer, WIRE_TAG_JOURNAL_GENERATION, generation);
+    wire_put_uint(writer, WIRE_TAG_JOURNAL_NEXT_JOB_ID, Reserved_job_id);
+    return buff;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Build a record holding a complete job description.  script_text
+ *      is included if not NULL, otherwise hash, if not NULL.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static lpjs_buff_t  *journal_job_record(unsigned type, job_t *job,
+					const char *script_text,
+					const unsigned char *hash,
+					wire_writer_t *writer)
+
+{
+    lpjs_buff_t *buff;
+    size_t      size;
+
+    size = LPJS_JOB_MSG_SIZE(script_text == NULL ? 0 : strlen(script_text))
+	   + SHA256_DIGEST_LEN;
+    buff = journal_new_record(type, size, writer);
+    job_write_to_wire(job, writer);
+    if ( script_text != NULL )
+	wire_put_str(writer, WIRE_TAG_SCRIPT, script_text);
+    else if ( hash != NULL )
+	wire_put_bytes(writer, WIRE_TAG_SCRIPT_HASH, hash, SHA256_DIGEST_LEN);
+    return buff;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Finish a record and write it to fd in one write(), which is
+ *      a single sequential append for the journal.  A partial write,
+ *      e.g. due to a full file system, is truncated away so that later
+ *      records remain readable.  *bytes is the length of the file so
+ *      far and is updated on success.  *buff is returned to the pool.
+ *
+ *  Returns:
+ *      LPJS_SUCCESS or LPJS_WRITE_FAILED
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static int  journal_write_record(int fd, lpjs_buff_t **buff,
+				 wire_writer_t *writer, size_t *bytes)
+
+{
+    ssize_t written;
+    int     status = LPJS_SUCCESS;
+
+    if ( journal_finish_record(*buff, writer) != 0 )
+	status = LPJS_WRITE_FAILED;
+    else if ( (written = write(fd, (*buff)->data, (*buff)->len))
+		!= (ssize_t)(*buff)->len )
+    {
+	lpjs_log("%s(): Error: write() failed: %s\n", __FUNCTION__,
+		 written < 0 ? strerror(errno) : "Short write");
+	if ( (written > 0) && (ftruncate(fd, *bytes) != 0) )
+	    lpjs_log("%s(): Error: ftruncate() failed: %s\n", __FUNCTION__,
+		     strerror(errno));
+	status = LPJS_WRITE_FAILED;
+    }
+    else
+	*bytes += written;
+    lpjs_buff_put(buff);
+    return status;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Append a record to the journal, or to the open group, which
+ *      is written by lpjs_journal_commit_group()
+ *
+ *  Returns:
+ *      LPJS_SUCCESS or LPJS_WRITE_FAILED
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Support group commit
+ ***************************************************************************/
+
+static int  journal_append(lpjs_buff_t **buff, wire_writer_t *writer)
+
+{
+    int     status = LPJS_SUCCESS;
+
+    if ( Journal_fd == -1 )
+    {
+	lpjs_log("%s(): Bug: Journal is not open.\n", __FUNCTION__);
+	lpjs_buff_put(buff);
+	return LPJS_WRITE_FAILED;
+    }
+    if ( Group == NULL )
+	return journal_write_record(Journal_fd, buff, writer, &Journal_bytes);
+
+    if ( journal_finish_record(*buff, writer) != 0 )
+	status = LPJS_WRITE_FAILED;
+    else
+	lpjs_buff_append(Group, (*buff)->data, (*buff)->len);
+    lpjs_buff_put(buff);
+    return status;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Append a record about an existing job to the journal
+ *
+ *  Returns:
+ *      LPJS_SUCCESS or LPJS_WRITE_FAILED
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static int  journal_append_job_event(unsigned type, unsigned long job_id,
+				     const char *compute_node,
+				     pid_t chaperone_pid, pid_t job_pid,
+				     time_t start_time)
+
+{
+    lpjs_buff_t     *buff;
+    wire_writer_t   writer;
+
+    buff = journal_new_record(type, LPJS_HOSTNAME_MAX + 64, &writer);
+    wire_put_uint(&writer, WIRE_TAG_JOB_ID, job_id);
+    if ( compute_node != NULL )
+	wire_put_str(&writer, WIRE_TAG_JOB_COMPUTE_NODE, compute_node);
+    if ( chaperone_pid != 0 )
+	wire_put_uint(&writer, WIRE_TAG_JOB_CHAPERONE_PID, chaperone_pid);
+    if ( job_pid != 0 )
+	wire_put_uint(&writer, WIRE_TAG_JOB_PID, job_pid);
+    if ( start_time != 0 )
+	wire_put_uint(&writer, WIRE_TAG_JOB_START_TIME, start_time);
+    if ( journal_append(&buff, &writer) != LPJS_SUCCESS )
+    {
+	lpjs_log("%s(): Error: Failed to journal event %u for job %lu.\n",
+		 __FUNCTION__, type, job_id);
+	return LPJS_WRITE_FAILED;
+    }
+    return LPJS_SUCCESS;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Look up a job by ID in a job list
+ *
+ *  Returns:
+ *      The job, or NULL if not found
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static job_t    *journal_list_job(job_list_t *job_list, unsigned long job_id)
+
+{
+    size_t  index;
+
+    if ( (index = job_list_find_job_id(job_list, job_id)) == JOB_LIST_NOT_FOUND )
+	return NULL;
+    return job_list_get_jobs_ae(job_list, index);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Add a job from a SUBMIT or RUNNING record to the queue
+ *
+ *  Returns:
+ *      0 on success, -1 if the record is malformed
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static int  journal_apply_job(unsigned type, const void *payload, size_t len,
+			      const char *script_text,
+			      const unsigned char *hash,
+			      job_list_t *pending_jobs,
+			      job_list_t *running_jobs)
+
+{
+    // Terminates process if malloc() fails, no check required
+    job_t           *job = job_new();
+    unsigned long   job_id;
+    unsigned char   digest[SHA256_DIGEST_LEN];
+    size_t          script = JOURNAL_NOT_FOUND;
+
+    if ( job_read_from_wire(job, payload, len) != 0 )
+    {
+	job_free(&job);
+	return -1;
+    }
+
+    job_id = job_get_job_id(job);
+    if ( (journal_list_job(pending_jobs, job_id) != NULL) ||
+	 (journal_list_job(running_jobs, job_id) != NULL) )
+    {
+	lpjs_log("%s(): Error: Duplicate job %lu ignored.\n",
+		 __FUNCTION__, job_id);
+	job_free(&job);
+	return 0;
+    }
+    if ( job_id >= Next_job_id )
+	Next_job_id = job_id + 1;
+
+    if ( type == LPJS_JOURNAL_RUNNING )
+    {
+	job_list_add_job(running_jobs, job);
+	return 0;
+    }
+
+    if ( script_text != NULL )
+    {
+	sha256(script_text, strlen(script_text), digest);
+	script = journal_add_script(script_text, digest);
+    }
+    else if ( hash != NULL )
+	script = journal_find_script(hash);
+    if ( script == JOURNAL_NOT_FOUND )
+	lpjs_log("%s(): Error: No script for job %lu.\n", __FUNCTION__, job_id);
+    else
+	journal_link_script(job_id, script);
+    job_list_add_job(pending_jobs, job);
+    return 0;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Set the compute node of a job read from the journal, which
+ *      owns its strings
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static void journal_set_compute_node(job_t *job, const char *compute_node)
+
+{
+    char    *node_name;
+
+    if ( (node_name = strdup(compute_node)) == NULL )
+    {
+	lpjs_log("%s(): Error: strdup() failed.\n", __FUNCTION__);
+	exit(EX_UNAVAILABLE);
+    }
+    free(job_get_compute_node(job));
+    job_set_compute_node(job, node_name);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Apply one record to the in-memory queue, exactly as the
+ *      transition it records was applied when it was written
+ *
+ *  Returns:
+ *      The record type, or -1 if the record is malformed
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Restore compute node of dispatched jobs
+ ***************************************************************************/
+
+static int  journal_apply(const void *payload, size_t len,
+			  job_list_t *pending_jobs, job_list_t *running_jobs,
+			  uint64_t *generation)
+
+{
+    wire_reader_t       reader;
+    wire_field_t        field;
+    uint64_t            type = 0,
+			job_id = 0,
+			chaperone_pid = 0,
+			job_pid = 0,
+			start_time = 0,
+			next_job_id = 0;
+    const char          *compute_node = NULL,
+			*script_text = NULL;
+    const unsigned char *hash = NULL;
+    job_t               *job;
+    int                 status;
+
+    if ( wire_reader_init(&reader, payload, len) != WIRE_OK )
+	return -1;
+
+    // Job specs in SUBMIT and RUNNING records are read by job_read_from_wire()
+    while ( (status = wire_next_field(&reader, &field)) == WIRE_OK )
+    {
+	switch(field.tag)
+	{
+	    case    WIRE_TAG_JOURNAL_RECORD:
+		status = wire_get_uint(&field, &type);
+		break;
+	    case    WIRE_TAG_JOURNAL_GENERATION:
+		status = wire_get_uint(&field, generation);
+		break;
+	    case    WIRE_TAG_JOURNAL_NEXT_JOB_ID:
+		status = wire_get_uint(&field, &next_job_id);
+		break;
+	    case    WIRE_TAG_JOB_ID:
+		status = wire_get_uint(&field, &job_id);
+		break;
+	    case    WIRE_TAG_JOB_CHAPERONE_PID:
+		status = wire_get_uint(&field, &chaperone_pid);
+		break;
+	    case    WIRE_TAG_JOB_PID:
+		status = wire_get_uint(&field, &job_pid);
+		break;
+	    case    WIRE_TAG_JOB_START_TIME:
+		status = wire_get_uint(&field, &start_time);
+		break;
+	    case    WIRE_TAG_JOB_COMPUTE_NODE:
+		if ( (compute_node = wire_get_str(&field)) == NULL )
+		    status = WIRE_MALFORMED;
+		break;
+	    case    WIRE_TAG_SCRIPT:
+		if ( (script_text = wire_get_str(&field)) == NULL )
+		    status = WIRE_MALFORMED;
+		break;
+	    case    WIRE_TAG_SCRIPT_HASH:
+		if ( field.len != SHA256_DIGEST_LEN )
+		    status = WIRE_MALFORMED;
+		hash = field.value;
+		break;
+	    default:
+		break;
+	}
+	if ( status != WIRE_OK )
+	    return -1;
+    }
+    if ( status != WIRE_END )
+	return -1;
+
+    switch(type)
+    {
+	case    LPJS_JOURNAL_HEADER:
+	case    LPJS_JOURNAL_RESERVE:
+	    if ( next_job_id > Reserved_job_id )
+		Reserved_job_id = next_job_id;
+	    return type;
+
+	case    LPJS_JOURNAL_SUBMIT:
+	case    LPJS_JOURNAL_RUNNING:
+	    if ( journal_apply_job(type, payload, len, script_text, hash,
+				   pending_jobs, running_jobs) != 0 )
+		return -1;
+	    return type;
+
+	case    LPJS_JOURNAL_DISPATCH:
+	    if ( (job = journal_list_job(pending_jobs, job_id)) == NULL )
+		break;
+	    if ( compute_node != NULL )
+		journal_set_compute_node(job, compute_node);
+	    job_set_chaperone_pid(job, chaperone_pid);
+	    job_list_set_job_state(pending_jobs, job, JOB_STATE_DISPATCHED);
+	    return type;
+
+	case    LPJS_JOURNAL_START:
+	    if ( compute_node == NULL )
+		return -1;
+	    if ( (job = journal_list_job(pending_jobs, job_id)) == NULL )
+		break;
+	    journal_set_compute_node(job, compute_node);
+	    job_set_chaperone_pid(job, chaperone_pid);
+	    job_set_job_pid(job, job_pid);
+	    job_set_start_time(job, start_time);
+	    job_list_remove_job(pending_jobs, job_id);
+	    job_list_add_job(running_jobs, job);
+	    if ( job_get_state(job) == JOB_STATE_DISPATCHED )
+		job_list_set_job_state(running_jobs, job, JOB_STATE_RUNNING);
+	    journal_unlink_script(job_id);
+	    return type;
+
+	case    LPJS_JOURNAL_CANCEL:
+	    if ( (job = journal_list_job(pending_jobs, job_id)) == NULL )
+		break;
+	    job_list_set_job_state(pending_jobs, job, JOB_STATE_CANCELED);
+	    return type;
+
+	case    LPJS_JOURNAL_COMPLETE:
+	    if ( ((job = job_list_remove_job(pending_jobs, job_id)) == NULL) &&
+		 ((job = job_list_remove_job(running_jobs, job_id)) == NULL) )
+		break;
+	    job_free(&job);
+	    journal_unlink_script(job_id);
+	    return type;
+
+	default:
+	    // Written by a newer dispatchd, safe to skip
+	    lpjs_log("%s(): Warning: Skipping unknown record type %lu.\n",
+		     __FUNCTION__, (unsigned long)type);
+	    return type;
+    }
+
+    lpjs_log("%s(): Warning: Record type %lu for unknown job %lu.\n",
+	     __FUNCTION__, (unsigned long)type, (unsigned long)job_id);
+    return type;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Apply the records in a journal or snapshot to the job lists.
+ *      The file must start with a header record.  If its generation
+ *      is less than min_generation, nothing further is applied.
+ *
+ *      *generation receives the generation from the header, and
+ *      *bytes the length of the records read successfully.
+ *
+ *  Returns:
+ *      LPJS_SUCCESS if every record was read, LPJS_READ_FAILED if
+ *      the file cannot be read or a record is truncated or corrupt
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static int  journal_replay(const char *path, job_list_t *pending_jobs,
+			   job_list_t *running_jobs, uint64_t min_generation,
+			   uint64_t *generation, size_t *bytes)
+
+{
+    FILE            *fp;
+    uint32_t        frame[2];
+    size_t          len;
+    lpjs_buff_t     *payload;
+    unsigned long   records = 0;
+    int             status = LPJS_SUCCESS,
+		    type;
+
+    *generation = 0;
+    *bytes = 0;
+    if ( (fp = fopen(path, "r")) == NULL )
+    {
+	lpjs_log("%s(): Error: Cannot open %s: %s\n", __FUNCTION__,
+		 path, strerror(errno));
+	return LPJS_READ_FAILED;
+    }
+
+    payload = lpjs_buff_get(0);
+    while ( fread(frame, LPJS_JOURNAL_FRAME_LEN, 1, fp) == 1 )
+    {
+	len = ntohl(frame[0]);
+	if ( len > LPJS_JOURNAL_RECORD_MAX )
+	{
+	    status = LPJS_READ_FAILED;
+	    break;
+	}
+	lpjs_buff_reserve(payload, len);
+	if ( (fread(payload->data, 1, len, fp) != len) ||
+	     (lpjs_crc32(payload->data, len) != ntohl(frame[1])) ||
+	     ((type = journal_apply(payload->data, len, pending_jobs,
+				    running_jobs, generation)) < 0) ||
+	     ((records == 0) && (type != LPJS_JOURNAL_HEADER)) )
+	{
+	    status = LPJS_READ_FAILED;
+	    break;
+	}
+	*bytes += LPJS_JOURNAL_FRAME_LEN + len;
+	++records;
+
+	if ( *generation < min_generation )
+	{
+	    lpjs_log("%s(): %s generation %lu is already in the snapshot.\n",
+		     __FUNCTION__, path, (unsigned long)*generation);
+	    break;
+	}
+    }
+    if ( (status == LPJS_SUCCESS) && ferror(fp) )
+	status = LPJS_READ_FAILED;
+    else if ( (status == LPJS_SUCCESS) && ! feof(fp) &&
+	      (*generation >= min_generation) )
+	status = LPJS_READ_FAILED;  // Partial frame at the end
+    lpjs_buff_put(&payload);
+    fclose(fp);
+
+    lpjs_log("%s(): Replayed %lu records, %zu bytes from %s.\n",
+	     __FUNCTION__, records, *bytes, path);
+    return status;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Check whether queue state has been saved by this version of
+ *      dispatchd.  If not, jobs should be imported from the spool
+ *      directories used by earlier versions.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+bool    lpjs_journal_exists(void)
+
+{
+    struct stat st;
+
+    return (stat(LPJS_SNAPSHOT_FILE, &st) == 0) ||
+	   (stat(LPJS_JOURNAL_FILE, &st) == 0);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Allocate the node resources held by the jobs in job_list.  If
+ *      dispatched_only is true, only jobs awaiting chaperone checkin
+ *      are counted.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static void journal_allocate_resources(job_list_t *job_list,
+				       node_list_t *node_list,
+				       bool dispatched_only)
+
+{
+    size_t  c;
+    job_t   *job;
+    node_t  *node;
+
+    for (c = 0; c < job_list_get_count(job_list); ++c)
+    {
+	job = job_list_get_jobs_ae(job_list, c);
+	if ( dispatched_only && (job_get_state(job) != JOB_STATE_DISPATCHED) )
+	    continue;
+	node = node_list_find_hostname(node_list, job_get_compute_node(job));
+	if ( node == NULL )
+	    lpjs_log("%s(): Error: Job %lu is on unknown node %s.\n",
+		     __FUNCTION__, job_get_job_id(job),
+		     job_get_compute_node(job));
+	else
+	    node_adjust_resources(node, job, NODE_RESOURCE_ALLOCATE);
+    }
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Rebuild the pending and running job lists from the snapshot
+ *      and journal, and reserve resources for running and dispatched
+ *      jobs.  A torn record at the end of the journal, left by a crash
+ *      during an append, ends the replay.  The caller should then call
+ *      lpjs_journal_compact() to open a new journal.
+ *
+ *      Job IDs resume after the last reserved block, since IDs from
+ *      it may have been given out in SUBMIT records that were lost.
+ *
+ *  Returns:
+ *      LPJS_SUCCESS, or LPJS_READ_FAILED if the snapshot is unusable
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Skip the last reserved block of job IDs
+ *  2026-10-19  Jason Bacon Reserve resources for dispatched jobs
+ ***************************************************************************/
+
+int     lpjs_journal_load(job_list_t *pending_jobs, job_list_t *running_jobs,
+			  node_list_t *node_list)
+
+{
+    uint64_t    snapshot_generation = 0,
+		journal_generation = 0;
+    size_t      bytes;
+    struct stat st;
+
+    if ( stat(LPJS_SNAPSHOT_FILE, &st) == 0 )
+    {
+	// Snapshots are renamed into place complete, so this is real damage
+	if ( journal_replay(LPJS_SNAPSHOT_FILE, pending_jobs, running_jobs, 0,
+			    &snapshot_generation, &bytes) != LPJS_SUCCESS )
+	{
+	    lpjs_log("%s(): Error: %s is corrupt after byte %zu.\n",
+		     __FUNCTION__, LPJS_SNAPSHOT_FILE, bytes);
+	    return LPJS_READ_FAILED;
+	}
+	Snapshot_bytes = bytes;
+    }
+
+    if ( stat(LPJS_JOURNAL_FILE, &st) == 0 )
+    {
+	if ( journal_replay(LPJS_JOURNAL_FILE, pending_jobs, running_jobs,
+			    snapshot_generation + 1, &journal_generation,
+			    &bytes) != LPJS_SUCCESS )
+	    lpjs_log("%s(): Warning: Ignoring %s after byte %zu of %zu.\n",
+		     __FUNCTION__, LPJS_JOURNAL_FILE, bytes,
+		     (size_t)st.st_size);
+	if ( journal_generation > snapshot_generation + 1 )
+	    lpjs_log("%s(): Error: Snapshot for journal generation %lu is missing.\n",
+		     __FUNCTION__, (unsigned long)journal_generation);
+    }
+    Generation = journal_generation > snapshot_generation ?
+		 journal_generation : snapshot_generation;
+    if ( Reserved_job_id > Next_job_id )
+	Next_job_id = Reserved_job_id;
+    Reserved_job_id = Next_job_id;
+
+    // Running jobs and dispatched pending jobs hold resources on nodes
+    journal_allocate_resources(running_jobs, node_list, false);
+    journal_allocate_resources(pending_jobs, node_list, true);
+
+    lpjs_log("%s(): Loaded %lu pending and %lu running jobs, next job ID %lu.\n",
+	     __FUNCTION__, job_list_get_count(pending_jobs),
+	     job_list_get_count(running_jobs), Next_job_id);
+    return LPJS_SUCCESS;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Check whether the journal has grown enough to be worth folding
+ *      into a new snapshot.  Compacting only when the journal exceeds
+ *      the last snapshot keeps the cost proportional to the appends.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+bool    lpjs_journal_compact_due(void)
+
+{
+    return (Journal_bytes > LPJS_JOURNAL_COMPACT_MIN) &&
+	   (Journal_bytes > Snapshot_bytes);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Write a record to the snapshot being built by lpjs_journal_compact()
+ *
+ *  Returns:
+ *      LPJS_SUCCESS or LPJS_WRITE_FAILED
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static int  journal_save_record(FILE *fp, lpjs_buff_t **buff,
+				wire_writer_t *writer)
+
+{
+    int     status = LPJS_SUCCESS;
+
+    if ( (journal_finish_record(*buff, writer) != 0) ||
+	 (fwrite((*buff)->data, (*buff)->len, 1, fp) != 1) )
+	status = LPJS_WRITE_FAILED;
+    lpjs_buff_put(buff);
+    return status;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Write a snapshot of the current job lists
+ *
+ *  Returns:
+ *      LPJS_SUCCESS or LPJS_WRITE_FAILED
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static int  journal_save_snapshot(FILE *fp, job_list_t *pending_jobs,
+				  job_list_t *running_jobs)
+
+{
+    lpjs_buff_t     *buff;
+    wire_writer_t   writer;
+    job_t           *job;
+    size_t          c,
+		    script;
+    const char      *script_text;
+    const unsigned char *hash;
+
+    buff = journal_header_record(Generation, &writer);
+    if ( journal_save_record(fp, &buff, &writer) != LPJS_SUCCESS )
+	return LPJS_WRITE_FAILED;
+
+    for (c = 0; c < Script_count; ++c)
+	Scripts[c].saved = false;
+
+    // Each script is saved with the first job that uses it
+    for (c = 0; c < job_list_get_count(pending_jobs); ++c)
+    {
+	job = job_list_get_jobs_ae(pending_jobs, c);
+	script_text = NULL;
+	hash = NULL;
+	if ( (script = journal_job_script(job_get_job_id(job)))
+		!= JOURNAL_NOT_FOUND )
+	{
+	    if ( ! Scripts[script].saved )
+		script_text = Scripts[script].text;
+	    hash = Scripts[script].hash;
+	    Scripts[script].saved = true;
+	}
+	buff = journal_job_record(LPJS_JOURNAL_SUBMIT, job, script_text,
+				  hash, &writer);
+	if ( journal_save_record(fp, &buff, &writer) != LPJS_SUCCESS )
+	    return LPJS_WRITE_FAILED;
+    }
+
+    for (c = 0; c < job_list_get_count(running_jobs); ++c)
+    {
+	job = job_list_get_jobs_ae(running_jobs, c);
+	buff = journal_job_record(LPJS_JOURNAL_RUNNING, job, NULL, NULL,
+				  &writer);
+	if ( journal_save_record(fp, &buff, &writer) != LPJS_SUCCESS )
+	    return LPJS_WRITE_FAILED;
+    }
+
+    return LPJS_SUCCESS;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Record the next job ID in LPJS_SPOOL_DIR/next-job for lpjs
+ *      clear-queue and other tools that can't read the journal.
+ *      dispatchd reads it only when importing from spool directories.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static void journal_save_next_job_id(void)
+
+{
+    int     fd;
+
+    if ( (fd = open(LPJS_NEXT_JOB_FILE ".tmp",
+		    O_WRONLY|O_CREAT|O_TRUNC, 0644)) == -1 )
+    {
+	lpjs_log("%s(): Error: Cannot create %s.tmp: %s\n", __FUNCTION__,
+		 LPJS_NEXT_JOB_FILE, strerror(errno));
+	return;
+    }
+    if ( (xt_dprintf(fd, "%lu\n", Next_job_id) < 0) ||
+	 (close(fd) != 0) ||
+	 (rename(LPJS_NEXT_JOB_FILE ".tmp", LPJS_NEXT_JOB_FILE) != 0) )
+	lpjs_log("%s(): Error: Cannot update %s: %s\n", __FUNCTION__,
+		 LPJS_NEXT_JOB_FILE, strerror(errno));
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Fold the journal into a new snapshot of the job lists and start
+ *      an empty journal of the next generation.  Both are written and
+ *      fsync()ed under temporary names before either is renamed into
+ *      place.  If the journal was not open, e.g. at startup, this
+ *      opens it.  On failure, the current journal remains in use.
+ *
+ *  Returns:
+ *      LPJS_SUCCESS or LPJS_WRITE_FAILED
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     lpjs_journal_compact(job_list_t *pending_jobs, job_list_t *running_jobs)
+
+{
+    FILE            *fp;
+    int             fd,
+		    dir_fd;
+    long            snapshot_bytes;
+    size_t          journal_bytes = 0;
+    lpjs_buff_t     *buff;
+    wire_writer_t   writer;
+
+    lpjs_log("%s(): Compacting %zu byte journal, generation %lu...\n",
+	     __FUNCTION__, Journal_bytes, (unsigned long)Generation);
+
+    if ( (fp = fopen(LPJS_SNAPSHOT_FILE ".tmp", "w")) == NULL )
+    {
+	lpjs_log("%s(): Error: Cannot create %s.tmp: %s\n", __FUNCTION__,
+		 LPJS_SNAPSHOT_FILE, strerror(errno));
+	return LPJS_WRITE_FAILED;
+    }
+    if ( (journal_save_snapshot(fp, pending_jobs, running_jobs) != LPJS_SUCCESS) ||
+	 (fflush(fp) != 0) || (fsync(fileno(fp)) != 0) ||
+	 ((snapshot_bytes = ftell(fp)) < 0) )
+    {
+	lpjs_log("%s(): Error: Cannot write %s.tmp: %s\n", __FUNCTION__,
+		 LPJS_SNAPSHOT_FILE, strerror(errno));
+	fclose(fp);
+	unlink(LPJS_SNAPSHOT_FILE ".tmp");
+	return LPJS_WRITE_FAILED;
+    }
+    fclose(fp);
+
+    if ( (fd = open(LPJS_JOURNAL_FILE ".tmp",
+		    O_WRONLY|O_CREAT|O_TRUNC|O_APPEND, 0644)) == -1 )
+    {
+	lpjs_log("%s(): Error: Cannot create %s.tmp: %s\n", __FUNCTION__,
+		 LPJS_JOURNAL_FILE, strerror(errno));
+	unlink(LPJS_SNAPSHOT_FILE ".tmp");
+	return LPJS_WRITE_FAILED;
+    }
+    buff = journal_header_record(Generation + 1, &writer);
+    if ( (journal_write_record(fd, &buff, &writer, &journal_bytes)
+	    != LPJS_SUCCESS) || (fsync(fd) != 0) )
+    {
+	lpjs_log("%s(): Error: Cannot write %s.tmp: %s\n", __FUNCTION__,
+		 LPJS_JOURNAL_FILE, strerror(errno));
+	close(fd);
+	unlink(LPJS_SNAPSHOT_FILE ".tmp");
+	unlink(LPJS_JOURNAL_FILE ".tmp");
+	return LPJS_WRITE_FAILED;
+    }
+
+    /*
+     *  A crash between the renames leaves a snapshot and journal of
+     *  the same generation, and the journal is ignored as already
+     *  folded in.
+     */
+    if ( (rename(LPJS_SNAPSHOT_FILE ".tmp", LPJS_SNAPSHOT_FILE) != 0) ||
+	 (rename(LPJS_JOURNAL_FILE ".tmp", LPJS_JOURNAL_FILE) != 0) )
+    {
+	lpjs_log("%s(): Error: rename() failed: %s\n", __FUNCTION__,
+		 strerror(errno));
+	close(fd);
+	return LPJS_WRITE_FAILED;
+    }
+    if ( (dir_fd = open(LPJS_SPOOL_DIR, O_RDONLY)) != -1 )
+    {
+	fsync(dir_fd);
+	close(dir_fd);
+    }
+
+    if ( Journal_fd != -1 )
+	close(Journal_fd);
+    Journal_fd = fd;
+    ++Generation;
+    Journal_bytes = journal_bytes;
+    Snapshot_bytes = snapshot_bytes;
+    journal_save_next_job_id();
+
+    lpjs_log("%s(): Snapshot is %zu bytes, journal generation %lu.\n",
+	     __FUNCTION__, Snapshot_bytes, (unsigned long)Generation);
+    return LPJS_SUCCESS;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Allocate count consecutive job IDs, e.g. for all members of
+ *      a job array.  IDs come from a block reserved in the journal,
+ *      so a new block costs one fsync() per LPJS_JOURNAL_ID_BLOCK
+ *      jobs and no file I/O is needed otherwise.  The reservation
+ *      bypasses any open group, so it is durable before the IDs are
+ *      used even if the group later fails to commit.
+ *
+ *  Returns:
+ *      The first ID allocated, or 0 if a new block could not be
+ *      reserved
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Write the reservation outside the group
+ ***************************************************************************/
+
+unsigned long   lpjs_journal_alloc_job_ids(unsigned long count)
+
+{
+    unsigned long   first = Next_job_id,
+		    reserved;
+    lpjs_buff_t     *buff;
+    wire_writer_t   writer;
+
+    if ( first + count > Reserved_job_id )
+    {
+	reserved = first + count + LPJS_JOURNAL_ID_BLOCK;
+	buff = journal_new_record(LPJS_JOURNAL_RESERVE, 64, &writer);
+	wire_put_uint(&writer, WIRE_TAG_JOURNAL_NEXT_JOB_ID, reserved);
+	if ( Journal_fd == -1 )
+	{
+	    lpjs_log("%s(): Bug: Journal is not open.\n", __FUNCTION__);
+	    lpjs_buff_put(&buff);
+	    return 0;
+	}
+	if ( (journal_write_record(Journal_fd, &buff, &writer, &Journal_bytes)
+		!= LPJS_SUCCESS) || (fsync(Journal_fd) != 0) )
+	{
+	    lpjs_log("%s(): Error: Cannot reserve job IDs up to %lu.\n",
+		     __FUNCTION__, reserved);
+	    return 0;
+	}
+	lpjs_debug("%s(): Reserved job IDs up to %lu.\n", __FUNCTION__,
+		   reserved);
+	Reserved_job_id = reserved;
+    }
+    Next_job_id += count;
+    return first;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Advance the next job ID to at least job_id, e.g. from the
+ *      next-job file when importing from spool directories
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    lpjs_journal_set_next_job_id(unsigned long job_id)
+
+{
+    if ( job_id > Next_job_id )
+	Next_job_id = job_id;
+    if ( Next_job_id > Reserved_job_id )
+	Reserved_job_id = Next_job_id;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Journal a new job, which should have an ID from
+ *      lpjs_journal_alloc_job_ids().  The script is written only if
+ *      no queued job uses the same one.  The job is queued once this
+ *      returns LPJS_SUCCESS.
+ *
+ *  Returns:
+ *      LPJS_SUCCESS or LPJS_WRITE_FAILED
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     lpjs_journal_submit(job_t *job, const char *script_text)
+
+{
+    unsigned char   hash[SHA256_DIGEST_LEN];
+    lpjs_buff_t     *buff;
+    wire_writer_t   writer;
+    unsigned long   job_id = job_get_job_id(job);
+    bool            new_script;
+
+    sha256(script_text, strlen(script_text), hash);
+    new_script = (journal_find_script(hash) == JOURNAL_NOT_FOUND);
+    buff = journal_job_record(LPJS_JOURNAL_SUBMIT, job,
+			      new_script ? script_text : NULL, hash, &writer);
+    if ( journal_append(&buff, &writer) != LPJS_SUCCESS )
+    {
+	lpjs_log("%s(): Error: Failed to journal job %lu.\n",
+		 __FUNCTION__, job_id);
+	return LPJS_WRITE_FAILED;
+    }
+
+    journal_link_script(job_id, journal_add_script(script_text, hash));
+    return LPJS_SUCCESS;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Start collecting records in memory instead of writing each one,
+ *      e.g. for all members of a job array.  Nothing is written until
+ *      lpjs_journal_commit_group().
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    lpjs_journal_begin_group(void)
+
+{
+    if ( Group != NULL )
+    {
+	lpjs_log("%s(): Bug: Group already open.\n", __FUNCTION__);
+	return;
+    }
+    Group = lpjs_buff_get(LPJS_BUFF_INITIAL_SIZE);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Write the records collected since lpjs_journal_begin_group()
+ *      in one write() and make them durable with one fsync().  On
+ *      failure, the journal is truncated to where the group began,
+ *      so none of it is replayed, and the caller should drop the jobs
+ *      with lpjs_journal_drop().
+ *
+ *  Returns:
+ *      LPJS_SUCCESS or LPJS_WRITE_FAILED
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     lpjs_journal_commit_group(void)
+
+{
+    ssize_t written;
+    int     status = LPJS_SUCCESS;
+
+    if ( Group == NULL )
+    {
+	lpjs_log("%s(): Bug: No group open.\n", __FUNCTION__);
+	return LPJS_WRITE_FAILED;
+    }
+    if ( Group->len > 0 )
+    {
+	if ( (written = write(Journal_fd, Group->data, Group->len))
+		!= (ssize_t)Group->len )
+	{
+	    lpjs_log("%s(): Error: write() failed: %s\n", __FUNCTION__,
+		     written < 0 ? strerror(errno) : "Short write");
+	    status = LPJS_WRITE_FAILED;
+	}
+	else if ( fsync(Journal_fd) != 0 )
+	{
+	    lpjs_log("%s(): Error: fsync() failed: %s\n", __FUNCTION__,
+		     strerror(errno));
+	    status = LPJS_WRITE_FAILED;
+	}
+	
+	if ( status == LPJS_SUCCESS )
+	    Journal_bytes += written;
+	// The journal is O_APPEND, so later records follow the truncation
+	else if ( (written > 0) && (ftruncate(Journal_fd, Journal_bytes) != 0) )
+	    lpjs_log("%s(): Error: ftruncate() failed: %s\n", __FUNCTION__,
+		     strerror(errno));
+    }
+    lpjs_buff_put(&Group);
+    return status;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Forget a job that was journaled in a group that failed to
+ *      commit, so its script is written again by the next submission
+ *      that uses it
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    lpjs_journal_drop(unsigned long job_id)
+
+{
+    journal_unlink_script(job_id);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Journal a job sent to compute_node, awaiting chaperone checkin.
+ *      The job holds resources on compute_node from now on.
+ *
+ *  Returns:
+ *      LPJS_SUCCESS or LPJS_WRITE_FAILED
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Record the compute node
+ ***************************************************************************/
+
+int     lpjs_journal_dispatch(unsigned long job_id, const char *compute_node,
+			      pid_t chaperone_pid)
+
+{
+    return journal_append_job_event(LPJS_JOURNAL_DISPATCH, job_id,
+				    compute_node, chaperone_pid, 0, 0);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Journal a job moving from pending to running.  Its script is
+ *      no longer needed and is released.
+ *
+ *  Returns:
+ *      LPJS_SUCCESS or LPJS_WRITE_FAILED
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Record the start time for the job history
+ ***************************************************************************/
+
+int     lpjs_journal_start(unsigned long job_id, const char *compute_node,
+			   pid_t chaperone_pid, pid_t job_pid,
+			   time_t start_time)
+
+{
+    int     status;
+
+    status = journal_append_job_event(LPJS_JOURNAL_START, job_id,
+				      compute_node, chaperone_pid, job_pid,
+				      start_time);
+    journal_unlink_script(job_id);
+    return status;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Journal a running job reported by a compd that we had no record
+ *      of, e.g. because its SUBMIT record was lost in a crash.  The job
+ *      should have its compute node set.
+ *
+ *  Returns:
+ *      LPJS_SUCCESS or LPJS_WRITE_FAILED
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     lpjs_journal_adopt(job_t *job)
+
+{
+    lpjs_buff_t     *buff;
+    wire_writer_t   writer;
+
+    // Never hand out its ID again, replay does the same on restart
+    lpjs_journal_set_next_job_id(job_get_job_id(job) + 1);
+    buff = journal_job_record(LPJS_JOURNAL_RUNNING, job, NULL, NULL, &writer);
+    if ( journal_append(&buff, &writer) != LPJS_SUCCESS )
+    {
+	lpjs_log("%s(): Error: Failed to journal job %lu.\n",
+		 __FUNCTION__, job_get_job_id(job));
+	return LPJS_WRITE_FAILED;
+    }
+    return LPJS_SUCCESS;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Journal cancellation of a dispatched job, which is removed
+ *      after chaperone checkin
+ *
+ *  Returns:
+ *      LPJS_SUCCESS or LPJS_WRITE_FAILED
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     lpjs_journal_cancel(unsigned long job_id)
+
+{
+    return journal_append_job_event(LPJS_JOURNAL_CANCEL, job_id, NULL, 0, 0,
+				    0);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Journal removal of a job from the queue, whether completed,
+ *      canceled, or failed
+ *
+ *  Returns:
+ *      LPJS_SUCCESS or LPJS_WRITE_FAILED
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     lpjs_journal_complete(unsigned long job_id)
+
+{
+    int     status;
+
+    status = journal_append_job_event(LPJS_JOURNAL_COMPLETE, job_id, NULL,
+				      0, 0, 0);
+    journal_unlink_script(job_id);
+    return status;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Hold a copy of a pending job's script without journaling it,
+ *      for jobs imported from spool directories before the next
+ *      lpjs_journal_compact()
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    lpjs_journal_set_script(unsigned long job_id, const char *script_text)
+
+{
+    unsigned char   hash[SHA256_DIGEST_LEN];
+
+    sha256(script_text, strlen(script_text), hash);
+    journal_link_script(job_id, journal_add_script(script_text, hash));
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Get the script of a pending job, and its SHA-256 if hash is
+ *      not NULL
+ *
+ *  Returns:
+ *      The script text, valid until the job starts or is removed,
+ *      or NULL if the job has no script
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+const char  *lpjs_journal_get_script(unsigned long job_id,
+				     unsigned char *hash)
+
+{
+    size_t  script;
+
+    if ( (script = journal_job_script(job_id)) == JOURNAL_NOT_FOUND )
+	return NULL;
+    if ( hash != NULL )
+	memcpy(hash, Scripts[script].hash, SHA256_DIGEST_LEN);
+    return Scripts[script].text;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Enable or disable the per-job spool directories under
+ *      LPJS_PENDING_DIR and LPJS_RUNNING_DIR, which are no longer
+ *      needed by dispatchd but may be useful to admin tools
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    lpjs_journal_set_spool_export(bool export)
+
+{
+    Spool_export = export;
+}
+
+
+bool    lpjs_journal_spool_export(void)
+
+{
+    return Spool_export;
+}
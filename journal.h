@@ -0,0 +1,73 @@
+#ifndef _LPJS_JOURNAL_H_
+#define _LPJS_JOURNAL_H_
+
+#include <stddef.h>     // size_t
+#include <stdint.h>     // uint32_t
+#include <sys/types.h>  // pid_t
+
+#ifndef true
+#include <stdbool.h>
+#endif
+
+#include "job-list.h"
+#include "node-list.h"
+
+/*
+ *  dispatchd's queue state is a snapshot of the pending and running
+ *  jobs, plus a journal of the transitions since.  Both are sequences
+ *  of records:
+ *
+ *      [length] [CRC-32] [payload]
+ *
+ *  length and CRC-32 cover the payload and are in network byte order.
+ *  The payload is in the wire.h format, with WIRE_TAG_JOURNAL_RECORD
+ *  giving the record type.  Each file begins with a header record
+ *  holding its generation.  A snapshot covers the journal of the same
+ *  generation, so a journal that is not newer than the snapshot was
+ *  already folded into it and is ignored.
+ *
+ *  Compaction writes a new snapshot and an empty journal of the next
+ *  generation to temporary files, then renames them into place, so a
+ *  crash at any point leaves a consistent pair.
+ *
+ *  Scripts are identified by SHA-256 and written only the first time
+ *  they are seen, so job array members cost one small record each.
+ *
+ *  Records are written as they happen, except that the members of a
+ *  submission are collected by lpjs_journal_begin_group() and written
+ *  and fsync()ed together by lpjs_journal_commit_group() before any
+ *  is acknowledged, so acknowledged jobs survive a crash.  They may
+ *  then wait in dispatchd's intake (intake.h) before reaching the
+ *  pending list, so the intake must be drained before
+ *  lpjs_journal_compact() snapshots the job lists.
+ *
+ *  Job IDs are handed out from blocks reserved by an fsync()ed
+ *  RESERVE record, and a restart resumes after the last reserved
+ *  block, so an ID is never reused even if the SUBMIT record using
+ *  it was lost in a crash.
+ */
+
+#define LPJS_JOURNAL_FRAME_LEN      8   // Length + CRC-32
+
+// Record types
+#define LPJS_JOURNAL_HEADER         1   // Generation, end of reserved job IDs
+#define LPJS_JOURNAL_SUBMIT         2   // Job specs, script or its hash
+#define LPJS_JOURNAL_DISPATCH       3   // Job ID, compute node, chaperone PID
+#define LPJS_JOURNAL_START          4   // Job ID, compute node, PIDs, time
+#define LPJS_JOURNAL_CANCEL         5   // Job ID of a dispatched job
+#define LPJS_JOURNAL_COMPLETE       6   // Job ID, job leaves the queue
+#define LPJS_JOURNAL_RUNNING        7   // Job specs, snapshot or adopted
+#define LPJS_JOURNAL_RESERVE        8   // End of reserved job IDs
+
+// Job IDs reserved per fsync() of the journal
+#define LPJS_JOURNAL_ID_BLOCK       1000
+
+// Compact when the journal is larger than this and the last snapshot
+#define LPJS_JOURNAL_COMPACT_MIN    (8 * 1024 * 1024)
+
+// Job specs and the largest script, with room for the other fields
+#define LPJS_JOURNAL_RECORD_MAX     LPJS_JOB_MSG_SIZE(LPJS_SCRIPT_SIZE_MAX)
+
+#include "journal-protos.h"
+
+#endif  // _LPJS_JOURNAL_H_
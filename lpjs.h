@@ -13,7 +13,8 @@ enum
 {
     LPJS_SUCCESS = 0,
     LPJS_READ_FAILED,
-    LPJS_WRITE_FAILED
+    LPJS_WRITE_FAILED,
+    LPJS_CONFIG_INVALID
 };
 
 #define LPJS_SHARED_FS_MARKER_MAX   128
@@ -39,12 +40,16 @@ enum
 #define LPJS_LOG_DIR            PREFIX "/var/log/lpjs"
 #define LPJS_COMPD_LOG          LPJS_LOG_DIR "/compd"
 #define LPJS_DISPATCHD_LOG      LPJS_LOG_DIR "/dispatchd"
-#define LPJS_JOB_HISTORY        LPJS_LOG_DIR "/job-history"
+#define LPJS_JOB_HISTORY        LPJS_LOG_DIR "/job-history"   // Old format, see history --import
+#define LPJS_HISTORY_DIR        LPJS_LOG_DIR "/history"
 
 #define LPJS_SPOOL_DIR          PREFIX "/var/spool/lpjs"
 #define LPJS_PENDING_DIR        LPJS_SPOOL_DIR "/pending"
 #define LPJS_RUNNING_DIR        LPJS_SPOOL_DIR "/running"
 #define LPJS_SPECS_FILE_NAME    "job.specs"
+#define LPJS_NEXT_JOB_FILE      LPJS_SPOOL_DIR "/next-job"
+#define LPJS_JOURNAL_FILE       LPJS_SPOOL_DIR "/journal"
+#define LPJS_SNAPSHOT_FILE      LPJS_SPOOL_DIR "/snapshot"
 
 /*
  *  Job scripts should be quite small, usually no more than a few dozen lines.
@@ -53,11 +58,19 @@ enum
  *  will have different CPU and memory requirements.
  */
 
-#define LPJS_SCRIPT_SIZE_MAX    LPJS_PAYLOAD_MAX
+// Scripts are held in heap buffers sized to fit.  munged limits
+// requests to 1 MiB, so leave room for the job specs.
+#define LPJS_SCRIPT_SIZE_MAX    (512 * 1024)
 
-#define LPJS_JOB_MSG_MAX        JOB_STR_MAX_LEN + LPJS_SCRIPT_SIZE_MAX
+// Job specs and script, for a script of script_size bytes
+#define LPJS_JOB_MSG_SIZE(script_size)  (JOB_STR_MAX_LEN + (script_size) + 64)
+
+// Submissions packed into one batch by lpjs submit, within munged's limit
+#define LPJS_SUBMIT_BATCH_MAX   LPJS_JOB_MSG_SIZE(LPJS_SCRIPT_SIZE_MAX)
 
 #define LPJS_RUN_DIR            PREFIX "/var/run/lpjs"
+// compd's record of running chaperones, one file per job ID
+#define LPJS_COMPD_JOBS_DIR     LPJS_RUN_DIR "/jobs"
 
 #define LPJS_MB                 1000000
 #define LPJS_MiB                1048576
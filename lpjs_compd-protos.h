@@ -2,9 +2,12 @@
 int lpjs_compd_checkin(int msg_fd, node_t *node);
 int lpjs_compd_checkin_loop(node_list_t *node_list, node_t *node);
 int lpjs_working_dir_setup(job_t *job, const char *script_buff, char *job_script_name, size_t maxlen);
-int lpjs_send_chaperone_status(int msg_fd, unsigned long job_id, chaperone_status_t status);
+int lpjs_send_chaperone_status(int msg_fd, const char *outgoing_msg);
 int lpjs_send_chaperone_status_loop(node_list_t *node_list, unsigned long job_id, chaperone_status_t status);
+void lpjs_compd_forward(int listen_fd, int compd_msg_fd);
 int lpjs_run_chaperone(job_t *job, const char *script_buff, int msg_fd, node_list_t *node_list);
 void lpjs_chown(job_t *job, const char *path);
 void sigchld_handler(int s2);
 int lpjs_remove_old_temp_dirs(void);
+int lpjs_compd_save_chaperone(job_t *job, pid_t chaperone_pid);
+int lpjs_compd_live_jobs(wire_writer_t *writer);
@@ -16,6 +16,7 @@
 #include <signal.h>
 #include <errno.h>
 #include <sys/socket.h>
+#include <sys/time.h>       // struct timeval
 #include <poll.h>
 #include <stdbool.h>
 #include <sys/stat.h>       // S_ISDIR()
@@ -24,8 +25,9 @@
 #include <fcntl.h>          // open()
 #include <signal.h>
 #include <sys/wait.h>
+#include <dirent.h>         // opendir()
 
-#include <xtend/string.h>
+#include <xtend/string.h>   // xt_strisint()
 #include <xtend/proc.h>
 #include <xtend/file.h>     // xt_rmkdir()
 
@@ -33,6 +35,9 @@
 #include "node-list.h"
 #include "config.h"
 #include "network.h"
+#include "session.h"
+#include "script-cache.h"
+#include "wire.h"
 #include "misc.h"
 #include "job.h"
 #include "lpjs_compd.h"
@@ -44,11 +49,15 @@ int     main (int argc, char *argv[])
     node_list_t *node_list = node_list_new();
     // Terminates process if malloc() fails, no check required
     node_t      *node = node_new();
+    // Terminates process if malloc() fails, no check required
+    script_cache_t  *script_cache = script_cache_new(SCRIPT_CACHE_SLOTS,
+                                                     SCRIPT_CACHE_BYTES_MAX);
     char        *munge_payload,
                 vis_msg[LPJS_MSG_LEN_MAX + 1];
     ssize_t     bytes;
-    int         compd_msg_fd;
-    struct pollfd   poll_fd;
+    int         compd_msg_fd,
+                local_listen_fd;
+    struct pollfd   poll_fd[2];
     extern FILE *Log_stream;
     uid_t       uid;
     gid_t       gid;
@@ -80,14 +89,17 @@ int     main (int argc, char *argv[])
     else
         Log_stream = stderr;
     
+    // Holds LPJS_COMPD_SOCKET, and the pid file on Linux
+    if ( xt_rmkdir(LPJS_RUN_DIR, 0755) != 0 )
+        return EX_CANTCREAT;
+    if ( xt_rmkdir(LPJS_COMPD_JOBS_DIR, 0700) != 0 )
+        return EX_CANTCREAT;
+    
 #ifdef __linux__    // systemd needs a pid file for forking daemons
     // FIXME: Make sure Pid_path is removed no matter where the program exits
     int     status;
     extern char Pid_path[PATH_MAX + 1];
     
-    if ( xt_rmkdir(LPJS_RUN_DIR, 0755) != 0 )
-        return EX_CANTCREAT;
-    
     snprintf(Pid_path, PATH_MAX + 1, "%s/lpjs_compd.pid", LPJS_RUN_DIR);
     status = xt_create_pid_file(Pid_path, Log_stream);
     if ( status != EX_OK )
@@ -97,24 +109,43 @@ int     main (int argc, char *argv[])
     // Get hostname of head node
     lpjs_load_config(node_list, LPJS_CONFIG_HEAD_ONLY, Log_stream);
 
+    // Advertised at checkin, so dispatchd can send just script hashes
+    node_set_script_cache_slots(node, SCRIPT_CACHE_SLOTS);
     compd_msg_fd = lpjs_compd_checkin_loop(node_list, node);
-    poll_fd.fd = compd_msg_fd;
     // POLLERR and POLLHUP are actually always set.  Listing POLLHUP here just
     // for documentation.
-    poll_fd.events = POLLIN | POLLHUP;
+    poll_fd[0].events = POLLIN | POLLHUP;
+    
+    // Chaperones hand notifications for dispatchd to us here, so they
+    // need not connect to dispatchd themselves.  -1 if unavailable,
+    // in which case they do.
+    local_listen_fd = lpjs_listen_local(LPJS_COMPD_SOCKET);
+    poll_fd[1].fd = local_listen_fd;
+    poll_fd[1].events = POLLIN;
     
     // Now keep daemon running, awaiting jobs
     // Almost correct: https://unix.stackexchange.com/questions/581426/how-to-get-notified-when-the-other-end-of-a-socketpair-is-closed
     while ( true )
     {
-        // Just poll the dedicated socket connection with dispatchd
-        // Time out after 2 seconds
-        poll(&poll_fd, 1, 2000);
+        // compd_msg_fd changes when we check in again
+        poll_fd[0].fd = compd_msg_fd;
+        poll_fd[1].revents = 0;
+        
+        // Poll the dedicated socket connection with dispatchd and the
+        // local socket.  Time out after 2 seconds, or immediately if
+        // a message from dispatchd was read while forwarding.
+        poll(poll_fd, local_listen_fd == -1 ? 1 : 2,
+             lpjs_recv_pending(compd_msg_fd) ? 0 : 2000);
+        if ( lpjs_recv_pending(compd_msg_fd) )
+            poll_fd[0].revents |= POLLIN;
+        
+        if ( poll_fd[1].revents & POLLIN )
+            lpjs_compd_forward(local_listen_fd, compd_msg_fd);
 
         // dispatchd closed its end of the socket?
-        if (poll_fd.revents & POLLHUP)
+        if (poll_fd[0].revents & POLLHUP)
         {
-            poll_fd.revents &= ~POLLHUP;
+            poll_fd[0].revents &= ~POLLHUP;
             
             // Close this end, or dispatchd gets "address already in use"
             // When trying to restart
@@ -125,17 +156,17 @@ int     main (int argc, char *argv[])
             compd_msg_fd = lpjs_compd_checkin_loop(node_list, node);
         }
         
-        if (poll_fd.revents & POLLERR)
+        if (poll_fd[0].revents & POLLERR)
         {
-            poll_fd.revents &= ~POLLERR;
+            poll_fd[0].revents &= ~POLLERR;
             lpjs_log("%s(): Error: Problem polling dispatchd: %s\n",
                     __FUNCTION__, strerror(errno));
             break;
         }
         
-        if (poll_fd.revents & POLLIN)
+        if (poll_fd[0].revents & POLLIN)
         {
-            poll_fd.revents &= ~POLLIN;
+            poll_fd[0].revents &= ~POLLIN;
             // FIXME: Add a timeout and handling code
             lpjs_log("%s(): New message from dispatchd.\n", __FUNCTION__);
             bytes = lpjs_recv_munge(compd_msg_fd, &munge_payload, 0, 0,
@@ -147,7 +178,7 @@ int     main (int argc, char *argv[])
                 close(compd_msg_fd);
                 lpjs_log("%s(): Error: Got %zd bytes from dispatchd.  Something is wrong.\n",
                         __FUNCTION__, bytes);
-                poll_fd.revents = 0;
+                poll_fd[0].revents = 0;
                 compd_msg_fd = lpjs_compd_checkin_loop(node_list, node);
             }
             else if ( bytes == 0 )
@@ -160,7 +191,7 @@ int     main (int argc, char *argv[])
                 lpjs_log("%s(): Error: 0 bytes received from dispatchd.  Disconnecting...\n",
                         __FUNCTION__);
                 close(compd_msg_fd);
-                poll_fd.revents = 0;
+                poll_fd[0].revents = 0;
                 compd_msg_fd = lpjs_compd_checkin_loop(node_list, node);
             }
             else
@@ -180,32 +211,93 @@ int     main (int argc, char *argv[])
     
                     // Ignore HUP that follows EOT
                     // FIXME: This might be bad timing
-                    poll_fd.revents &= ~POLLHUP;
+                    poll_fd[0].revents &= ~POLLHUP;
                     compd_msg_fd = lpjs_compd_checkin_loop(node_list, node);
                 }
                 else if ( munge_payload[0] == LPJS_COMPD_REQUEST_NEW_JOB )
                 {
                     // Terminates process if malloc() fails, no check required
                     job_t   *job = job_new();
-                    char    *script_buff;
+                    char    *end;
+                    const char  *script_buff = NULL;
+                    wire_field_t    field, hash_field;
+                    bool        have_hash, cache_miss = false;
+                    char        response[2];
                     
                     lpjs_log("%s(): LPJS_COMPD_REQUEST_NEW_JOB\n", __FUNCTION__);
                     
                     /*
                      *  Message from dispatch contains the job specs
-                     *  followed by the job script text.
+                     *  followed by the job script text, in the binary
+                     *  format described in wire.h.  Accept text from
+                     *  a dispatchd that predates it.
+                     *
+                     *  If the script was sent to us recently, dispatchd
+                     *  sends only its hash.  Cache scripts sent with a
+                     *  hash for later jobs, e.g. the rest of an array.
                      */
                     
-                    job_read_from_string(job, munge_payload + 1, &script_buff);
-                    job_print_full_specs(job, Log_stream);
-                    
-                    /*
-                     *  lpjs_run_chaperone() forks, and the child process
-                     *  sends a response to lpjs_compd, depending on
-                     *  whether the dispatch succeeds.
-                     */
+                    if ( wire_is_binary(munge_payload + 1, bytes - 1) )
+                    {
+                        have_hash =
+                            (wire_find_field(munge_payload + 1, bytes - 1,
+                                             WIRE_TAG_SCRIPT_HASH,
+                                             &hash_field) == WIRE_OK) &&
+                            (hash_field.len == SHA256_DIGEST_LEN);
+                        if ( job_read_from_wire(job, munge_payload + 1,
+                                                bytes - 1) != 0 )
+                            script_buff = NULL;
+                        else if ( wire_find_field(munge_payload + 1, bytes - 1,
+                                      WIRE_TAG_SCRIPT, &field) == WIRE_OK )
+                        {
+                            script_buff = wire_get_str(&field);
+                            if ( have_hash && (script_buff != NULL) )
+                                script_cache_add(script_cache, script_buff,
+                                                 NULL);
+                        }
+                        else if ( have_hash )
+                        {
+                            script_buff = script_cache_find(script_cache,
+                                                            hash_field.value);
+                            cache_miss = script_buff == NULL;
+                        }
+                    }
+                    else if ( job_read_from_string(job, munge_payload + 1, &end)
+                                == JOB_SPECS_ITEMS )
+                        script_buff = end;
                     
-                    lpjs_run_chaperone(job, script_buff, compd_msg_fd, node_list);
+                    if ( cache_miss )
+                    {
+                        // dispatchd will resend with the script
+                        lpjs_log("%s(): Script for job %lu not cached.\n",
+                                 __FUNCTION__, job_get_job_id(job));
+                        snprintf(response, sizeof(response), "%c",
+                                 LPJS_COMPD_SCRIPT_NOT_CACHED);
+                        if ( lpjs_send_munge(compd_msg_fd, response, close)
+                                != LPJS_MSG_SENT )
+                            lpjs_log("%s(): Error: Failed to report cache miss.\n",
+                                     __FUNCTION__);
+                        job_free(&job);
+                    }
+                    else if ( script_buff == NULL )
+                    {
+                        // dispatchd will give up waiting for the chaperone
+                        lpjs_log("%s(): Error: Malformed new job request.\n",
+                                 __FUNCTION__);
+                        job_free(&job);
+                    }
+                    else
+                    {
+                        job_print_full_specs(job, Log_stream);
+                        
+                        /*
+                         *  lpjs_run_chaperone() forks, and the child process
+                         *  sends a response to lpjs_compd, depending on
+                         *  whether the dispatch succeeds.
+                         */
+                        
+                        lpjs_run_chaperone(job, script_buff, compd_msg_fd, node_list);
+                    }
                 }
                 else if ( munge_payload[0] == LPJS_COMPD_REQUEST_CANCEL )
                 {
@@ -238,27 +330,87 @@ int     main (int argc, char *argv[])
 }
 
 
+/***************************************************************************
+ *  Description:
+ *      Send node specs to dispatchd and await authorization.
+ *
+ *      Specs are sent in the binary format described in wire.h.
+ *      If dispatchd rejects that, it may predate the binary format,
+ *      so later attempts use the legacy text checkin.  This allows
+ *      compute nodes to be upgraded before the head node.
+ *
+ *      A binary checkin includes a nonce for a session (see session.h).
+ *      If the authorization reply carries dispatchd's nonce, later
+ *      messages on compd_msg_fd are authenticated by the session
+ *      instead of munge.
+ *
+ *  Returns:
+ *      EX_OK on success, EX_IOERR if the checkin should be retried
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Send binary specs, fall back to text
+ *  2026-10-19  Jason Bacon Establish session
+ *  2026-10-19  Jason Bacon Negotiate compression
+ *  2026-10-19  Jason Bacon Report live chaperones
+ ***************************************************************************/
+
 int     lpjs_compd_checkin(int compd_msg_fd, node_t *node)
 
 {
+    // Set once dispatchd rejects a binary checkin
+    static bool text_checkin = false;
     char        outgoing_msg[LPJS_MSG_LEN_MAX + 1],
                 *munge_payload,
                 specs[NODE_SPECS_LEN + 1];
-    ssize_t     bytes;
+    ssize_t     bytes,
+                msg_len;
     uid_t       uid;
     gid_t       gid;
+    wire_writer_t   writer;
+    wire_field_t    field;
+    unsigned char   compd_nonce[SESSION_NONCE_LEN];
+    bool        want_session = false;
+    uint64_t    compress_methods;
+    size_t      authorized_len = strlen(LPJS_NODE_AUTHORIZED_MSG) + 1;
     extern FILE *Log_stream;
     
     /* Send a message to the server */
     /* Need to send \0, so xt_dprintf() doesn't work here */
     node_detect_specs(node);
-    snprintf(outgoing_msg, LPJS_MSG_LEN_MAX + 1,
-            "%c%s %s", LPJS_DISPATCHD_REQUEST_COMPD_CHECKIN,
-            LPJS_PROTOCOL_VERSION, node_specs_to_str(node, specs, NODE_SPECS_LEN + 1));
+    node_specs_to_str(node, specs, NODE_SPECS_LEN + 1);
+    if ( text_checkin )
+    {
+        msg_len = snprintf(outgoing_msg, LPJS_MSG_LEN_MAX + 1,
+                "%c%s %s", LPJS_DISPATCHD_REQUEST_COMPD_CHECKIN,
+                LPJS_PROTOCOL_VERSION_TEXT, specs);
+    }
+    else
+    {
+        outgoing_msg[0] = LPJS_DISPATCHD_REQUEST_COMPD_CHECKIN;
+        wire_writer_init(&writer, outgoing_msg + 1, LPJS_MSG_LEN_MAX);
+        wire_put_str(&writer, WIRE_TAG_PROTOCOL_VERSION, LPJS_PROTOCOL_VERSION);
+        node_write_to_wire(node, &writer);
+        // Without a nonce, just use munge for every message
+        if ( session_random_bytes(compd_nonce, SESSION_NONCE_LEN) == 0 )
+        {
+            wire_put_bytes(&writer, WIRE_TAG_SESSION_NONCE, compd_nonce,
+                           SESSION_NONCE_LEN);
+            want_session = true;
+        }
+        // dispatchd confirms in its reply if it can expand them
+        wire_put_uint(&writer, WIRE_TAG_COMPRESSION, LPJS_COMPRESS_METHODS);
+        // Lets a restarted dispatchd reconcile its running jobs
+        lpjs_compd_live_jobs(&writer);
+        // Specs are far smaller than LPJS_MSG_LEN_MAX, and live jobs
+        // are added only while they fit, so this cannot overflow
+        msg_len = wire_writer_len(&writer) + 1;
+    }
     lpjs_log("%s(): Sending node specs:\n", __FUNCTION__);
     node_print_specs_header(Log_stream);
-    fprintf(Log_stream, "%s\n", outgoing_msg + 1);
-    if ( lpjs_send_munge(compd_msg_fd, outgoing_msg, close) != LPJS_MSG_SENT )
+    fprintf(Log_stream, "%s\n", specs);
+    if ( lpjs_send_munge_bin(compd_msg_fd, outgoing_msg, msg_len, close)
+            != LPJS_MSG_SENT )
     {
         close(compd_msg_fd);
         lpjs_log("%s(): Error: Failed to send checkin message to dispatchd: %s\n",
@@ -278,6 +430,16 @@ int     lpjs_compd_checkin(int compd_msg_fd, node_t *node)
                 __FUNCTION__);
         exit(EX_IOERR); // FIXME: Should we retry?
     }
+    else if ( ! text_checkin &&
+              (strcmp(munge_payload, LPJS_WRONG_PROTOCOL_VERSION_MSG) == 0) )
+    {
+        close(compd_msg_fd);
+        lpjs_log("%s(): dispatchd rejected binary checkin.  Retrying with text.\n",
+                 __FUNCTION__);
+        text_checkin = true;
+        free(munge_payload);
+        return EX_IOERR;
+    }
     else if ( strcmp(munge_payload, LPJS_WRONG_PROTOCOL_VERSION_MSG) == 0 )
     {
         close(compd_msg_fd);
@@ -300,8 +462,31 @@ int     lpjs_compd_checkin(int compd_msg_fd, node_t *node)
         exit(EX_NOPERM);
     }
     else
+    {
         lpjs_log("%s(): Received authorization from lpjs_dispatchd.\n",
                 __FUNCTION__);
+        
+        // Older dispatchds send nothing after the authorization string
+        if ( want_session && (bytes > (ssize_t)authorized_len) &&
+             (wire_find_field(munge_payload + authorized_len,
+                              bytes - authorized_len,
+                              WIRE_TAG_SESSION_NONCE, &field) == WIRE_OK) &&
+             (field.len == SESSION_NONCE_LEN) )
+        {
+            session_start(compd_msg_fd, compd_nonce, field.value,
+                          SESSION_ROLE_COMPD, uid, gid);
+            lpjs_log("%s(): Session established.\n", __FUNCTION__);
+        }
+        if ( (bytes > (ssize_t)authorized_len) &&
+             (wire_find_field(munge_payload + authorized_len,
+                              bytes - authorized_len,
+                              WIRE_TAG_COMPRESSION, &field) == WIRE_OK) &&
+             (wire_get_uint(&field, &compress_methods) == WIRE_OK) )
+        {
+            lpjs_compress_enable(compd_msg_fd, compress_methods);
+            lpjs_log("%s(): Compression enabled.\n", __FUNCTION__);
+        }
+    }
 
     free(munge_payload);
     
@@ -505,7 +690,7 @@ int     lpjs_working_dir_setup(job_t *job, const char *script_buff,
 
 /***************************************************************************
  *  Description:
- *      Attempt to send job completion report to dispatchd
+ *      Attempt to send chaperone status report to dispatchd
  *
  *  Returns:
  *      EX_OK on success, EX_IOERR otherwise
@@ -513,22 +698,12 @@ int     lpjs_working_dir_setup(job_t *job, const char *script_buff,
  *  History: 
  *  Date        Name        Modification
  *  2024-12-07  Jason Bacon Adapt from lpjs_chaperone_completion
+ *  2026-10-19  Jason Bacon Take message from caller
  ***************************************************************************/
 
-int     lpjs_send_chaperone_status(int msg_fd, unsigned long job_id,
-                                   chaperone_status_t chaperone_status)
+int     lpjs_send_chaperone_status(int msg_fd, const char *outgoing_msg)
 
 {
-    char    outgoing_msg[LPJS_MSG_LEN_MAX + 1],
-            hostname[sysconf(_SC_HOST_NAME_MAX) + 1];
-    
-    lpjs_log("%s(): job_id %lu sending status %d on fd %d\n", __FUNCTION__,
-             job_id, chaperone_status, msg_fd);
-    /* Send job completion message to dispatchd */
-    gethostname(hostname, sysconf(_SC_HOST_NAME_MAX));
-    snprintf(outgoing_msg, LPJS_MSG_LEN_MAX + 1, "%c%s %lu %d",
-             LPJS_DISPATCHD_REQUEST_CHAPERONE_STATUS, hostname, job_id,
-             chaperone_status);
     lpjs_debug("%s(): msg = %s\n", __FUNCTION__, outgoing_msg + 1);
     if ( lpjs_send_munge(msg_fd, outgoing_msg, close) != LPJS_MSG_SENT )
     {
@@ -537,8 +712,6 @@ int     lpjs_send_chaperone_status(int msg_fd, unsigned long job_id,
         close(msg_fd);
         return LPJS_WRITE_FAILED;
     }
-    lpjs_debug("%s(): Status %d sent by job_id %lu.\n",
-             __FUNCTION__, chaperone_status, job_id);
     
     return EX_OK;   // FIXME: Use LPJS return values
 }
@@ -546,7 +719,8 @@ int     lpjs_send_chaperone_status(int msg_fd, unsigned long job_id,
 
 /***************************************************************************
  *  Description:
- *      Connect to dispatchd and send checkin request.
+ *      Send chaperone status to dispatchd, through lpjs_compd's local
+ *      socket if possible, otherwise by connecting to dispatchd.
  *      Retry indefinitely if failure occurs.
  *
  *  Returns:
@@ -555,6 +729,7 @@ int     lpjs_send_chaperone_status(int msg_fd, unsigned long job_id,
  *  History: 
  *  Date        Name        Modification
  *  2024-12-07  Jason Bacon Adapt from lpjs_chaperone_completion_loop
+ *  2026-10-19  Jason Bacon Try lpjs_send_via_compd() first
  ***************************************************************************/
 
 int     lpjs_send_chaperone_status_loop(node_list_t *node_list,
@@ -563,9 +738,24 @@ int     lpjs_send_chaperone_status_loop(node_list_t *node_list,
 
 {
     int     msg_fd, send_status;
+    char    outgoing_msg[LPJS_MSG_LEN_MAX + 1],
+            hostname[sysconf(_SC_HOST_NAME_MAX) + 1];
     
-    lpjs_debug("%s(): job_id %lu sendind status %d\n", __FUNCTION__,
+    lpjs_log("%s(): job_id %lu sending status %d\n", __FUNCTION__,
              job_id, chaperone_status);
+    gethostname(hostname, sysconf(_SC_HOST_NAME_MAX));
+    snprintf(outgoing_msg, LPJS_MSG_LEN_MAX + 1, "%c%s %lu %d",
+             LPJS_DISPATCHD_REQUEST_CHAPERONE_STATUS, hostname, job_id,
+             chaperone_status);
+    
+    // Our parent compd forwards it on its connection to dispatchd
+    if ( lpjs_send_via_compd(outgoing_msg) == LPJS_MSG_SENT )
+    {
+        lpjs_debug("%s(): Chaperone status %d forwarded by compd.\n",
+                   __FUNCTION__, chaperone_status);
+        return 0;
+    }
+    
     // Retry socket connection and message send indefinitely
     do
     {
@@ -580,8 +770,7 @@ int     lpjs_send_chaperone_status_loop(node_list_t *node_list,
         }
         else
         {
-            send_status = lpjs_send_chaperone_status(msg_fd, job_id,
-                                                     chaperone_status);
+            send_status = lpjs_send_chaperone_status(msg_fd, outgoing_msg);
             lpjs_debug("%s(): msg_fd = %d  send_status = %d\n", 
                      __FUNCTION__, msg_fd, send_status);
             if ( send_status != EX_OK )
@@ -600,6 +789,85 @@ int     lpjs_send_chaperone_status_loop(node_list_t *node_list,
 }
 
 
+/***************************************************************************
+ *  Description:
+ *      Accept a connection on LPJS_COMPD_SOCKET and forward the
+ *      chaperone notification received on it to dispatchd over our
+ *      persistent connection, so that dispatchd sees one connection
+ *      per node instead of several per job.  The sender is told
+ *      LPJS_NODE_AUTHORIZED_MSG once dispatchd has acknowledged it.
+ *      Otherwise the connection is just closed, and the sender
+ *      connects to dispatchd itself.
+ *
+ *      Nothing is forwarded on a munge-only connection, since
+ *      dispatchds that predate sessions ignore messages from compd
+ *      after checkin.  Only notifications are forwarded, since
+ *      dispatchd attributes them to us rather than the sender.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    lpjs_compd_forward(int listen_fd, int compd_msg_fd)
+
+{
+    int             msg_fd;
+    char            *munge_payload;
+    ssize_t         bytes;
+    uid_t           uid, dispatchd_uid;
+    gid_t           gid, dispatchd_gid;
+    // Senders write immediately after connecting
+    struct timeval  timeout = { 1, 0 };
+    
+    if ( (msg_fd = accept(listen_fd, NULL, NULL)) == -1 )
+    {
+        lpjs_log("%s(): Error: accept() failed: %s\n", __FUNCTION__,
+                 strerror(errno));
+        return;
+    }
+    
+    // msg_fd may be reused from a connection closed with plain close()
+    lpjs_forget_acks(msg_fd);
+    session_end(msg_fd);
+    lpjs_discard_deferred(msg_fd);
+    lpjs_compress_enable(msg_fd, 0);
+    if ( lpjs_local_peer_start(msg_fd) != 1 )
+    {
+        close(msg_fd);
+        return;
+    }
+    
+    // Don't let a stalled sender block messages from dispatchd
+    setsockopt(msg_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    bytes = lpjs_recv_munge(msg_fd, &munge_payload, 0, 0, &uid, &gid,
+                            lpjs_no_close);
+    if ( bytes > 0 )
+    {
+        if ( ! lpjs_is_notification(munge_payload) )
+            lpjs_log("%s(): Error: Not forwarding request %d from uid %d.\n",
+                     __FUNCTION__, munge_payload[0], uid);
+        else if ( ! session_active(compd_msg_fd) &&
+                  (lpjs_local_peer_get(compd_msg_fd, &dispatchd_uid,
+                                       &dispatchd_gid) != 0) )
+            lpjs_debug("%s(): dispatchd does not accept forwarded notices.\n",
+                       __FUNCTION__);
+        else if ( lpjs_send_munge(compd_msg_fd, munge_payload, lpjs_no_close)
+                    == LPJS_MSG_SENT )
+        {
+            lpjs_debug("%s(): Forwarded %s\n", __FUNCTION__,
+                       munge_payload + 1);
+            lpjs_send_munge(msg_fd, LPJS_NODE_AUTHORIZED_MSG, lpjs_no_close);
+        }
+        free(munge_payload);
+    }
+    
+    lpjs_forget_acks(msg_fd);
+    lpjs_local_peer_end(msg_fd);
+    close(msg_fd);
+}
+
+
 /***************************************************************************
  *  Description:
  *  
@@ -608,6 +876,7 @@ int     lpjs_send_chaperone_status_loop(node_list_t *node_list,
  *  History: 
  *  Date        Name        Modification
  *  2024-03-10  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Record chaperone for checkin reports
  ***************************************************************************/
 
 int     lpjs_run_chaperone(job_t *job, const char *script_buff,
@@ -787,6 +1056,12 @@ int     lpjs_run_chaperone(job_t *job, const char *script_buff,
          *  don't want dispatchd stuck waiting.
          */
         
+        // Prune finished jobs and record this one for the next checkin.
+        // Do this first, so dispatchd never knows of a chaperone that
+        // a restarted compd would not report.
+        lpjs_compd_live_jobs(NULL);
+        lpjs_compd_save_chaperone(job, chaperone_pid);
+        
         lpjs_debug("%s(): Sending chaperone forked verification, pid = %d.\n",
                 __FUNCTION__, chaperone_pid);
         snprintf(chaperone_response, LPJS_MSG_LEN_MAX + 1,
@@ -848,14 +1123,19 @@ void    lpjs_chown(job_t *job, const char *path)
  *  History: 
  *  Date        Name        Modification
  *  2024-05-04  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Reap all exited children, signals may merge
  ***************************************************************************/
 
 void    sigchld_handler(int s2)
 
 {
-    int     status;
+    int     status,
+            saved_errno = errno;
     
-    wait(&status);
+    // Unreaped chaperones would look alive to lpjs_compd_live_jobs()
+    while ( waitpid(-1, &status, WNOHANG) > 0 )
+        ;
+    errno = saved_errno;
 }
 
 
@@ -896,3 +1176,170 @@ int     lpjs_remove_old_temp_dirs()
     return xt_spawnlp(P_WAIT, P_ECHO, NULL, NULL, NULL,
                 PREFIX "/libexec/lpjs/SMI/remove-old-temp-dirs", NULL);
 }
+
+
+/***************************************************************************
+ *  Description:
+ *      Record a launched chaperone in LPJS_COMPD_JOBS_DIR, so it can
+ *      be reported to dispatchd at checkin, even after compd restarts.
+ *      The file holds the job specs in wire.h format.
+ *
+ *  Returns:
+ *      0 on success, -1 on failure
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Make room for the temp file suffix
+ ***************************************************************************/
+
+int     lpjs_compd_save_chaperone(job_t *job, pid_t chaperone_pid)
+
+{
+    char            buff[LPJS_JOB_MSG_SIZE(0)],
+                    path[PATH_MAX + 1],
+                    tmp_path[PATH_MAX + 5];     // path + ".tmp"
+    wire_writer_t   writer;
+    ssize_t         len;
+    int             fd;
+    
+    job_set_chaperone_pid(job, chaperone_pid);
+    wire_writer_init(&writer, buff, sizeof(buff));
+    job_write_to_wire(job, &writer);
+    if ( (len = wire_writer_len(&writer)) == -1 )
+    {
+        lpjs_log("%s(): Error: Job specs too large.\n", __FUNCTION__);
+        return -1;
+    }
+    
+    // Write a temp file and rename, so checkin never sees a partial file
+    snprintf(path, PATH_MAX + 1, "%s/%lu", LPJS_COMPD_JOBS_DIR,
+             job_get_job_id(job));
+    snprintf(tmp_path, PATH_MAX + 5, "%s.tmp", path);
+    if ( (fd = open(tmp_path, O_WRONLY|O_CREAT|O_TRUNC, 0600)) == -1 )
+    {
+        lpjs_log("%s(): Error: Cannot create %s: %s\n", __FUNCTION__,
+                 tmp_path, strerror(errno));
+        return -1;
+    }
+    if ( write(fd, buff, len) != len )
+    {
+        lpjs_log("%s(): Error: Cannot write %s: %s\n", __FUNCTION__,
+                 tmp_path, strerror(errno));
+        close(fd);
+        unlink(tmp_path);
+        return -1;
+    }
+    close(fd);
+    if ( rename(tmp_path, path) != 0 )
+    {
+        lpjs_log("%s(): Error: Cannot rename %s: %s\n", __FUNCTION__,
+                 tmp_path, strerror(errno));
+        unlink(tmp_path);
+        return -1;
+    }
+    return 0;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Scan LPJS_COMPD_JOBS_DIR for jobs whose chaperone is still
+ *      running, removing the records of those that have exited.
+ *      If writer is not NULL, append a WIRE_TAG_NODE_LIVE_JOB field
+ *      with the specs of each live job, followed by the count in
+ *      WIRE_TAG_NODE_LIVE_JOBS.  The count is sent only if every live
+ *      job fit in the message, since dispatchd treats jobs missing
+ *      from a complete report as lost.
+ *
+ *  Returns:
+ *      The number of live jobs, or -1 if the directory cannot be read
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     lpjs_compd_live_jobs(wire_writer_t *writer)
+
+{
+    DIR             *dir;
+    struct dirent   *entry;
+    char            buff[LPJS_JOB_MSG_SIZE(0)],
+                    path[PATH_MAX + 1];
+    job_t           *job;
+    ssize_t         len;
+    pid_t           pid;
+    int             fd,
+                    live = 0;
+    bool            complete = true;
+    
+    if ( (dir = opendir(LPJS_COMPD_JOBS_DIR)) == NULL )
+    {
+        lpjs_log("%s(): Error: Cannot open %s: %s\n", __FUNCTION__,
+                 LPJS_COMPD_JOBS_DIR, strerror(errno));
+        return -1;
+    }
+    
+    while ( (entry = readdir(dir)) != NULL )
+    {
+        if ( entry->d_name[0] == '.' )
+            continue;
+        snprintf(path, PATH_MAX + 1, "%s/%s", LPJS_COMPD_JOBS_DIR,
+                 entry->d_name);
+        // Leftover temp file from a crash during lpjs_compd_save_chaperone()
+        if ( ! xt_strisint(entry->d_name, 10) )
+        {
+            unlink(path);
+            continue;
+        }
+        
+        len = -1;
+        if ( (fd = open(path, O_RDONLY)) != -1 )
+        {
+            len = read(fd, buff, sizeof(buff));
+            close(fd);
+        }
+        job = job_new();
+        if ( (len < 1) || (job_read_from_wire(job, buff, len) != 0) )
+        {
+            lpjs_log("%s(): Error: Removing unreadable %s.\n",
+                     __FUNCTION__, path);
+            unlink(path);
+            job_free(&job);
+            continue;
+        }
+        
+        // EPERM means the process exists, but belongs to another user
+        pid = job_get_chaperone_pid(job);
+        if ( (pid < 1) || ((kill(pid, 0) == -1) && (errno == ESRCH)) )
+        {
+            lpjs_debug("%s(): Job %lu chaperone %d has exited.\n",
+                       __FUNCTION__, job_get_job_id(job), pid);
+            unlink(path);
+        }
+        else
+        {
+            ++live;
+            if ( writer == NULL )
+                ;
+            else if ( wire_writer_room(writer) >= len +
+                      2 * WIRE_FIELD_HEADER_LEN + sizeof(uint64_t) )
+                wire_put_bytes(writer, WIRE_TAG_NODE_LIVE_JOB, buff, len);
+            else
+                complete = false;
+        }
+        job_free(&job);
+    }
+    closedir(dir);
+    
+    if ( writer != NULL )
+    {
+        if ( complete )
+            wire_put_uint(writer, WIRE_TAG_NODE_LIVE_JOBS, live);
+        else
+            lpjs_log("%s(): Error: Too many live jobs for checkin, "
+                     "dispatchd will not reconcile.\n", __FUNCTION__);
+    }
+    return live;
+}
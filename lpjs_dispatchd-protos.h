@@ -1,16 +1,31 @@
 /* lpjs_dispatchd.c */
 int lpjs_process_events(node_list_t *node_list);
 void    lpjs_log_job(job_list_t *job_list, const char *hostname, unsigned long job_id, int exit_status, size_t peak_rss);
-void lpjs_check_comp_fds(fd_set *read_fds, node_list_t *node_list, job_list_t *running_jobs);
+void lpjs_check_comp_fds(fd_set *read_fds, node_list_t *node_list, job_list_t *pending_jobs, job_list_t *running_jobs);
 int lpjs_listen(struct sockaddr_in *server_address);
 int lpjs_check_listen_fd(int listen_fd, fd_set *read_fds, node_list_t *node_list, job_list_t *pending_jobs, job_list_t *running_jobs);
-void lpjs_process_compute_node_checkin(int msg_fd, char *incoming_msg, node_list_t *node_list, uid_t munge_uid, gid_t munge_gid);
-int lpjs_submit(int msg_fd, const char *incoming_msg, node_list_t *node_list, job_list_t *pending_jobs, job_list_t *running_jobs, uid_t munge_uid, gid_t munge_gid);
+void lpjs_process_chaperone_status(node_list_t *node_list, job_list_t *pending_jobs, char *payload);
+void lpjs_process_job_completion(node_list_t *node_list, job_list_t *pending_jobs, job_list_t *running_jobs, char *payload);
+void lpjs_process_compute_node_checkin(int msg_fd, char *munge_payload, size_t payload_len, node_list_t *node_list, job_list_t *pending_jobs, job_list_t *running_jobs, uid_t munge_uid, gid_t munge_gid);
+void lpjs_reconcile_compute_node(node_list_t *node_list, job_list_t *pending_jobs, job_list_t *running_jobs, node_t *node, const void *specs, size_t specs_len);
+int lpjs_send_job_list(int msg_fd, job_list_t *pending_jobs, job_list_t *running_jobs);
+int lpjs_submit(int msg_fd, const char *incoming_msg, size_t msg_len, node_list_t *node_list, job_list_t *pending_jobs, job_list_t *running_jobs, uid_t munge_uid, gid_t munge_gid);
+int lpjs_submit_batch(int msg_fd, const char *incoming_msg, size_t msg_len, node_list_t *node_list, job_list_t *pending_jobs, job_list_t *running_jobs, uid_t munge_uid, gid_t munge_gid);
+job_t *lpjs_read_submission(const char *msg, size_t msg_len, const char **script_text);
+unsigned lpjs_spool_submission(lpjs_stream_t *stream, lpjs_spool_t *spool, job_t *submission, const char *script_text, uid_t munge_uid, gid_t munge_gid);
+void lpjs_spool_finish(lpjs_stream_t *stream, lpjs_spool_t *spool, int commit_status, node_list_t *node_list, job_list_t *pending_jobs, job_list_t *running_jobs, bool name_scripts);
+size_t lpjs_drain_intake(node_list_t *node_list, job_list_t *pending_jobs, job_list_t *running_jobs, size_t max_jobs);
 int lpjs_cancel(int msg_fd, const char *incoming_msg, node_list_t *node_list, job_list_t *pending_jobs, job_list_t *running_jobs, uid_t munge_uid, gid_t munge_gid);
 int lpjs_kill_processes(node_list_t *node_list, job_t *job);
-int lpjs_queue_job(int msg_fd, job_list_t *pending_jobs, job_t *job, unsigned long job_array_index, const char *script_text);
+int lpjs_queue_job(job_t *job, unsigned long job_id, unsigned long job_array_index, const char *script_text);
+int lpjs_export_pending_job(job_t *job, const char *script_text);
+int lpjs_export_running_job(job_t *job);
 int lpjs_update_job(node_list_t *node_list, char *payload, job_list_t *pending_jobs, job_list_t *running_jobs);
 int lpjs_load_job_list(job_list_t *job_list, node_list_t *node_list, char *spool_dir);
+unsigned long lpjs_load_next_job_id(void);
 void lpjs_dispatchd_terminate_handler(int s2);
+void lpjs_dispatchd_shutdown(void);
+int lpjs_reload_request(int msg_fd, node_list_t *node_list, uid_t munge_uid);
+void lpjs_dispatchd_reload_handler(int s2);
 void lpjs_dispatchd_sigpipe(int s2);
 int adjust_resources(node_list_t *node_list, job_list_t *job_list, const char *hostname, unsigned long job_id, node_resource_t direction);
@@ -22,6 +22,7 @@
 #include <sys/socket.h>
 #include <sys/select.h>
 #include <netinet/in.h>
+#include <sys/un.h>       // sockaddr_un
 #include <signal.h>
 #include <errno.h>
 #include <stdbool.h>
@@ -44,6 +45,12 @@
 #include "config.h"
 #include "scheduler.h"
 #include "network.h"
+#include "session.h"
+#include "wire.h"
+#include "journal.h"
+#include "cleaner.h"
+#include "intake.h"
+#include "job-history.h"
 #include "misc.h"
 #include "lpjs_dispatchd.h"
 
@@ -58,7 +65,6 @@ int     main(int argc,char *argv[])
     // Must be global for signal handler
     // FIXME: Maybe use ucontext to pass these to handler
     extern FILE         *Log_stream;
-    extern FILE         *Job_history_stream;
     extern node_list_t  *Node_list;
 
     Node_list = node_list;
@@ -129,17 +135,31 @@ int     main(int argc,char *argv[])
             }
             daemon_gid = gr_ent->gr_gid;
         }
+        else if ( strcmp(argv[arg], "--spool-export") == 0 )
+        {
+            // Also keep per-job directories under pending and running
+            lpjs_journal_set_spool_export(true);
+        }
         else
         {
-            fprintf (stderr, "Usage: %s [--daemonize|--log-output] [--user username] [--group groupname]\n", argv[0]);
+            fprintf (stderr, "Usage: %s [--daemonize|--log-output] [--user username] [--group groupname] [--spool-export]\n", argv[0]);
             return EX_USAGE;
         }
     }
-    Job_history_stream = lpjs_log_output(LPJS_JOB_HISTORY, "a");
+    
+    // Job history segments, readable by all for lpjs history
+    if ( xt_rmkdir(LPJS_HISTORY_DIR, 0755) != 0 )
+    {
+        fprintf(stderr, "Cannot create %s: %s\n", LPJS_HISTORY_DIR, strerror(errno));
+        return EX_CANTCREAT;
+    }
     
     // Make log file writable to daemon owner after root creates it
+    // History segments are replaced by rename()
     chown(LPJS_LOG_DIR, daemon_uid, daemon_gid);
     chown(LPJS_DISPATCHD_LOG, daemon_uid, daemon_gid);
+    chown(LPJS_HISTORY_DIR, daemon_uid, daemon_gid);
+    chown(LPJS_HISTORY_HOT, daemon_uid, daemon_gid);
     
     // Go where daemon has write permissions, so a core can be dumped
     // in the event of a crash
@@ -160,19 +180,23 @@ int     main(int argc,char *argv[])
     }
     
     // Make spool dir writable to daemon owner after root creates it
+    // The journal and snapshot are replaced by rename()
+    chown(LPJS_SPOOL_DIR, daemon_uid, daemon_gid);
     chown(LPJS_PENDING_DIR, daemon_uid, daemon_gid);
     chown(LPJS_RUNNING_DIR, daemon_uid, daemon_gid);
-    chown(LPJS_SPOOL_DIR "/next-job", daemon_uid, daemon_gid);
+    chown(LPJS_NEXT_JOB_FILE, daemon_uid, daemon_gid);
+    chown(LPJS_JOURNAL_FILE, daemon_uid, daemon_gid);
+    chown(LPJS_SNAPSHOT_FILE, daemon_uid, daemon_gid);
     
     // Just in case somebody borked perms
     chmod(PREFIX "/var", 0755);
     chmod(LPJS_PENDING_DIR, 0755);
     chmod(LPJS_RUNNING_DIR, 0755);
     chmod(LPJS_SPOOL_DIR, 0755);
-    chmod(LPJS_SPOOL_DIR "/next-job", 0755);
+    chmod(LPJS_NEXT_JOB_FILE, 0755);
     chmod(LPJS_COMPD_LOG, 0755);
     chmod(LPJS_DISPATCHD_LOG, 0755);
-    chmod(LPJS_JOB_HISTORY, 0755);
+    chmod(LPJS_HISTORY_DIR, 0755);
     
 /*
  *  systemd needs a pid file for forking daemons.  BSD systems don't
@@ -182,18 +206,20 @@ int     main(int argc,char *argv[])
  *  because they crashed or were terminated with SIGKILL.
  */
 
+    // Holds LPJS_LOCAL_SOCKET, which only the daemon user may create
+    if ( xt_rmkdir(LPJS_RUN_DIR, 0755) != 0 )
+        return EX_CANTCREAT;
+    chown(LPJS_RUN_DIR, daemon_uid, daemon_gid);
+    chmod(LPJS_RUN_DIR, 0755);
+    
 #ifdef __linux__
     int         status;
     extern char Pid_path[PATH_MAX + 1];
     
-    if ( xt_rmkdir(LPJS_RUN_DIR, 0755) != 0 )
-        return EX_CANTCREAT;
-    
     snprintf(Pid_path, PATH_MAX + 1, "%s/lpjs_dispatchd.pid", LPJS_RUN_DIR);
     status = xt_create_pid_file(Pid_path, Log_stream);
     if ( status != EX_OK )
         return status;
-    chown(LPJS_RUN_DIR, daemon_uid, daemon_gid);
     chown(Pid_path, daemon_uid, daemon_gid);
 #endif
 
@@ -225,6 +251,10 @@ int     main(int argc,char *argv[])
     // Read etc/lpjs/config, created by lpjs-admin
     lpjs_load_config(node_list, LPJS_CONFIG_ALL, Log_stream);
     
+    // As the daemon user, so that new segments are owned by it
+    if ( lpjs_history_open() != 0 )
+        return EX_CANTCREAT;
+    
     /*
      *  bind(): address already in use during testing with frequent restarts.
      *  Best approach is to ensure that client completes a close
@@ -233,9 +263,25 @@ int     main(int argc,char *argv[])
      *  Copy saved in ./bind-address-already-in-use.pdf
      *  FIXME: Does this handler actually help?  FDs are closed
      *  upon process termination anyway.
+     *
+     *  Like SIGHUP below, the handler only sets a flag, so that
+     *  lpjs_process_events() can save a snapshot of the queue first.
      */
-    signal(SIGINT, lpjs_dispatchd_terminate_handler);
-    signal(SIGTERM, lpjs_dispatchd_terminate_handler);
+    struct sigaction    term_action = { 0 };
+    term_action.sa_handler = lpjs_dispatchd_terminate_handler;
+    sigemptyset(&term_action.sa_mask);
+    sigaction(SIGINT, &term_action, NULL);
+    sigaction(SIGTERM, &term_action, NULL);
+    
+    /*
+     *  SIGHUP reloads etc/lpjs/config.  The handler only sets a flag,
+     *  which is checked by lpjs_process_events().  Don't use SA_RESTART,
+     *  so that select() is interrupted and the reload happens right away.
+     */
+    struct sigaction    hup_action = { 0 };
+    hup_action.sa_handler = lpjs_dispatchd_reload_handler;
+    sigemptyset(&hup_action.sa_mask);
+    sigaction(SIGHUP, &hup_action, NULL);
     
     /*
      *  dispatchd shouldn't be trying to write to broken pipes, but
@@ -250,31 +296,60 @@ int     main(int argc,char *argv[])
 
 /***************************************************************************
  *  Description:
- *      Listen for messages on LPJS_TCP_PORT and respond with either info
- *      (lpjs-nodes, lpjs-jobs, etc.) or actions (lpjs-submit).
+ *      Listen for messages on LPJS_TCP_PORT and LPJS_LOCAL_SOCKET and
+ *      respond with either info (lpjs-nodes, lpjs-jobs, etc.) or
+ *      actions (lpjs-submit).
  *
  *  History: 
  *  Date        Name        Modification
  *  2021-09-25  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Also listen on LPJS_LOCAL_SOCKET
+ *  2026-10-19  Jason Bacon Load queue from journal, compact periodically
+ *  2026-10-19  Jason Bacon Remove exported spool directories when idle
+ *  2026-10-19  Jason Bacon Snapshot the queue before terminating
+ *  2026-10-19  Jason Bacon Queue acknowledged submissions when idle
+ *  2026-10-19  Jason Bacon Report select() errors
  ***************************************************************************/
 
 int     lpjs_process_events(node_list_t *node_list)
 
 {
-    int                 listen_fd;
+    int                 listen_fd,
+                        local_listen_fd;
     struct sockaddr_in  server_address = { 0 };
     // job_list_new() terminates process if malloc fails, no need to check
     job_list_t          *pending_jobs = job_list_new(),
                         *running_jobs = job_list_new();
+    // Per-user/group/state totals for both lists, kept current by job-list.c
+    job_stats_t         *job_stats = job_stats_new();
 
-    lpjs_load_job_list(pending_jobs, node_list, LPJS_PENDING_DIR);
-    lpjs_load_job_list(running_jobs, node_list, LPJS_RUNNING_DIR);
+    job_list_set_stats(pending_jobs, job_stats);
+    job_list_set_stats(running_jobs, job_stats);
+    if ( lpjs_journal_exists() )
+    {
+        if ( lpjs_journal_load(pending_jobs, running_jobs, node_list)
+                != LPJS_SUCCESS )
+            return EX_DATAERR;
+    }
+    else
+    {
+        // First start since queue state moved from the spool directories
+        lpjs_load_job_list(pending_jobs, node_list, LPJS_PENDING_DIR);
+        lpjs_load_job_list(running_jobs, node_list, LPJS_RUNNING_DIR);
+        lpjs_journal_set_next_job_id(lpjs_load_next_job_id());
+    }
+    
+    // Fold what was loaded into a new snapshot and open the journal
+    if ( lpjs_journal_compact(pending_jobs, running_jobs) != LPJS_SUCCESS )
+        return EX_CANTCREAT;
     
     /*
      *  Step 1: Create a socket for listening for new connections.
      */
     
     listen_fd = lpjs_listen(&server_address);
+    // -1 if unavailable, commands fall back to TCP
+    local_listen_fd = lpjs_listen_local(LPJS_LOCAL_SOCKET);
 
     /*
      *  Step 2: Accept new connections, and create a separate socket
@@ -284,7 +359,52 @@ int     lpjs_process_events(node_list_t *node_list)
     while ( true )
     {
         fd_set  read_fds;
-        int     nfds, highest_fd;
+        int     nfds, highest_fd, ready;
+        bool    deferred = false,
+                intake,
+                cleanup;
+        struct timeval  no_wait = { 0, 0 };
+        extern volatile sig_atomic_t    Reload_config,
+                                        Terminate;
+        
+        // Restart then only needs to read the snapshot
+        if ( Terminate )
+        {
+            // The snapshot is taken from the job lists
+            lpjs_drain_intake(NULL, pending_jobs, running_jobs,
+                              lpjs_intake_queued());
+            lpjs_journal_compact(pending_jobs, running_jobs);
+            lpjs_dispatchd_shutdown();
+        }
+        
+        if ( Reload_config )
+        {
+            char    report[LPJS_MSG_LEN_MAX + 1];
+            
+            Reload_config = 0;
+            lpjs_reload_config(node_list, report, LPJS_MSG_LEN_MAX + 1);
+            // New nodes or higher limits may allow more jobs to run
+            lpjs_dispatch_jobs(node_list, pending_jobs, running_jobs);
+        }
+        
+        // Keep restart time and disk use proportional to the queue
+        if ( lpjs_journal_compact_due() )
+        {
+            lpjs_drain_intake(node_list, pending_jobs, running_jobs,
+                              lpjs_intake_queued());
+            lpjs_journal_compact(pending_jobs, running_jobs);
+        }
+        
+        // New jobs also wait for an idle moment unless they fall behind
+        if ( lpjs_intake_queued() > LPJS_INTAKE_QUEUE_MAX )
+            lpjs_drain_intake(node_list, pending_jobs, running_jobs,
+                              LPJS_INTAKE_BATCH);
+        intake = (lpjs_intake_queued() > 0);
+        
+        // Spool cleanup waits for an idle moment unless it falls behind
+        if ( lpjs_cleaner_queued() > LPJS_CLEANER_QUEUE_MAX )
+            lpjs_cleaner_run(LPJS_CLEANER_BATCH);
+        cleanup = (lpjs_cleaner_queued() > 0);
         
         // poll() is generally preferable to select(), because it checks
         // only fds explicitly listed, while select() checks every fd from
@@ -298,6 +418,12 @@ int     lpjs_process_events(node_list_t *node_list)
         
         FD_SET(listen_fd, &read_fds);
         highest_fd = listen_fd;
+        if ( local_listen_fd != -1 )
+        {
+            FD_SET(local_listen_fd, &read_fds);
+            if ( local_listen_fd > highest_fd )
+                highest_fd = local_listen_fd;
+        }
         
         for (unsigned c = 0; c < node_list_get_compute_node_count(node_list); ++c)
         {
@@ -309,6 +435,8 @@ int     lpjs_process_events(node_list_t *node_list)
                 FD_SET(node_get_msg_fd(node), &read_fds);
                 if ( node_get_msg_fd(node) > highest_fd )
                     highest_fd = node_get_msg_fd(node);
+                if ( lpjs_recv_pending(node_get_msg_fd(node)) )
+                    deferred = true;
             }
         }
 
@@ -322,24 +450,47 @@ int     lpjs_process_events(node_list_t *node_list)
          */
         nfds = highest_fd + 1;
         
+        // Don't block if notifications were already read from a compd,
+        // or if there are new jobs to queue or spool cleanup to do when
+        // no input is waiting
         lpjs_log("%s(): Waiting for input events...\n", __FUNCTION__);
-        if ( select(nfds, &read_fds, NULL, NULL, LPJS_NO_SELECT_TIMEOUT) > 0 )
+        ready = select(nfds, &read_fds, NULL, NULL,
+                       deferred || intake || cleanup ? &no_wait :
+                       LPJS_NO_SELECT_TIMEOUT);
+        if ( (ready > 0) || deferred )
         {
             //lpjs_debug("%s(): Checking comp fds...\n", __FUNCTION__);
-            // compd doesn't presently initiate conversations on
-            // the persistend socket.  It is used only for dispatchd
-            // to send new jobs to compd.  This function only serves
-            // to check for lost connections with compd daemons.
-            lpjs_check_comp_fds(&read_fds, node_list, running_jobs);
+            // compd forwards chaperone notifications on the persistent
+            // socket, and we also detect lost compd connections here.
+            if ( ready < 0 )
+                FD_ZERO(&read_fds);
+            lpjs_check_comp_fds(&read_fds, node_list, pending_jobs,
+                                running_jobs);
             
             //lpjs_debug("%s(): Checking listen fd...\n", __FUNCTION__);
             // Check FD_ISSET before calling function to avoid overhead
             if ( FD_ISSET(listen_fd, &read_fds) )
                 lpjs_check_listen_fd(listen_fd, &read_fds,
                                      node_list, pending_jobs, running_jobs);
+            if ( (local_listen_fd != -1) &&
+                 FD_ISSET(local_listen_fd, &read_fds) )
+                lpjs_check_listen_fd(local_listen_fd, &read_fds,
+                                     node_list, pending_jobs, running_jobs);
         }
+        else if ( (ready < 0) && (errno == EINTR) )
+            continue;   // Signal such as SIGHUP, check flags at loop top
+        else if ( (ready == 0) && intake )
+            lpjs_drain_intake(node_list, pending_jobs, running_jobs,
+                              LPJS_INTAKE_BATCH);
+        else if ( (ready == 0) && cleanup )
+            lpjs_cleaner_run(LPJS_CLEANER_BATCH);
+        else if ( ready < 0 )
+            lpjs_log("%s(): Error: select() failed: %s\n", __FUNCTION__,
+                     strerror(errno));
+        // A zero timeout is only used when there is work to do
         else
-            lpjs_log("%s(): Bug: select() returned 0. This should never happen with no timeout.\n");
+            lpjs_log("%s(): Bug: select() timed out with nothing to do.\n",
+                     __FUNCTION__);
     }
     
     // Never actually get here, but make the compiler happy
@@ -356,30 +507,46 @@ int     lpjs_process_events(node_list_t *node_list)
  *  History: 
  *  Date        Name        Modification
  *  2021-09-28  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Record in the segmented job history
+ *  2026-10-19  Jason Bacon Record run time
  ***************************************************************************/
 
 void    lpjs_log_job(job_list_t *job_list, const char *hostname,
                     unsigned long job_id, int exit_status, size_t peak_rss)
 
 {
-    extern FILE *Job_history_stream;
-    job_t       *job;
-    size_t      index;
+    job_t               *job;
+    size_t              index;
+    history_record_t    record;
+    char                script[PATH_MAX + 1];
+    const char          *script_name;
     
     if ( (index = job_list_find_job_id(job_list, job_id)) != JOB_LIST_NOT_FOUND )
     {
         if ( (job = job_list_get_jobs_ae(job_list, index)) != NULL )
         {
-            // phys_mib_per_processor is MiB and peak_rss if KiB
-            fprintf(Job_history_stream, "%s %lu %d %zu %zu %d %d %s %s %s/%s\n",
-                    xt_str_localtime("%m-%d %H:%M:%S"),
-                    job_id, exit_status, peak_rss,
-                    job_get_phys_mib_per_processor(job) * 1024,
-                    job_get_processors_per_job(job),
-                    job_get_threads_per_process(job),
-                    hostname, job_get_user_name(job),
-                    job_get_submit_dir(job), job_get_script_name(job));
-            fflush(Job_history_stream);
+            // Match lpjs history --script, which strips ./ too
+            script_name = job_get_script_name(job);
+            if ( strncmp(script_name, "./", 2) == 0 )
+                script_name += 2;
+            snprintf(script, sizeof(script), "%s/%s",
+                     job_get_submit_dir(job), script_name);
+            record.time = time(NULL);
+            record.job_id = job_id;
+            record.exit_status = exit_status;
+            record.peak_rss = peak_rss;
+            record.pmem_mib = job_get_phys_mib_per_processor(job);
+            record.processors = job_get_processors_per_job(job);
+            record.threads = job_get_threads_per_process(job);
+            record.node = hostname;
+            record.user = job_get_user_name(job);
+            record.script = script;
+            // Jobs restored from an older snapshot have no start time
+            if ( job_get_start_time(job) != 0 )
+                record.run_time = record.time - job_get_start_time(job);
+            else
+                record.run_time = -1;
+            lpjs_history_append(&record);
         }
     }
 }
@@ -387,19 +554,22 @@ void    lpjs_log_job(job_list_t *job_list, const char *hostname,
 
 /***************************************************************************
  *  Description:
- *      Check all connected sockets for messages
+ *      Check all connected sockets for messages.  compd forwards
+ *      chaperone notifications on its persistent connection (see
+ *      lpjs_send_via_compd()).  Some may have been read already, while
+ *      waiting for a reply to a new job, and are not seen by select().
  *
  *  History: 
  *  Date        Name        Modification
  *  2024-01-22  Jason Bacon Factor out from lpjs_process_events()
+ *  2026-10-19  Jason Bacon Process notifications forwarded by compd
  ***************************************************************************/
 
 void    lpjs_check_comp_fds(fd_set *read_fds, node_list_t *node_list,
-                            job_list_t *running_jobs)
+                            job_list_t *pending_jobs, job_list_t *running_jobs)
 
 {
-    // Terminates process if malloc() fails, no check required
-    node_t  *node = node_new();
+    node_t  *node;
     int     fd;
     ssize_t bytes;
     char    *munge_payload;
@@ -413,7 +583,8 @@ void    lpjs_check_comp_fds(fd_set *read_fds, node_list_t *node_list,
     {
         node = node_list_get_compute_nodes_ae(node_list, c);
         fd = node_get_msg_fd(node);
-        if ( (fd != NODE_MSG_FD_NOT_OPEN) && FD_ISSET(fd, read_fds) )
+        if ( (fd != NODE_MSG_FD_NOT_OPEN) &&
+             (FD_ISSET(fd, read_fds) || lpjs_recv_pending(fd)) )
         {
             // lpjs_debug("Activity on fd %d\n", fd);
             
@@ -431,14 +602,37 @@ void    lpjs_check_comp_fds(fd_set *read_fds, node_list_t *node_list,
                 lpjs_log("%s(): Lost connection to %s.  Closing %d...\n",
                         __FUNCTION__, node_get_hostname(node), fd);
                 lpjs_wait_close(fd);
+                lpjs_discard_deferred(fd);
                 node_set_msg_fd(node, NODE_MSG_FD_NOT_OPEN);
                 node_set_state(node, "down");
             }
             else
             {
-                // At present, compd never messages dispatchd after checkin
+                // compd only forwards chaperone notifications
                 switch(munge_payload[0])
                 {
+                    case    LPJS_DISPATCHD_REQUEST_CHAPERONE_STATUS:
+                        lpjs_log("%s(): LPJS_DISPATCHD_REQUEST_CHAPERONE_STATUS via %s\n",
+                                 __FUNCTION__, node_get_hostname(node));
+                        lpjs_process_chaperone_status(node_list, pending_jobs,
+                                                      munge_payload + 1);
+                        break;
+                    
+                    case    LPJS_DISPATCHD_REQUEST_JOB_STARTED:
+                        lpjs_log("%s(): LPJS_DISPATCHD_REQUEST_JOB_STARTED via %s\n",
+                                 __FUNCTION__, node_get_hostname(node));
+                        lpjs_update_job(node_list, munge_payload + 1,
+                                        pending_jobs, running_jobs);
+                        break;
+                    
+                    case    LPJS_DISPATCHD_REQUEST_JOB_COMPLETE:
+                        lpjs_log("%s(): LPJS_DISPATCHD_REQUEST_JOB_COMPLETE via %s\n",
+                                 __FUNCTION__, node_get_hostname(node));
+                        lpjs_process_job_completion(node_list, pending_jobs,
+                                                    running_jobs,
+                                                    munge_payload + 1);
+                        break;
+                    
                     default:
                         lpjs_log("%s(): Error: Invalid notification on fd %d: %d\n",
                                 __FUNCTION__, fd, munge_payload[0]);
@@ -520,7 +714,6 @@ int     lpjs_listen(struct sockaddr_in *server_address)
 }
 
 
-
 /***************************************************************************
  *  Description
  *      Process events arriving on the listening socket
@@ -528,6 +721,9 @@ int     lpjs_listen(struct sockaddr_in *server_address)
  *  History: 
  *  Date        Name        Modification
  *  2024-01-22  Jason Bacon Factor out from lpjs_process_events()
+ *  2026-10-19  Jason Bacon Identify local connections by peer uid
+ *  2026-10-19  Jason Bacon Share notification handlers with compd path
+ *  2026-10-19  Jason Bacon Compress responses if the request allows
  ***************************************************************************/
 
 int     lpjs_check_listen_fd(int listen_fd, fd_set *read_fds,
@@ -536,21 +732,12 @@ int     lpjs_check_listen_fd(int listen_fd, fd_set *read_fds,
 
 {
     int             msg_fd,
-                    chaperone_status,
-                    exit_status;
+                    local;
     ssize_t         bytes;
-    size_t          peak_rss;
-    char            *munge_payload,
-                    *p,
-                    *compute_node,
-                    outgoing_msg[LPJS_MSG_LEN_MAX + 1];
+    char            *munge_payload;
     socklen_t       address_len = sizeof (struct sockaddr_in);
     uid_t           munge_uid;
     gid_t           munge_gid;
-    unsigned long   job_id;
-    node_t          *node;
-    int             items;
-    job_t           *job;
     struct sockaddr_in client_address = { 0 };
     
     bytes = 0;
@@ -564,9 +751,27 @@ int     lpjs_check_listen_fd(int listen_fd, fd_set *read_fds,
     }
     else
     {
-        lpjs_log("%s(): Accepted connection. fd = %d  addr = %s  port = %u\n",
-                 __FUNCTION__, msg_fd, inet_ntoa(client_address.sin_addr),
-                 client_address.sin_port);
+        // msg_fd may be reused from a connection closed with plain close()
+        lpjs_forget_acks(msg_fd);
+        session_end(msg_fd);
+        lpjs_discard_deferred(msg_fd);
+        lpjs_compress_enable(msg_fd, 0);
+        
+        // Records the peer uid for connections to LPJS_LOCAL_SOCKET
+        local = lpjs_local_peer_start(msg_fd);
+        if ( local == 1 )
+            lpjs_log("%s(): Accepted local connection. fd = %d\n",
+                     __FUNCTION__, msg_fd);
+        else if ( local == 0 )
+            lpjs_log("%s(): Accepted connection. fd = %d  addr = %s  port = %u\n",
+                     __FUNCTION__, msg_fd, inet_ntoa(client_address.sin_addr),
+                     client_address.sin_port);
+        else
+        {
+            // Can't identify the user, so can't authorize anything
+            close(msg_fd);
+            return -1;
+        }
 
         /* Read a message through the socket */
         // FIXME: Timeouts temporarily disabled to debug hung connections
@@ -606,6 +811,10 @@ int     lpjs_check_listen_fd(int listen_fd, fd_set *read_fds,
             return LPJS_RECV_FAILED;
         }
         
+        // Large responses, e.g. job lists, may be compressed if the
+        // request advertised support
+        lpjs_compress_accept(msg_fd, munge_payload, bytes);
+        
         /* Process request */
         switch(munge_payload[0])
         {
@@ -613,7 +822,9 @@ int     lpjs_check_listen_fd(int listen_fd, fd_set *read_fds,
                 lpjs_log("%s(): LPJS_DISPATCHD_REQUEST_COMPD_CHECKIN fd = %d\n",
                         __FUNCTION__, msg_fd);
                 lpjs_process_compute_node_checkin(msg_fd, munge_payload,
-                                                  node_list, munge_uid, munge_gid);
+                                                  bytes, node_list,
+                                                  pending_jobs, running_jobs,
+                                                  munge_uid, munge_gid);
                 lpjs_dispatch_jobs(node_list, pending_jobs, running_jobs);
                 // This connection is sustained, don't close it
                 break;
@@ -646,53 +857,65 @@ int     lpjs_check_listen_fd(int listen_fd, fd_set *read_fds,
                 lpjs_dispatch_jobs(node_list, pending_jobs, running_jobs);
                 break;
             
+            case    LPJS_DISPATCHD_REQUEST_RELOAD_CONFIG:
+                lpjs_log("%s(): LPJS_DISPATCHD_REQUEST_RELOAD_CONFIG fd = %d\n",
+                        __FUNCTION__, msg_fd);
+                lpjs_reload_request(msg_fd, node_list, munge_uid);
+                lpjs_wait_close(msg_fd);
+                
+                // New resources might be available
+                lpjs_dispatch_jobs(node_list, pending_jobs, running_jobs);
+                break;
+            
             case    LPJS_DISPATCHD_REQUEST_JOB_LIST:
                 lpjs_log("%s(): LPJS_DISPATCHD_REQUEST_JOB_STATUS fd = %d\n",
                         __FUNCTION__, msg_fd);
-             
-                // FIXME: Keep list sorted at all times instead of
-                // just for "lpjs jobs" output?
-                job_list_sort(running_jobs);
                 
-                // FIXME: factor out to lpjs_send_job_list(), check
-                // all messages for success
-                snprintf(outgoing_msg, LPJS_MSG_LEN_MAX + 1, "%zu running:\n\n",
-                                job_list_get_count(running_jobs));
-                if ( lpjs_send_munge(msg_fd, outgoing_msg,
-                                lpjs_dispatchd_safe_close) != LPJS_MSG_SENT )
-                {
-                    lpjs_log("%s(): Error: Failed to send \"Running\".\n", __FUNCTION__);
-                    break;
-                }
-                job_list_send_params(msg_fd, running_jobs);
-                snprintf(outgoing_msg, LPJS_MSG_LEN_MAX + 1, "\n%zu pending:\n\n",
-                                job_list_get_count(pending_jobs));
-                if ( lpjs_send_munge(msg_fd, outgoing_msg,
-                                lpjs_dispatchd_safe_close) != LPJS_MSG_SENT )
-                {
-                    lpjs_log("%s(): Failed to send \"Pending\".\n", __FUNCTION__);
-                    break;
-                }
-                job_list_send_params(msg_fd, pending_jobs);
+                // Include acknowledged jobs not yet queued
+                lpjs_drain_intake(node_list, pending_jobs, running_jobs,
+                                  lpjs_intake_queued());
                 // Need to send EOT after job list
-                lpjs_dispatchd_safe_close(msg_fd);
+                if ( lpjs_send_job_list(msg_fd, pending_jobs, running_jobs)
+                        == LPJS_MSG_SENT )
+                    lpjs_dispatchd_safe_close(msg_fd);
+                break;
+            
+            case    LPJS_DISPATCHD_REQUEST_JOB_SUMMARY:
+                lpjs_log("%s(): LPJS_DISPATCHD_REQUEST_JOB_SUMMARY fd = %d\n",
+                        __FUNCTION__, msg_fd);
+                lpjs_drain_intake(node_list, pending_jobs, running_jobs,
+                                  lpjs_intake_queued());
+                // Pending and running lists share one stats object
+                job_stats_send_summary(msg_fd, job_list_get_stats(pending_jobs));
+                lpjs_wait_close(msg_fd);
                 break;
             
             case    LPJS_DISPATCHD_REQUEST_SUBMIT:
                 lpjs_log("%s(): LPJS_DISPATCHD_REQUEST_SUBMIT fd = %d\n",
                         __FUNCTION__, msg_fd);
-                lpjs_submit(msg_fd, munge_payload, node_list,
+                lpjs_submit(msg_fd, munge_payload, bytes, node_list,
                             pending_jobs, running_jobs,
                             munge_uid, munge_gid);
                 lpjs_wait_close(msg_fd);
-                
-                lpjs_dispatch_jobs(node_list, pending_jobs, running_jobs);
+                // New jobs are dispatched once they leave the intake
+                break;
+            
+            case    LPJS_DISPATCHD_REQUEST_SUBMIT_BATCH:
+                lpjs_log("%s(): LPJS_DISPATCHD_REQUEST_SUBMIT_BATCH fd = %d\n",
+                        __FUNCTION__, msg_fd);
+                lpjs_submit_batch(msg_fd, munge_payload, bytes, node_list,
+                                  pending_jobs, running_jobs,
+                                  munge_uid, munge_gid);
+                lpjs_wait_close(msg_fd);
                 break;
             
             case    LPJS_DISPATCHD_REQUEST_CANCEL:
                 lpjs_log("%s(): LPJS_DISPATCHD_REQUEST_CANCEL fd = %d\n",
                         __FUNCTION__, msg_fd);
                 
+                // The job may not have left the intake yet
+                lpjs_drain_intake(node_list, pending_jobs, running_jobs,
+                                  lpjs_intake_queued());
                 lpjs_cancel(msg_fd, munge_payload + 1, node_list,
                             pending_jobs, running_jobs,
                             munge_uid, munge_gid);
@@ -709,59 +932,8 @@ int     lpjs_check_listen_fd(int listen_fd, fd_set *read_fds,
                 // lpjs_dispatchd_safe_close(msg_fd);
                 lpjs_log("%s(): LPJS_DISPATCHD_REQUEST_CHAPERONE_STATUS fd = %d\n",
                         __FUNCTION__, msg_fd);
-                p = munge_payload + 1;
-                compute_node = strsep(&p, " ");
-                sscanf(p, "%lu %d", &job_id, &chaperone_status);
-                lpjs_debug("%s(): job_id = %lu status = %d  compute_node = %s\n",
-                         __FUNCTION__, job_id, chaperone_status,
-                         compute_node);
-                
-                // Errors that occur before exec()ing script
-                switch(chaperone_status)
-                {
-                    case    LPJS_CHAPERONE_OK:
-                        lpjs_log("%s(): Chaperone status OK.\n",__FUNCTION__);
-                        // FIXME: Anything to do here?
-                        break;
-
-                    case    LPJS_CHAPERONE_SCRIPT_FAILED:
-                        lpjs_log("%s(): Error: Job script failed to start: %d\n",
-                                __FUNCTION__, chaperone_status);
-                        // Don't try to restart a script that failed
-                        // Either the user needs to fix it, or something
-                        // is not installed properly
-                        adjust_resources(node_list, pending_jobs,
-                                         compute_node,
-                                         job_id, NODE_RESOURCE_RELEASE);
-                        lpjs_remove_pending_job(pending_jobs, job_id);
-                        break;
-                    
-                    default:    // LPJS_CHAPERONE_OSERR and the rest...
-                        lpjs_log("%s(): Error %d detected on %s.\n"
-                                "See chaperone_status_t in network.h.\n",
-                                __FUNCTION__, chaperone_status, compute_node);
-                        
-                        lpjs_log("%s(): Releasing resourcesfor job %lu...\n",
-                                 __FUNCTION__, job_id);
-                        adjust_resources(node_list, pending_jobs,
-                                         compute_node,
-                                         job_id, NODE_RESOURCE_RELEASE);
-    
-                        // FIXME: Node should not come back up from here when daemons
-                        // are restarted.  It should require "lpjs nodes up nodename"
-                        // node_set_state(node, "malfunction");
-                        lpjs_log("%s(): Setting %s state to down...\n",
-                                 __FUNCTION__, compute_node);
-                        node = node_list_find_hostname(node_list, compute_node);
-                        if ( node == NULL )
-                            lpjs_log("%s(): Bug: No such node in list.\n",
-                                     __FUNCTION__);
-                        else
-                            node_set_state(node, "down");
-                        lpjs_debug("%s(): Done.\n");
-                        // FIXME: Make sure job state is reset, but don't remove
-                        break;
-                }
+                lpjs_process_chaperone_status(node_list, pending_jobs,
+                                              munge_payload + 1);
                 break;
 
             case    LPJS_DISPATCHD_REQUEST_JOB_STARTED:
@@ -790,44 +962,8 @@ int     lpjs_check_listen_fd(int listen_fd, fd_set *read_fds,
             case    LPJS_DISPATCHD_REQUEST_JOB_COMPLETE:
                 lpjs_log("%s(): LPJS_DISPATCHD_REQUEST_JOB_COMPLETE fd = %d\n",
                         __FUNCTION__, msg_fd);
-                p = munge_payload + 1;
-                compute_node = strsep(&p, " ");
-                lpjs_debug("%s(): compute_node = %s ", __FUNCTION__, compute_node);
-                node = node_list_find_hostname(node_list, compute_node);
-                if ( node == NULL )
-                {
-                    lpjs_log("%s(): Error: Invalid hostname in job completion report.\n",
-                            __FUNCTION__);
-                    break;
-                }
-                if ( (items = sscanf(p, "%lu %d %zu", &job_id,
-                                     &exit_status, &peak_rss)) != 3 )
-                {
-                    lpjs_log("%s(): Error: Got %d items reading job_id, processors, mem, status, peak_rss.\n",
-                            items);
-                    break;
-                }
-                lpjs_debug("%s(): job_id = %lu  status = %d  peak-RSS = %zu\n",
-                    __FUNCTION__, job_id, exit_status, peak_rss);
-                
-                adjust_resources(node_list, running_jobs, compute_node, job_id, NODE_RESOURCE_RELEASE);
-                
-                /*
-                 *      Write a completed job record to accounting log
-                 *      Note the job completion in the main log
-                 *      Do this before removing from running_jobs
-                 */
-                lpjs_log_job(running_jobs, compute_node, job_id, exit_status, peak_rss);
-                
-                if ( (job = lpjs_remove_running_job(running_jobs,
-                                                    job_id)) != NULL )
-                    job_free(&job);
-                else
-                    lpjs_log("%s(): Error: remove_running_job returned NULL.  This is a bug.\n",
-                            __FUNCTION__);
-                
-                // FIXME: Don't dispatch pending jobs that have been canceled
-                lpjs_dispatch_jobs(node_list, pending_jobs, running_jobs);
+                lpjs_process_job_completion(node_list, pending_jobs,
+                                            running_jobs, munge_payload + 1);
 
                 // This is a temporary connection from the chaperone
                 // for just this message.  Don't keep it open.
@@ -847,18 +983,189 @@ int     lpjs_check_listen_fd(int listen_fd, fd_set *read_fds,
 }
 
 
+/***************************************************************************
+ *  Description:
+ *      Process a chaperone status report, sent directly by the
+ *      chaperone or forwarded by compd.  payload follows the
+ *      LPJS_DISPATCHD_REQUEST_CHAPERONE_STATUS byte.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Factor out from lpjs_check_listen_fd()
+ ***************************************************************************/
+
+void    lpjs_process_chaperone_status(node_list_t *node_list,
+                                      job_list_t *pending_jobs, char *payload)
+
+{
+    char            *p = payload,
+                    *compute_node;
+    unsigned long   job_id;
+    int             chaperone_status;
+    node_t          *node;
+    
+    compute_node = strsep(&p, " ");
+    if ( (p == NULL) || (sscanf(p, "%lu %d", &job_id, &chaperone_status) != 2) )
+    {
+        lpjs_log("%s(): Error: Malformed chaperone status report.\n",
+                 __FUNCTION__);
+        return;
+    }
+    lpjs_debug("%s(): job_id = %lu status = %d  compute_node = %s\n",
+             __FUNCTION__, job_id, chaperone_status,
+             compute_node);
+    
+    // Errors that occur before exec()ing script
+    switch(chaperone_status)
+    {
+        case    LPJS_CHAPERONE_OK:
+            lpjs_log("%s(): Chaperone status OK.\n",__FUNCTION__);
+            // FIXME: Anything to do here?
+            break;
+
+        case    LPJS_CHAPERONE_SCRIPT_FAILED:
+            lpjs_log("%s(): Error: Job script failed to start: %d\n",
+                    __FUNCTION__, chaperone_status);
+            // Don't try to restart a script that failed
+            // Either the user needs to fix it, or something
+            // is not installed properly
+            adjust_resources(node_list, pending_jobs,
+                             compute_node,
+                             job_id, NODE_RESOURCE_RELEASE);
+            lpjs_remove_pending_job(pending_jobs, job_id);
+            break;
+        
+        default:    // LPJS_CHAPERONE_OSERR and the rest...
+            lpjs_log("%s(): Error %d detected on %s.\n"
+                    "See chaperone_status_t in network.h.\n",
+                    __FUNCTION__, chaperone_status, compute_node);
+            
+            lpjs_log("%s(): Releasing resourcesfor job %lu...\n",
+                     __FUNCTION__, job_id);
+            adjust_resources(node_list, pending_jobs,
+                             compute_node,
+                             job_id, NODE_RESOURCE_RELEASE);
+
+            // FIXME: Node should not come back up from here when daemons
+            // are restarted.  It should require "lpjs nodes up nodename"
+            // node_set_state(node, "malfunction");
+            lpjs_log("%s(): Setting %s state to down...\n",
+                     __FUNCTION__, compute_node);
+            node = node_list_find_hostname(node_list, compute_node);
+            if ( node == NULL )
+                lpjs_log("%s(): Bug: No such node in list.\n",
+                         __FUNCTION__);
+            else
+                node_set_state(node, "down");
+            lpjs_debug("%s(): Done.\n", __FUNCTION__);
+            // FIXME: Make sure job state is reset, but don't remove
+            break;
+    }
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Process a job completion report, sent directly by the chaperone
+ *      or forwarded by compd, and dispatch jobs to the freed resources.
+ *      payload follows the LPJS_DISPATCHD_REQUEST_JOB_COMPLETE byte.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Factor out from lpjs_check_listen_fd()
+ *  2026-10-19  Jason Bacon Report items read when there are no fields
+ ***************************************************************************/
+
+void    lpjs_process_job_completion(node_list_t *node_list,
+                                    job_list_t *pending_jobs,
+                                    job_list_t *running_jobs, char *payload)
+
+{
+    char            *p = payload,
+                    *compute_node;
+    unsigned long   job_id;
+    int             exit_status,
+                    items = 0;
+    size_t          peak_rss;
+    node_t          *node;
+    job_t           *job;
+    
+    compute_node = strsep(&p, " ");
+    lpjs_debug("%s(): compute_node = %s ", __FUNCTION__, compute_node);
+    node = node_list_find_hostname(node_list, compute_node);
+    if ( node == NULL )
+    {
+        lpjs_log("%s(): Error: Invalid hostname in job completion report.\n",
+                __FUNCTION__);
+        return;
+    }
+    if ( (p == NULL) || ((items = sscanf(p, "%lu %d %zu", &job_id,
+                                         &exit_status, &peak_rss)) != 3) )
+    {
+        lpjs_log("%s(): Error: Got %d items reading job_id, status, peak_rss.\n",
+                __FUNCTION__, items);
+        return;
+    }
+    lpjs_debug("%s(): job_id = %lu  status = %d  peak-RSS = %zu\n",
+        __FUNCTION__, job_id, exit_status, peak_rss);
+    
+    adjust_resources(node_list, running_jobs, compute_node, job_id, NODE_RESOURCE_RELEASE);
+    
+    /*
+     *      Write a completed job record to accounting log
+     *      Note the job completion in the main log
+     *      Do this before removing from running_jobs
+     */
+    lpjs_log_job(running_jobs, compute_node, job_id, exit_status, peak_rss);
+    
+    if ( (job = lpjs_remove_running_job(running_jobs,
+                                        job_id)) != NULL )
+        job_free(&job);
+    else
+        lpjs_log("%s(): Error: remove_running_job returned NULL.  This is a bug.\n",
+                __FUNCTION__);
+    
+    // FIXME: Don't dispatch pending jobs that have been canceled
+    lpjs_dispatch_jobs(node_list, pending_jobs, running_jobs);
+}
+
+
 /***************************************************************************
  *  Description:
  *      Process a compute node checkin request
  *
+ *      Current compds send their specs in the binary format described
+ *      in wire.h.  Compds that predate it send "%c%s %s", command,
+ *      protocol version, and text specs.  These are still accepted
+ *      with LPJS_PROTOCOL_VERSION_TEXT, so compute nodes can be
+ *      upgraded after dispatchd, and are sent jobs in text format.
+ *
+ *      If a binary checkin includes a session nonce, our own nonce
+ *      follows the authorization string in the reply, which only
+ *      munge_uid can decode, and later
+ *      messages on msg_fd are authenticated by the session (see
+ *      session.h) rather than munge.  The session remembers munge_uid,
+ *      so every later message is checked against the checkin user.
+ *
+ *      Binary checkins from current compds also list the jobs still
+ *      running on the node, see lpjs_reconcile_compute_node().
+ *
  *  History: 
  *  Date        Name        Modification
  *  2024-01-22  Jason Bacon Factor out from lpjs_process_events()
+ *  2026-10-19  Jason Bacon Accept binary and legacy text checkins
+ *  2026-10-19  Jason Bacon Establish session
+ *  2026-10-19  Jason Bacon Confirm compression methods
+ *  2026-10-19  Jason Bacon Reconcile running jobs
+ *  2026-10-19  Jason Bacon Restrict the reply to the compd user
  ***************************************************************************/
 
 void    lpjs_process_compute_node_checkin(int msg_fd,
                                           char *munge_payload,
+                                          size_t payload_len,
                                           node_list_t *node_list,
+                                          job_list_t *pending_jobs,
+                                          job_list_t *running_jobs,
                                           uid_t munge_uid, gid_t munge_gid)
 
 {
@@ -866,6 +1173,14 @@ void    lpjs_process_compute_node_checkin(int msg_fd,
     node_t      *new_node = node_new();
     extern FILE *Log_stream;
     char        *p, *compd_protocol_version;
+    const char  *wire_protocol_version;
+    wire_field_t    field;
+    const unsigned char *compd_nonce = NULL;
+    unsigned char   dispatchd_nonce[SESSION_NONCE_LEN];
+    char        reply[LPJS_MSG_LEN_MAX + 1];
+    size_t      reply_len;
+    wire_writer_t   writer;
+    unsigned    compress_methods;
     
     // FIXME: Check for duplicate checkins.  We should not get
     // a checkin request while one is already open
@@ -876,38 +1191,75 @@ void    lpjs_process_compute_node_checkin(int msg_fd,
             __FUNCTION__, munge_uid, munge_gid);
 
     /*
-     *  Validate version of connecting client.
-     *  Payload format = "%c%s %s", command, lpjs-version, content
+     *  Validate version of connecting client.  Binary messages carry
+     *  a schema version, checked by node_read_from_wire().
      *  FIXME: Just doing this for compd checkins as a test.
      *  Add to other connections as needed.
-     *  FIXME: Be less strict about version matching after development
-     *  slows and communication protocols are more stable.
      */
-    p = munge_payload + 1;
-    compd_protocol_version = strsep(&p, " ");
-    lpjs_debug("compd protocol version = %s  dispatchd protocol version = %s\n",
-                compd_protocol_version, LPJS_PROTOCOL_VERSION);
-    if ( strcmp(compd_protocol_version, LPJS_PROTOCOL_VERSION) != 0 )
-    {
-        lpjs_send_munge(msg_fd, LPJS_WRONG_PROTOCOL_VERSION_MSG, lpjs_dispatchd_safe_close);
-        lpjs_log("%s(): Warning: Checkin request from node with wrong LPJS protocol version: %s\n",
-                __FUNCTION__, compd_protocol_version);
-        lpjs_dispatchd_safe_close(msg_fd);
-        return; // FIXME: Return status?
+    if ( wire_is_binary(munge_payload + 1, payload_len - 1) )
+    {
+        if ( wire_find_field(munge_payload + 1, payload_len - 1,
+                             WIRE_TAG_PROTOCOL_VERSION, &field) == WIRE_OK )
+            wire_protocol_version = wire_get_str(&field);
+        else
+            wire_protocol_version = NULL;
+        lpjs_debug("compd protocol version = %s  dispatchd protocol version = %s\n",
+                   wire_protocol_version == NULL ? "unknown" : wire_protocol_version,
+                   LPJS_PROTOCOL_VERSION);
+        
+        // Get specs from node, +1 to skip command code
+        if ( node_read_from_wire(new_node, munge_payload + 1,
+                                 payload_len - 1) != 0 )
+        {
+            lpjs_send_munge(msg_fd, LPJS_WRONG_PROTOCOL_VERSION_MSG, lpjs_dispatchd_safe_close);
+            lpjs_log("%s(): Warning: Unusable checkin request from node with LPJS protocol version %s\n",
+                    __FUNCTION__, wire_protocol_version == NULL ?
+                    "unknown" : wire_protocol_version);
+            lpjs_dispatchd_safe_close(msg_fd);
+            node_free(&new_node);
+            return; // FIXME: Return status?
+        }
+        
+        if ( (wire_find_field(munge_payload + 1, payload_len - 1,
+                              WIRE_TAG_SESSION_NONCE, &field) == WIRE_OK) &&
+             (field.len == SESSION_NONCE_LEN) &&
+             (session_random_bytes(dispatchd_nonce, SESSION_NONCE_LEN) == 0) )
+            compd_nonce = field.value;
+    }
+    else
+    {
+        // Payload format = "%c%s %s", command, lpjs-version, content
+        p = munge_payload + 1;
+        compd_protocol_version = strsep(&p, " ");
+        lpjs_debug("compd protocol version = %s  dispatchd protocol version = %s\n",
+                    compd_protocol_version, LPJS_PROTOCOL_VERSION);
+        if ( (p == NULL) ||
+             (strcmp(compd_protocol_version, LPJS_PROTOCOL_VERSION_TEXT) != 0) )
+        {
+            lpjs_send_munge(msg_fd, LPJS_WRONG_PROTOCOL_VERSION_MSG, lpjs_dispatchd_safe_close);
+            lpjs_log("%s(): Warning: Checkin request from node with wrong LPJS protocol version: %s\n",
+                    __FUNCTION__, compd_protocol_version);
+            lpjs_dispatchd_safe_close(msg_fd);
+            node_free(&new_node);
+            return; // FIXME: Return status?
+        }
+        
+        // Get specs from node
+        if ( node_str_to_specs(new_node, p) != 0 )
+        {
+            lpjs_send_munge(msg_fd, LPJS_WRONG_PROTOCOL_VERSION_MSG, lpjs_dispatchd_safe_close);
+            lpjs_log("%s(): Warning: Malformed specs in checkin request.\n",
+                    __FUNCTION__);
+            lpjs_dispatchd_safe_close(msg_fd);
+            node_free(&new_node);
+            return;
+        }
+        lpjs_log("%s(): Node %s uses the legacy text protocol.\n",
+                 __FUNCTION__, node_get_hostname(new_node));
     }
     
     // FIXME: Record username of compd checkin.  If not root, then only
     // that user can submit jobs to the node.
-
-    /*
-     *  Get specs from node and add msg_fd
-     */
-    
-    // Extract specs from incoming_msg + 1
-    // node_recv_specs(new_node, msg_fd);
-    
-    // +1 to skip command code
-    node_str_to_specs(new_node, p);
     
     // Keep in sync with node_list_send_status()
     node_print_status_header(Log_stream);
@@ -935,105 +1287,647 @@ void    lpjs_process_compute_node_checkin(int msg_fd,
     }
     else
     {
-        lpjs_send_munge(msg_fd, LPJS_NODE_AUTHORIZED_MSG, lpjs_dispatchd_safe_close);
+        /*
+         *  Old compds compare the reply with strcmp(), so they
+         *  ignore our nonce after the '\0', but they never send
+         *  a nonce anyway.
+         */
+        reply_len = strlcpy(reply, LPJS_NODE_AUTHORIZED_MSG,
+                            LPJS_MSG_LEN_MAX + 1) + 1;
+        // Compression was enabled by lpjs_compress_accept() if the
+        // checkin advertised it, so let compd know we agree
+        compress_methods = lpjs_compress_methods(msg_fd);
+        if ( (compd_nonce != NULL) || (compress_methods != 0) )
+        {
+            wire_writer_init(&writer, reply + reply_len,
+                             LPJS_MSG_LEN_MAX + 1 - reply_len);
+            if ( compd_nonce != NULL )
+                wire_put_bytes(&writer, WIRE_TAG_SESSION_NONCE,
+                               dispatchd_nonce, SESSION_NONCE_LEN);
+            if ( compress_methods != 0 )
+                wire_put_uint(&writer, WIRE_TAG_COMPRESSION, compress_methods);
+            reply_len += wire_writer_len(&writer);
+        }
+        // Only compd may decode our nonce, so only it can derive the
+        // session keys, even if the checkin was captured and replayed
+        if ( (lpjs_send_munge_bin_to(msg_fd, reply, reply_len, munge_uid,
+                                     lpjs_dispatchd_safe_close)
+                == LPJS_MSG_SENT) && (compd_nonce != NULL) )
+        {
+            session_start(msg_fd, compd_nonce, dispatchd_nonce,
+                          SESSION_ROLE_DISPATCHD, munge_uid, munge_gid);
+            lpjs_log("%s(): Session established with %s.\n",
+                     __FUNCTION__, node_get_hostname(new_node));
+        }
         node_set_msg_fd(new_node, msg_fd);
         
         // Nodes were added to node_list by lpjs_load_config()
         // Just update the fields here
         node_list_update_compute(node_list, new_node);
+        
+        if ( wire_is_binary(munge_payload + 1, payload_len - 1) )
+            lpjs_reconcile_compute_node(node_list, pending_jobs, running_jobs,
+                        node_list_find_hostname(node_list,
+                                                node_get_hostname(new_node)),
+                        munge_payload + 1, payload_len - 1);
     }
+    // Binary specs point into munge_payload, which the caller frees
+    node_free(&new_node);
 }
 
 
 /***************************************************************************
  *  Description:
- *      Add a new submission to the queue
- *  
+ *      Reconcile the queue with the jobs a compute node reports as
+ *      still running at checkin, e.g. after dispatchd restarted.
+ *      Jobs we placed on the node that it no longer runs finished or
+ *      died while we were not listening.  They are recorded in the job
+ *      history with LPJS_EXIT_STATUS_LOST and their resources released.
+ *      Jobs it runs that we have no record of are adopted, so their
+ *      resources are not handed out again.  Only this node's capacity
+ *      is affected.
+ *
+ *      Compds that do not send WIRE_TAG_NODE_LIVE_JOBS, because they
+ *      predate it or could not list every job, are left alone.
+ *
+ *  Arguments:
+ *      node        Node in node_list that checked in
+ *      specs       Checkin message body, past the request code
+ *
  *  History: 
  *  Date        Name        Modification
- *  2024-01-22  Jason Bacon Factor out from lpjs_process_events()
+ *  2026-10-19  Jason Bacon Begin
  ***************************************************************************/
 
-int     lpjs_submit(int msg_fd, const char *incoming_msg,
-                    node_list_t *node_list,
-                    job_list_t *pending_jobs, job_list_t *running_jobs,
-                    uid_t munge_uid, gid_t munge_gid)
+void    lpjs_reconcile_compute_node(node_list_t *node_list,
+                                    job_list_t *pending_jobs,
+                                    job_list_t *running_jobs,
+                                    node_t *node,
+                                    const void *specs, size_t specs_len)
 
 {
-    char        script_path[PATH_MAX + 1],
-                *end,
-                *script_text;
-    // Terminates process if malloc() fails, no check required
-    job_t       *submission = job_new(),
-                *job;
-    int         c, job_array_index;
-    
-    // Payload from lpjs submit is a job description in JOB_SPEC_FORMAT
-    job_read_from_string(submission, incoming_msg + 1, &end);
-    
-    if ( strcmp(job_get_user_name(submission), "root") == 0 )
+    wire_reader_t   reader;
+    wire_field_t    field;
+    uint64_t        live_count;
+    job_t           **live_jobs,
+                    *job;
+    size_t          live = 0,
+                    c,
+                    l;
+    unsigned long   job_id;
+    const char      *hostname,
+                    *compute_node;
+    char            *node_name;
+    
+    if ( (node == NULL) ||
+         (wire_find_field(specs, specs_len, WIRE_TAG_NODE_LIVE_JOBS,
+                          &field) != WIRE_OK) ||
+         (wire_get_uint(&field, &live_count) != WIRE_OK) ||
+         (live_count > JOB_LIST_MAX_JOBS) )
+        return;
+    hostname = node_get_hostname(node);
+    
+    if ( (live_jobs = malloc((live_count + 1) * sizeof(*live_jobs))) == NULL )
     {
-        lpjs_log("%s(): Error: Rejecting job submission from root.\n",
-                __FUNCTION__);
-        // msg_fd is closed below
-        lpjs_send_munge(msg_fd, "Error: Cannot run jobs as root.\n", lpjs_no_close);
+        lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
+        exit(EX_UNAVAILABLE);
+    }
+    // Already validated by node_read_from_wire()
+    wire_reader_init(&reader, specs, specs_len);
+    while ( (wire_next_field(&reader, &field) == WIRE_OK) &&
+            (live < live_count) )
+    {
+        if ( field.tag != WIRE_TAG_NODE_LIVE_JOB )
+            continue;
+        // Terminates process if malloc() fails, no check required
+        job = job_new();
+        if ( job_read_from_wire(job, field.value, field.len) != 0 )
+        {
+            job_free(&job);
+            break;
+        }
+        live_jobs[live++] = job;
+    }
+    if ( live != live_count )
+    {
+        lpjs_log("%s(): Error: Malformed live job report from %s.\n",
+                 __FUNCTION__, hostname);
+        live_count = 0;     // Adopt nothing below
     }
     else
     {
-        // Should only be a newline between job specs and script
-        script_text = end + 1;
+        lpjs_log("%s(): %s reports %zu live jobs.\n", __FUNCTION__,
+                 hostname, live);
+        
+        // Backwards, since jobs are removed as we go
+        for (c = job_list_get_count(running_jobs); c-- > 0; )
+        {
+            job = job_list_get_jobs_ae(running_jobs, c);
+            compute_node = job_get_compute_node(job);
+            job_id = job_get_job_id(job);
+            if ( (compute_node == NULL) ||
+                 (strcmp(compute_node, hostname) != 0) )
+                continue;
+            for (l = 0; (l < live) &&
+                        (job_get_job_id(live_jobs[l]) != job_id); ++l)
+                ;
+            if ( l < live )
+                continue;
+            
+            lpjs_log("%s(): Error: Running job %lu is gone from %s.\n",
+                     __FUNCTION__, job_id, hostname);
+            adjust_resources(node_list, running_jobs, hostname, job_id,
+                             NODE_RESOURCE_RELEASE);
+            lpjs_log_job(running_jobs, hostname, job_id,
+                         LPJS_EXIT_STATUS_LOST, 0);
+            if ( (job = lpjs_remove_running_job(running_jobs, job_id)) != NULL )
+                job_free(&job);
+        }
         
-        snprintf(script_path, PATH_MAX + 1, "%s/%s",
-                 job_get_submit_dir(submission), job_get_script_name(submission));
-        for (c = 0; c < job_get_job_count(submission); ++c)
+        // Dispatched jobs whose chaperone died before checking in
+        for (c = job_list_get_count(pending_jobs); c-- > 0; )
         {
-            lpjs_log("%s(): Submit script %s:%s from %d, %d\n", __FUNCTION__,
-                    job_get_submit_node(submission), script_path, munge_uid,
-                    munge_gid);
-            job_array_index = c + 1;    // Job arrays are 1-based
+            job = job_list_get_jobs_ae(pending_jobs, c);
+            compute_node = job_get_compute_node(job);
+            job_id = job_get_job_id(job);
+            if ( (job_get_state(job) == JOB_STATE_PENDING) ||
+                 (compute_node == NULL) ||
+                 (strcmp(compute_node, hostname) != 0) )
+                continue;
+            for (l = 0; (l < live) &&
+                        (job_get_job_id(live_jobs[l]) != job_id); ++l)
+                ;
+            if ( l < live )
+                continue;
             
-            // Create a separate job_t object for each member of the job array
-            // job_dup() terminates process if malloc() fails
-            job = job_dup(submission);
-            lpjs_queue_job(msg_fd, pending_jobs, job, job_array_index, script_text);
+            lpjs_log("%s(): Error: Dispatched job %lu is gone from %s.\n",
+                     __FUNCTION__, job_id, hostname);
+            // Canceled jobs released their resources when canceled
+            if ( job_get_state(job) == JOB_STATE_DISPATCHED )
+            {
+                adjust_resources(node_list, pending_jobs, hostname, job_id,
+                                 NODE_RESOURCE_RELEASE);
+                lpjs_log_job(pending_jobs, hostname, job_id,
+                             LPJS_EXIT_STATUS_LOST, 0);
+            }
+            if ( (job = lpjs_remove_pending_job(pending_jobs, job_id)) != NULL )
+                job_free(&job);
         }
     }
     
-    lpjs_dispatchd_safe_close(msg_fd);
-    job_free(&submission);
-    
-    return EX_OK;
+    for (l = 0; l < live; ++l)
+    {
+        job = live_jobs[l];
+        job_id = job_get_job_id(job);
+        if ( (l >= live_count) ||
+             (job_list_find_job_id(running_jobs, job_id) != JOB_LIST_NOT_FOUND) ||
+             (job_list_find_job_id(pending_jobs, job_id) != JOB_LIST_NOT_FOUND) )
+        {
+            job_free(&job);
+            continue;
+        }
+        
+        lpjs_log("%s(): Adopting unknown job %lu running on %s.\n",
+                 __FUNCTION__, job_id, hostname);
+        if ( (node_name = strdup(hostname)) == NULL )
+        {
+            lpjs_log("%s(): Error: strdup() failed.\n", __FUNCTION__);
+            exit(EX_UNAVAILABLE);
+        }
+        free(job_get_compute_node(job));
+        job_set_compute_node(job, node_name);
+        job_set_state(job, JOB_STATE_RUNNING);
+        lpjs_journal_adopt(job);
+        job_list_add_job(running_jobs, job);
+        node_adjust_resources(node, job, NODE_RESOURCE_ALLOCATE);
+    }
+    free(live_jobs);
 }
 
 
 /***************************************************************************
  *  Description:
- *      Add a new submission to the queue
+ *      Stream running and pending jobs to msg_fd for lpjs jobs.
+ *      Jobs are packed into large frames, so the number of messages
+ *      and acknowledgements grows by one per LPJS_STREAM_FRAME_MAX
+ *      bytes rather than one per job.  The caller sends EOT.
  *
  *  Returns:
- *      LPJS_SUCCESS, etc.
- *  
+ *      LPJS_MSG_SENT on success, another LPJS_* code if msg_fd has failed
+ *
  *  History: 
  *  Date        Name        Modification
- *  2024-01-22  Jason Bacon Factor out from lpjs_process_events()
+ *  2026-10-19  Jason Bacon Factor out from lpjs_check_listen_fd()
  ***************************************************************************/
 
-int     lpjs_cancel(int msg_fd, const char *incoming_msg,
-                    node_list_t *node_list,
-                    job_list_t *pending_jobs, job_list_t *running_jobs,
-                    uid_t munge_uid, gid_t munge_gid)
+int     lpjs_send_job_list(int msg_fd,
+                           job_list_t *pending_jobs, job_list_t *running_jobs)
 
 {
-    unsigned long   job_id;
-    char            *end;
-    job_t           *job;
-    size_t          index;
-    char            *hostname;
+    lpjs_stream_t   stream;
     
-    lpjs_debug("%s(): Incoming = '%s'\n", __FUNCTION__, incoming_msg);
-    job_id = strtoul(incoming_msg, &end, 10);
-    if ( *end != '\0' )
-    {
+    lpjs_stream_init(&stream, msg_fd, lpjs_dispatchd_safe_close);
+    
+    // Job lists are kept sorted by job_list_add_job()
+    lpjs_stream_printf(&stream, "%zu running:\n\n",
+                       job_list_get_count(running_jobs));
+    job_list_send_params(&stream, running_jobs);
+    lpjs_stream_printf(&stream, "\n%zu pending:\n\n",
+                       job_list_get_count(pending_jobs));
+    job_list_send_params(&stream, pending_jobs);
+    
+    // Errors are sticky, so checking once at the end is enough
+    if ( lpjs_stream_finish(&stream, false) != LPJS_MSG_SENT )
+    {
+        lpjs_log("%s(): Error: Failed to send job list.\n", __FUNCTION__);
+        return stream.status;
+    }
+    return LPJS_MSG_SENT;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Add a new submission to the queue
+ *  
+ *  History: 
+ *  Date        Name        Modification
+ *  2024-01-22  Jason Bacon Factor out from lpjs_process_events()
+ *  2026-10-19  Jason Bacon Accept binary submissions, reject malformed
+ *  2026-10-19  Jason Bacon Allocate IDs for the whole array at once
+ *  2026-10-19  Jason Bacon Group commit, acknowledge in one stream
+ *  2026-10-19  Jason Bacon Factor out lpjs_spool_submission()
+ *  2026-10-19  Jason Bacon Acknowledge once journaled, queue jobs later
+ ***************************************************************************/
+
+int     lpjs_submit(int msg_fd, const char *incoming_msg, size_t msg_len,
+                    node_list_t *node_list,
+                    job_list_t *pending_jobs, job_list_t *running_jobs,
+                    uid_t munge_uid, gid_t munge_gid)
+
+{
+    const char  *script_text;
+    job_t       *submission;
+    lpjs_spool_t    spool = { 0 };
+    lpjs_stream_t   stream;
+    
+    lpjs_stream_init(&stream, msg_fd, lpjs_no_close);
+    
+    /*
+     *  Journal the whole array with one write() and fsync(), so
+     *  every acknowledged job survives a crash, at the cost of one
+     *  fsync() per submission rather than per job.
+     */
+    lpjs_journal_begin_group();
+    if ( (submission = lpjs_read_submission(incoming_msg + 1, msg_len - 1,
+                                            &script_text)) == NULL )
+    {
+        lpjs_log("%s(): Error: Malformed job submission.\n", __FUNCTION__);
+        lpjs_stream_printf(&stream, "Error: Malformed job submission.\n");
+    }
+    else
+    {
+        lpjs_spool_submission(&stream, &spool, submission, script_text,
+                              munge_uid, munge_gid);
+        job_free(&submission);
+    }
+    lpjs_spool_finish(&stream, &spool, lpjs_journal_commit_group(),
+                      node_list, pending_jobs, running_jobs, false);
+    
+    if ( lpjs_stream_finish(&stream, false) != LPJS_MSG_SENT )
+        lpjs_log("%s(): Error: Failed to send response.\n", __FUNCTION__);
+    lpjs_dispatchd_safe_close(msg_fd);
+    
+    return EX_OK;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Add many submissions from lpjs submit to the queue.  The
+ *      message holds one WIRE_TAG_SUBMISSION per script, each in the
+ *      format of LPJS_DISPATCHD_REQUEST_SUBMIT, followed by the count
+ *      in WIRE_TAG_SUBMISSIONS.  All are journaled with one fsync()
+ *      and acknowledged in one stream, with one line per job naming
+ *      its script.  A malformed submission is reported and skipped.
+ *  
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Acknowledge once journaled, queue jobs later
+ ***************************************************************************/
+
+int     lpjs_submit_batch(int msg_fd, const char *incoming_msg,
+                          size_t msg_len, node_list_t *node_list,
+                          job_list_t *pending_jobs, job_list_t *running_jobs,
+                          uid_t munge_uid, gid_t munge_gid)
+
+{
+    const char      *script_text;
+    job_t           *submission;
+    wire_reader_t   reader;
+    wire_field_t    field;
+    uint64_t        count;
+    size_t          received = 0;
+    lpjs_spool_t    spool = { 0 };
+    lpjs_stream_t   stream;
+    
+    lpjs_stream_init(&stream, msg_fd, lpjs_no_close);
+    
+    // The count comes last, so its presence means nothing was cut off
+    if ( (wire_reader_init(&reader, incoming_msg + 1, msg_len - 1) != WIRE_OK) ||
+         (wire_find_field(incoming_msg + 1, msg_len - 1,
+                          WIRE_TAG_SUBMISSIONS, &field) != WIRE_OK) ||
+         (wire_get_uint(&field, &count) != WIRE_OK) )
+    {
+        lpjs_log("%s(): Error: Malformed batch submission.\n", __FUNCTION__);
+        lpjs_stream_printf(&stream, "Error: Malformed batch submission.\n");
+        count = 0;
+    }
+    
+    lpjs_journal_begin_group();
+    while ( (received < count) && (wire_next_field(&reader, &field) == WIRE_OK) )
+    {
+        if ( field.tag != WIRE_TAG_SUBMISSION )
+            continue;
+        ++received;
+        if ( (submission = lpjs_read_submission((const char *)field.value,
+                                                field.len,
+                                                &script_text)) == NULL )
+        {
+            lpjs_log("%s(): Error: Malformed job submission %zu.\n",
+                     __FUNCTION__, received);
+            lpjs_stream_printf(&stream,
+                               "Error: Malformed job submission %zu.\n",
+                               received);
+            continue;
+        }
+        lpjs_spool_submission(&stream, &spool, submission, script_text,
+                              munge_uid, munge_gid);
+        job_free(&submission);
+    }
+    if ( received < count )
+        lpjs_stream_printf(&stream, "Error: Received %zu of %lu submissions.\n",
+                           received, (unsigned long)count);
+    lpjs_spool_finish(&stream, &spool, lpjs_journal_commit_group(),
+                      node_list, pending_jobs, running_jobs, true);
+    
+    if ( lpjs_stream_finish(&stream, false) != LPJS_MSG_SENT )
+        lpjs_log("%s(): Error: Failed to send response.\n", __FUNCTION__);
+    lpjs_dispatchd_safe_close(msg_fd);
+    
+    return EX_OK;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Parse a submission from lpjs submit: a job description
+ *      followed by the script, in the binary format described in
+ *      wire.h.  Older lpjs submit commands send JOB_SPEC_FORMAT,
+ *      newline, script.
+ *
+ *  Returns:
+ *      The job description, with *script_text pointing into msg,
+ *      or NULL if the submission is malformed
+ *  
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Factor out from lpjs_submit()
+ ***************************************************************************/
+
+job_t   *lpjs_read_submission(const char *msg, size_t msg_len,
+                              const char **script_text)
+
+{
+    // Terminates process if malloc() fails, no check required
+    job_t           *submission = job_new();
+    wire_field_t    field;
+    char            *end;
+    
+    *script_text = NULL;
+    if ( wire_is_binary(msg, msg_len) )
+    {
+        if ( (job_read_from_wire(submission, msg, msg_len) == 0) &&
+             (wire_find_field(msg, msg_len, WIRE_TAG_SCRIPT, &field) == WIRE_OK) )
+            *script_text = wire_get_str(&field);
+    }
+    else if ( job_read_from_string(submission, msg, &end) == JOB_SPECS_ITEMS )
+    {
+        // Should only be a newline between job specs and script
+        *script_text = end + 1;
+    }
+    
+    if ( *script_text == NULL )
+        job_free(&submission);
+    return submission;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Journal the jobs of one submission in the open journal group,
+ *      adding them to spool.  Errors are reported on stream.  The
+ *      caller commits the group and calls lpjs_spool_finish().
+ *
+ *  Returns:
+ *      The number of jobs added to spool
+ *  
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Factor out from lpjs_submit()
+ ***************************************************************************/
+
+unsigned    lpjs_spool_submission(lpjs_stream_t *stream, lpjs_spool_t *spool,
+                                  job_t *submission, const char *script_text,
+                                  uid_t munge_uid, gid_t munge_gid)
+
+{
+    char            script_path[PATH_MAX + 1];
+    job_t           *job,
+                    **new_jobs;
+    int             c, job_array_index;
+    unsigned        job_count = job_get_job_count(submission),
+                    queued = 0;
+    unsigned long   first_job_id;
+    
+    if ( strcmp(job_get_user_name(submission), "root") == 0 )
+    {
+        lpjs_log("%s(): Error: Rejecting job submission from root.\n",
+                __FUNCTION__);
+        lpjs_stream_printf(stream, "Error: Cannot run jobs as root.\n");
+        return 0;
+    }
+    if ( (first_job_id = lpjs_journal_alloc_job_ids(job_count)) == 0 )
+    {
+        lpjs_stream_printf(stream, "Error: Cannot allocate job IDs.\n");
+        spool->failed += job_count;
+        return 0;
+    }
+    
+    if ( spool->count + job_count > spool->slots )
+    {
+        spool->slots = (spool->count + job_count) * 2;
+        new_jobs = realloc(spool->jobs, spool->slots * sizeof(*spool->jobs));
+        if ( new_jobs == NULL )
+        {
+            lpjs_log("%s(): Error: realloc() failed.\n", __FUNCTION__);
+            exit(EX_UNAVAILABLE);
+        }
+        spool->jobs = new_jobs;
+    }
+    
+    snprintf(script_path, PATH_MAX + 1, "%s/%s",
+             job_get_submit_dir(submission), job_get_script_name(submission));
+    lpjs_log("%s(): Submit script %s:%s from %d, %d\n", __FUNCTION__,
+            job_get_submit_node(submission), script_path, munge_uid,
+            munge_gid);
+    
+    for (c = 0; c < job_count; ++c)
+    {
+        job_array_index = c + 1;    // Job arrays are 1-based
+        
+        // Create a separate job_t object for each member of the job array
+        // job_dup() terminates process if malloc() fails
+        job = job_dup(submission);
+        if ( lpjs_queue_job(job, first_job_id + c, job_array_index,
+                            script_text) == LPJS_SUCCESS )
+        {
+            spool->jobs[spool->count++] = job;
+            ++queued;
+        }
+        else
+            job_free(&job);
+    }
+    spool->failed += job_count - queued;
+    return queued;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Once the journal group holding the jobs in spool is committed,
+ *      hand them to the intake and send their IDs back to lpjs submit.
+ *      The jobs are durable at this point, so the client need not wait
+ *      for them to reach the pending list.  If the intake is full,
+ *      make room first, so a flood of submissions is slowed to the
+ *      rate dispatchd can queue them.  If the commit failed, drop the
+ *      jobs instead.
+ *  
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Factor out from lpjs_submit()
+ *  2026-10-19  Jason Bacon Queue through the intake
+ ***************************************************************************/
+
+void    lpjs_spool_finish(lpjs_stream_t *stream, lpjs_spool_t *spool,
+                          int commit_status, node_list_t *node_list,
+                          job_list_t *pending_jobs, job_list_t *running_jobs,
+                          bool name_scripts)
+
+{
+    size_t  c;
+    job_t   *job;
+    
+    for (c = 0; c < spool->count; ++c)
+    {
+        job = spool->jobs[c];
+        if ( commit_status != LPJS_SUCCESS )
+        {
+            lpjs_journal_drop(job_get_job_id(job));
+            job_free(&job);
+            ++spool->failed;
+            continue;
+        }
+        if ( name_scripts )
+            lpjs_stream_printf(stream, "Spooled job %lu for %s.\n",
+                               job_get_job_id(job), job_get_script_name(job));
+        else
+            lpjs_stream_printf(stream, "Spooled job %lu.\n",
+                               job_get_job_id(job));
+        if ( lpjs_intake_queued() >= LPJS_INTAKE_LIMIT )
+            lpjs_drain_intake(node_list, pending_jobs, running_jobs,
+                              LPJS_INTAKE_BATCH);
+        // The intake owns job now
+        lpjs_intake_add(job);
+    }
+    if ( spool->failed > 0 )
+        lpjs_stream_printf(stream, "Error: Failed to spool %u jobs.\n",
+                           spool->failed);
+    free(spool->jobs);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Move up to max_jobs acknowledged jobs from the intake to the
+ *      pending list, exporting them first with --spool-export, and
+ *      dispatch them unless node_list is NULL.
+ *  
+ *  Returns:
+ *      The number of jobs moved
+ *  
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+size_t  lpjs_drain_intake(node_list_t *node_list, job_list_t *pending_jobs,
+                          job_list_t *running_jobs, size_t max_jobs)
+
+{
+    size_t  moved;
+    job_t   *job;
+    
+    for (moved = 0; (moved < max_jobs) &&
+                    ((job = lpjs_intake_next()) != NULL); ++moved)
+    {
+        // Optional, the journal is authoritative
+        if ( lpjs_journal_spool_export() )
+            lpjs_export_pending_job(job,
+                    lpjs_journal_get_script(job_get_job_id(job), NULL));
+        job_list_add_job(pending_jobs, job);
+    }
+    if ( moved > 0 )
+    {
+        lpjs_debug("%s(): Queued %zu jobs, %zu in intake.\n",
+                   __FUNCTION__, moved, lpjs_intake_queued());
+        if ( node_list != NULL )
+            lpjs_dispatch_jobs(node_list, pending_jobs, running_jobs);
+    }
+    return moved;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Add a new submission to the queue
+ *
+ *  Returns:
+ *      LPJS_SUCCESS, etc.
+ *  
+ *  History: 
+ *  Date        Name        Modification
+ *  2024-01-22  Jason Bacon Factor out from lpjs_process_events()
+ *  2026-10-19  Jason Bacon Journal cancellation of dispatched jobs
+ ***************************************************************************/
+
+int     lpjs_cancel(int msg_fd, const char *incoming_msg,
+                    node_list_t *node_list,
+                    job_list_t *pending_jobs, job_list_t *running_jobs,
+                    uid_t munge_uid, gid_t munge_gid)
+
+{
+    unsigned long   job_id;
+    char            *end;
+    job_t           *job;
+    size_t          index;
+    char            *hostname;
+    
+    lpjs_debug("%s(): Incoming = '%s'\n", __FUNCTION__, incoming_msg);
+    job_id = strtoul(incoming_msg, &end, 10);
+    if ( *end != '\0' )
+    {
         lpjs_log("%s(): Bug: Malformed job_id: '%s'\n",
                 __FUNCTION__, incoming_msg);
         return -1;
@@ -1048,7 +1942,8 @@ int     lpjs_cancel(int msg_fd, const char *incoming_msg,
         {
             if ( job_get_state(job) == JOB_STATE_DISPATCHED )
             {
-                job_set_state(job, JOB_STATE_CANCELED);
+                lpjs_journal_cancel(job_id);
+                job_list_set_job_state(pending_jobs, job, JOB_STATE_CANCELED);
                 // Resources are reserved as soon as chaperone is forked,
                 // before job state is changed to running
                 hostname = job_get_compute_node(job);
@@ -1171,7 +2066,10 @@ int     lpjs_kill_processes(node_list_t *node_list, job_t *job)
 
 /***************************************************************************
  *  Description:
- *      Add a job to the queue
+ *      Journal a new job.  job_id must come from
+ *      lpjs_journal_alloc_job_ids().  Submissions are journaled in a
+ *      group (see lpjs_journal_begin_group()), so the caller adds the
+ *      job to the pending list once the group is committed.
  *
  *  Returns:
  *      LPJS_SUCCESS on success
@@ -1179,54 +2077,53 @@ int     lpjs_kill_processes(node_list_t *node_list, job_t *job)
  *  History: 
  *  Date        Name        Modification
  *  2021-09-30  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Journal instead of creating a spool directory
+ *  2026-10-19  Jason Bacon Take job_id from caller
+ *  2026-10-19  Jason Bacon Leave queueing and response to the caller
  ***************************************************************************/
 
-int     lpjs_queue_job(int msg_fd, job_list_t *pending_jobs, job_t *job,
+int     lpjs_queue_job(job_t *job, unsigned long job_id,
                        unsigned long job_array_index, const char *script_text)
 
+{
+    lpjs_log("%s(): Spooling %s as job %lu...\n", __FUNCTION__,
+             job_get_script_name(job), job_id);
+    
+    job_set_job_id(job, job_id);
+    job_set_array_index(job, job_array_index);
+    
+    return lpjs_journal_submit(job, script_text);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Write a new job's script and specs to LPJS_PENDING_DIR/job_id,
+ *      for lpjs_dispatchd --spool-export
+ *
+ *  Returns:
+ *      LPJS_SUCCESS on success
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Factor out from lpjs_queue_job()
+ ***************************************************************************/
+
+int     lpjs_export_pending_job(job_t *job, const char *script_text)
+
 {
     char    pending_dir[PATH_MAX + 1],
             script_path[PATH_MAX + 2],
-            specs_path[PATH_MAX + 11],
-            job_id_path[PATH_MAX + 1],
-            job_id_buff[LPJS_MAX_INT_DIGITS + 1],
-            outgoing_msg[LPJS_MSG_LEN_MAX + 1];
+            specs_path[PATH_MAX + 11];
     int     fd;
-    ssize_t bytes;
-    unsigned long   next_job_id;
     FILE    *fp;
     
-    lpjs_log("%s(): Spooling %s...\n", __FUNCTION__, job_get_script_name(job));
-    
-    snprintf(job_id_path, PATH_MAX + 1, "%s/next-job", LPJS_SPOOL_DIR);
-    if ( (fd = open(job_id_path, O_RDONLY)) == -1 )
-    {
-        lpjs_log("%s(): Cannot open %s/next-job: %s\n", __FUNCTION__,
-                LPJS_SPOOL_DIR, strerror(errno));
-        next_job_id = 1;
-    }
-    else
-    {
-        bytes = read(fd, job_id_buff, LPJS_MAX_INT_DIGITS + 1);
-        if ( bytes == -1 )
-        {
-            lpjs_log("%s(): Error: Can't read %s: %s\n",
-                    __FUNCTION__, job_id_path, strerror(errno));
-            exit(EX_DATAERR);
-        }
-        sscanf(job_id_buff, "%lu", &next_job_id);
-        close(fd);
-    }
-    lpjs_debug("%s(): Selected job ID %lu\n", __FUNCTION__, next_job_id);
-
-    job_set_job_id(job, next_job_id);
-    job_set_array_index(job, job_array_index);
-    
     snprintf(pending_dir, PATH_MAX + 1, "%s/%lu", LPJS_PENDING_DIR,
-            next_job_id);
+            job_get_job_id(job));
     if ( xt_rmkdir(pending_dir, 0755) != 0 )
     {
-        fprintf(stderr, "Cannot create %s: %s\n", pending_dir, strerror(errno));
+        lpjs_log("%s(): Error: Cannot create %s: %s\n", __FUNCTION__,
+                pending_dir, strerror(errno));
         return LPJS_WRITE_FAILED;
     }
 
@@ -1250,11 +2147,8 @@ int     lpjs_queue_job(int msg_fd, job_list_t *pending_jobs, job_t *job,
     close(fd);
     lpjs_debug("%s(): Copied script to %s.\n", __FUNCTION__, script_path);
     
-    /*
-     *  Write basic job specs to a file for the dispatcher
-     */
-    
-    snprintf(specs_path, PATH_MAX + 11, "%s/job.specs", pending_dir);
+    snprintf(specs_path, PATH_MAX + 11, "%s/%s", pending_dir,
+            LPJS_SPECS_FILE_NAME);
     // FIXME: Switch to low-level I/O?
     if ( (fp = fopen(specs_path, "w")) == NULL )
     {
@@ -1272,37 +2166,53 @@ int     lpjs_queue_job(int msg_fd, job_list_t *pending_jobs, job_t *job,
     fclose(fp);
     lpjs_debug("%s(): Wrote job specs to %s.\n", __FUNCTION__, specs_path);
     
-    // Back to submit command for terminal output
-    snprintf(outgoing_msg, LPJS_MSG_LEN_MAX, "Spooled job %lu to %s.\n",
-            next_job_id, pending_dir);
-    if ( lpjs_send_munge(msg_fd, outgoing_msg,
-                         lpjs_dispatchd_safe_close) != LPJS_MSG_SENT )
-    {
-        lpjs_log("%s(): Error: Failed to send response.\n", __FUNCTION__);
-        // FIXME: Should we continue?
-    }
-    lpjs_debug("%s(): Send message %s back to user.\n", __FUNCTION__, outgoing_msg);
+    return LPJS_SUCCESS;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Move a started job's directory from LPJS_PENDING_DIR to
+ *      LPJS_RUNNING_DIR and update its specs with node and PIDs,
+ *      for lpjs_dispatchd --spool-export
+ *
+ *  Returns:
+ *      LPJS_SUCCESS on success
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Factor out from lpjs_update_job()
+ ***************************************************************************/
+
+int     lpjs_export_running_job(job_t *job)
+
+{
+    char    pending_job_dir[PATH_MAX + 1],
+            running_job_dir[PATH_MAX + 1 - 10],
+            specs_path[PATH_MAX + 1];
+    FILE    *fp;
+    
+    // FIXME: Check success of all steps below
+    snprintf(pending_job_dir, PATH_MAX + 1,
+            LPJS_PENDING_DIR "/%lu", job_get_job_id(job));
+    snprintf(running_job_dir, PATH_MAX + 1 - 10,
+            LPJS_RUNNING_DIR "/%lu", job_get_job_id(job));
+    rename(pending_job_dir, running_job_dir);
+    
+    snprintf(specs_path, PATH_MAX + 1, "%s/%s", running_job_dir,
+            LPJS_SPECS_FILE_NAME);
+    lpjs_log("%s(): Storing updated specs to %s.\n",
+            __FUNCTION__, specs_path);
     
-    // Bump job num after successful spool
-    if ( (fd = open(job_id_path, O_WRONLY|O_CREAT|O_TRUNC, 0644)) == -1 )
+    // FIXME: Switch to low-level I/O?
+    if ( (fp = fopen(specs_path, "w")) == NULL )
     {
-        lpjs_log("%s(): Error: Cannot update %s: %s\n", __FUNCTION__,
-                job_id_path, strerror(errno));
+        lpjs_log("%s(): Error: Cannot create %s: %s\n", __FUNCTION__,
+                specs_path, strerror(errno));
         return LPJS_WRITE_FAILED;
     }
-    else
-    {
-        if ( xt_dprintf(fd, "%lu\n", ++next_job_id) < 0 )
-        {
-            lpjs_log("%s(): Error: write() failed for %job_id_path: %s\n", __FUNCTION__,
-                    script_path, strerror(errno));
-            close(fd);
-            return LPJS_WRITE_FAILED;
-        }
-        close(fd);
-    }
-    
-    job_list_add_job(pending_jobs, job);
+    job_print_full_specs(job, fp);
+    fclose(fp);
     
     return LPJS_SUCCESS;
 }
@@ -1317,6 +2227,8 @@ int     lpjs_queue_job(int msg_fd, job_list_t *pending_jobs, job_t *job,
  *  History: 
  *  Date        Name        Modification
  *  2024-05-01  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Journal the start, spool directory is optional
+ *  2026-10-19  Jason Bacon Record the start time
  ***************************************************************************/
 
 int     lpjs_update_job(node_list_t *node_list, char *payload,
@@ -1324,15 +2236,12 @@ int     lpjs_update_job(node_list_t *node_list, char *payload,
 
 {
     char    *compute_node,
-            *p,
-            pending_job_dir[PATH_MAX + 1],
-            running_job_dir[PATH_MAX + 1 - 10],
-            specs_path[PATH_MAX + 1];
-    FILE    *fp;
+            *p;
     unsigned long   job_id;
     pid_t   chaperone_pid, job_pid;
     size_t  job_list_index;
     job_t   *job;
+    time_t  start_time = time(NULL);
     
     p = payload;
     compute_node = strsep(&p, " ");
@@ -1345,42 +2254,28 @@ int     lpjs_update_job(node_list_t *node_list, char *payload,
         lpjs_log("%s(): Bug: Job id not found.\n", __FUNCTION__);
     else
     {
-        // FIXME: Check success of all steps below
-        // Move job from pending spool dir to running
-        snprintf(pending_job_dir, PATH_MAX + 1,
-                LPJS_PENDING_DIR "/%lu", job_id);
-        snprintf(running_job_dir, PATH_MAX + 1 - 10,
-                LPJS_RUNNING_DIR "/%lu", job_id);
-        // lpjs_debug("%s(): Moving %s to %s...\n", __FUNCTION__,
-        //              pending_job_dir, running_job_dir);
-        rename(pending_job_dir, running_job_dir);
+        lpjs_journal_start(job_id, compute_node, chaperone_pid, job_pid,
+                           start_time);
         
         // Add node and PID info to job object
         job = job_list_get_jobs_ae(pending_jobs, job_list_index);
         // lpjs_debug("%s(): Adding %s %lu %lu to job %lu\n",
         //        __FUNCTION__, compute_node, chaperone_pid, job_pid, job_id);
+        free(job_get_compute_node(job));    // Set when dispatched
         job_set_compute_node(job, strdup(compute_node));
         job_set_chaperone_pid(job, chaperone_pid);
         job_set_job_pid(job, job_pid);
+        job_set_start_time(job, start_time);
 
         // Update in-memory job lists
         job_list_add_job(running_jobs, job);
         job_list_remove_job(pending_jobs, job_get_job_id(job));
+        // Canceled jobs keep their state so they're removed below
+        if ( job_get_state(job) == JOB_STATE_DISPATCHED )
+            job_list_set_job_state(running_jobs, job, JOB_STATE_RUNNING);
         
-        // FIXME: Update specs file in running dir with node and PIDs
-        snprintf(specs_path, PATH_MAX + 1, "%s/job.specs", running_job_dir);
-        lpjs_log("%s(): Storing updated specs to %s.\n",
-                __FUNCTION__, specs_path);
-        
-        // FIXME: Switch to low-level I/O?
-        if ( (fp = fopen(specs_path, "w")) == NULL )
-        {
-            lpjs_log("%s(): Error: Cannot create %s: %s\n", __FUNCTION__,
-                    specs_path, strerror(errno));
-            return LPJS_WRITE_FAILED;
-        }
-        job_print_full_specs(job, fp);
-        fclose(fp);
+        if ( lpjs_journal_spool_export() )
+            lpjs_export_running_job(job);
         
         /*
          *  If job was canceled while still pending but after dispatched,
@@ -1403,6 +2298,9 @@ int     lpjs_update_job(node_list_t *node_list, char *payload,
 
 /***************************************************************************
  *  Description:
+ *      Import jobs from the per-job spool directories used before
+ *      queue state moved to the journal.  Scripts of pending jobs
+ *      are handed to the journal for the first snapshot.
  *
  *  Returns:
  *      LPJS_SUCCESS, etc.
@@ -1413,6 +2311,8 @@ int     lpjs_update_job(node_list_t *node_list, char *payload,
  *  History: 
  *  Date        Name        Modification
  *  2024-05-08  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Load scripts of pending jobs for the journal
+ *  2026-10-19  Jason Bacon Skip running jobs on unknown nodes
  ***************************************************************************/
 
 int     lpjs_load_job_list(job_list_t *job_list, node_list_t *node_list,
@@ -1421,7 +2321,10 @@ int     lpjs_load_job_list(job_list_t *job_list, node_list_t *node_list,
 {
     DIR             *dp;
     struct dirent   *entry;
-    char            specs_path[PATH_MAX + 1];
+    char            specs_path[PATH_MAX + 1],
+                    script_path[PATH_MAX + 1],
+                    *script_buff;
+    ssize_t         script_size;
     extern FILE     *Log_stream;
     node_t          *compute_node;
     
@@ -1456,30 +2359,38 @@ int     lpjs_load_job_list(job_list_t *job_list, node_list_t *node_list,
             lpjs_log("%s(): Loaded job #%s\n", __FUNCTION__, entry->d_name);
             job_list_add_job(job_list, job);
             
-            // FIXME: Update node status if job is running
-            // This code is untested
-            if ( strcmp(spool_dir, LPJS_RUNNING_DIR) == 0 )
+            if ( strcmp(spool_dir, LPJS_PENDING_DIR) == 0 )
             {
-                compute_node = node_list_find_hostname(node_list,
-                                                       job_get_compute_node(job));
+                snprintf(script_path, PATH_MAX + 1, "%s/%s/%s",
+                        spool_dir, entry->d_name,
+                        xt_basename(job_get_script_name(job)));
+                if ( (script_size = lpjs_script_size(script_path)) >= 0 )
+                {
+                    if ( (script_buff = malloc(script_size + 1)) == NULL )
+                    {
+                        lpjs_log("%s(): Error: malloc() failed.\n",
+                                 __FUNCTION__);
+                        exit(EX_UNAVAILABLE);
+                    }
+                    if ( lpjs_load_script(script_path, script_buff,
+                                          script_size + 1) >= 0 )
+                        lpjs_journal_set_script(job_get_job_id(job),
+                                                script_buff);
+                    free(script_buff);
+                }
+            }
+            
+            // Allocate once here.  Jobs that finished while we were
+            // down are released when their compd checks in.
+            if ( (strcmp(spool_dir, LPJS_RUNNING_DIR) == 0) &&
+                 (job_get_compute_node(job) != NULL) &&
+                 ((compute_node = node_list_find_hostname(node_list,
+                                    job_get_compute_node(job))) != NULL) )
                 node_adjust_resources(compute_node, job,
                                       NODE_RESOURCE_ALLOCATE);
-                /* Replaces...
-                node_set_processors_used(compute_node,
-                                    node_get_processors_used(compute_node) +
-                                    job_get_processors_per_job(job));
-                node_set_phys_MiB_used(compute_node,
-                                       node_get_phys_MiB_used(compute_node) +
-                                       job_get_processors_per_job(job) *
-                                       job_get_phys_mib_per_processor(job));
-                */
-            }
         }
     }
     closedir(dp);
-    
-    // FIXME: Sort numerically by job id
-    job_list_sort(job_list);
 
     return LPJS_SUCCESS;   // FIXME: Define return codes
 }
@@ -1487,15 +2398,81 @@ int     lpjs_load_job_list(job_list_t *job_list, node_list_t *node_list,
 
 /***************************************************************************
  *  Description:
- *      Gracefully shut down in the event of an interrupt signal
+ *      Read the next job ID from LPJS_NEXT_JOB_FILE, for importing
+ *      from spool directories
+ *
+ *  Returns:
+ *      The next job ID, or 1 if the file cannot be read
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Factor out from lpjs_queue_job()
+ ***************************************************************************/
+
+unsigned long   lpjs_load_next_job_id(void)
+
+{
+    char            job_id_buff[LPJS_MAX_INT_DIGITS + 1];
+    int             fd;
+    ssize_t         bytes;
+    unsigned long   next_job_id = 1;
+    
+    if ( (fd = open(LPJS_NEXT_JOB_FILE, O_RDONLY)) == -1 )
+    {
+        lpjs_log("%s(): Cannot open %s: %s\n", __FUNCTION__,
+                LPJS_NEXT_JOB_FILE, strerror(errno));
+        return next_job_id;
+    }
+    bytes = read(fd, job_id_buff, LPJS_MAX_INT_DIGITS);
+    close(fd);
+    if ( bytes == -1 )
+    {
+        lpjs_log("%s(): Error: Can't read %s: %s\n",
+                __FUNCTION__, LPJS_NEXT_JOB_FILE, strerror(errno));
+        return next_job_id;
+    }
+    job_id_buff[bytes] = '\0';
+    sscanf(job_id_buff, "%lu", &next_job_id);
+    
+    return next_job_id;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      SIGINT/SIGTERM handler.  Just set a flag, so lpjs_process_events()
+ *      can snapshot the queue and call lpjs_dispatchd_shutdown().  A
+ *      second signal means the event loop is stuck, so shut down now.
  *
  *  History: 
  *  Date        Name        Modification
  *  2021-09-28  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Remove LPJS_LOCAL_SOCKET
+ *  2026-10-19  Jason Bacon Defer to the event loop
  ***************************************************************************/
 
 void    lpjs_dispatchd_terminate_handler(int s2)
 
+{
+    extern volatile sig_atomic_t    Terminate;
+    
+    if ( Terminate )
+        lpjs_dispatchd_shutdown();
+    Terminate = 1;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Gracefully shut down in the event of an interrupt signal
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Factor out from lpjs_dispatchd_terminate_handler()
+ ***************************************************************************/
+
+void    lpjs_dispatchd_shutdown(void)
+
 {
     node_t  *node;
     int     c;
@@ -1512,6 +2489,7 @@ void    lpjs_dispatchd_terminate_handler(int s2)
             lpjs_dispatchd_safe_close(node_get_msg_fd(node));
         }
     }
+    unlink(LPJS_LOCAL_SOCKET);
 #ifdef __linux__
     extern char Pid_path[PATH_MAX + 1];
     remove(Pid_path);
@@ -1520,6 +2498,63 @@ void    lpjs_dispatchd_terminate_handler(int s2)
 }
 
 
+/***************************************************************************
+ *  Description:
+ *      Reload etc/lpjs/config at the request of "lpjs nodes reload".
+ *      Only root and the user running dispatchd may do this.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     lpjs_reload_request(int msg_fd, node_list_t *node_list,
+                            uid_t munge_uid)
+
+{
+    char    report[LPJS_MSG_LEN_MAX + 1];
+    int     status;
+    
+    if ( (munge_uid != 0) && (munge_uid != getuid()) )
+    {
+        strlcpy(report, "Only root or the user running lpjs_dispatchd can reload the config.\n",
+                LPJS_MSG_LEN_MAX + 1);
+        status = EX_NOPERM;
+    }
+    else
+        status = lpjs_reload_config(node_list, report, LPJS_MSG_LEN_MAX + 1);
+    
+    strlcat(report, LPJS_EOT_MSG, LPJS_MSG_LEN_MAX + 1);
+    if ( lpjs_send_munge(msg_fd, report, lpjs_dispatchd_safe_close)
+            != LPJS_MSG_SENT )
+    {
+        lpjs_log("%s(): Error: Failed to send reload report.\n", __FUNCTION__);
+        lpjs_dispatchd_safe_close(msg_fd);
+    }
+    
+    return status;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      SIGHUP handler.  Just set a flag, since reloading the config
+ *      is not async-signal-safe.  lpjs_process_events() does the work.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    lpjs_dispatchd_reload_handler(int s2)
+
+{
+    extern volatile sig_atomic_t    Reload_config;
+    
+    Reload_config = 1;
+}
+
+
 void    lpjs_dispatchd_sigpipe(int s2)
 
 {
@@ -1,6 +1,19 @@
 #ifndef _LPJS_DISPATCHD_H_
 #define _LPJS_DISPATCHD_H_
 
+// Exit status in the job history for jobs whose chaperone vanished,
+// e.g. while dispatchd was down
+#define LPJS_EXIT_STATUS_LOST   -1
+
+// Jobs journaled by lpjs_spool_submission(), awaiting the group commit
+typedef struct
+{
+    job_t       **jobs;
+    size_t      count,
+                slots;
+    unsigned    failed;
+}   lpjs_spool_t;
+
 #include "lpjs_dispatchd-protos.h"
 
 #endif
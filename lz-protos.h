@@ -0,0 +1,3 @@
+/* lz.c */
+ssize_t lz_compress(const void *src, size_t src_len, void *dest, size_t dest_size);
+ssize_t lz_decompress(const void *src, size_t src_len, void *dest, size_t dest_size);
@@ -0,0 +1,231 @@
+#include <stdio.h>
+#include <string.h>         // memcpy(), memset()
+
+#include "lz.h"
+
+/*
+ *  A small LZ77 compressor in the style of LZ4, used to shrink large
+ *  messages before munge encodes them.  It favors speed and simplicity
+ *  over ratio: one hash probe per position, no lazy matching.
+ */
+
+static uint32_t lz_hash(const unsigned char *p)
+
+{
+    uint32_t    v;
+
+    memcpy(&v, p, sizeof(v));
+    return (v * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Write a length nibble's continuation bytes, if any
+ *
+ *  Returns:
+ *      Updated output pointer, or NULL if out of room
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static unsigned char    *lz_put_len(unsigned char *op,
+				    const unsigned char *op_end, size_t len)
+
+{
+    if ( len < 15 )
+	return op;
+    for (len -= 15; len >= 255; len -= 255)
+    {
+	if ( op == op_end )
+	    return NULL;
+	*op++ = 255;
+    }
+    if ( op == op_end )
+	return NULL;
+    *op++ = len;
+    return op;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Write one sequence.  A match_len of 0 marks the last sequence,
+ *      which has no offset.
+ *
+ *  Returns:
+ *      Updated output pointer, or NULL if out of room
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static unsigned char    *lz_put_sequence(unsigned char *op,
+					 const unsigned char *op_end,
+					 const unsigned char *literals,
+					 size_t literal_len, size_t offset,
+					 size_t match_len)
+
+{
+    size_t  match_code = match_len == 0 ? 0 : match_len - LZ_MATCH_MIN;
+
+    if ( op == op_end )
+	return NULL;
+    *op++ = (literal_len < 15 ? literal_len : 15) << 4 |
+	    (match_code < 15 ? match_code : 15);
+    if ( (op = lz_put_len(op, op_end, literal_len)) == NULL ||
+	 ((size_t)(op_end - op) < literal_len) )
+	return NULL;
+    memcpy(op, literals, literal_len);
+    op += literal_len;
+
+    if ( match_len == 0 )
+	return op;
+    if ( op_end - op < 2 )
+	return NULL;
+    *op++ = offset;
+    *op++ = offset >> 8;
+    return lz_put_len(op, op_end, match_code);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Compress src_len bytes from src into dest.  Use a dest_size
+ *      smaller than src_len to give up early on incompressible data,
+ *      or LZ_COMPRESS_BOUND(src_len) to always succeed.
+ *
+ *  Returns:
+ *      Compressed length, or -1 if it would exceed dest_size
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+ssize_t lz_compress(const void *src, size_t src_len, void *dest,
+		    size_t dest_size)
+
+{
+    const unsigned char *in = src,
+			*end = in + src_len,
+			*ip = in,
+			*anchor = in,
+			*match;
+    unsigned char       *op = dest,
+			*op_end = op + dest_size;
+    // Positions of recent 4-byte sequences, relative to in
+    uint32_t            table[LZ_HASH_SIZE];
+    uint32_t            h;
+    size_t              match_len;
+
+    memset(table, 0, sizeof(table));
+    while ( end - ip >= LZ_MATCH_MIN )
+    {
+	h = lz_hash(ip);
+	match = in + table[h];
+	table[h] = ip - in;
+	if ( (match < ip) && (ip - match <= LZ_OFFSET_MAX) &&
+	     (memcmp(match, ip, LZ_MATCH_MIN) == 0) )
+	{
+	    for (match_len = LZ_MATCH_MIN;
+		 (ip + match_len < end) && (match[match_len] == ip[match_len]);
+		 ++match_len)
+		;
+	    if ( (op = lz_put_sequence(op, op_end, anchor, ip - anchor,
+				       ip - match, match_len)) == NULL )
+		return -1;
+	    ip += match_len;
+	    anchor = ip;
+	}
+	else
+	    ++ip;
+    }
+
+    if ( (op = lz_put_sequence(op, op_end, anchor, end - anchor, 0, 0))
+	    == NULL )
+	return -1;
+    return op - (unsigned char *)dest;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Decompress src_len bytes from src into dest.  The input is not
+ *      trusted: every length and offset is checked against both
+ *      buffers.
+ *
+ *  Returns:
+ *      Decompressed length, or -1 if src is malformed or the output
+ *      would exceed dest_size
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+ssize_t lz_decompress(const void *src, size_t src_len, void *dest,
+		      size_t dest_size)
+
+{
+    const unsigned char *ip = src,
+			*end = ip + src_len;
+    unsigned char       *out = dest,
+			*op = out,
+			*op_end = out + dest_size;
+    unsigned            token, c;
+    size_t              len, offset;
+
+    while ( ip < end )
+    {
+	token = *ip++;
+
+	// Literals
+	len = token >> 4;
+	if ( len == 15 )
+	{
+	    do
+	    {
+		if ( ip == end )
+		    return -1;
+		len += c = *ip++;
+	    }   while ( c == 255 );
+	}
+	if ( ((size_t)(end - ip) < len) || ((size_t)(op_end - op) < len) )
+	    return -1;
+	memcpy(op, ip, len);
+	ip += len;
+	op += len;
+
+	// The last sequence has no match
+	if ( ip == end )
+	    break;
+
+	// Match, which may overlap the output it copies
+	if ( end - ip < 2 )
+	    return -1;
+	offset = ip[0] | ip[1] << 8;
+	ip += 2;
+	if ( (offset == 0) || (offset > (size_t)(op - out)) )
+	    return -1;
+	len = token & 15;
+	if ( len == 15 )
+	{
+	    do
+	    {
+		if ( ip == end )
+		    return -1;
+		len += c = *ip++;
+	    }   while ( c == 255 );
+	}
+	len += LZ_MATCH_MIN;
+	if ( (size_t)(op_end - op) < len )
+	    return -1;
+	for (; len > 0; --len, ++op)
+	    *op = op[-offset];
+    }
+    return op - out;
+}
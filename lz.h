@@ -0,0 +1,30 @@
+#ifndef _LPJS_LZ_H_
+#define _LPJS_LZ_H_
+
+#include <stddef.h>     // size_t
+#include <stdint.h>     // uint32_t
+#include <sys/types.h>  // ssize_t
+
+/*
+ *  Compressed format, a sequence of:
+ *
+ *      [token] [literal length...] [literals] [offset] [match length...]
+ *
+ *  The high 4 bits of the token are the number of literals, the low 4
+ *  bits the match length minus LZ_MATCH_MIN.  A nibble of 15 means
+ *  more length follows in bytes of 255 until a byte < 255.  The offset
+ *  is 2 bytes, little-endian, counting back from the current output.
+ *  The last sequence has literals only and ends the input.
+ */
+
+#define LZ_MATCH_MIN        4
+#define LZ_OFFSET_MAX       65535
+#define LZ_HASH_BITS        12
+#define LZ_HASH_SIZE        (1 << LZ_HASH_BITS)
+
+// Worst case output size, for incompressible input
+#define LZ_COMPRESS_BOUND(len)  ((len) + (len) / 255 + 16)
+
+#include "lz-protos.h"
+
+#endif  // _LPJS_LZ_H_
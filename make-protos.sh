@@ -1,7 +1,9 @@
 #!/bin/sh -e
 
-for file in lpjs_dispatchd.c lpjs_compd.c config.c network.c misc.c \
-	    scheduler.c job.c job-list.c node.c node-pseudo.c node-list.c \
+for file in lpjs_dispatchd.c lpjs_compd.c config.c network.c misc.c arena.c wire.c session.c stream.c \
+	    sha256.c script-cache.c buff.c lz.c cred.c journal.c cleaner.c intake.c \
+	    job-history.c history.c \
+	    scheduler.c job.c job-list.c job-stats.c node.c node-pseudo.c node-list.c \
 	    realpath.c chaperone.c cancel.c nodes.c; do
     proto_file=${file%.c}-protos.h
     echo $file $proto_file
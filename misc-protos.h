@@ -6,6 +6,8 @@ int xt_create_pid_file(const char *pid_path, FILE *log_stream);
 char *xt_str_localtime(const char *format);
 const char *xt_basename(const char *restrict str);
 ssize_t lpjs_load_script(const char *script_path, char *script_buff, size_t buff_size);
+ssize_t lpjs_script_size(const char *script_path);
 char *lpjs_get_marker_filename(char shared_fs_marker[], const char *hostname, size_t array_size);
 void lpjs_job_log_dir(const char *log_parent, unsigned long job_id, char *log_dir, size_t array_size);
 size_t lpjs_parse_phys_MiB(char *str);
+uint32_t lpjs_crc32(const void *buff, size_t len);
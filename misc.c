@@ -7,6 +7,10 @@
 #include <errno.h>
 #include <limits.h>     // PATH_MAX
 #include <fcntl.h>      // open()
+#include <signal.h>     // sig_atomic_t
+#include <stdint.h>     // uint32_t
+#include <stdbool.h>
+#include <sys/stat.h>   // stat()
 
 #include <xtend/file.h> // xt_rmkdir()
 
@@ -17,16 +21,19 @@
 
 /*
  *  Avoid globals like the plague, but make an exception here so
- *  signal handlers can log messages.  All commands might use
+ *  signal handlers can log messages and set flags.  All commands might use
  *  lpjs_log(), so Log_stream must be always be initialized in main().
  *  Default linkage on Apple clang14 causes extern variables to be
  *  undefined, unless they are initialized.
  */
 FILE        *Log_stream = NULL;
-FILE        *Job_history_stream = NULL;
 node_list_t *Node_list = NULL;
 bool        Debug = true;   // FIXME: Control with --debug flag
 char        Pid_path[PATH_MAX + 1] = "";
+// Set by SIGHUP handler, checked by dispatchd event loop
+volatile sig_atomic_t   Reload_config = 0;
+// Set by SIGINT/SIGTERM handler, checked by dispatchd event loop
+volatile sig_atomic_t   Terminate = 0;
 
 /***************************************************************************
  *  Description:
@@ -285,11 +292,19 @@ ssize_t lpjs_load_script(const char *script_path,
 	return -1;
     }
     
-    bytes = read(fd, script_buff, buff_size + 1);
-    if ( bytes == buff_size + 1 )
+    // Leave room for the null terminator
+    bytes = read(fd, script_buff, buff_size);
+    if ( bytes == -1 )
+    {
+	lpjs_log("%s(): Error: Failed to read %s: %s\n", __FUNCTION__,
+		script_path, strerror(errno));
+	close(fd);
+	return -1;
+    }
+    else if ( bytes == buff_size )
     {
 	lpjs_log("%s(): Error: Script exceeds %zd.  Reduce script size or increase script_size_max.\n",
-		__FUNCTION__, buff_size);
+		__FUNCTION__, buff_size - 1);
 	close(fd);
 	return -1;
     }
@@ -300,6 +315,41 @@ ssize_t lpjs_load_script(const char *script_path,
 }
 
 
+/***************************************************************************
+ *  Description:
+ *      Get the size of a script file, so a buffer can be allocated
+ *      to fit before lpjs_load_script().
+ *
+ *  Returns:
+ *      Size in bytes, or -1 if the script cannot be examined or
+ *      exceeds LPJS_SCRIPT_SIZE_MAX
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+ssize_t lpjs_script_size(const char *script_path)
+
+{
+    struct stat st;
+    
+    if ( stat(script_path, &st) != 0 )
+    {
+	lpjs_log("%s(): Error: Failed to stat %s: %s\n", __FUNCTION__,
+		script_path, strerror(errno));
+	return -1;
+    }
+    if ( st.st_size > LPJS_SCRIPT_SIZE_MAX )
+    {
+	lpjs_log("%s(): Error: %s exceeds LPJS_SCRIPT_SIZE_MAX = %d.\n",
+		 __FUNCTION__, script_path, LPJS_SCRIPT_SIZE_MAX);
+	return -1;
+    }
+    return st.st_size;
+}
+
+
 /***************************************************************************
  *  Use auto-c2man to generate a man page from this comment
  *
@@ -408,3 +458,42 @@ size_t  lpjs_parse_phys_MiB(char *str)
     
     return mem;
 }
+
+
+/***************************************************************************
+ *  Description:
+ *      Compute the CRC-32 (IEEE 802.3) of buff, used to detect torn
+ *      or damaged records in the journal and history index
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Move from journal.c for the history index
+ ***************************************************************************/
+
+uint32_t    lpjs_crc32(const void *buff, size_t len)
+
+{
+    static uint32_t     table[256];
+    static bool         initialized = false;
+    const unsigned char *p = buff;
+    uint32_t            crc;
+    unsigned            c, bit;
+
+    if ( ! initialized )
+    {
+	for (c = 0; c < 256; ++c)
+	{
+	    crc = c;
+	    for (bit = 0; bit < 8; ++bit)
+		crc = (crc & 1) ? (crc >> 1) ^ 0xedb88320 : crc >> 1;
+	    table[c] = crc;
+	}
+	initialized = true;
+    }
+
+    crc = 0xffffffff;
+    while ( len-- > 0 )
+	crc = table[(crc ^ *p++) & 0xff] ^ (crc >> 8);
+    return crc ^ 0xffffffff;
+}
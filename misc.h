@@ -1,6 +1,8 @@
 #ifndef _LPJS_MISC_H_
 #define _LPJS_MISC_H_
 
+#include <stdint.h>     // uint32_t
+
 enum
 {
     LPJS_LOG_LEVEL_NORMAL,
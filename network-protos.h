@@ -1,10 +1,35 @@
 /* network.c */
 int lpjs_connect_to_dispatchd(node_list_t *node_list);
+int lpjs_connect_local(const char *path);
+int lpjs_listen_local(const char *path);
+int lpjs_send_via_compd(const char *msg);
 int lpjs_print_response(int msg_fd, const char *caller_name);
 ssize_t lpjs_send(int msg_fd, int send_flags, const char *format, ...);
+ssize_t lpjs_sendv(int msg_fd, int send_flags, const struct iovec *iov, int iovcnt);
 ssize_t lpjs_recv(int msg_fd, char *buff, size_t buff_len, int flags, int timeout);
+ssize_t lpjs_recv_buff(int msg_fd, lpjs_buff_t *buff, int flags, int timeout);
+_Bool lpjs_recv_pending(int msg_fd);
+void lpjs_discard_deferred(int msg_fd);
+void lpjs_compress_enable(int msg_fd, unsigned methods);
+unsigned lpjs_compress_methods(int msg_fd);
+void lpjs_compress_accept(int msg_fd, const char *payload, size_t len);
+size_t lpjs_list_request(char *msg, size_t size, int request_code);
 ssize_t lpjs_recv_munge(int msg_fd, char **payload, int flags, int timeout, uid_t *uid, gid_t *gid, int (*close_function)(int));
+ssize_t lpjs_recv_munge_reply(int msg_fd, char **payload, int flags, int timeout, uid_t *uid, gid_t *gid, int (*close_function)(int));
+_Bool lpjs_is_notification(const char *payload);
 int lpjs_send_munge(int msg_fd, const char *msg, int (*close_function)(int));
+int lpjs_send_munge_bin(int msg_fd, const void *msg, size_t msg_len, int (*close_function)(int));
+int lpjs_send_munge_bin_to(int msg_fd, const void *msg, size_t msg_len, uid_t reader_uid, int (*close_function)(int));
+int lpjs_send_munge_pipelined(int msg_fd, const char *msg, int (*close_function)(int));
+int lpjs_send_munge_frame(int msg_fd, const void *msg, size_t msg_len, int (*close_function)(int));
+int lpjs_send_munge_frame_to(int msg_fd, const void *msg, size_t msg_len, uid_t reader_uid, int (*close_function)(int));
+int lpjs_send_session_frame(int msg_fd, const void *msg, size_t msg_len, int (*close_function)(int));
+unsigned lpjs_acks_due(int msg_fd, int adjustment);
+void lpjs_forget_acks(int msg_fd);
+int lpjs_local_peer_start(int msg_fd);
+void lpjs_local_peer_end(int msg_fd);
+int lpjs_local_peer_get(int msg_fd, uid_t *uid, gid_t *gid);
+int lpjs_collect_acks(int msg_fd, _Bool wait);
 int lpjs_wait_close(int msg_fd);
 int lpjs_dispatchd_safe_close(int msg_fd);
 int lpjs_no_close(int fd);
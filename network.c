@@ -1,3 +1,7 @@
+#ifdef __linux__
+#define _GNU_SOURCE         // struct ucred
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -7,7 +11,10 @@
 #include <arpa/inet.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <sys/un.h>       // sockaddr_un
 #include <stdarg.h>
+#include <fcntl.h>          // fcntl()
+#include <sys/stat.h>       // chmod()
 
 #include <munge.h>
 #include <xtend/string.h>   // strlcpy() on Linux
@@ -18,6 +25,10 @@
 #include "network.h"
 #include "lpjs.h"
 #include "misc.h"
+#include "session.h"
+#include "wire.h"
+#include "lz.h"
+#include "cred.h"
 
 /***************************************************************************
  *  Description:
@@ -26,6 +37,8 @@
  *  History: 
  *  Date        Name        Modification
  *  2021-09-28  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Clear acks and session left on a reused fd
+ *  2026-10-19  Jason Bacon Prefer LPJS_LOCAL_SOCKET when available
  ***************************************************************************/
 
 int     lpjs_connect_to_dispatchd(node_list_t *node_list)
@@ -35,6 +48,10 @@ int     lpjs_connect_to_dispatchd(node_list_t *node_list)
     struct sockaddr_in  server_address;     // sockaddr_in = inet4
     int                 msg_fd;
 
+    // On the head node, skip name resolution, TCP, and munge
+    if ( (msg_fd = lpjs_connect_local(LPJS_LOCAL_SOCKET)) != -1 )
+	return msg_fd;
+    
     /*
      *  Create a socket endpoint to pair with the endpoint on the server.
      *  AF_INET and PF_INET have the same value, but PF_INET is more
@@ -50,6 +67,13 @@ int     lpjs_connect_to_dispatchd(node_list_t *node_list)
 		__FUNCTION__, strerror(errno));
 	return -1;
     }
+    
+    // msg_fd may be reused from a connection closed with plain close()
+    lpjs_forget_acks(msg_fd);
+    session_end(msg_fd);
+    lpjs_local_peer_end(msg_fd);
+    lpjs_discard_deferred(msg_fd);
+    lpjs_compress_enable(msg_fd, 0);
 
     // AF_INET = inet4 (IPv4), AF_INET6 for inet6 (IPv6)
     server_address.sin_family = AF_INET;
@@ -87,6 +111,174 @@ int     lpjs_connect_to_dispatchd(node_list_t *node_list)
 }
 
 
+/***************************************************************************
+ *  Description:
+ *      Connect to a daemon through a Unix-domain socket on this host,
+ *      LPJS_LOCAL_SOCKET for lpjs_dispatchd on the head node, or
+ *      LPJS_COMPD_SOCKET for lpjs_compd.  The kernel reports each
+ *      end's credentials to the other, so messages on the connection
+ *      are sent without munge.  Only the daemon users can create the
+ *      sockets, since LPJS_RUN_DIR is writable only by them.
+ *
+ *  Returns:
+ *      Connected fd, or -1 if the daemon is not listening on path
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Take socket path from caller
+ ***************************************************************************/
+
+int     lpjs_connect_local(const char *path)
+
+{
+    struct sockaddr_un  server_address = { 0 };
+    int                 msg_fd;
+    
+    if ( access(path, F_OK) != 0 )
+	return -1;
+    
+    if ( (msg_fd = socket(PF_UNIX, SOCK_STREAM, 0)) < 0 )
+	return -1;
+    
+    // msg_fd may be reused from a connection closed with plain close()
+    lpjs_forget_acks(msg_fd);
+    session_end(msg_fd);
+    lpjs_discard_deferred(msg_fd);
+    lpjs_compress_enable(msg_fd, 0);
+    
+    server_address.sun_family = AF_UNIX;
+    strlcpy(server_address.sun_path, path, sizeof(server_address.sun_path));
+    
+    // A stale socket left by a daemon that is no longer running
+    // refuses connections, so the caller falls back to TCP
+    if ( (connect(msg_fd, (struct sockaddr *)&server_address,
+		  sizeof(server_address)) < 0) ||
+	 (lpjs_local_peer_start(msg_fd) != 1) )
+    {
+	lpjs_debug("%s(): %s unavailable: %s\n", __FUNCTION__,
+		   path, strerror(errno));
+	lpjs_local_peer_end(msg_fd);
+	close(msg_fd);
+	return -1;
+    }
+    
+    return msg_fd;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Create a listener socket at path for clients on this host.
+ *      Clients are identified by their kernel-reported credentials
+ *      instead of munge, see lpjs_connect_local().  The socket is
+ *      open to all users, like the TCP port.  The listening fd is
+ *      not inherited by children such as lpjs-chaperone.
+ *
+ *  Returns:
+ *      Listening fd, or -1 if the socket could not be created, in
+ *      which case clients fall back to TCP
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Move from lpjs_dispatchd.c, take path
+ ***************************************************************************/
+
+int     lpjs_listen_local(const char *path)
+
+{
+    int                 listen_fd;
+    struct sockaddr_un  server_address = { 0 };
+    
+    if ( (listen_fd = socket(PF_UNIX, SOCK_STREAM, 0)) < 0 )
+    {
+	lpjs_log("%s(): Error: Can't create local socket: %s\n",
+		 __FUNCTION__, strerror(errno));
+	return -1;
+    }
+    fcntl(listen_fd, F_SETFD, FD_CLOEXEC);
+    
+    server_address.sun_family = AF_UNIX;
+    strlcpy(server_address.sun_path, path, sizeof(server_address.sun_path));
+    
+    // Left behind if the previous daemon did not exit cleanly
+    unlink(path);
+    if ( (bind(listen_fd, (struct sockaddr *)&server_address,
+	       sizeof(server_address)) != 0) ||
+	 (chmod(path, 0666) != 0) ||
+	 (listen(listen_fd, LPJS_CONNECTION_QUEUE_MAX) != 0) )
+    {
+	lpjs_log("%s(): Error: Can't listen on %s: %s\n",
+		 __FUNCTION__, path, strerror(errno));
+	close(listen_fd);
+	unlink(path);
+	return -1;
+    }
+    lpjs_log("%s(): Listening on %s...\n", __FUNCTION__, path);
+    
+    return listen_fd;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Hand a notification for dispatchd, such as a job start or
+ *      completion report, to lpjs_compd on this node through
+ *      LPJS_COMPD_SOCKET.  compd forwards it on its persistent
+ *      connection to dispatchd and replies LPJS_NODE_AUTHORIZED_MSG
+ *      once dispatchd has acknowledged it.  This spares dispatchd a
+ *      new connection, name lookup, and munge credential per
+ *      notification when many jobs finish at once.
+ *
+ *  Returns:
+ *      LPJS_MSG_SENT if dispatchd received the message, other codes
+ *      if the caller should send it directly instead
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     lpjs_send_via_compd(const char *msg)
+
+{
+    int         msg_fd,
+		status;
+    char        *payload;
+    ssize_t     bytes;
+    uid_t       uid;
+    gid_t       gid;
+    
+    if ( (msg_fd = lpjs_connect_local(LPJS_COMPD_SOCKET)) == -1 )
+	return LPJS_SEND_FAILED;
+    
+    // compd closes the connection if it cannot forward the message
+    if ( (status = lpjs_send_munge(msg_fd, msg, lpjs_no_close))
+	    == LPJS_MSG_SENT )
+    {
+	bytes = lpjs_recv_munge(msg_fd, &payload, 0, 0, &uid, &gid,
+				lpjs_no_close);
+	if ( bytes < 1 )
+	    status = LPJS_RECV_FAILED;
+	else
+	{
+	    if ( strcmp(payload, LPJS_NODE_AUTHORIZED_MSG) != 0 )
+		status = LPJS_RECV_FAILED;
+	    free(payload);
+	}
+    }
+    if ( status != LPJS_MSG_SENT )
+	lpjs_log("%s(): lpjs_compd did not forward notice, sending directly.\n",
+		 __FUNCTION__);
+    
+    lpjs_forget_acks(msg_fd);
+    lpjs_local_peer_end(msg_fd);
+    close(msg_fd);
+    return status;
+}
+
+
 /***************************************************************************
  *  Use auto-c2man to generate a man page from this comment
  *
@@ -204,6 +396,7 @@ int     lpjs_print_response(int msg_fd, const char *caller_name)
  *  History: 
  *  Date        Name        Modification
  *  2021-09-29  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Format into a heap buffer, send with lpjs_sendv()
  ***************************************************************************/
 
 ssize_t lpjs_send(int msg_fd, int send_flags, const char *format, ...)
@@ -211,53 +404,124 @@ ssize_t lpjs_send(int msg_fd, int send_flags, const char *format, ...)
 {
     va_list     ap;
     int         status;
-    uint32_t    msg_len;
-    char        buff[LPJS_MSG_LEN_MAX + 1];
+    lpjs_buff_t *buff;
+    struct iovec    iov;
     
-    // Append message after length bytes, which we insert later
+    buff = lpjs_buff_get(0);
     va_start(ap, format);
-    status = vsnprintf(buff + sizeof(uint32_t),
-		       LPJS_MSG_LEN_MAX + 1 - sizeof(uint32_t), format, ap);
-
-    // vsnprintf() returns the length the the string would have been
-    // if buff were unlimited, so we have to use strlen.
+    status = lpjs_buff_vprintf(buff, format, ap);
+    va_end(ap);
+    
     // Also send '\0' byte to mark end of message
-    msg_len = strlen(buff + sizeof(uint32_t)) + 1;
-    // lpjs_debug("buff = %s\n", buff + sizeof(uint32_t));
-    // lpjs_debug("%s(): msg_len = %" PRId32 "\n", __FUNCTION__, msg_len);
+    iov.iov_base = buff->data;
+    iov.iov_len = buff->len + 1;
+    lpjs_sendv(msg_fd, send_flags, &iov, 1);
+    lpjs_buff_put(&buff);
+    
+    return status;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Send the concatenation of iovcnt buffers as one message, in the
+ *      format of lpjs_send(), without copying them into one buffer.
+ *      iovcnt must not exceed LPJS_SENDV_IOV_MAX.
+ *
+ *  Returns:
+ *      Number of message bytes sent, not counting the length prefix,
+ *      or -1 on error
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+ssize_t lpjs_sendv(int msg_fd, int send_flags, const struct iovec *iov,
+		   int iovcnt)
+
+{
+    struct iovec    vec[LPJS_SENDV_IOV_MAX + 1], *next;
+    struct msghdr   header = { 0 };
+    uint32_t        net_len;
+    size_t          msg_len, remaining;
+    ssize_t         bytes;
+    int             c, count;
+    
+    if ( (iovcnt < 0) || (iovcnt > LPJS_SENDV_IOV_MAX) )
+    {
+	lpjs_log("%s(): Bug: iovcnt = %d.\n", __FUNCTION__, iovcnt);
+	return -1;
+    }
     
     // Prefix message with length in binary format, network byte-order
-    *(uint32_t *)buff = htonl(msg_len);
-   
+    for (c = 0, msg_len = 0; c < iovcnt; ++c)
+    {
+	vec[c + 1] = iov[c];
+	msg_len += iov[c].iov_len;
+    }
+    net_len = htonl(msg_len);
+    vec[0].iov_base = &net_len;
+    vec[0].iov_len = sizeof(uint32_t);
+    
     /*
-     *  Send length and message in one send() to ensure they're
-     *  received together, not interleaved with unrelated messages
+     *  Send length and message in one call to ensure they're
+     *  received together, not interleaved with unrelated messages.
+     *  Large messages may take several calls.
      */
-    send(msg_fd, buff, sizeof(uint32_t) + msg_len, send_flags);
-    va_end(ap);
+    next = vec;
+    count = iovcnt + 1;
+    remaining = sizeof(uint32_t) + msg_len;
+    while ( remaining > 0 )
+    {
+	header.msg_iov = next;
+	header.msg_iovlen = count;
+	if ( (bytes = sendmsg(msg_fd, &header, send_flags)) < 0 )
+	{
+	    if ( errno == EINTR )
+		continue;
+	    return -1;
+	}
+	remaining -= bytes;
+	
+	// Skip what was sent
+	while ( (count > 0) && ((size_t)bytes >= next->iov_len) )
+	{
+	    bytes -= next->iov_len;
+	    ++next;
+	    --count;
+	}
+	if ( count > 0 )
+	{
+	    next->iov_base = (char *)next->iov_base + bytes;
+	    next->iov_len -= bytes;
+	}
+    }
     
-    return status;
+    return msg_len;
 }
 
 
 /***************************************************************************
  *  Description:
- *      Receive a message sent by lpjs_send().  A uint32_t containing
- *      the message length in network byte order is received first,
- *      followed by the message.  The interface is idential to recv(2).
+ *      Wait up to timeout microseconds for input on msg_fd, if
+ *      timeout is not 0, and read the length prefix of the next
+ *      message sent by lpjs_send().
  *
- *  timeout:    timeout in microseconds
+ *  Returns:
+ *      sizeof(uint32_t) on success, 0 if nothing was received,
+ *      LPJS_RECV_FAILED on error
  *
  *  History: 
  *  Date        Name        Modification
- *  2024-01-19  Jason Bacon Begin
+ *  2024-01-19  Jason Bacon Begin as part of lpjs_recv()
+ *  2026-10-19  Jason Bacon Factor out of lpjs_recv()
  ***************************************************************************/
 
-ssize_t lpjs_recv(int msg_fd, char *buff, size_t buff_len, int flags,
-		  int timeout)
+static ssize_t  lpjs_recv_len(int msg_fd, int flags, int timeout,
+			      uint32_t *msg_len)
 
 {
-    uint32_t    msg_len;
     ssize_t     bytes_read;
     // struct timeval  timeout_tv = { timeout / 1000000, timeout % 1000000 };
     struct pollfd   poll_fd;
@@ -299,7 +563,7 @@ ssize_t lpjs_recv(int msg_fd, char *buff, size_t buff_len, int flags,
     }
 
     // lpjs_debug("Receiving message...\n");
-    bytes_read = recv(msg_fd, &msg_len, sizeof(uint32_t), flags | MSG_WAITALL);
+    bytes_read = recv(msg_fd, msg_len, sizeof(uint32_t), flags | MSG_WAITALL);
     if ( bytes_read == 0 )
 	// Not a timeout, just got nothing
 	// Should never happen on blocking reads
@@ -317,18 +581,75 @@ ssize_t lpjs_recv(int msg_fd, char *buff, size_t buff_len, int flags,
 	// FIXME: Recover from this
 	exit(EX_DATAERR);
     }
-    msg_len = ntohl(msg_len);
+    *msg_len = ntohl(*msg_len);
     
-    if ( msg_len > buff_len )
+    return bytes_read;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Receive exactly len bytes into buff.  MSG_WAITALL may still
+ *      return early if interrupted by a signal, so keep reading until
+ *      the whole message arrives.
+ *
+ *  Returns:
+ *      len on success, LPJS_RECV_FAILED if the connection failed
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static ssize_t  lpjs_recv_all(int msg_fd, void *buff, size_t len, int flags)
+
+{
+    size_t  received = 0;
+    ssize_t bytes;
+    
+    while ( received < len )
     {
-	lpjs_log("%s(): Bug: msg_len (%" PRIi32 ") > buff_len - 1 (%zu) on fd = %d.\n",
-		 __FUNCTION__, msg_len, buff_len - 1, msg_fd);
-	return 0;
+	bytes = recv(msg_fd, (char *)buff + received, len - received,
+		     flags | MSG_WAITALL);
+	if ( (bytes < 0) && (errno == EINTR) )
+	    continue;
+	if ( bytes < 1 )
+	{
+	    lpjs_log("%s(): Error: recv(fd = %d) failed after %zu of %zu bytes: %s\n",
+		     __FUNCTION__, msg_fd, received, len,
+		     bytes == 0 ? "EOF" : strerror(errno));
+	    return LPJS_RECV_FAILED;
+	}
+	received += bytes;
     }
+    return len;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Read and discard the body of a message too large for the
+ *      caller, so that the next message is read from its start
+ *      instead of from the middle of this one.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static void lpjs_recv_discard(int msg_fd, size_t len, int flags)
+
+{
+    char    junk[4096];
+    size_t  chunk;
     
-    bytes_read = recv(msg_fd, buff, msg_len, flags | MSG_WAITALL);
-    
-    return bytes_read;
+    while ( len > 0 )
+    {
+	chunk = len < sizeof(junk) ? len : sizeof(junk);
+	if ( lpjs_recv_all(msg_fd, junk, chunk, flags) < 0 )
+	    return;
+	len -= chunk;
+    }
 }
 
 
@@ -338,134 +659,1390 @@ ssize_t lpjs_recv(int msg_fd, char *buff, size_t buff_len, int flags,
  *      the message length in network byte order is received first,
  *      followed by the message.  The interface is idential to recv(2).
  *
- *  Arguments:
- *      msg_fd          Socket file descriptor
- *      payload         Buffer to receive message
- *      flags           See recv(2)
- *      timeout         useconds, passed to lpjs_recv
- *      uid, gid        Owner of sending process
- *      close_function  Different close procedures for dispatch and compd
+ *      Messages longer than buff_len are discarded and reported as
+ *      a failure.  Use lpjs_recv_buff() for messages of unknown size.
+ *
+ *  timeout:    timeout in microseconds
  *
  *  History: 
  *  Date        Name        Modification
- *  2024-02-19  Jason Bacon Begin
+ *  2024-01-19  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Discard oversized messages instead of
+ *                          leaving them in the stream
  ***************************************************************************/
 
-ssize_t lpjs_recv_munge(int msg_fd, char **payload, int flags, int timeout,
-			uid_t *uid, gid_t *gid, int(*close_function)(int))
+ssize_t lpjs_recv(int msg_fd, char *buff, size_t buff_len, int flags,
+		  int timeout)
 
 {
+    uint32_t    msg_len;
     ssize_t     bytes_read;
-    int         payload_len;
-    munge_err_t munge_status;
-    char        incoming_msg[LPJS_MSG_LEN_MAX + 1];
-    
-    bytes_read = lpjs_recv(msg_fd, incoming_msg, LPJS_MSG_LEN_MAX + 1,
-			   flags, timeout);
+
+    if ( (bytes_read = lpjs_recv_len(msg_fd, flags, timeout, &msg_len)) < 1 )
+	return bytes_read;
     
-    if ( bytes_read == LPJS_RECV_FAILED )
-    {
-	lpjs_log("%s(): Error: lpjs_recv(fd = %d) failed: %s",
-		__FUNCTION__, msg_fd, strerror(errno));
-	return LPJS_RECV_FAILED;
-    }
-    else if ( bytes_read == LPJS_RECV_TIMEOUT )
-	return LPJS_RECV_TIMEOUT;
-    else if ( bytes_read < 0 )
+    if ( msg_len > buff_len )
     {
-	lpjs_log("%s(): Bug: Undefined return code from lpjs_recv(fd = %d): %d\n",
-		 __FUNCTION__, msg_fd, bytes_read);
-	// FIXME: What should we really do here?
+	lpjs_log("%s(): Bug: msg_len (%" PRIu32 ") > buff_len (%zu) on fd = %d.  Discarding.\n",
+		 __FUNCTION__, msg_len, buff_len, msg_fd);
+	lpjs_recv_discard(msg_fd, msg_len, flags);
 	return LPJS_RECV_FAILED;
     }
-    else
-    {
-	munge_status = munge_decode(incoming_msg, NULL, (void **)payload,
-				    &payload_len, uid, gid);
-	if ( munge_status != EMUNGE_SUCCESS )
-	{
-	    if ( close_function != NULL )
-		close_function(msg_fd);
-	    lpjs_log("%s(): Error: munge_decode(fd = %d) failed.  %zd bytes, Error = %s\n",
-		     __FUNCTION__, msg_fd, bytes_read, munge_strerror(munge_status));
-	    return -1;  // FIXME: Define return codes
-	}
-	
-	// Acknolwedge successful receipt of message
-	lpjs_send(msg_fd, 0, LPJS_MUNGE_CRED_VERIFIED_MSG);
-	return payload_len;
-    }
+    
+    return lpjs_recv_all(msg_fd, buff, msg_len, flags);
 }
 
 
 /***************************************************************************
  *  Description:
- *      Send a munge-encoded message
+ *      Receive a message sent by lpjs_send() into a growable buffer,
+ *      so messages up to LPJS_MSG_SIZE_MAX bytes can be received
+ *      without a large fixed buffer.  buff->data is '\0'-terminated.
+ *
+ *  timeout:    timeout in microseconds
  *
  *  Returns:
- *      EX_OK on success, various other error codes
+ *      Message length, 0 if nothing was received, LPJS_RECV_FAILED
+ *      on error
  *
  *  History: 
  *  Date        Name        Modification
- *  2024-01-21  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Begin
  ***************************************************************************/
 
-int     lpjs_send_munge(int msg_fd, const char *msg, int(*close_function)(int))
+ssize_t lpjs_recv_buff(int msg_fd, lpjs_buff_t *buff, int flags, int timeout)
 
 {
-    char        *cred,
-		incoming_msg[LPJS_MSG_LEN_MAX + 1];
-    ssize_t     bytes;
-    munge_err_t munge_status;
+    uint32_t    msg_len;
+    ssize_t     bytes_read;
+
+    buff->len = 0;
+    *buff->data = '\0';
+    if ( (bytes_read = lpjs_recv_len(msg_fd, flags, timeout, &msg_len)) < 1 )
+	return bytes_read;
     
-    if ( (munge_status = munge_encode(&cred, NULL, msg, strlen(msg))) != EMUNGE_SUCCESS )
+    if ( msg_len > LPJS_MSG_SIZE_MAX )
     {
-	lpjs_log("%s(): Error: munge_encode(fd = %d) failed: %s.\n",
-		__FUNCTION__, msg_fd, munge_strerror(munge_status));
-	// May be close(), lpjs_dispatchd_safe_close(), or lpjs_no_close()
-	close_function(msg_fd);
-	return LPJS_MUNGE_FAILED;
+	lpjs_log("%s(): Error: msg_len (%" PRIu32 ") > LPJS_MSG_SIZE_MAX on fd = %d.  Discarding.\n",
+		 __FUNCTION__, msg_len, msg_fd);
+	lpjs_recv_discard(msg_fd, msg_len, flags);
+	return LPJS_RECV_FAILED;
     }
+    
+    lpjs_buff_reserve(buff, msg_len);
+    if ( (bytes_read = lpjs_recv_all(msg_fd, buff->data, msg_len, flags)) < 0 )
+	return bytes_read;
+    buff->len = msg_len;
+    buff->data[msg_len] = '\0';
+    
+    return msg_len;
+}
 
-    // lpjs_debug("%s(): Sending %zd bytes: %s...\n", __FUNCTION__, strlen(cred), cred);
-    if ( lpjs_send(msg_fd, 0, cred) < 0 )
-    {
-	lpjs_log("%s(): Error: Failed to send credential to dispatchd",
-		__FUNCTION__);
-	// May be close(), lpjs_dispatchd_safe_close(), or lpjs_no_close()
-	close_function(msg_fd);
-	free(cred);
-	return LPJS_SEND_FAILED;
-    }
-    free(cred);
+
+/*
+ *  Messages received out of turn on each fd, indexed by fd, grown as
+ *  needed.  On the persistent dispatchd-compd connection, either end
+ *  may send a message while the other is waiting for an
+ *  acknowledgement or reply, e.g. a chaperone notification forwarded
+ *  by compd while dispatchd is sending a new job.  These are decoded
+ *  and acknowledged right away, so neither end waits on the other,
+ *  and queued here for the next lpjs_recv_munge().
+ */
+
+typedef struct lpjs_deferred
+{
+    struct lpjs_deferred    *next;
+    char                    *payload;
+    ssize_t                 len;
+    uid_t                   uid;
+    gid_t                   gid;
+}   lpjs_deferred_t;
+
+typedef struct
+{
+    lpjs_deferred_t *head;
+    lpjs_deferred_t *tail;
+}   lpjs_backlog_t;
+
+static lpjs_backlog_t   *Backlogs = NULL;
+static size_t           Backlogs_size = 0;
+
+/***************************************************************************
+ *  Description:
+ *      Queue a decoded message for the next lpjs_recv_munge() on
+ *      msg_fd.  The queue takes ownership of payload.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static void lpjs_defer(int msg_fd, char *payload, ssize_t len,
+		       uid_t uid, gid_t gid)
+
+{
+    lpjs_deferred_t *msg;
+    lpjs_backlog_t  *new_backlogs;
+    size_t          new_size;
     
-    // lpjs_debug("%s(): Waiting for response.\n", __FUNCTION__);
-    // Read acknowledgment
-    bytes = lpjs_recv(msg_fd, incoming_msg, LPJS_MSG_LEN_MAX, 0, 0);
-    if ( bytes == LPJS_RECV_FAILED )
+    if ( (size_t)msg_fd >= Backlogs_size )
     {
-	lpjs_log("%s(): Error: lpjs_recv(fd = %d) failed.\n",
-		__FUNCTION__, msg_fd);
-	return LPJS_RECV_FAILED;
+	for (new_size = Backlogs_size == 0 ? 64 : Backlogs_size;
+	     new_size <= (size_t)msg_fd; new_size *= 2)
+	    ;
+	if ( (new_backlogs = realloc(Backlogs,
+				     new_size * sizeof(*Backlogs))) == NULL )
+	{
+	    lpjs_log("%s(): Error: realloc() failed.\n", __FUNCTION__);
+	    exit(EX_UNAVAILABLE);
+	}
+	memset(new_backlogs + Backlogs_size, 0,
+	       (new_size - Backlogs_size) * sizeof(*Backlogs));
+	Backlogs = new_backlogs;
+	Backlogs_size = new_size;
     }
-    else if ( bytes == LPJS_RECV_TIMEOUT )
+    
+    if ( (msg = malloc(sizeof(*msg))) == NULL )
     {
-	lpjs_log("%s(): Error: lpjs_recv(fd = %d) timeout.\n",
-		__FUNCTION__,msg_fd);
-	return LPJS_RECV_TIMEOUT;
+	lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
+	exit(EX_UNAVAILABLE);
     }
-    if ( (bytes < 1) || (strcmp(incoming_msg, LPJS_MUNGE_CRED_VERIFIED_MSG) != 0) )
-    {
-	lpjs_log("%s(): Warning: Expected %s, got %zd bytes on fd = %d.\n",
-		__FUNCTION__, LPJS_MUNGE_CRED_VERIFIED_MSG, bytes, msg_fd);
-	return LPJS_RECV_FAILED;
+    msg->next = NULL;
+    msg->payload = payload;
+    msg->len = len;
+    msg->uid = uid;
+    msg->gid = gid;
+    if ( Backlogs[msg_fd].tail == NULL )
+	Backlogs[msg_fd].head = msg;
+    else
+	Backlogs[msg_fd].tail->next = msg;
+    Backlogs[msg_fd].tail = msg;
+    lpjs_debug("%s(): Deferred %zd byte message on fd = %d.\n",
+	       __FUNCTION__, len, msg_fd);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Remove the oldest deferred message on msg_fd.  Call only if
+ *      lpjs_recv_pending() is true.
+ *
+ *  Returns:
+ *      Payload length, as for lpjs_recv_munge()
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static ssize_t  lpjs_undefer(int msg_fd, char **payload,
+			     uid_t *uid, gid_t *gid)
+
+{
+    lpjs_deferred_t *msg = Backlogs[msg_fd].head;
+    ssize_t         len = msg->len;
+    
+    if ( (Backlogs[msg_fd].head = msg->next) == NULL )
+	Backlogs[msg_fd].tail = NULL;
+    *payload = msg->payload;
+    *uid = msg->uid;
+    *gid = msg->gid;
+    free(msg);
+    return len;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Check for deferred messages on msg_fd.  select() and poll()
+ *      cannot see these, since they have already been read from the
+ *      socket, so event loops must check here as well.
+ *
+ *  Returns:
+ *      true if lpjs_recv_munge() will return a message without reading
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+bool    lpjs_recv_pending(int msg_fd)
+
+{
+    return (msg_fd >= 0) && ((size_t)msg_fd < Backlogs_size) &&
+	   (Backlogs[msg_fd].head != NULL);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Discard deferred messages on msg_fd, e.g. when it is closed.
+ *      File descriptors are reused, so a new connection must not
+ *      inherit them.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    lpjs_discard_deferred(int msg_fd)
+
+{
+    char    *payload;
+    uid_t   uid;
+    gid_t   gid;
+    
+    while ( lpjs_recv_pending(msg_fd) )
+    {
+	lpjs_undefer(msg_fd, &payload, &uid, &gid);
+	free(payload);
+    }
+}
+
+
+/*
+ *  Compression methods the peer on each fd can expand, indexed by
+ *  fd, grown as needed.  See LPJS_COMPRESS_MAGIC in network.h.
+ */
+
+static unsigned char    *Compress_methods = NULL;
+static size_t           Compress_methods_size = 0;
+
+/***************************************************************************
+ *  Description:
+ *      Record the compression methods the peer on msg_fd has
+ *      advertised, limited to those we support.  Use 0 to disable
+ *      compression, e.g. on a new connection that reuses msg_fd.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    lpjs_compress_enable(int msg_fd, unsigned methods)
+
+{
+    size_t          new_size;
+    unsigned char   *new_methods;
+    
+    if ( msg_fd < 0 )
+	return;
+    
+    if ( (size_t)msg_fd >= Compress_methods_size )
+    {
+	if ( methods == 0 )
+	    return;
+	for (new_size = Compress_methods_size == 0 ? 64 : Compress_methods_size;
+	     new_size <= (size_t)msg_fd; new_size *= 2)
+	    ;
+	if ( (new_methods = realloc(Compress_methods, new_size)) == NULL )
+	{
+	    lpjs_log("%s(): Error: realloc() failed.\n", __FUNCTION__);
+	    exit(EX_UNAVAILABLE);
+	}
+	memset(new_methods + Compress_methods_size, 0,
+	       new_size - Compress_methods_size);
+	Compress_methods = new_methods;
+	Compress_methods_size = new_size;
+    }
+    Compress_methods[msg_fd] = methods & LPJS_COMPRESS_METHODS;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Get the compression methods usable on msg_fd
+ *
+ *  Returns:
+ *      Bit mask of LPJS_COMPRESS_* methods, 0 if none
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+unsigned    lpjs_compress_methods(int msg_fd)
+
+{
+    if ( (msg_fd < 0) || ((size_t)msg_fd >= Compress_methods_size) )
+	return 0;
+    return Compress_methods[msg_fd];
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Enable compression on msg_fd for the methods advertised in a
+ *      binary request by WIRE_TAG_COMPRESSION.  Requests from older
+ *      peers have no such field, and leave compression disabled.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    lpjs_compress_accept(int msg_fd, const char *payload, size_t len)
+
+{
+    wire_field_t    field;
+    uint64_t        methods;
+    
+    // +1 to skip request code
+    if ( (len > 1) && wire_is_binary(payload + 1, len - 1) &&
+	 (wire_find_field(payload + 1, len - 1, WIRE_TAG_COMPRESSION,
+			  &field) == WIRE_OK) &&
+	 (wire_get_uint(&field, &methods) == WIRE_OK) )
+	lpjs_compress_enable(msg_fd, methods);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Build a request with no arguments, such as
+ *      LPJS_DISPATCHD_REQUEST_JOB_LIST, advertising the compression
+ *      methods we can expand, so that a large response may be
+ *      compressed.  Older dispatchds ignore everything after the
+ *      request code.
+ *
+ *  Returns:
+ *      Message length, for lpjs_send_munge_bin()
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+size_t  lpjs_list_request(char *msg, size_t size, int request_code)
+
+{
+    wire_writer_t   writer;
+    
+    msg[0] = request_code;
+    wire_writer_init(&writer, msg + 1, size - 1);
+    wire_put_uint(&writer, WIRE_TAG_COMPRESSION, LPJS_COMPRESS_METHODS);
+    if ( wire_writer_len(&writer) < 0 )
+    {
+	// Caller's buffer is too small, just send the request code
+	msg[1] = '\0';
+	return 1;
+    }
+    return wire_writer_len(&writer) + 1;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Compress a message for msg_fd, if the peer supports it and
+ *      the message is at least LPJS_COMPRESS_MIN bytes
+ *
+ *  Returns:
+ *      A pooled buffer holding the compressed message, which the
+ *      caller returns with lpjs_buff_put(), or NULL if the message
+ *      should be sent as is
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static lpjs_buff_t  *lpjs_compress_msg(int msg_fd, const void *msg,
+				       size_t msg_len)
+
+{
+    lpjs_buff_t     *compressed;
+    unsigned char   *header;
+    ssize_t         len;
+    
+    if ( ((lpjs_compress_methods(msg_fd) & LPJS_COMPRESS_LZ) == 0) ||
+	 (msg_len < LPJS_COMPRESS_MIN) || (msg_len > UINT32_MAX) )
+	return NULL;
+    
+    // Not worth it unless it saves something after the header
+    compressed = lpjs_buff_get(msg_len);
+    len = lz_compress(msg, msg_len, compressed->data + LPJS_COMPRESS_HEADER_LEN,
+		      msg_len - LPJS_COMPRESS_HEADER_LEN - 1);
+    if ( len < 0 )
+    {
+	lpjs_buff_put(&compressed);
+	return NULL;
+    }
+    
+    header = (unsigned char *)compressed->data;
+    header[0] = LPJS_COMPRESS_MAGIC;
+    header[1] = LPJS_COMPRESS_LZ;
+    header[2] = msg_len >> 24;
+    header[3] = msg_len >> 16;
+    header[4] = msg_len >> 8;
+    header[5] = msg_len;
+    compressed->len = LPJS_COMPRESS_HEADER_LEN + len;
+    return compressed;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Check whether a received payload was compressed by
+ *      lpjs_compress_msg()
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static bool lpjs_is_compressed(const char *payload, size_t len)
+
+{
+    return (len >= LPJS_COMPRESS_HEADER_LEN) &&
+	   ((unsigned char)payload[0] == LPJS_COMPRESS_MAGIC);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Replace a compressed payload with the original message,
+ *      '\0'-terminated as for munge_decode().  On failure, *payload
+ *      is freed.
+ *
+ *  Returns:
+ *      Length of the original message, or -1 if malformed
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static ssize_t  lpjs_expand_msg(char **payload, size_t len)
+
+{
+    const unsigned char *header = (unsigned char *)*payload;
+    size_t      original_len;
+    char        *original;
+    
+    original_len = (size_t)header[2] << 24 | header[3] << 16 |
+		   header[4] << 8 | header[5];
+    if ( (header[1] != LPJS_COMPRESS_LZ) ||
+	 (original_len > LPJS_MSG_SIZE_MAX) )
+    {
+	free(*payload);
+	return -1;
+    }
+    
+    if ( (original = malloc(original_len + 1)) == NULL )
+    {
+	lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
+	exit(EX_UNAVAILABLE);
+    }
+    if ( lz_decompress(*payload + LPJS_COMPRESS_HEADER_LEN,
+		       len - LPJS_COMPRESS_HEADER_LEN,
+		       original, original_len) != (ssize_t)original_len )
+    {
+	free(original);
+	free(*payload);
+	return -1;
+    }
+    original[original_len] = '\0';
+    free(*payload);
+    *payload = original;
+    return original_len;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Authenticate and acknowledge a message received into incoming
+ *      by lpjs_recv_buff(), and return its payload as described for
+ *      lpjs_recv_munge().  incoming is returned to the pool.
+ *
+ *  Returns:
+ *      Payload length, 0 if the peer closed a local connection,
+ *      -1 if the message could not be authenticated or expanded
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Factor out from lpjs_recv_munge()
+ *  2026-10-19  Jason Bacon Expand compressed messages
+ *  2026-10-19  Jason Bacon Use the pluggable credential backend (cred.h)
+ ***************************************************************************/
+
+static ssize_t  lpjs_open_msg(int msg_fd, lpjs_buff_t *incoming,
+			      ssize_t bytes_read, char **payload,
+			      uid_t *uid, gid_t *gid,
+			      int(*close_function)(int))
+
+{
+    int         payload_len;
+    int         cred_status;
+    ssize_t     session_len;
+    const unsigned char *session_payload;
+    uid_t       session_uid;
+    gid_t       session_gid;
+    
+    if ( lpjs_local_peer_get(msg_fd, uid, gid) == 0 )
+    {
+	if ( bytes_read == 0 )
+	{
+	    // Peer closed the connection, nothing allocated
+	    lpjs_buff_put(&incoming);
+	    return 0;
+	}
+	
+	// Credentials from the kernel, nothing to decode.  Caller frees.
+	*payload = incoming->data;
+	incoming->data = NULL;
+	incoming->size = 0;
+	lpjs_buff_put(&incoming);
+	
+	lpjs_send(msg_fd, 0, LPJS_MUNGE_CRED_VERIFIED_MSG);
+	return bytes_read;
+    }
+    else if ( session_is_frame(incoming->data, bytes_read) )
+    {
+	if ( (session_len = session_open(msg_fd, (unsigned char *)incoming->data,
+					 bytes_read, &session_payload)) < 0 )
+	{
+	    lpjs_buff_put(&incoming);
+	    lpjs_send(msg_fd, 0, LPJS_MUNGE_CRED_FAILED_MSG);
+	    if ( close_function != NULL )
+		close_function(msg_fd);
+	    lpjs_log("%s(): Error: Unauthenticated session frame on fd = %d.\n",
+		     __FUNCTION__, msg_fd);
+	    return -1;
+	}
+	
+	// Same as munge_decode(): caller frees, '\0'-terminated
+	if ( (*payload = malloc(session_len + 1)) == NULL )
+	{
+	    lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
+	    exit(EX_UNAVAILABLE);
+	}
+	memcpy(*payload, session_payload, session_len);
+	(*payload)[session_len] = '\0';
+	payload_len = session_len;
+	lpjs_buff_put(&incoming);
+	session_get_peer(msg_fd, uid, gid);
+    }
+    else
+    {
+	cred_status = lpjs_cred_decode(incoming->data, (void **)payload,
+				       &payload_len, uid, gid);
+	lpjs_buff_put(&incoming);
+	// Munge messages on a session must come from the same user
+	if ( (cred_status == LPJS_CRED_OK) &&
+	     (session_get_peer(msg_fd, &session_uid, &session_gid) == 0) &&
+	     ((*uid != session_uid) || (*gid != session_gid)) )
+	{
+	    lpjs_log("%s(): Error: uid %d on fd = %d does not match checkin uid %d.\n",
+		     __FUNCTION__, *uid, msg_fd, session_uid);
+	    free(*payload);
+	    cred_status = LPJS_CRED_INVALID;
+	}
+	if ( cred_status != LPJS_CRED_OK )
+	{
+	    // Let a pipelining sender know, rather than just hanging up
+	    lpjs_send(msg_fd, 0, LPJS_MUNGE_CRED_FAILED_MSG);
+	    if ( close_function != NULL )
+		close_function(msg_fd);
+	    lpjs_log("%s(): Error: %s decode(fd = %d) failed.  %zd bytes, Error = %s\n",
+		     __FUNCTION__, lpjs_cred_backend_name(), msg_fd, bytes_read,
+		     munge_strerror(cred_status));
+	    return -1;  // FIXME: Define return codes
+	}
+    }
+    
+    // Compressed by lpjs_send_munge_frame()
+    if ( lpjs_is_compressed(*payload, payload_len) &&
+	 ((payload_len = lpjs_expand_msg(payload, payload_len)) < 0) )
+    {
+	lpjs_send(msg_fd, 0, LPJS_MUNGE_CRED_FAILED_MSG);
+	if ( close_function != NULL )
+	    close_function(msg_fd);
+	lpjs_log("%s(): Error: Malformed compressed message on fd = %d.\n",
+		 __FUNCTION__, msg_fd);
+	return -1;
+    }
+    
+    // Acknolwedge successful receipt of message
+    lpjs_send(msg_fd, 0, LPJS_MUNGE_CRED_VERIFIED_MSG);
+    return payload_len;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Read the next message from the socket and open it with
+ *      lpjs_open_msg().  Arguments are as for lpjs_recv_munge().
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Factor out from lpjs_recv_munge()
+ ***************************************************************************/
+
+static ssize_t  lpjs_recv_next(int msg_fd, char **payload, int flags,
+			       int timeout, uid_t *uid, gid_t *gid,
+			       int(*close_function)(int))
+
+{
+    ssize_t     bytes_read;
+    lpjs_buff_t *incoming;
+    
+    // Sized to the message, so scripts need no large stack buffers
+    incoming = lpjs_buff_get(0);
+    bytes_read = lpjs_recv_buff(msg_fd, incoming, flags, timeout);
+    
+    if ( bytes_read == LPJS_RECV_FAILED )
+    {
+	lpjs_log("%s(): Error: lpjs_recv(fd = %d) failed: %s",
+		__FUNCTION__, msg_fd, strerror(errno));
+	lpjs_buff_put(&incoming);
+	return LPJS_RECV_FAILED;
+    }
+    else if ( bytes_read == LPJS_RECV_TIMEOUT )
+    {
+	lpjs_buff_put(&incoming);
+	return LPJS_RECV_TIMEOUT;
+    }
+    else if ( bytes_read < 0 )
+    {
+	lpjs_log("%s(): Bug: Undefined return code from lpjs_recv(fd = %d): %d\n",
+		 __FUNCTION__, msg_fd, bytes_read);
+	// FIXME: What should we really do here?
+	lpjs_buff_put(&incoming);
+	return LPJS_RECV_FAILED;
+    }
+    
+    return lpjs_open_msg(msg_fd, incoming, bytes_read, payload, uid, gid,
+			 close_function);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Receive a message sent by lpjs_send().  A uint32_t containing
+ *      the message length in network byte order is received first,
+ *      followed by the message.  The interface is idential to recv(2).
+ *
+ *  Arguments:
+ *      msg_fd          Socket file descriptor
+ *      payload         Buffer to receive message
+ *      flags           See recv(2)
+ *      timeout         useconds, passed to lpjs_recv
+ *      uid, gid        Owner of sending process
+ *      close_function  Different close procedures for dispatch and compd
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2024-02-19  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Collect pipelined acks first, report failures
+ *  2026-10-19  Jason Bacon Accept session frames, check uid on sessions
+ *  2026-10-19  Jason Bacon Receive into a pooled heap buffer
+ *  2026-10-19  Jason Bacon Accept local connections without munge
+ *  2026-10-19  Jason Bacon Return deferred messages first
+ ***************************************************************************/
+
+ssize_t lpjs_recv_munge(int msg_fd, char **payload, int flags, int timeout,
+			uid_t *uid, gid_t *gid, int(*close_function)(int))
+
+{
+    // Acknowledgements for pipelined messages precede any reply
+    if ( (lpjs_acks_due(msg_fd, 0) > 0) &&
+	 (lpjs_collect_acks(msg_fd, true) != LPJS_MSG_SENT) )
+	return LPJS_RECV_FAILED;
+    
+    // Received while waiting for an acknowledgement or reply
+    if ( lpjs_recv_pending(msg_fd) )
+	return lpjs_undefer(msg_fd, payload, uid, gid);
+    
+    return lpjs_recv_next(msg_fd, payload, flags, timeout, uid, gid,
+			  close_function);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Receive the reply to a request sent to compd on its persistent
+ *      connection, e.g. LPJS_CHAPERONE_FORKED.  compd also forwards
+ *      chaperone notifications on this connection (see
+ *      lpjs_send_via_compd()), so some may arrive ahead of the reply.
+ *      These are deferred, in order, for later lpjs_recv_munge()
+ *      calls.  The reply itself is never deferred, since compd sends
+ *      it only after acknowledging the request.
+ *
+ *      Arguments and return values are as for lpjs_recv_munge().
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+ssize_t lpjs_recv_munge_reply(int msg_fd, char **payload, int flags,
+			      int timeout, uid_t *uid, gid_t *gid,
+			      int(*close_function)(int))
+
+{
+    ssize_t     bytes;
+    
+    if ( (lpjs_acks_due(msg_fd, 0) > 0) &&
+	 (lpjs_collect_acks(msg_fd, true) != LPJS_MSG_SENT) )
+	return LPJS_RECV_FAILED;
+    
+    while ( ((bytes = lpjs_recv_next(msg_fd, payload, flags, timeout,
+				     uid, gid, close_function)) > 0) &&
+	    lpjs_is_notification(*payload) )
+	lpjs_defer(msg_fd, *payload, bytes, *uid, *gid);
+    
+    return bytes;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Check whether a payload is a chaperone notification, which
+ *      compd may forward to dispatchd at any time
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+bool    lpjs_is_notification(const char *payload)
+
+{
+    return (payload[0] == LPJS_DISPATCHD_REQUEST_CHAPERONE_STATUS) ||
+	   (payload[0] == LPJS_DISPATCHD_REQUEST_JOB_STARTED) ||
+	   (payload[0] == LPJS_DISPATCHD_REQUEST_JOB_COMPLETE);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Send a munge-encoded text message
+ *
+ *  Returns:
+ *      EX_OK on success, various other error codes
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2024-01-21  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Wrap lpjs_send_munge_bin()
+ ***************************************************************************/
+
+int     lpjs_send_munge(int msg_fd, const char *msg, int(*close_function)(int))
+
+{
+    return lpjs_send_munge_bin(msg_fd, msg, strlen(msg), close_function);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Send a munge-encoded message that may contain '\0' bytes,
+ *      such as the binary format in wire.h, and wait for it and any
+ *      pipelined messages before it to be acknowledged.
+ *
+ *  Returns:
+ *      EX_OK on success, various other error codes
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Factor out from lpjs_send_munge()
+ ***************************************************************************/
+
+int     lpjs_send_munge_bin(int msg_fd, const void *msg, size_t msg_len,
+			    int(*close_function)(int))
+
+{
+    return lpjs_send_munge_bin_to(msg_fd, msg, msg_len, LPJS_CRED_ANY_UID,
+				  close_function);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Like lpjs_send_munge_bin(), but a munge credential can only
+ *      be decoded by reader_uid, e.g. for the checkin reply, which
+ *      carries a session nonce (see session.h).
+ *
+ *  Returns:
+ *      EX_OK on success, various other error codes
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     lpjs_send_munge_bin_to(int msg_fd, const void *msg, size_t msg_len,
+			       uid_t reader_uid, int(*close_function)(int))
+
+{
+    int     status;
+    
+    if ( (status = lpjs_send_munge_frame_to(msg_fd, msg, msg_len, reader_uid,
+					    close_function)) != LPJS_MSG_SENT )
+	return status;
+    
+    return lpjs_collect_acks(msg_fd, true);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Send a munge-encoded text message without waiting for the
+ *      acknowledgement, so that many messages can be in flight.
+ *      Use this for a series of messages such as a job listing, to
+ *      avoid a network round trip per message.
+ *
+ *      Receivers acknowledge each message in order, just as for
+ *      lpjs_send_munge(), so no changes are needed on the other end.
+ *      Acknowledgements that have already arrived are collected here,
+ *      so they cannot back up and stall the receiver.  The rest are
+ *      collected by the next lpjs_send_munge() or lpjs_recv_munge()
+ *      on msg_fd, so a failure is reported there, e.g. when sending
+ *      EOT in lpjs_dispatchd_safe_close().
+ *
+ *  Returns:
+ *      LPJS_MSG_SENT if the message was sent and no acknowledgement
+ *      received so far indicates an error, other codes otherwise
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     lpjs_send_munge_pipelined(int msg_fd, const char *msg,
+				  int(*close_function)(int))
+
+{
+    int     status;
+    
+    if ( (status = lpjs_send_munge_frame(msg_fd, msg, strlen(msg),
+					 close_function)) != LPJS_MSG_SENT )
+	return status;
+    
+    return lpjs_collect_acks(msg_fd, false);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Send one message with a munge credential that reader_uid can
+ *      decode, and record that an acknowledgement is due
+ *
+ *  Returns:
+ *      LPJS_MSG_SENT, LPJS_MUNGE_FAILED, or LPJS_SEND_FAILED
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Factor out from lpjs_send_munge_frame()
+ *  2026-10-19  Jason Bacon Use the pluggable credential backend (cred.h)
+ *  2026-10-19  Jason Bacon Restrict to reader_uid
+ ***************************************************************************/
+
+static int  lpjs_send_munge_cred(int msg_fd, const void *msg,
+				 size_t msg_len, uid_t reader_uid,
+				 int(*close_function)(int))
+
+{
+    char        *cred;
+    int         cred_status;
+    struct iovec    iov;
+    
+    if ( (cred_status = lpjs_cred_encode_for(&cred, msg, msg_len, reader_uid))
+	    != LPJS_CRED_OK )
+    {
+	lpjs_log("%s(): Error: %s encode(fd = %d) failed: %s.\n",
+		__FUNCTION__, lpjs_cred_backend_name(), msg_fd,
+		munge_strerror(cred_status));
+	lpjs_forget_acks(msg_fd);
+	// May be close(), lpjs_dispatchd_safe_close(), or lpjs_no_close()
+	close_function(msg_fd);
+	return LPJS_MUNGE_FAILED;
     }
-    // lpjs_debug("%s(): Done.\n", __FUNCTION__);
 
+    // lpjs_debug("%s(): Sending %zd bytes: %s...\n", __FUNCTION__, strlen(cred), cred);
+    // Straight from munge's buffer, including the '\0' as in lpjs_send()
+    iov.iov_base = cred;
+    iov.iov_len = strlen(cred) + 1;
+    if ( lpjs_sendv(msg_fd, 0, &iov, 1) < 0 )
+    {
+	lpjs_log("%s(): Error: Failed to send credential to dispatchd",
+		__FUNCTION__);
+	lpjs_forget_acks(msg_fd);
+	// May be close(), lpjs_dispatchd_safe_close(), or lpjs_no_close()
+	close_function(msg_fd);
+	free(cred);
+	return LPJS_SEND_FAILED;
+    }
+    free(cred);
+    lpjs_acks_due(msg_fd, 1);
+    
+    return LPJS_MSG_SENT;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Encode and send one message, and record that an
+ *      acknowledgement is due.  Connections with a session established
+ *      at checkin use a session frame instead of a munge credential,
+ *      and local connections (lpjs_connect_local()) send it as is.
+ *      Large messages are compressed first if the peer advertised
+ *      support (lpjs_compress_enable()).
+ *
+ *  Returns:
+ *      LPJS_MSG_SENT, LPJS_MUNGE_FAILED, or LPJS_SEND_FAILED
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Factor out from lpjs_send_munge_bin()
+ *  2026-10-19  Jason Bacon Send credential with lpjs_sendv(), no copy
+ *  2026-10-19  Jason Bacon Send local connections without munge
+ *  2026-10-19  Jason Bacon Compress large messages
+ ***************************************************************************/
+
+int     lpjs_send_munge_frame(int msg_fd, const void *msg, size_t msg_len,
+			      int(*close_function)(int))
+
+{
+    return lpjs_send_munge_frame_to(msg_fd, msg, msg_len, LPJS_CRED_ANY_UID,
+				    close_function);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Like lpjs_send_munge_frame(), but a munge credential can only
+ *      be decoded by reader_uid.  Session frames and local connections
+ *      are already private to the two ends.
+ *
+ *  Returns:
+ *      LPJS_MSG_SENT, LPJS_MUNGE_FAILED, or LPJS_SEND_FAILED
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Factor out from lpjs_send_munge_frame()
+ ***************************************************************************/
+
+int     lpjs_send_munge_frame_to(int msg_fd, const void *msg, size_t msg_len,
+				 uid_t reader_uid, int(*close_function)(int))
+
+{
+    struct iovec    iov;
+    uid_t       peer_uid;
+    gid_t       peer_gid;
+    lpjs_buff_t *compressed;
+    int         status;
+    
+    // The kernel vouches for both ends of a local connection, which
+    // are received as is even if a session was started by checkin
+    if ( lpjs_local_peer_get(msg_fd, &peer_uid, &peer_gid) == 0 )
+    {
+	iov.iov_base = (void *)msg;
+	iov.iov_len = msg_len;
+	if ( lpjs_sendv(msg_fd, 0, &iov, 1) < 0 )
+	{
+	    lpjs_log("%s(): Error: send(fd = %d) failed: %s\n",
+		     __FUNCTION__, msg_fd, strerror(errno));
+	    lpjs_forget_acks(msg_fd);
+	    close_function(msg_fd);
+	    return LPJS_SEND_FAILED;
+	}
+	lpjs_acks_due(msg_fd, 1);
+	return LPJS_MSG_SENT;
+    }
+    
+    // NULL if not worthwhile, in which case send as is
+    if ( (compressed = lpjs_compress_msg(msg_fd, msg, msg_len)) != NULL )
+    {
+	msg = compressed->data;
+	msg_len = compressed->len;
+    }
+    
+    if ( session_active(msg_fd) )
+	status = lpjs_send_session_frame(msg_fd, msg, msg_len, close_function);
+    else
+	status = lpjs_send_munge_cred(msg_fd, msg, msg_len, reader_uid,
+				      close_function);
+    lpjs_buff_put(&compressed);
+    
+    return status;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Send one message in an authenticated session frame (see
+ *      session.h), and record that an acknowledgement is due.
+ *      This replaces munge_encode() on the sending end and
+ *      munge_decode() on the receiving end for all messages after
+ *      checkin on the persistent dispatchd-compd connection.
+ *
+ *  Returns:
+ *      LPJS_MSG_SENT or LPJS_SEND_FAILED
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Seal into a pooled buffer, any size
+ ***************************************************************************/
+
+int     lpjs_send_session_frame(int msg_fd, const void *msg, size_t msg_len,
+				int(*close_function)(int))
+
+{
+    lpjs_buff_t     *frame;
+    ssize_t         frame_len;
+    struct iovec    iov;
+    
+    frame = lpjs_buff_get(msg_len + SESSION_OVERHEAD);
+    if ( (frame_len = session_seal(msg_fd, msg, msg_len,
+				   (unsigned char *)frame->data,
+				   frame->size)) < 0 )
+    {
+	lpjs_log("%s(): Bug: session_seal(fd = %d) failed for %zu bytes.\n",
+		 __FUNCTION__, msg_fd, msg_len);
+	lpjs_buff_put(&frame);
+	return LPJS_SEND_FAILED;
+    }
+    
+    // Length prefix as in lpjs_send(), so lpjs_recv() can read it
+    iov.iov_base = frame->data;
+    iov.iov_len = frame_len;
+    if ( lpjs_sendv(msg_fd, 0, &iov, 1) < 0 )
+    {
+	lpjs_log("%s(): Error: send(fd = %d) failed: %s\n",
+		 __FUNCTION__, msg_fd, strerror(errno));
+	lpjs_buff_put(&frame);
+	lpjs_forget_acks(msg_fd);
+	// May be close(), lpjs_dispatchd_safe_close(), or lpjs_no_close()
+	close_function(msg_fd);
+	return LPJS_SEND_FAILED;
+    }
+    lpjs_buff_put(&frame);
+    lpjs_acks_due(msg_fd, 1);
+    
     return LPJS_MSG_SENT;
 }
 
 
+/*
+ *  Number of acknowledgements due on each fd, for messages sent by
+ *  lpjs_send_munge_frame().  Indexed by fd, grown as needed.
+ */
+
+static unsigned *Acks_due = NULL;
+static size_t   Acks_due_size = 0;
+
+/***************************************************************************
+ *  Description:
+ *      Adjust the number of acknowledgements due on msg_fd
+ *
+ *  Returns:
+ *      The new count
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+unsigned    lpjs_acks_due(int msg_fd, int adjustment)
+
+{
+    size_t      new_size;
+    unsigned    *new_acks;
+    
+    if ( (size_t)msg_fd >= Acks_due_size )
+    {
+	if ( adjustment <= 0 )
+	    return 0;
+	for (new_size = Acks_due_size == 0 ? 64 : Acks_due_size;
+	     new_size <= (size_t)msg_fd; new_size *= 2)
+	    ;
+	if ( (new_acks = realloc(Acks_due, new_size * sizeof(*Acks_due)))
+		== NULL )
+	{
+	    lpjs_log("%s(): Error: realloc() failed.\n", __FUNCTION__);
+	    exit(EX_UNAVAILABLE);
+	}
+	memset(new_acks + Acks_due_size, 0,
+	       (new_size - Acks_due_size) * sizeof(*Acks_due));
+	Acks_due = new_acks;
+	Acks_due_size = new_size;
+    }
+    Acks_due[msg_fd] += adjustment;
+    return Acks_due[msg_fd];
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Discard acknowledgements due on msg_fd, e.g. when it is closed.
+ *      File descriptors are reused, so a new connection must not
+ *      inherit them.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    lpjs_forget_acks(int msg_fd)
+
+{
+    if ( (msg_fd >= 0) && ((size_t)msg_fd < Acks_due_size) )
+	Acks_due[msg_fd] = 0;
+}
+
+
+/*
+ *  Peer credentials for each AF_UNIX connection, indexed by fd, grown
+ *  as needed.  Messages on these connections are not munge-encoded.
+ */
+
+typedef struct
+{
+    bool    local;
+    uid_t   uid;
+    gid_t   gid;
+}   lpjs_local_peer_t;
+
+static lpjs_local_peer_t    *Local_peers = NULL;
+static size_t               Local_peers_size = 0;
+
+/***************************************************************************
+ *  Description:
+ *      Check whether msg_fd is an AF_UNIX connection, and if so,
+ *      record the peer's credentials as reported by the kernel.
+ *      Called on both ends after accept() or connect().
+ *
+ *  Returns:
+ *      1 if msg_fd is local, 0 if not, -1 if credentials are unavailable
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     lpjs_local_peer_start(int msg_fd)
+
+{
+    struct sockaddr_storage address;
+    socklen_t               address_len = sizeof(address);
+    lpjs_local_peer_t       *new_peers;
+    size_t                  new_size;
+    uid_t                   uid;
+    gid_t                   gid;
+#ifdef __linux__
+    struct ucred            cred;
+    socklen_t               cred_len = sizeof(cred);
+#endif
+    
+    lpjs_local_peer_end(msg_fd);
+    if ( (getsockname(msg_fd, (struct sockaddr *)&address, &address_len) != 0)
+	 || (address.ss_family != AF_UNIX) )
+	return 0;
+    
+#ifdef __linux__
+    if ( getsockopt(msg_fd, SOL_SOCKET, SO_PEERCRED, &cred, &cred_len) != 0 )
+    {
+	lpjs_log("%s(): Error: SO_PEERCRED failed on fd = %d: %s\n",
+		 __FUNCTION__, msg_fd, strerror(errno));
+	return -1;
+    }
+    uid = cred.uid;
+    gid = cred.gid;
+#else
+    if ( getpeereid(msg_fd, &uid, &gid) != 0 )
+    {
+	lpjs_log("%s(): Error: getpeereid() failed on fd = %d: %s\n",
+		 __FUNCTION__, msg_fd, strerror(errno));
+	return -1;
+    }
+#endif
+    
+    if ( (size_t)msg_fd >= Local_peers_size )
+    {
+	for (new_size = Local_peers_size == 0 ? 64 : Local_peers_size;
+	     new_size <= (size_t)msg_fd; new_size *= 2)
+	    ;
+	if ( (new_peers = realloc(Local_peers,
+				  new_size * sizeof(*Local_peers))) == NULL )
+	{
+	    lpjs_log("%s(): Error: realloc() failed.\n", __FUNCTION__);
+	    exit(EX_UNAVAILABLE);
+	}
+	memset(new_peers + Local_peers_size, 0,
+	       (new_size - Local_peers_size) * sizeof(*Local_peers));
+	Local_peers = new_peers;
+	Local_peers_size = new_size;
+    }
+    Local_peers[msg_fd].local = true;
+    Local_peers[msg_fd].uid = uid;
+    Local_peers[msg_fd].gid = gid;
+    
+    return 1;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Forget the peer credentials for msg_fd, e.g. when it is closed
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    lpjs_local_peer_end(int msg_fd)
+
+{
+    if ( (msg_fd >= 0) && ((size_t)msg_fd < Local_peers_size) )
+	Local_peers[msg_fd].local = false;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Get the credentials of the peer on a local connection
+ *
+ *  Returns:
+ *      0 on success, -1 if msg_fd is not a local connection
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     lpjs_local_peer_get(int msg_fd, uid_t *uid, gid_t *gid)
+
+{
+    if ( (msg_fd < 0) || ((size_t)msg_fd >= Local_peers_size) ||
+	 ! Local_peers[msg_fd].local )
+	return -1;
+    *uid = Local_peers[msg_fd].uid;
+    *gid = Local_peers[msg_fd].gid;
+    return 0;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Tell a message sent by the peer from an acknowledgement, while
+ *      waiting for acknowledgements.  Only session and local
+ *      connections can carry both, see lpjs_collect_acks().
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static bool lpjs_is_peer_msg(int msg_fd, const char *msg, size_t len)
+
+{
+    uid_t   uid;
+    gid_t   gid;
+    
+    // Local messages are sent as is, even with a session, and all
+    // begin with a request code
+    if ( lpjs_local_peer_get(msg_fd, &uid, &gid) == 0 )
+	return (strcmp(msg, LPJS_MUNGE_CRED_VERIFIED_MSG) != 0) &&
+	       (strcmp(msg, LPJS_MUNGE_CRED_FAILED_MSG) != 0);
+    
+    return session_active(msg_fd) && session_is_frame(msg, len);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Read acknowledgements due on msg_fd.  They arrive in the order
+ *      the messages were sent, ahead of any reply from the receiver.
+ *      If wait is false, only read those that have already arrived.
+ *
+ *      A receiver that cannot decode a message replies with
+ *      LPJS_MUNGE_CRED_FAILED_MSG, and older receivers just close
+ *      the connection, so either results in an error here.
+ *
+ *      On the persistent dispatchd-compd connection, the peer may
+ *      send its own message before acknowledging ours.  It is
+ *      acknowledged and deferred for the next lpjs_recv_munge(), so
+ *      that both ends cannot end up waiting for each other.
+ *
+ *  Returns:
+ *      LPJS_MSG_SENT if all acknowledgements read were positive,
+ *      LPJS_RECV_FAILED or LPJS_RECV_TIMEOUT otherwise
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Factor out from lpjs_send_munge()
+ *  2026-10-19  Jason Bacon Defer messages sent by the peer
+ ***************************************************************************/
+
+int     lpjs_collect_acks(int msg_fd, bool wait)
+
+{
+    lpjs_buff_t     *incoming;
+    char            *payload;
+    ssize_t         bytes;
+    struct pollfd   poll_fd;
+    uid_t           uid;
+    gid_t           gid;
+    int             status = LPJS_MSG_SENT;
+    
+    poll_fd.fd = msg_fd;
+    poll_fd.events = POLLIN;
+    incoming = lpjs_buff_get(0);
+    while ( lpjs_acks_due(msg_fd, 0) > 0 )
+    {
+	if ( ! wait && (poll(&poll_fd, 1, 0) < 1) )
+	    break;
+	
+	// lpjs_debug("%s(): Waiting for response.\n", __FUNCTION__);
+	bytes = lpjs_recv_buff(msg_fd, incoming, 0, 0);
+	if ( bytes == LPJS_RECV_FAILED )
+	{
+	    lpjs_log("%s(): Error: lpjs_recv(fd = %d) failed.\n",
+		    __FUNCTION__, msg_fd);
+	    status = LPJS_RECV_FAILED;
+	    break;
+	}
+	else if ( bytes == LPJS_RECV_TIMEOUT )
+	{
+	    lpjs_log("%s(): Error: lpjs_recv(fd = %d) timeout.\n",
+		    __FUNCTION__,msg_fd);
+	    status = LPJS_RECV_TIMEOUT;
+	    break;
+	}
+	if ( (bytes > 0) && lpjs_is_peer_msg(msg_fd, incoming->data, bytes) )
+	{
+	    // lpjs_open_msg() returns incoming to the pool
+	    bytes = lpjs_open_msg(msg_fd, incoming, bytes, &payload,
+				  &uid, &gid, NULL);
+	    incoming = lpjs_buff_get(0);
+	    if ( bytes < 0 )
+	    {
+		status = LPJS_RECV_FAILED;
+		break;
+	    }
+	    lpjs_defer(msg_fd, payload, bytes, uid, gid);
+	    continue;
+	}
+	if ( (bytes < 1) || (bytes > LPJS_ACK_MSG_MAX) ||
+	     (strcmp(incoming->data, LPJS_MUNGE_CRED_VERIFIED_MSG) != 0) )
+	{
+	    lpjs_log("%s(): Warning: Expected %s, got %zd bytes on fd = %d.\n",
+		    __FUNCTION__, LPJS_MUNGE_CRED_VERIFIED_MSG, bytes, msg_fd);
+	    status = LPJS_RECV_FAILED;
+	    break;
+	}
+	lpjs_acks_due(msg_fd, -1);
+    }
+    lpjs_buff_put(&incoming);
+    if ( status != LPJS_MSG_SENT )
+	lpjs_forget_acks(msg_fd);
+    // lpjs_debug("%s(): Done.\n", __FUNCTION__);
+
+    return status;
+}
+
+
 /***************************************************************************
  *  Description:
  *      Wait for remote system to hang up.  This is used to avoid
@@ -508,6 +2085,9 @@ int     lpjs_wait_close(int msg_fd)
  *  History: 
  *  Date        Name        Modification
  *  2024-01-14  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Discard pipelined acks and session
+ *  2026-10-19  Jason Bacon Discard local peer credentials
+ *  2026-10-19  Jason Bacon Discard deferred messages
  ***************************************************************************/
 
 int     lpjs_dispatchd_safe_close(int msg_fd)
@@ -528,6 +2108,11 @@ int     lpjs_dispatchd_safe_close(int msg_fd)
     }
     
     lpjs_debug("%s(): Closing %d.\n", __FUNCTION__, msg_fd);
+    lpjs_forget_acks(msg_fd);
+    session_end(msg_fd);
+    lpjs_local_peer_end(msg_fd);
+    lpjs_discard_deferred(msg_fd);
+    lpjs_compress_enable(msg_fd, 0);
     return close(msg_fd);
 }
 
@@ -9,7 +9,9 @@
 
 enum
 {
-    // Internal events
+    // Internal events.  Chaperone notifications may be forwarded by
+    // compd (lpjs_is_notification()), so must not share codes with
+    // LPJS_CHAPERONE_FORKED or LPJS_COMPD_SCRIPT_NOT_CACHED.
     LPJS_DISPATCHD_REQUEST_COMPD_CHECKIN = 1,
     LPJS_DISPATCHD_REQUEST_CHAPERONE_STATUS,
     LPJS_DISPATCHD_REQUEST_JOB_STARTED,
@@ -20,7 +22,10 @@ enum
     LPJS_DISPATCHD_REQUEST_SUBMIT,
     LPJS_DISPATCHD_REQUEST_CANCEL,
     LPJS_DISPATCHD_REQUEST_PAUSE,
-    LPJS_DISPATCHD_REQUEST_RESUME
+    LPJS_DISPATCHD_REQUEST_RESUME,
+    LPJS_DISPATCHD_REQUEST_RELOAD_CONFIG,
+    LPJS_DISPATCHD_REQUEST_JOB_SUMMARY,
+    LPJS_DISPATCHD_REQUEST_SUBMIT_BATCH
 };
 
 enum
@@ -42,7 +47,11 @@ typedef enum
     LPJS_CHAPERONE_SCRIPT_FAILED,
     LPJS_CHAPERONE_OSERR,
     LPJS_CHAPERONE_CANTCREAT,
-    LPJS_CHAPERONE_EXEC_FAILED
+    LPJS_CHAPERONE_EXEC_FAILED,
+    
+    // Sent by compd instead of LPJS_CHAPERONE_FORKED if the new job
+    // request had only the script hash, and it is not in the cache
+    LPJS_COMPD_SCRIPT_NOT_CACHED
 }   chaperone_status_t;
 
 
@@ -66,6 +75,32 @@ typedef enum
 #define LPJS_TEXT_IP_ADDRESS_MAX    64
 // FIXME: 4096 is just a guestimate
 #define LPJS_MSG_LEN_MAX            LPJS_PAYLOAD_MAX + 4096
+/*
+ *  Largest message lpjs_recv_buff() will accept.  A job message holds
+ *  up to LPJS_SCRIPT_SIZE_MAX bytes of script, which munge base64
+ *  encodes to 4/3 its size, plus the job specs.
+ */
+#define LPJS_MSG_SIZE_MAX           (4 * 1024 * 1024)
+#define LPJS_ACK_MSG_MAX            64
+
+/*
+ *  Messages of at least LPJS_COMPRESS_MIN bytes are compressed on
+ *  connections where the peer advertised support with
+ *  WIRE_TAG_COMPRESSION (lpjs_compress_enable()).  A compressed
+ *  payload is
+ *
+ *      LPJS_COMPRESS_MAGIC [method] [original length] [data]
+ *
+ *  with the length a uint32 in network byte order.  Like WIRE_MAGIC,
+ *  LPJS_COMPRESS_MAGIC cannot start a request code or text message.
+ *  Local connections are never compressed.
+ */
+#define LPJS_COMPRESS_MAGIC         0xb8
+#define LPJS_COMPRESS_HEADER_LEN    6
+#define LPJS_COMPRESS_MIN           4096
+#define LPJS_COMPRESS_LZ            0x01    // Built-in LZ77, see lz.h
+#define LPJS_COMPRESS_METHODS       LPJS_COMPRESS_LZ    // All we support
+#define LPJS_SENDV_IOV_MAX          8
 #define LPJS_CONNECTION_QUEUE_MAX   4096    // Should be more than enough
 
 /*
@@ -77,16 +112,25 @@ typedef enum
  *  cannot be used by both.
  */
 #define LPJS_IP_TCP_PORT                (short)6818 // Need short for htons()
+// Unix-domain socket for commands run on the head node
+#define LPJS_LOCAL_SOCKET               LPJS_RUN_DIR "/dispatchd.sock"
+// Unix-domain socket for chaperone notifications, see lpjs_send_via_compd()
+#define LPJS_COMPD_SOCKET               LPJS_RUN_DIR "/compd.sock"
 #define LPJS_RETRY_TIME                 5
 #define LPJS_MUNGE_CRED_VERIFIED_MSG    "MCD"
+#define LPJS_MUNGE_CRED_FAILED_MSG      "MCF"
 #define LPJS_NODE_AUTHORIZED_MSG        "Node authorized"
 #define LPJS_NODE_NOT_AUTHORIZED_MSG    "Node not authorized"
 
 /*
  *  Used to decide whether different versions of LPJS can talk to each other.
- *  Bump this when there's a change to any message format.
+ *  Bump this when there's a change to any message format.  Compatibility
+ *  of binary messages is decided by WIRE_SCHEMA_VERSION (wire.h), so this
+ *  is informational for peers using them.  Compds still sending text
+ *  checkins are accepted if they report LPJS_PROTOCOL_VERSION_TEXT.
  */
-#define LPJS_PROTOCOL_VERSION           "0.0.1"
+#define LPJS_PROTOCOL_VERSION           "0.0.2"
+#define LPJS_PROTOCOL_VERSION_TEXT      "0.0.1"
 #define LPJS_WRONG_PROTOCOL_VERSION_MSG "Wrong LPJS protocol version"
 #define LPJS_WRONG_VERSION_RETRY_TIME   10  // Use 60 when stable
 
@@ -98,6 +142,9 @@ typedef enum
 #include "node-list.h"
 #endif
 
+#include <sys/uio.h>    // struct iovec
+#include "buff.h"
+
 #include "network-protos.h"
 
 #endif
@@ -491,6 +491,15 @@ char  node_get_arch_ae(node_t *node_ptr, size_t c)
 
 char *    node_get_state(node_t *node_ptr)
 
+{
+    // state is stored as a node_state_t.  Return the name for
+    // compatibility with code that prints or compares strings.
+    return node_state_name(node_ptr->state);
+}
+
+
+node_state_t    node_get_state_code(node_t *node_ptr)
+
 {
     return node_ptr->state;
 }
@@ -502,33 +511,31 @@ char *    node_get_state(node_t *node_ptr)
  *      
  *
  *  Description:
- *      Accessor for an array element of state member in a node_t
- *      structure. Use this function to get node_ptr->state[c]
- *      in a node_t object from non-member functions.
+ *      Accessor for msg_fd member in a node_t structure.
+ *      Use this function to get msg_fd in a node_t object
+ *      from non-member functions.
  *
  *  Arguments:
- *      node_ptr        Pointer to the structure to get
- *      c               Subscript to the state array
+ *      node_ptr        Pointer to the structure to set
  *
  *  Returns:
- *      Value of one element of structure member state.
+ *      Value of the structure member msg_fd.
  *
  *  Examples:
  *      node_t          node;
- *      size_t          c;
- *      char *          state_element;
+ *      int             msg_fd;
  *
- *      state_element = node_get_state_ae(&node, c);
+ *      msg_fd = node_get_msg_fd(&node);
  *
  *  History: 
  *  Date        Name        Modification
  *  2026-08-15  gen-get-set Auto-generated from node-private.h
  ***************************************************************************/
 
-char  node_get_state_ae(node_t *node_ptr, size_t c)
+int    node_get_msg_fd(node_t *node_ptr)
 
 {
-    return node_ptr->state[c];
+    return node_ptr->msg_fd;
 }
 
 
@@ -538,31 +545,31 @@ char  node_get_state_ae(node_t *node_ptr, size_t c)
  *      
  *
  *  Description:
- *      Accessor for msg_fd member in a node_t structure.
- *      Use this function to get msg_fd in a node_t object
+ *      Accessor for last_ping member in a node_t structure.
+ *      Use this function to get last_ping in a node_t object
  *      from non-member functions.
  *
  *  Arguments:
  *      node_ptr        Pointer to the structure to set
  *
  *  Returns:
- *      Value of the structure member msg_fd.
+ *      Value of the structure member last_ping.
  *
  *  Examples:
  *      node_t          node;
- *      int             msg_fd;
+ *      time_t          last_ping;
  *
- *      msg_fd = node_get_msg_fd(&node);
+ *      last_ping = node_get_last_ping(&node);
  *
  *  History: 
  *  Date        Name        Modification
  *  2026-08-15  gen-get-set Auto-generated from node-private.h
  ***************************************************************************/
 
-int    node_get_msg_fd(node_t *node_ptr)
+time_t    node_get_last_ping(node_t *node_ptr)
 
 {
-    return node_ptr->msg_fd;
+    return node_ptr->last_ping;
 }
 
 
@@ -572,29 +579,63 @@ int    node_get_msg_fd(node_t *node_ptr)
  *      
  *
  *  Description:
- *      Accessor for last_ping member in a node_t structure.
- *      Use this function to get last_ping in a node_t object
+ *      Accessor for wire_version member in a node_t structure.
+ *      Use this function to get wire_version in a node_t object
  *      from non-member functions.
  *
  *  Arguments:
  *      node_ptr        Pointer to the structure to set
  *
  *  Returns:
- *      Value of the structure member last_ping.
+ *      Value of the structure member wire_version.
  *
  *  Examples:
  *      node_t          node;
- *      time_t          last_ping;
+ *      unsigned        wire_version;
  *
- *      last_ping = node_get_last_ping(&node);
+ *      wire_version = node_get_wire_version(&node);
  *
  *  History: 
  *  Date        Name        Modification
- *  2026-08-15  gen-get-set Auto-generated from node-private.h
+ *  2026-10-19  Jason Bacon Begin
  ***************************************************************************/
 
-time_t    node_get_last_ping(node_t *node_ptr)
+unsigned    node_get_wire_version(node_t *node_ptr)
 
 {
-    return node_ptr->last_ping;
+    return node_ptr->wire_version;
+}
+
+
+/***************************************************************************
+ *  Library:
+ *      #include <node.h>
+ *      
+ *
+ *  Description:
+ *      Accessor for script_cache_slots member in a node_t structure.
+ *      Use this function to get script_cache_slots in a node_t object
+ *      from non-member functions.
+ *
+ *  Arguments:
+ *      node_ptr        Pointer to the structure to set
+ *
+ *  Returns:
+ *      Value of the structure member script_cache_slots.
+ *
+ *  Examples:
+ *      node_t          node;
+ *      unsigned        script_cache_slots;
+ *
+ *      script_cache_slots = node_get_script_cache_slots(&node);
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+unsigned    node_get_script_cache_slots(node_t *node_ptr)
+
+{
+    return node_ptr->script_cache_slots;
 }
@@ -24,6 +24,8 @@ char node_get_os_ae(node_t *node_ptr, size_t c);
 char *node_get_arch(node_t *node_ptr);
 char node_get_arch_ae(node_t *node_ptr, size_t c);
 char *node_get_state(node_t *node_ptr);
-char node_get_state_ae(node_t *node_ptr, size_t c);
+node_state_t node_get_state_code(node_t *node_ptr);
 int node_get_msg_fd(node_t *node_ptr);
 time_t node_get_last_ping(node_t *node_ptr);
+unsigned node_get_wire_version(node_t *node_ptr);
+unsigned node_get_script_cache_slots(node_t *node_ptr);
@@ -260,7 +260,8 @@ int     node_list_set_compute_node_count(node_list_t *node_list_ptr, unsigned ne
 int     node_list_set_compute_nodes_ae(node_list_t *node_list_ptr, size_t c, node_t *new_compute_nodes_element)
 
 {
-    if ( false )
+    // compute_nodes is now dynamically allocated
+    if ( c >= node_list_ptr->compute_node_array_size )
 	return NODE_LIST_DATA_OUT_OF_RANGE;
     else
     {
@@ -311,7 +312,8 @@ int     node_list_set_compute_nodes_ae(node_list_t *node_list_ptr, size_t c, nod
 int     node_list_set_compute_nodes_cpy(node_list_t *node_list_ptr, node_t * new_compute_nodes[], size_t array_size)
 
 {
-    if ( new_compute_nodes == NULL )
+    if ( (new_compute_nodes == NULL) ||
+	 (array_size > node_list_ptr->compute_node_array_size) )
 	return NODE_LIST_DATA_OUT_OF_RANGE;
     else
     {
@@ -11,11 +11,36 @@ extern "C" {
 
 #include "node-list.h"
 
+#ifndef true
+#include <stdbool.h>
+#endif
+
+#include <stdint.h>
+
 struct node_list
 {
     char        *head_node;
     unsigned    compute_node_count;
-    node_t      *compute_nodes[LPJS_MAX_NODES];
+    // Grown on demand by node_list_add_compute_node()
+    unsigned    compute_node_array_size;
+    node_t      **compute_nodes;
+    
+    /*
+     *  Hot scheduling table: The fields examined by the fit check for
+     *  every node on every scheduling pass, stored as parallel arrays
+     *  indexed like compute_nodes.  A scan then reads a few contiguous
+     *  cache lines per 64 nodes rather than chasing a pointer to a
+     *  separate node_t for each node.  This is a mirror of node_t,
+     *  which remains authoritative.  It is maintained only for the list
+     *  that owns the nodes, i.e. the one loaded from the config file.
+     */
+    bool        hot_table;
+    uint8_t     *hot_state;             // node_state_t
+    uint32_t    *hot_free_processors;
+    uint32_t    *hot_free_MiB;          // 32 bits allows 4 PiB per node
+    uint32_t    *hot_features;          // Reserved for has_feature
+    // Sum of the nodes' counted fields, valid only with hot_table
+    node_totals_t   totals;
 };
 
 #ifdef  __cplusplus
@@ -1,8 +1,17 @@
 /* node-list.c */
 node_list_t *node_list_new(void);
 void node_list_init(node_list_t *node_list);
+void node_list_free(node_list_t **node_list);
 void node_list_update_compute(node_list_t *node_list, node_t *node);
 void node_list_send_status(int msg_fd, node_list_t *node_list);
 int node_list_add_compute_node(node_list_t *node_list, node_t *node);
+void node_list_resize_arrays(node_list_t *node_list);
+void node_list_enable_hot_table(node_list_t *node_list);
+void node_list_sync_hot(node_list_t *node_list, unsigned index, node_t *node);
+void node_list_adjust_totals(node_list_t *node_list, const node_totals_t *old, const node_totals_t *new);
+void node_list_get_totals(node_list_t *node_list, node_totals_t *totals);
+unsigned node_list_find_fits(node_list_t *node_list, unsigned start, unsigned processors, uint64_t MiB, uint32_t features, unsigned *matches, unsigned max_matches);
+node_t *node_list_remove_compute_node(node_list_t *node_list, const char *hostname);
 node_t *node_list_find_hostname(node_list_t *node_list, const char *hostname);
 int node_list_set_state(node_list_t *node_list, char *arg_string, uid_t munge_uid, int msg_fd);
+void node_list_merge_config(node_list_t *node_list, node_list_t *config_list, unsigned *added, unsigned *updated, unsigned *removed, unsigned *paused);
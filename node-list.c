@@ -10,6 +10,7 @@
 
 #include "node-list-private.h"
 #include "network.h"
+#include "stream.h"
 #include "lpjs.h"
 #include "misc.h"
 
@@ -72,6 +73,44 @@ void    node_list_init(node_list_t *node_list)
 {
     node_list->head_node = NULL;
     node_list->compute_node_count = 0;
+    node_list->compute_node_array_size = 0;
+    node_list->compute_nodes = NULL;
+    node_list->hot_table = false;
+    node_list->hot_state = NULL;
+    node_list->hot_free_processors = NULL;
+    node_list->hot_free_MiB = NULL;
+    node_list->hot_features = NULL;
+    memset(&node_list->totals, 0, sizeof(node_list->totals));
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Destructor for node_list_t.  Frees all nodes in the list.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    node_list_free(node_list_t **node_list)
+
+{
+    unsigned    c;
+    
+    if ( *node_list == NULL )
+        return;
+    
+    for (c = 0; c < (*node_list)->compute_node_count; ++c)
+        node_free(&(*node_list)->compute_nodes[c]);
+    free((*node_list)->compute_nodes);
+    free((*node_list)->hot_state);
+    free((*node_list)->hot_free_processors);
+    free((*node_list)->hot_free_MiB);
+    free((*node_list)->hot_features);
+    free((*node_list)->head_node);
+    free(*node_list);
+    *node_list = NULL;
 }
 
 
@@ -83,6 +122,7 @@ void    node_list_init(node_list_t *node_list)
  *  History: 
  *  Date        Name        Modification
  *  2021-10-02  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Copy message format version
  ***************************************************************************/
 
 void    node_list_update_compute(node_list_t *node_list, node_t *new_node)
@@ -118,6 +158,10 @@ void    node_list_update_compute(node_list_t *node_list, node_t *new_node)
             node_set_arch(node_list->compute_nodes[c], strdup(node_get_arch(new_node)));
             node_set_msg_fd(node_list->compute_nodes[c], node_get_msg_fd(new_node));
             node_set_last_ping(node_list->compute_nodes[c], node_get_last_ping(new_node));
+            node_set_wire_version(node_list->compute_nodes[c], node_get_wire_version(new_node));
+            // A compd that checks in again starts with an empty cache
+            node_set_script_cache_slots(node_list->compute_nodes[c], node_get_script_cache_slots(new_node));
+            node_forget_scripts_sent(node_list->compute_nodes[c]);
             return;
         }
     }
@@ -126,84 +170,56 @@ void    node_list_update_compute(node_list_t *node_list, node_t *new_node)
 
 /***************************************************************************
  *  Description:
- *      Send current node list to msg_fd in human-readable format
+ *      Send current node list to msg_fd in human-readable format.
+ *      The list is streamed in frames of up to LPJS_STREAM_FRAME_MAX
+ *      bytes, so it is never truncated on large clusters.
  *  
  *  History: 
  *  Date        Name        Modification
  *  2021-09-26  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Stream instead of one size-limited message
  ***************************************************************************/
 
 void    node_list_send_status(int msg_fd, node_list_t *node_list)
 
 {
-    unsigned        c,
-                    processors_up,
-                    processors_up_used,
-                    processors_down;
-    unsigned long   mem_up,
-                    mem_up_used,
-                    mem_down;
-    char            temp[LPJS_MSG_LEN_MAX + 1],
-                    outgoing_msg[LPJS_MSG_LEN_MAX + 1];
-    
-    outgoing_msg[0] = '\0';
-    
-    snprintf(temp, LPJS_MSG_LEN_MAX,
+    unsigned        c;
+    node_totals_t   totals;
+    lpjs_stream_t   stream;
+    char            temp[LPJS_MSG_LEN_MAX + 1];
+    
+    // Only dispatchd calls this function, so wait for client to close first
+    lpjs_stream_init(&stream, msg_fd, lpjs_dispatchd_safe_close);
+    
+    lpjs_stream_printf(&stream,
             NODE_STATUS_HEADER_FORMAT, "Hostname", "State",
             "Procs", "Used", "PhysMiB", "Used", "OS", "Arch");
-    strlcat(outgoing_msg, temp, LPJS_MSG_LEN_MAX + 1);
-    
-    processors_up = processors_up_used = processors_down = 0;
-    mem_up = mem_up_used = mem_down = 0;
     
     for (c = 0; c < node_list->compute_node_count; ++c)
     {
         node_status_to_str(node_list->compute_nodes[c], temp, LPJS_MSG_LEN_MAX + 1);
-        strlcat(outgoing_msg, temp, LPJS_MSG_LEN_MAX + 1);
-        if ( strcmp(node_get_state(node_list->compute_nodes[c]), "up") == 0 )
-        {
-            processors_up += node_get_processors(node_list->compute_nodes[c]);
-            processors_up_used += node_get_processors_used(node_list->compute_nodes[c]);
-            mem_up += node_get_phys_MiB(node_list->compute_nodes[c]);
-            mem_up_used += node_get_phys_MiB_used(node_list->compute_nodes[c]);
-        }
-        else
-        {
-            processors_down += node_get_processors(node_list->compute_nodes[c]);
-            mem_down += node_get_phys_MiB(node_list->compute_nodes[c]);
-        }
+        lpjs_stream_printf(&stream, "%s", temp);
     }
     
     // lpjs_debug("Sending summary...\n");
-    snprintf(temp, LPJS_MSG_LEN_MAX + 1,
+    node_list_get_totals(node_list, &totals);
+    lpjs_stream_printf(&stream,
             "\n" NODE_STATUS_FORMAT, "Total", "up",
-            processors_up, processors_up_used, mem_up, mem_up_used, "-", "-");
-    strlcat(outgoing_msg, temp, LPJS_MSG_LEN_MAX + 1);
-    
-    snprintf(temp, LPJS_MSG_LEN_MAX,
+            totals.processors_up, totals.processors_up_used,
+            totals.MiB_up, totals.MiB_up_used, "-", "-");
+    lpjs_stream_printf(&stream,
             NODE_STATUS_FORMAT, "Total", "down",
-            processors_down, 0, mem_down, (size_t)0, "-", "-");
-    strlcat(outgoing_msg, temp, LPJS_MSG_LEN_MAX + 1);
+            totals.processors_down, 0, totals.MiB_down, (size_t)0, "-", "-");
 
-    // Only dispatchd calls this function, so wait for client to close first
-    if ( lpjs_send_munge(msg_fd, outgoing_msg,
-                         lpjs_dispatchd_safe_close) != LPJS_MSG_SENT )
-    {
-        lpjs_log("%s(): Error: Failed to send node list info.\n", __FUNCTION__);
-        lpjs_dispatchd_safe_close(msg_fd);
-        return; // FIXME: Define return codes
-    }
-    
     /*
      *  Closing the listener first results in "address already in use"
-     *  errors on restart.  Send an EOT character to signal the end of
-     *  transmission, so the client can close first and avoid a wait
-     *  state for the socket.
+     *  errors on restart.  End the last frame with an EOT character to
+     *  signal the end of transmission, so the client can close first
+     *  and avoid a wait state for the socket.
      */
     
-    if ( lpjs_send_munge(msg_fd, LPJS_EOT_MSG, lpjs_dispatchd_safe_close)
-                         != LPJS_MSG_SENT )
-        lpjs_log("%s(): Error: Failed to send EOT.\n", __FUNCTION__);
+    if ( lpjs_stream_finish(&stream, true) != LPJS_MSG_SENT )
+        lpjs_log("%s(): Error: Failed to send node list info.\n", __FUNCTION__);
     else
         lpjs_log("%s(): EOT sent.\n", __FUNCTION__);
 }
@@ -241,19 +257,352 @@ void    node_list_send_status(int msg_fd, node_list_t *node_list)
 int     node_list_add_compute_node(node_list_t *node_list, node_t *node)
 
 {
-    if ( node_list->compute_node_count == LPJS_MAX_NODES )
+    if ( node_list->compute_node_count == node_list->compute_node_array_size )
     {
-        lpjs_log("%s(): Error: LPJS_MAX_NODES reached.  Cannot add new node.\n", __FUNCTION__);
-        return -1;
+        if ( node_list->compute_node_array_size == 0 )
+            node_list->compute_node_array_size = NODE_LIST_INITIAL_SIZE;
+        else
+            node_list->compute_node_array_size *= 2;
+        node_list_resize_arrays(node_list);
     }
     
     // lpjs_debug("%s(): Adding %s\n", __FUNCTION__, node_get_hostname(node));
-    node_list->compute_nodes[node_list->compute_node_count++] = node;
+    node_list->compute_nodes[node_list->compute_node_count] = node;
+    if ( node_list->hot_table )
+        node_set_registry(node, node_list, node_list->compute_node_count);
+    ++node_list->compute_node_count;
     
     return 0;   // FIXME: Define return codes
 }
 
 
+/***************************************************************************
+ *  Description:
+ *      Reallocate compute_nodes and the hot table, if enabled, to
+ *      compute_node_array_size elements.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    node_list_resize_arrays(node_list_t *node_list)
+
+{
+    size_t  size = node_list->compute_node_array_size;
+    
+    node_list->compute_nodes = realloc(node_list->compute_nodes,
+                                       size * sizeof(*node_list->compute_nodes));
+    if ( node_list->compute_nodes == NULL )
+    {
+        lpjs_log("%s(): Error: realloc() failed.\n", __FUNCTION__);
+        exit(EX_UNAVAILABLE);
+    }
+    
+    if ( node_list->hot_table )
+    {
+        node_list->hot_state = realloc(node_list->hot_state,
+                                size * sizeof(*node_list->hot_state));
+        node_list->hot_free_processors = realloc(node_list->hot_free_processors,
+                                size * sizeof(*node_list->hot_free_processors));
+        node_list->hot_free_MiB = realloc(node_list->hot_free_MiB,
+                                size * sizeof(*node_list->hot_free_MiB));
+        node_list->hot_features = realloc(node_list->hot_features,
+                                size * sizeof(*node_list->hot_features));
+        if ( (node_list->hot_state == NULL) ||
+             (node_list->hot_free_processors == NULL) ||
+             (node_list->hot_free_MiB == NULL) ||
+             (node_list->hot_features == NULL) )
+        {
+            lpjs_log("%s(): Error: realloc() failed.\n", __FUNCTION__);
+            exit(EX_UNAVAILABLE);
+        }
+    }
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Maintain a hot scheduling table for this list, which must be the
+ *      only list with the table enabled for the nodes it holds.  This
+ *      is the list loaded from the config file by dispatchd.  Other
+ *      lists of the same nodes, e.g. matched nodes, must not enable it.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    node_list_enable_hot_table(node_list_t *node_list)
+
+{
+    unsigned    c;
+    
+    if ( node_list->hot_table )
+        return;
+    
+    node_list->hot_table = true;
+    if ( node_list->compute_node_array_size > 0 )
+        node_list_resize_arrays(node_list);
+    for (c = 0; c < node_list->compute_node_count; ++c)
+        node_set_registry(node_list->compute_nodes[c], node_list, c);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Copy the scheduling fields of node into slot index of the hot
+ *      table.  Called via node_sync_hot() whenever they change.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    node_list_sync_hot(node_list_t *node_list, unsigned index,
+                           node_t *node)
+
+{
+    unsigned    processors, processors_used;
+    size_t      MiB, MiB_used;
+    
+    if ( ! node_list->hot_table ||
+         (index >= node_list->compute_node_array_size) )
+        return;
+    
+    processors = node_get_processors(node);
+    processors_used = node_get_processors_used(node);
+    MiB = node_get_phys_MiB(node);
+    MiB_used = node_get_phys_MiB_used(node);
+    
+    // Usage can exceed capacity briefly if limits are lowered by reload
+    node_list->hot_state[index] = node_get_state_code(node);
+    node_list->hot_free_processors[index] =
+        processors > processors_used ? processors - processors_used : 0;
+    MiB = MiB > MiB_used ? MiB - MiB_used : 0;
+    node_list->hot_free_MiB[index] = MiB > UINT32_MAX ? UINT32_MAX : MiB;
+    node_list->hot_features[index] = 0;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Replace a node's contribution to the cluster totals.  Called via
+ *      node_sync_hot() and node_set_registry(), which keep track of
+ *      what each node has contributed.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    node_list_adjust_totals(node_list_t *node_list,
+                                const node_totals_t *old,
+                                const node_totals_t *new)
+
+{
+    node_totals_t   *totals = &node_list->totals;
+    
+    totals->processors_up += new->processors_up - old->processors_up;
+    totals->processors_up_used +=
+        new->processors_up_used - old->processors_up_used;
+    totals->processors_down += new->processors_down - old->processors_down;
+    totals->MiB_up += new->MiB_up - old->MiB_up;
+    totals->MiB_up_used += new->MiB_up_used - old->MiB_up_used;
+    totals->MiB_down += new->MiB_down - old->MiB_down;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Get cluster resource totals.  This is O(1) for the list holding
+ *      the hot scheduling table, which maintains them incrementally.
+ *      Other lists are summed on demand.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    node_list_get_totals(node_list_t *node_list, node_totals_t *totals)
+
+{
+    unsigned    c;
+    node_t      *node;
+    
+    if ( node_list->hot_table )
+    {
+        *totals = node_list->totals;
+        return;
+    }
+    
+    memset(totals, 0, sizeof(*totals));
+    for (c = 0; c < node_list->compute_node_count; ++c)
+    {
+        node = node_list->compute_nodes[c];
+        if ( node_get_state_code(node) == NODE_STATE_UP )
+        {
+            totals->processors_up += node_get_processors(node);
+            totals->processors_up_used += node_get_processors_used(node);
+            totals->MiB_up += node_get_phys_MiB(node);
+            totals->MiB_up_used += node_get_phys_MiB_used(node);
+        }
+        else
+        {
+            totals->processors_down += node_get_processors(node);
+            totals->MiB_down += node_get_phys_MiB(node);
+        }
+    }
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Find nodes at or after start that are up and have at least the
+ *      given processors, memory, and feature bits free.
+ *
+ *      The inner loop tests a block of nodes with no branches or early
+ *      exit, so compilers can vectorize it (e.g. gcc -O3, clang -O2)
+ *      for whatever SIMD instructions the target supports.  Matches are
+ *      then collected from the block, so each node is tested only once
+ *      no matter how many matches are requested.
+ *
+ *  Arguments:
+ *      node_list   List with hot table enabled
+ *      start       Index of first node to check
+ *      processors  Minimum free processors
+ *      MiB         Minimum free memory
+ *      features    Feature bits that must all be present
+ *      matches     Array to receive indexes of matching nodes
+ *      max_matches Stop after this many matches
+ *
+ *  Returns:
+ *      The number of matching nodes stored in matches
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+unsigned    node_list_find_fits(node_list_t *node_list, unsigned start,
+                                unsigned processors, uint64_t MiB,
+                                uint32_t features,
+                                unsigned *matches, unsigned max_matches)
+
+{
+    const uint8_t   * restrict state;
+    const uint32_t  * restrict free_processors;
+    const uint32_t  * restrict free_MiB;
+    const uint32_t  * restrict node_features;
+    unsigned        count = node_list->compute_node_count,
+                    block_start, block_len, c, match_count;
+    unsigned char   fits[NODE_LIST_FIT_BLOCK], *hit, *end;
+    uint32_t        min_MiB;
+    
+    if ( ! node_list->hot_table )
+    {
+        lpjs_log("%s(): Bug: Hot table not enabled for this list.\n",
+                 __FUNCTION__);
+        return 0;
+    }
+    
+    // Keep all comparisons 32-bit so they vectorize well
+    if ( MiB > UINT32_MAX )
+        return 0;
+    min_MiB = MiB;
+    
+    match_count = 0;
+    for (block_start = start;
+         (block_start < count) && (match_count < max_matches);
+         block_start += block_len)
+    {
+        block_len = count - block_start;
+        if ( block_len > NODE_LIST_FIT_BLOCK )
+            block_len = NODE_LIST_FIT_BLOCK;
+        
+        state = node_list->hot_state + block_start;
+        free_processors = node_list->hot_free_processors + block_start;
+        free_MiB = node_list->hot_free_MiB + block_start;
+        node_features = node_list->hot_features + block_start;
+        
+        // Bitwise & rather than && to avoid short-circuit branches
+        for (c = 0; c < block_len; ++c)
+            fits[c] = (state[c] == NODE_STATE_UP) &
+                      (free_processors[c] >= processors) &
+                      (free_MiB[c] >= min_MiB) &
+                      ((node_features[c] & features) == features);
+        
+        // Matches are usually sparse, and memchr() is vectorized too
+        end = fits + block_len;
+        for (hit = fits; (match_count < max_matches) &&
+             ((hit = memchr(hit, 1, end - hit)) != NULL); ++hit)
+            matches[match_count++] = block_start + (hit - fits);
+    }
+    
+    return match_count;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Remove a node from the list without freeing it.  Order of the
+ *      remaining nodes is preserved, so "lpjs nodes" output stays in
+ *      config file order.
+ *
+ *  Returns:
+ *      Pointer to the removed node, or NULL if hostname is not in the list
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+node_t  *node_list_remove_compute_node(node_list_t *node_list,
+                                       const char *hostname)
+
+{
+    unsigned    c;
+    node_t      *node;
+    
+    for (c = 0; c < node_list->compute_node_count; ++c)
+    {
+        node = node_list->compute_nodes[c];
+        if ( strcmp(node_get_hostname(node), hostname) == 0 )
+        {
+            size_t  tail = node_list->compute_node_count - c - 1;
+            
+            memmove(node_list->compute_nodes + c,
+                    node_list->compute_nodes + c + 1,
+                    tail * sizeof(*node_list->compute_nodes));
+            --node_list->compute_node_count;
+            if ( node_list->hot_table )
+            {
+                node_set_registry(node, NULL, 0);
+                // Moved nodes sync their new hot table slots
+                for (; c < node_list->compute_node_count; ++c)
+                    node_set_registry(node_list->compute_nodes[c],
+                                      node_list, c);
+            }
+            return node;
+        }
+    }
+    return NULL;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Find a compute node by hostname.  Empty slots are skipped, such
+ *      as those left in a config list by node_list_merge_config().
+ *
+ *  Returns:
+ *      Pointer to the node, or NULL if hostname is not in the list
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Skip empty slots
+ ***************************************************************************/
+
 node_t  *node_list_find_hostname(node_list_t *node_list, const char *hostname)
 
 {
@@ -264,7 +613,7 @@ node_t  *node_list_find_hostname(node_list_t *node_list, const char *hostname)
     {
         node = node_list->compute_nodes[c];
         // lpjs_debug("%s(): Checking %s\n", __FUNCTION__, node_get_hostname(node));
-        if ( strcmp(node_get_hostname(node), hostname) == 0 )
+        if ( (node != NULL) && (strcmp(node_get_hostname(node), hostname) == 0) )
             return node;
     }
     
@@ -375,3 +724,132 @@ int     node_list_set_state(node_list_t *node_list, char *arg_string,
     
     return 0;   // FIXME: Define return codes
 }
+
+
+/***************************************************************************
+ *  Description:
+ *      Bring a live node list in line with a freshly loaded config,
+ *      without disturbing nodes that are unchanged.  New nodes are
+ *      added in the offline state and will come up when their compd
+ *      checks in.  Processor and memory overrides are applied to
+ *      existing nodes, leaving resource usage and compd connections
+ *      intact.  Nodes no longer in the config are removed if idle.
+ *      Nodes with running jobs are paused instead, and can be removed
+ *      by another reload after their jobs finish.
+ *
+ *      Nodes moved to node_list are removed from config_list, so the
+ *      caller can simply node_list_free() config_list afterward.
+ *
+ *  Arguments:
+ *      node_list   Live node list used by dispatchd
+ *      config_list Node list just loaded from etc/lpjs/config
+ *      added, updated, removed, paused
+ *                  Counts of nodes affected, for reporting
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Fix NULL dereference when nodes are added
+ ***************************************************************************/
+
+void    node_list_merge_config(node_list_t *node_list,
+                               node_list_t *config_list,
+                               unsigned *added, unsigned *updated,
+                               unsigned *removed, unsigned *paused)
+
+{
+    unsigned    c;
+    node_t      *config_node, *live_node;
+    
+    *added = *updated = *removed = *paused = 0;
+    
+    if ( (config_list->head_node != NULL) && (node_list->head_node != NULL)
+         && (strcmp(config_list->head_node, node_list->head_node) != 0) )
+        lpjs_log("%s(): Warning: Head node change to %s requires a restart.\n",
+                 __FUNCTION__, config_list->head_node);
+    
+    // Add new nodes and apply overrides to existing ones
+    for (c = 0; c < config_list->compute_node_count; ++c)
+    {
+        config_node = config_list->compute_nodes[c];
+        live_node = node_list_find_hostname(node_list,
+                                            node_get_hostname(config_node));
+        if ( live_node == NULL )
+        {
+            lpjs_log("%s(): Info: Adding node %s.\n", __FUNCTION__,
+                     node_get_hostname(config_node));
+            node_list_add_compute_node(node_list, config_node);
+            // Ownership moved to node_list, node_list_find_hostname()
+            // skips the empty slot in the retire pass below
+            config_list->compute_nodes[c] = NULL;
+            ++*added;
+            continue;
+        }
+        
+        /*
+         *  Auto-detected values will be refreshed at the next compd
+         *  checkin, so just clear the override flag in that case.
+         */
+        if ( (node_get_auto_processors(config_node) !=
+              node_get_auto_processors(live_node)) ||
+             (! node_get_auto_processors(config_node) &&
+              (node_get_processors(config_node) !=
+               node_get_processors(live_node))) ||
+             (node_get_auto_phys_MiB(config_node) !=
+              node_get_auto_phys_MiB(live_node)) ||
+             (! node_get_auto_phys_MiB(config_node) &&
+              (node_get_phys_MiB(config_node) !=
+               node_get_phys_MiB(live_node))) )
+        {
+            lpjs_log("%s(): Info: Updating node %s.\n", __FUNCTION__,
+                     node_get_hostname(live_node));
+            node_set_auto_processors(live_node,
+                                     node_get_auto_processors(config_node));
+            if ( ! node_get_auto_processors(config_node) )
+                node_set_processors(live_node,
+                                    node_get_processors(config_node));
+            node_set_auto_phys_MiB(live_node,
+                                   node_get_auto_phys_MiB(config_node));
+            if ( ! node_get_auto_phys_MiB(config_node) )
+                node_set_phys_MiB(live_node, node_get_phys_MiB(config_node));
+            ++*updated;
+        }
+    }
+    
+    // Retire nodes that are no longer in the config
+    c = 0;
+    while ( c < node_list->compute_node_count )
+    {
+        live_node = node_list->compute_nodes[c];
+        if ( node_list_find_hostname(config_list,
+                                     node_get_hostname(live_node)) != NULL )
+        {
+            ++c;
+            continue;
+        }
+        
+        if ( node_get_processors_used(live_node) != 0 )
+        {
+            if ( node_get_state_code(live_node) != NODE_STATE_PAUSED )
+            {
+                lpjs_log("%s(): Info: %s removed from config, but has running jobs.  Pausing.\n",
+                         __FUNCTION__, node_get_hostname(live_node));
+                node_set_state(live_node, "paused");
+                ++*paused;
+            }
+            ++c;
+        }
+        else
+        {
+            lpjs_log("%s(): Info: Removing node %s.\n", __FUNCTION__,
+                     node_get_hostname(live_node));
+            if ( node_get_msg_fd(live_node) != NODE_MSG_FD_NOT_OPEN )
+                lpjs_dispatchd_safe_close(node_get_msg_fd(live_node));
+            node_list_remove_compute_node(node_list,
+                                          node_get_hostname(live_node));
+            node_free(&live_node);
+            ++*removed;
+            // Don't advance c: Next node has moved into this slot
+        }
+    }
+}
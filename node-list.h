@@ -5,9 +5,15 @@
 #include "node.h"
 #endif
 
+#include <stdint.h>
+
 typedef struct node_list node_list_t;
 
-#define LPJS_MAX_NODES  1024
+// Initial size of compute_nodes array.  It is doubled as needed.
+#define NODE_LIST_INITIAL_SIZE  64
+
+// Nodes examined per iteration of the fit check kernel
+#define NODE_LIST_FIT_BLOCK     256
 
 #include "node-list-rvs.h"
 #include "node-list-accessors.h"
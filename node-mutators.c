@@ -215,6 +215,7 @@ int     node_set_processors(node_t *node_ptr, unsigned new_processors)
     else
     {
 	node_ptr->processors = new_processors;
+	node_sync_hot(node_ptr);
 	return NODE_DATA_OK;
     }
 }
@@ -267,6 +268,7 @@ int     node_set_processors_used(node_t *node_ptr, unsigned new_processors_used)
     else
     {
 	node_ptr->processors_used = new_processors_used;
+	node_sync_hot(node_ptr);
 	return NODE_DATA_OK;
     }
 }
@@ -319,6 +321,7 @@ int     node_set_phys_MiB(node_t *node_ptr, size_t new_phys_MiB)
     else
     {
 	node_ptr->phys_MiB = new_phys_MiB;
+	node_sync_hot(node_ptr);
 	return NODE_DATA_OK;
     }
 }
@@ -371,6 +374,7 @@ int     node_set_phys_MiB_used(node_t *node_ptr, size_t new_phys_MiB_used)
     else
     {
 	node_ptr->phys_MiB_used = new_phys_MiB_used;
+	node_sync_hot(node_ptr);
 	return NODE_DATA_OK;
     }
 }
@@ -882,11 +886,25 @@ int     node_set_arch_cpy(node_t *node_ptr, char * new_arch, size_t array_size)
 int     node_set_state(node_t *node_ptr, char * new_state)
 
 {
-    if ( new_state == NULL )
+    node_state_t    code;
+    
+    if ( (new_state == NULL) ||
+	 ((code = node_state_code(new_state)) == NODE_STATE_COUNT) )
+	return NODE_DATA_OUT_OF_RANGE;
+    else
+	return node_set_state_code(node_ptr, code);
+}
+
+
+int     node_set_state_code(node_t *node_ptr, node_state_t new_state)
+
+{
+    if ( new_state >= NODE_STATE_COUNT )
 	return NODE_DATA_OUT_OF_RANGE;
     else
     {
 	node_ptr->state = new_state;
+	node_sync_hot(node_ptr);
 	return NODE_DATA_OK;
     }
 }
@@ -898,14 +916,17 @@ int     node_set_state(node_t *node_ptr, char * new_state)
  *      
  *
  *  Description:
- *      Mutator for an array element of state member in a node_t
- *      structure. Use this function to set node_ptr->state[c]
- *      in a node_t object from non-member functions.
+ *      Mutator for msg_fd member in a node_t structure.
+ *      Use this function to set msg_fd in a node_t object
+ *      from non-member functions.  This function performs a direct
+ *      assignment for scalar or pointer structure members.  If
+ *      msg_fd is a pointer, data previously pointed to should
+ *      be freed before calling this function to avoid memory
+ *      leaks.
  *
  *  Arguments:
  *      node_ptr        Pointer to the structure to set
- *      c               Subscript to the state array
- *      new_state_element The new value for state[c]
+ *      new_msg_fd      The new value for msg_fd
  *
  *  Returns:
  *      NODE_DATA_OK if the new value is acceptable and assigned
@@ -913,30 +934,29 @@ int     node_set_state(node_t *node_ptr, char * new_state)
  *
  *  Examples:
  *      node_t          node;
- *      size_t          c;
- *      char *          new_state_element;
+ *      int             new_msg_fd;
  *
- *      if ( node_set_state_ae(&node, c, new_state_element)
+ *      if ( node_set_msg_fd(&node, new_msg_fd)
  *              == NODE_DATA_OK )
  *      {
  *      }
  *
  *  See also:
- *      NODE_SET_STATE_AE(3)
+ *      (3)
  *
  *  History: 
  *  Date        Name        Modification
  *  2026-08-15  gen-get-set Auto-generated from node-private.h
  ***************************************************************************/
 
-int     node_set_state_ae(node_t *node_ptr, size_t c, char  new_state_element)
+int     node_set_msg_fd(node_t *node_ptr, int new_msg_fd)
 
 {
     if ( false )
 	return NODE_DATA_OUT_OF_RANGE;
     else
     {
-	node_ptr->state[c] = new_state_element;
+	node_ptr->msg_fd = new_msg_fd;
 	return NODE_DATA_OK;
     }
 }
@@ -948,15 +968,17 @@ int     node_set_state_ae(node_t *node_ptr, size_t c, char  new_state_element)
  *      
  *
  *  Description:
- *      Mutator for state member in a node_t structure.
- *      Use this function to set state in a node_t object
- *      from non-member functions.  This function copies the array pointed to
- *      by new_state to node_ptr->state.
+ *      Mutator for last_ping member in a node_t structure.
+ *      Use this function to set last_ping in a node_t object
+ *      from non-member functions.  This function performs a direct
+ *      assignment for scalar or pointer structure members.  If
+ *      last_ping is a pointer, data previously pointed to should
+ *      be freed before calling this function to avoid memory
+ *      leaks.
  *
  *  Arguments:
  *      node_ptr        Pointer to the structure to set
- *      new_state       The new value for state
- *      array_size      Size of the state array.
+ *      new_last_ping   The new value for last_ping
  *
  *  Returns:
  *      NODE_DATA_OK if the new value is acceptable and assigned
@@ -964,31 +986,29 @@ int     node_set_state_ae(node_t *node_ptr, size_t c, char  new_state_element)
  *
  *  Examples:
  *      node_t          node;
- *      char *          new_state;
- *      size_t          array_size;
+ *      time_t          new_last_ping;
  *
- *      if ( node_set_state_cpy(&node, new_state, array_size)
+ *      if ( node_set_last_ping(&node, new_last_ping)
  *              == NODE_DATA_OK )
  *      {
  *      }
  *
  *  See also:
- *      NODE_SET_STATE(3)
+ *      (3)
  *
  *  History: 
  *  Date        Name        Modification
  *  2026-08-15  gen-get-set Auto-generated from node-private.h
  ***************************************************************************/
 
-int     node_set_state_cpy(node_t *node_ptr, char * new_state, size_t array_size)
+int     node_set_last_ping(node_t *node_ptr, time_t new_last_ping)
 
 {
-    if ( new_state == NULL )
+    if ( false )
 	return NODE_DATA_OUT_OF_RANGE;
     else
     {
-	// FIXME: Assuming char array is a null-terminated string
-	strlcpy(node_ptr->state, new_state, array_size);
+	node_ptr->last_ping = new_last_ping;
 	return NODE_DATA_OK;
     }
 }
@@ -1000,17 +1020,17 @@ int     node_set_state_cpy(node_t *node_ptr, char * new_state, size_t array_size
  *      
  *
  *  Description:
- *      Mutator for msg_fd member in a node_t structure.
- *      Use this function to set msg_fd in a node_t object
+ *      Mutator for wire_version member in a node_t structure.
+ *      Use this function to set wire_version in a node_t object
  *      from non-member functions.  This function performs a direct
  *      assignment for scalar or pointer structure members.  If
- *      msg_fd is a pointer, data previously pointed to should
+ *      wire_version is a pointer, data previously pointed to should
  *      be freed before calling this function to avoid memory
  *      leaks.
  *
  *  Arguments:
  *      node_ptr        Pointer to the structure to set
- *      new_msg_fd      The new value for msg_fd
+ *      new_wire_version The new value for wire_version
  *
  *  Returns:
  *      NODE_DATA_OK if the new value is acceptable and assigned
@@ -1018,9 +1038,9 @@ int     node_set_state_cpy(node_t *node_ptr, char * new_state, size_t array_size
  *
  *  Examples:
  *      node_t          node;
- *      int             new_msg_fd;
+ *      unsigned        new_wire_version;
  *
- *      if ( node_set_msg_fd(&node, new_msg_fd)
+ *      if ( node_set_wire_version(&node, new_wire_version)
  *              == NODE_DATA_OK )
  *      {
  *      }
@@ -1030,17 +1050,17 @@ int     node_set_state_cpy(node_t *node_ptr, char * new_state, size_t array_size
  *
  *  History: 
  *  Date        Name        Modification
- *  2026-08-15  gen-get-set Auto-generated from node-private.h
+ *  2026-10-19  Jason Bacon Begin
  ***************************************************************************/
 
-int     node_set_msg_fd(node_t *node_ptr, int new_msg_fd)
+int     node_set_wire_version(node_t *node_ptr, unsigned new_wire_version)
 
 {
-    if ( false )
+    if ( new_wire_version > WIRE_SCHEMA_VERSION )
 	return NODE_DATA_OUT_OF_RANGE;
     else
     {
-	node_ptr->msg_fd = new_msg_fd;
+	node_ptr->wire_version = new_wire_version;
 	return NODE_DATA_OK;
     }
 }
@@ -1052,17 +1072,17 @@ int     node_set_msg_fd(node_t *node_ptr, int new_msg_fd)
  *      
  *
  *  Description:
- *      Mutator for last_ping member in a node_t structure.
- *      Use this function to set last_ping in a node_t object
+ *      Mutator for script_cache_slots member in a node_t structure.
+ *      Use this function to set script_cache_slots in a node_t object
  *      from non-member functions.  This function performs a direct
  *      assignment for scalar or pointer structure members.  If
- *      last_ping is a pointer, data previously pointed to should
+ *      script_cache_slots is a pointer, data previously pointed to should
  *      be freed before calling this function to avoid memory
  *      leaks.
  *
  *  Arguments:
  *      node_ptr        Pointer to the structure to set
- *      new_last_ping   The new value for last_ping
+ *      new_script_cache_slots The new value for script_cache_slots
  *
  *  Returns:
  *      NODE_DATA_OK if the new value is acceptable and assigned
@@ -1070,9 +1090,9 @@ int     node_set_msg_fd(node_t *node_ptr, int new_msg_fd)
  *
  *  Examples:
  *      node_t          node;
- *      time_t          new_last_ping;
+ *      unsigned        new_script_cache_slots;
  *
- *      if ( node_set_last_ping(&node, new_last_ping)
+ *      if ( node_set_script_cache_slots(&node, new_script_cache_slots)
  *              == NODE_DATA_OK )
  *      {
  *      }
@@ -1082,17 +1102,17 @@ int     node_set_msg_fd(node_t *node_ptr, int new_msg_fd)
  *
  *  History: 
  *  Date        Name        Modification
- *  2026-08-15  gen-get-set Auto-generated from node-private.h
+ *  2026-10-19  Jason Bacon Begin
  ***************************************************************************/
 
-int     node_set_last_ping(node_t *node_ptr, time_t new_last_ping)
+int     node_set_script_cache_slots(node_t *node_ptr, unsigned new_script_cache_slots)
 
 {
     if ( false )
 	return NODE_DATA_OUT_OF_RANGE;
     else
     {
-	node_ptr->last_ping = new_last_ping;
+	node_ptr->script_cache_slots = new_script_cache_slots;
 	return NODE_DATA_OK;
     }
 }
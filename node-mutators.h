@@ -31,7 +31,8 @@ int node_set_arch(node_t *node_ptr, char *new_arch);
 int node_set_arch_ae(node_t *node_ptr, size_t c, char new_arch_element);
 int node_set_arch_cpy(node_t *node_ptr, char *new_arch, size_t array_size);
 int node_set_state(node_t *node_ptr, char *new_state);
-int node_set_state_ae(node_t *node_ptr, size_t c, char new_state_element);
-int node_set_state_cpy(node_t *node_ptr, char *new_state, size_t array_size);
+int node_set_state_code(node_t *node_ptr, node_state_t new_state);
 int node_set_msg_fd(node_t *node_ptr, int new_msg_fd);
 int node_set_last_ping(node_t *node_ptr, time_t new_last_ping);
+int node_set_wire_version(node_t *node_ptr, unsigned new_wire_version);
+int node_set_script_cache_slots(node_t *node_ptr, unsigned new_script_cache_slots);
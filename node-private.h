@@ -13,6 +13,9 @@ extern "C" {
 #include <stdbool.h>
 #endif
 
+#include "node.h"
+#include "sha256.h"
+
 struct node
 {
     char            *hostname;
@@ -30,15 +33,28 @@ struct node
     int             zfs;                // 0 or 1
     char            *os;
     char            *arch;
-    char            *state;
+    node_state_t    state;
     int             msg_fd;
     // For detecting odd comm issues, where socket connection drop
     // cannot be detected directly
     time_t          last_ping;
+    // Binary message schema spoken by this node's compd, or 0 for
+    // the legacy text protocol
+    unsigned        wire_version;
+    // Number of job scripts this node's compd can cache, 0 if none,
+    // and a ring of hashes of scripts recently sent to it
+    unsigned        script_cache_slots;
+    unsigned char   scripts_sent[NODE_SCRIPTS_SENT_MAX][SHA256_DIGEST_LEN];
+    unsigned        scripts_sent_count;
+    unsigned        scripts_sent_next;
+    // Node list holding the hot scheduling table for this node, if any.
+    // Mutators of state and resource fields update the table.
+    struct node_list *registry;
+    unsigned        registry_index;
+    // This node's current contribution to the registry's totals
+    node_totals_t   counted;
 };
 
-#include "node.h"
-
 #ifdef  __cplusplus
 }
 #endif
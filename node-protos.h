@@ -1,6 +1,11 @@
 /* node.c */
 node_t *node_new(void);
 void node_init(node_t *node);
+void node_free(node_t **node);
+char *node_state_name(node_state_t state);
+node_state_t node_state_code(const char *name);
+void node_set_registry(node_t *node, struct node_list *registry, unsigned index);
+void node_sync_hot(node_t *node);
 void node_detect_specs(node_t *node);
 void node_print_status_header(FILE *stream);
 void node_print_status(node_t *node, FILE *stream);
@@ -9,4 +14,9 @@ void node_send_status(node_t *node, int msg_fd);
 int node_print_specs_header(FILE *stream);
 char *node_specs_to_str(node_t *node, char *str, size_t buff_len);
 ssize_t node_str_to_specs(node_t *node, const char *str);
+_Bool node_script_was_sent(node_t *node, const unsigned char *hash);
+void node_note_script_sent(node_t *node, const unsigned char *hash);
+void node_forget_scripts_sent(node_t *node);
+void node_write_to_wire(node_t *node, wire_writer_t *writer);
+int node_read_from_wire(node_t *node, const void *buff, size_t len);
 int node_adjust_resources(node_t *node, job_t *job, node_resource_t direction);
@@ -26,6 +26,7 @@ int     node_set_processors_available(node_t *node, unsigned processors)
     else
     {
 	node->processors_used = node->processors - processors;
+	node_sync_hot(node);
 	return NODE_DATA_OK;
     }
 }
@@ -46,6 +47,7 @@ int     node_set_phys_MiB_available(node_t *node, unsigned phys_MiB)
     else
     {
 	node->phys_MiB_used = node->phys_MiB - phys_MiB;
+	node_sync_hot(node);
 	return NODE_DATA_OK;
     }
 }
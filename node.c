@@ -14,6 +14,11 @@
 #include "lpjs.h"
 #include "misc.h"
 
+// Indexed by node_state_t
+static char *Node_state_names[NODE_STATE_COUNT] =
+{
+    "offline", "up", "down", "paused", "updating", "updated"
+};
 
 /***************************************************************************
  *  Description:
@@ -64,9 +69,145 @@ void    node_init(node_t *node)
     node->zfs = 0;
     node->os = "unknown";
     node->arch = "unknown";
-    node->state = "offline";
+    node->state = NODE_STATE_OFFLINE;
     node->msg_fd = NODE_MSG_FD_NOT_OPEN;
     node->last_ping = 0;
+    node->wire_version = 0;
+    node->script_cache_slots = 0;
+    node->scripts_sent_count = 0;
+    node->scripts_sent_next = 0;
+    node->registry = NULL;
+    node->registry_index = 0;
+    memset(&node->counted, 0, sizeof(node->counted));
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Destructor for node_t.  os and arch may point to static strings,
+ *      so only hostname and the structure itself are freed.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    node_free(node_t **node)
+
+{
+    if ( *node != NULL )
+    {
+        free((*node)->hostname);
+        free(*node);
+        *node = NULL;
+    }
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Convert between node_state_t and the names used in messages
+ *      and "lpjs nodes" output.
+ *
+ *  Returns:
+ *      node_state_name(): Name of state, or "invalid"
+ *      node_state_code(): State code, or NODE_STATE_COUNT if name is
+ *      not a valid state
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+char    *node_state_name(node_state_t state)
+
+{
+    if ( state >= NODE_STATE_COUNT )
+        return "invalid";
+    return Node_state_names[state];
+}
+
+
+node_state_t    node_state_code(const char *name)
+
+{
+    node_state_t    state;
+    
+    for (state = 0; state < NODE_STATE_COUNT; ++state)
+        if ( strcmp(name, Node_state_names[state]) == 0 )
+            break;
+    return state;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Attach a node to the node list holding its hot scheduling table
+ *      entry, or detach it if registry is NULL.  Called only by
+ *      node-list.c when nodes are added, moved, or removed.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    node_set_registry(node_t *node, struct node_list *registry,
+                          unsigned index)
+
+{
+    static node_totals_t    none;
+    
+    // Take this node out of the old list's totals
+    if ( (node->registry != NULL) && (node->registry != registry) )
+    {
+        node_list_adjust_totals(node->registry, &node->counted, &none);
+        node->counted = none;
+    }
+    node->registry = registry;
+    node->registry_index = index;
+    node_sync_hot(node);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Copy fields used by the scheduler's fit checks into the hot
+ *      table of the node list holding this node.  node_t remains the
+ *      authoritative copy, so this must be called whenever state,
+ *      processors, or memory fields change.  The generated mutators
+ *      and node_adjust_resources() take care of this.
+ *
+ *      Also updates the list's cluster totals, replacing what was last
+ *      counted for this node with its current values.
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    node_sync_hot(node_t *node)
+
+{
+    node_totals_t   now = { 0 };
+    
+    if ( node->registry != NULL )
+    {
+        if ( node->state == NODE_STATE_UP )
+        {
+            now.processors_up = node->processors;
+            now.processors_up_used = node->processors_used;
+            now.MiB_up = node->phys_MiB;
+            now.MiB_up_used = node->phys_MiB_used;
+        }
+        else
+        {
+            now.processors_down = node->processors;
+            now.MiB_down = node->phys_MiB;
+        }
+        node_list_adjust_totals(node->registry, &node->counted, &now);
+        node->counted = now;
+        node_list_sync_hot(node->registry, node->registry_index, node);
+    }
 }
 
 
@@ -164,7 +305,8 @@ void    node_print_status_header(FILE *stream)
 void    node_print_status(node_t *node, FILE *stream)
 
 {
-    fprintf(stream, NODE_STATUS_FORMAT, node->hostname, node->state,
+    fprintf(stream, NODE_STATUS_FORMAT, node->hostname,
+           node_state_name(node->state),
            node->processors, node->processors_used,
            node->phys_MiB, node->phys_MiB_used, node->os, node->arch);
 }
@@ -174,7 +316,8 @@ void    node_status_to_str(node_t *node, char *str, size_t array_size)
 
 {
     snprintf(str, array_size,
-                NODE_STATUS_FORMAT, node->hostname, node->state,        
+                NODE_STATUS_FORMAT, node->hostname,
+                node_state_name(node->state),
                 node->processors, node->processors_used,                                 
                 node->phys_MiB, node->phys_MiB_used, node->os, node->arch);
 }
@@ -221,7 +364,8 @@ char    *node_specs_to_str(node_t *node, char *str, size_t buff_len)
 {
     if ( snprintf(str, buff_len,
                   "%s\t%s\t%u\t%lu\t%u\t%s\t%s",
-                  node->hostname, node->state, node->processors,
+                  node->hostname, node_state_name(node->state),
+                  node->processors,
                   node->phys_MiB, node->zfs, node->os, node->arch) < 0 )
     {
         lpjs_log("%s(): Error: snprintf() failed\n", __FUNCTION__);
@@ -258,7 +402,7 @@ ssize_t node_str_to_specs(node_t *node, const char *str)
         exit(EX_UNAVAILABLE);
     }
     
-    node->state = "offline";
+    node->state = NODE_STATE_OFFLINE;
     node->os = "unknown";
     node->arch = "unknown";
 
@@ -276,7 +420,11 @@ ssize_t node_str_to_specs(node_t *node, const char *str)
         lpjs_log("%s(): Bug: Failed to extract state from specs.\n", __FUNCTION__);
         return -1;
     }
-    node->state = strdup(field);
+    if ( (node->state = node_state_code(field)) == NODE_STATE_COUNT )
+    {
+        lpjs_log("%s(): Bug: Invalid state in specs: %s\n", __FUNCTION__, field);
+        node->state = NODE_STATE_OFFLINE;
+    }
 
     if ( (field = strsep(&stringp, "\t")) == NULL )
     {
@@ -332,6 +480,215 @@ ssize_t node_str_to_specs(node_t *node, const char *str)
 }
 
 
+/***************************************************************************
+ *  Description:
+ *      Check whether a job script was recently sent to node, so that
+ *      its compd is likely to have it cached and dispatchd can send
+ *      just the hash.  Only the last NODE_SCRIPTS_SENT_MAX scripts, or
+ *      as many as the compd can cache if fewer, are remembered.  This
+ *      is only a hint: compd reports a miss if it has evicted the
+ *      script, and dispatchd then sends it in full.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+bool    node_script_was_sent(node_t *node, const unsigned char *hash)
+
+{
+    unsigned    c;
+    
+    for (c = 0; c < node->scripts_sent_count; ++c)
+        if ( memcmp(node->scripts_sent[c], hash, SHA256_DIGEST_LEN) == 0 )
+            return true;
+    return false;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Remember that a job script was sent to node in full,
+ *      replacing the oldest entry if the ring is full
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    node_note_script_sent(node_t *node, const unsigned char *hash)
+
+{
+    unsigned    ring_size;
+    
+    ring_size = node->script_cache_slots < NODE_SCRIPTS_SENT_MAX ?
+                node->script_cache_slots : NODE_SCRIPTS_SENT_MAX;
+    if ( (ring_size == 0) || node_script_was_sent(node, hash) )
+        return;
+    if ( node->scripts_sent_next >= ring_size )
+        node->scripts_sent_next = 0;
+    memcpy(node->scripts_sent[node->scripts_sent_next++], hash,
+           SHA256_DIGEST_LEN);
+    if ( node->scripts_sent_count < ring_size )
+        ++node->scripts_sent_count;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Forget scripts sent to node, e.g. when its compd checks in
+ *      again and its cache starts out empty
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    node_forget_scripts_sent(node_t *node)
+
+{
+    node->scripts_sent_count = 0;
+    node->scripts_sent_next = 0;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Append node hardware and OS specs to a binary message,
+ *      e.g. from compd to dispatchd.  See wire.h.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Add script cache slots
+ ***************************************************************************/
+
+void    node_write_to_wire(node_t *node, wire_writer_t *writer)
+
+{
+    wire_put_str(writer, WIRE_TAG_NODE_HOSTNAME, node->hostname);
+    wire_put_uint(writer, WIRE_TAG_NODE_STATE, node->state);
+    wire_put_uint(writer, WIRE_TAG_NODE_PROCESSORS, node->processors);
+    wire_put_uint(writer, WIRE_TAG_NODE_PHYS_MIB, node->phys_MiB);
+    wire_put_uint(writer, WIRE_TAG_NODE_ZFS, node->zfs);
+    wire_put_str(writer, WIRE_TAG_NODE_OS, node->os);
+    wire_put_str(writer, WIRE_TAG_NODE_ARCH, node->arch);
+    if ( node->script_cache_slots > 0 )
+        wire_put_uint(writer, WIRE_TAG_NODE_SCRIPT_CACHE,
+                      node->script_cache_slots);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Populate a node from a binary message body, as written by
+ *      node_write_to_wire().  Nothing is copied except the hostname,
+ *      which node_free() releases: os and arch point into buff, so
+ *      the node must not outlive it.  node_list_update_compute()
+ *      makes its own copies.  Fields with other tags are skipped.
+ *
+ *  Returns:
+ *      0 on success, -1 if the message is malformed or incompatible
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     node_read_from_wire(node_t *node, const void *buff, size_t len)
+
+{
+    wire_reader_t   reader;
+    wire_field_t    field;
+    uint64_t        val;
+    const char      *hostname = NULL, *str;
+    int             status;
+
+    node_init(node);
+
+    if ( (status = wire_reader_init(&reader, buff, len)) != WIRE_OK )
+    {
+        lpjs_log("%s(): Error: Bad message header, status %d.\n",
+                 __FUNCTION__, status);
+        return -1;
+    }
+    node->wire_version = reader.version;
+
+    while ( (status = wire_next_field(&reader, &field)) == WIRE_OK )
+    {
+        switch(field.tag)
+        {
+            case    WIRE_TAG_NODE_HOSTNAME:
+                if ( (hostname = wire_get_str(&field)) == NULL )
+                    status = WIRE_MALFORMED;
+                break;
+            case    WIRE_TAG_NODE_STATE:
+                if ( ((status = wire_get_uint(&field, &val)) == WIRE_OK) &&
+                     (val >= NODE_STATE_COUNT) )
+                    status = WIRE_MALFORMED;
+                node->state = val;
+                break;
+            case    WIRE_TAG_NODE_PROCESSORS:
+                status = wire_get_uint(&field, &val);
+                node->processors = val;
+                break;
+            case    WIRE_TAG_NODE_PHYS_MIB:
+                status = wire_get_uint(&field, &val);
+                node->phys_MiB = val;
+                break;
+            case    WIRE_TAG_NODE_ZFS:
+                status = wire_get_uint(&field, &val);
+                node->zfs = val;
+                break;
+            case    WIRE_TAG_NODE_OS:
+                if ( (str = wire_get_str(&field)) == NULL )
+                    status = WIRE_MALFORMED;
+                node->os = (char *)str;
+                break;
+            case    WIRE_TAG_NODE_ARCH:
+                if ( (str = wire_get_str(&field)) == NULL )
+                    status = WIRE_MALFORMED;
+                node->arch = (char *)str;
+                break;
+            case    WIRE_TAG_NODE_SCRIPT_CACHE:
+                status = wire_get_uint(&field, &val);
+                node->script_cache_slots = val;
+                break;
+            default:
+                if ( field.tag & WIRE_TAG_CRITICAL )
+                    status = WIRE_UNKNOWN_CRITICAL;
+        }
+        if ( status != WIRE_OK )
+        {
+            lpjs_log("%s(): Error: Bad field, tag 0x%04x, status %d.\n",
+                     __FUNCTION__, field.tag, status);
+            node_init(node);
+            return -1;
+        }
+    }
+    if ( status != WIRE_END )
+    {
+        lpjs_log("%s(): Error: Truncated message.\n", __FUNCTION__);
+        node_init(node);
+        return -1;
+    }
+    if ( hostname == NULL )
+    {
+        lpjs_log("%s(): Error: Missing hostname.\n", __FUNCTION__);
+        node_init(node);
+        return -1;
+    }
+
+    if ( (node->hostname = strdup(hostname)) == NULL )
+    {
+        lpjs_log("%s(): Error: strdup() failed.\n", __FUNCTION__);
+        exit(EX_UNAVAILABLE);
+    }
+
+    return 0;
+}
+
+
 /***************************************************************************
  *  Description:
  *      Release resources on node associated with job
@@ -358,6 +715,7 @@ int     node_adjust_resources(node_t *node, job_t *job, node_resource_t directio
              node_get_hostname(node));
     node->processors_used += processors;
     node->phys_MiB_used += MiB;
+    node_sync_hot(node);
     
     return 0;   // FIXME: Define return codes
 }
@@ -23,10 +23,15 @@
 
 typedef struct node node_t;
 
+// node_set_registry() takes a node list, and node-list.h includes node.h
+struct node_list;
+
 #define NODE_MSG_FD_NOT_OPEN        -1
 #define NODE_STATUS_HEADER_FORMAT   "%-20s %-8s %5s %4s %7s %7s %-9s %-9s\n"
 #define NODE_STATUS_FORMAT          "%-20s %-8s %5u %4u %7zu %7zu %-9s %-9s\n"
 #define NODE_SPECS_LEN              1024
+// Script hashes remembered per node, see node_script_was_sent()
+#define NODE_SCRIPTS_SENT_MAX       32
 
 typedef enum
 {
@@ -34,6 +39,33 @@ typedef enum
     NODE_RESOURCE_RELEASE = -1
 }   node_resource_t;
 
+// Keep in sync with Node_state_names in node.c
+typedef enum
+{
+    NODE_STATE_OFFLINE = 0,
+    NODE_STATE_UP,
+    NODE_STATE_DOWN,
+    NODE_STATE_PAUSED,
+    NODE_STATE_UPDATING,
+    NODE_STATE_UPDATED,
+    NODE_STATE_COUNT
+}   node_state_t;
+
+/*
+ *  Cluster resource totals for "lpjs nodes" and scheduler checks.
+ *  Nodes not up count as down.  Maintained incrementally by the node
+ *  list holding the hot scheduling table.  See node_list_get_totals().
+ */
+typedef struct
+{
+    unsigned    processors_up;
+    unsigned    processors_up_used;
+    unsigned    processors_down;
+    size_t      MiB_up;
+    size_t      MiB_up_used;
+    size_t      MiB_down;
+}   node_totals_t;
+
 #include "node-rvs.h"
 #include "node-accessors.h"
 #include "node-mutators.h"
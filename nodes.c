@@ -6,6 +6,7 @@
  *  History: 
  *  Date        Name        Modification
  *  2021-09-25  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Advertise compression
  ***************************************************************************/
 
 #include <stdio.h>
@@ -30,21 +31,35 @@ int     main (int argc, char *argv[])
     // Terminates process if malloc() fails, no check required
     node_list_t *node_list = node_list_new();
     char        outgoing_msg[LPJS_MSG_LEN_MAX + 1];
+    size_t      msg_len = 0;
     extern FILE *Log_stream;
     
     switch(argc)
     {
 	case    1:  // lpjs nodes
-	    outgoing_msg[0] = LPJS_DISPATCHD_REQUEST_NODE_LIST;
-	    outgoing_msg[1] = '\0';
+	    // Advertises compression, since node lists can be large
+	    msg_len = lpjs_list_request(outgoing_msg, LPJS_MSG_LEN_MAX + 1,
+					LPJS_DISPATCHD_REQUEST_NODE_LIST);
 	    break;
 	
 	default:
-	    if ( (strcmp(argv[1], "paused") == 0) ||
+	    if ( strcmp(argv[1], "reload") == 0 )
+	    {
+		// lpjs nodes reload: Re-read etc/lpjs/config in dispatchd
+		if ( argc != 2 )
+		    usage(argv);
+		outgoing_msg[0] = LPJS_DISPATCHD_REQUEST_RELOAD_CONFIG;
+		outgoing_msg[1] = '\0';
+		msg_len = 1;
+	    }
+	    else if ( (strcmp(argv[1], "paused") == 0) ||
 		 (strcmp(argv[1], "updating") == 0) ||
 		 (strcmp(argv[1], "updated") == 0) ||
 		 (strcmp(argv[1], "up") == 0) )
+	    {
 		lpjs_set_node_state(argc, argv, outgoing_msg, LPJS_MSG_LEN_MAX + 1);
+		msg_len = strlen(outgoing_msg);
+	    }
 	    else
 		usage(argv);
     }
@@ -61,7 +76,8 @@ int     main (int argc, char *argv[])
 	return EX_IOERR;
     }
 
-    if ( lpjs_send_munge(msg_fd, outgoing_msg, close) != LPJS_MSG_SENT )
+    if ( lpjs_send_munge_bin(msg_fd, outgoing_msg, msg_len, close)
+	    != LPJS_MSG_SENT )
     {
 	perror("lpjs-nodes: Failed to send message to dispatch");
 	close(msg_fd);
@@ -137,5 +153,6 @@ void    usage(char *argv[])
 
 {
     fprintf (stderr, "Usage: %s nodes [paused|updating|up all|nodename [nodename...]]\n", argv[0]);
+    fprintf (stderr, "       %s nodes reload\n", argv[0]);
     exit(EX_USAGE);
 }
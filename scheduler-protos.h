@@ -1,9 +1,10 @@
 /* scheduler.c */
 int lpjs_select_nodes(void);
-int lpjs_dispatch_next_job(node_list_t *node_list, job_list_t *pending_jobs, job_list_t *running_jobs);
+int lpjs_dispatch_next_job(node_list_t *node_list, job_list_t *pending_jobs, job_list_t *running_jobs, arena_t *scratch);
+int lpjs_send_new_job(job_t *job, node_t *node, const char *script_buff, const unsigned char *script_hash, char *outgoing_msg, size_t msg_size, char **munge_payload, ssize_t *payload_bytes);
+ssize_t lpjs_new_job_msg(job_t *job, node_t *node, const char *script_buff, const unsigned char *script_hash, _Bool send_script, char *outgoing_msg, size_t msg_size);
 int lpjs_dispatch_jobs(node_list_t *node_list, job_list_t *pending_jobs, job_list_t *running_jobs);
 unsigned long lpjs_select_next_job(job_list_t *pending_jobs, job_t **job);
-int lpjs_match_nodes(job_t *job, node_list_t *node_list, node_list_t *matched_nodes);
-int lpjs_get_usable_processors(job_t *job, node_t *node);
+int lpjs_match_nodes(job_t *job, node_list_t *node_list, arena_t *scratch, node_t ***matched_nodes);
 job_t *lpjs_remove_pending_job(job_list_t *pending_jobs, unsigned long job_id);
 job_t *lpjs_remove_running_job(job_list_t *running_jobs, unsigned long job_id);
@@ -4,7 +4,6 @@
 #include <string.h>     // strerror()
 #include <errno.h>
 #include <unistd.h>     // close()
-#include <sys/wait.h>
 #include <sysexits.h>
 
 #include <xtend/file.h>
@@ -15,6 +14,10 @@
 #include "node-list.h"
 #include "scheduler.h"
 #include "network.h"
+#include "wire.h"
+#include "sha256.h"
+#include "journal.h"
+#include "cleaner.h"
 #include "misc.h"       // lpjs_log()
 
 /***************************************************************************
@@ -45,6 +48,9 @@ int     lpjs_select_nodes()
  *      Check available nodes and the job queue, and dispatch the
  *      next job, if possible.
  *
+ *      Temporaries (matched node set, script, outgoing message) are
+ *      allocated from scratch, which the caller resets between calls.
+ *
  *  Returns:
  *      The number of nodes matched, or a negative error
  *      code if something went wrong.  A positive number indicates
@@ -54,27 +60,32 @@ int     lpjs_select_nodes()
  *  History: 
  *  Date        Name        Modification
  *  2024-01-22  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Use scratch arena for temporaries
+ *  2026-10-19  Jason Bacon Send binary job messages to compds that accept them
+ *  2026-10-19  Jason Bacon Send script hash to compds that cache scripts
+ *  2026-10-19  Jason Bacon Size script and message buffers to fit
+ *  2026-10-19  Jason Bacon Get script from the journal, journal dispatch
+ *  2026-10-19  Jason Bacon Set compute node when dispatched
  ***************************************************************************/
 
 int     lpjs_dispatch_next_job(node_list_t *node_list,
 			       job_list_t *pending_jobs,
-			       job_list_t *running_jobs)
+			       job_list_t *running_jobs,
+			       arena_t *scratch)
 
 {
     job_t       *job;
-    // Terminates process if malloc() fails, no check required
-    node_list_t *matched_nodes = node_list_new();
-    char        pending_path[PATH_MAX + 1],
-		script_path[PATH_MAX + 2],
-		script_buff[LPJS_SCRIPT_SIZE_MAX + 1],
-		outgoing_msg[LPJS_JOB_MSG_MAX + 1],
-		*munge_payload;
+    node_t      **matched_nodes;
+    const char  *script_buff;
+    char        *outgoing_msg,
+		*munge_payload,
+		*compute_node;
+    unsigned char   script_hash[SHA256_DIGEST_LEN];
     int         compd_msg_fd,
 		node_count;
-    ssize_t     script_size,
-		payload_bytes;
-    uid_t       uid;
-    gid_t       gid;
+    ssize_t     payload_bytes;
+    size_t      script_size,
+		msg_size;
     
     /*
      *  Look through spool dir and determine requirements of the
@@ -92,10 +103,11 @@ int     lpjs_dispatch_next_job(node_list_t *node_list,
      *  for the job requirements
      */
     
-    if ( (node_count = lpjs_match_nodes(job, node_list, matched_nodes)) > 0 )
+    if ( (node_count = lpjs_match_nodes(job, node_list, scratch,
+					&matched_nodes)) > 0 )
     {
-	lpjs_log("%s(): Found %u available nodes.\n",
-		__FUNCTION__, node_list_get_compute_node_count(matched_nodes));
+	lpjs_log("%s(): Found %d available nodes.\n",
+		__FUNCTION__, node_count);
 	
 	/*
 	 *  Do not move from pending to running yet.
@@ -104,20 +116,21 @@ int     lpjs_dispatch_next_job(node_list_t *node_list,
 	 */
 	
 	/*
-	 *  Load script from spool/lpjs/pending
+	 *  The journal holds scripts of pending jobs in memory, with
+	 *  the hash sent in WIRE_TAG_SCRIPT_HASH and checked by compd
 	 */
 	
-	snprintf(pending_path, PATH_MAX + 1, "%s/%lu",
-		 LPJS_PENDING_DIR, job_get_job_id(job));
-	snprintf(script_path, PATH_MAX + 2, "%s/%s",
-		 pending_path, job_get_script_name(job));
-	script_size = lpjs_load_script(script_path, script_buff,
-				       LPJS_SCRIPT_SIZE_MAX + 1);
-
-	if ( script_size < LPJS_SCRIPT_MIN_SIZE )
+	if ( (script_buff = lpjs_journal_get_script(job_get_job_id(job),
+						    script_hash)) == NULL )
+	{
+	    lpjs_log("%s(): Error: No script for job %lu.\n",
+		    __FUNCTION__, job_get_job_id(job));
+	    return node_count;
+	}
+	if ( (script_size = strlen(script_buff)) < LPJS_SCRIPT_MIN_SIZE )
 	{
 	    lpjs_log("%s(): Error: Script %s < %d characters.\n",
-		    __FUNCTION__, script_path, LPJS_SCRIPT_MIN_SIZE);
+		    __FUNCTION__, job_get_script_name(job), LPJS_SCRIPT_MIN_SIZE);
 	    return node_count;
 	}
 	
@@ -128,10 +141,13 @@ int     lpjs_dispatch_next_job(node_list_t *node_list,
 	 *          Use script cached in spool dir at submission
 	 */
 	
+	msg_size = LPJS_JOB_MSG_SIZE(script_size);
+	outgoing_msg = arena_alloc(scratch, msg_size + 1);
+	
 	// FIXME: Revamp and verify handling of failed dispatches
-	for (int c = 0; c < node_list_get_compute_node_count(matched_nodes); ++c)
+	for (int c = 0; c < node_count; ++c)
 	{
-	    node_t *node = node_list_get_compute_nodes_ae(matched_nodes, c);
+	    node_t *node = matched_nodes[c];
 	    
 	    compd_msg_fd = node_get_msg_fd(node);
 
@@ -139,23 +155,8 @@ int     lpjs_dispatch_next_job(node_list_t *node_list,
 		    __FUNCTION__, job_get_job_id(job),
 		    node_get_hostname(node), compd_msg_fd);
 	    
-	    outgoing_msg[0] = LPJS_COMPD_REQUEST_NEW_JOB;
-	    job_print_to_string(job, outgoing_msg + 1, LPJS_JOB_MSG_MAX + 1);
-
-	    lpjs_log("%s(): Job specs: %s\n", __FUNCTION__, outgoing_msg + 1);
-	    
-	    // FIXME: Check for truncation
-	    strlcat(outgoing_msg, script_buff, LPJS_JOB_MSG_MAX + 1);
-	    if ( lpjs_send_munge(compd_msg_fd, outgoing_msg,
-				 lpjs_dispatchd_safe_close) != LPJS_MSG_SENT )
-	    {
-		lpjs_log("%s(): Error: Failed to send job to compd.\n", __FUNCTION__);
-		free(matched_nodes);
-		return node_count;
-	    }
-	    
 	    /*
-	     *  Get chaperone launch status back from compd.
+	     *  Send the job and get chaperone launch status back from compd.
 	     *  FIXME: This can take a while and timeouts happen
 	     *      Don't wait, but let compd/chaperone connect again
 	     *      to send status.  Modify lpjs_compd.c
@@ -166,12 +167,14 @@ int     lpjs_dispatch_next_job(node_list_t *node_list,
 	     *      LPJS_DISPATCHD_REQUEST_JOB_COMPLETE?
 	     */
 	    
-	    lpjs_log("%s(): Awaiting chaperone fork verification from %s compd...\n",
+	    lpjs_log("%s(): Sending job, awaiting chaperone fork verification from %s compd...\n",
 		     __FUNCTION__, node_get_hostname(node));
-	    payload_bytes = lpjs_recv_munge(compd_msg_fd, &munge_payload,
-					    0, LPJS_CHAPERONE_STATUS_TIMEOUT,
-					    &uid, &gid,
-					    lpjs_dispatchd_safe_close);
+	    // Allocated by munge_decode(), not part of scratch
+	    munge_payload = NULL;
+	    if ( lpjs_send_new_job(job, node, script_buff, script_hash,
+				   outgoing_msg, msg_size, &munge_payload,
+				   &payload_bytes) != LPJS_MSG_SENT )
+		return node_count;
 	    if ( payload_bytes == LPJS_RECV_TIMEOUT )
 	    {
 		lpjs_log("%s(): Error: Timed out awaiting dispatch status.\n",
@@ -180,12 +183,13 @@ int     lpjs_dispatch_next_job(node_list_t *node_list,
 			 node_get_hostname(node));
 		node_set_state(node, "down");
 	    }
-	    else if ( munge_payload[0] != LPJS_CHAPERONE_FORKED )
+	    else if ( (payload_bytes < 1) ||
+		      (munge_payload[0] != LPJS_CHAPERONE_FORKED) )
 	    {
 		lpjs_log("%s(): Bug: Should have received LPJS_CHAPERONE_FORKED.\n",
 			 __FUNCTION__);
 		lpjs_log("%s(): Got %d instead.\n",
-			__FUNCTION__, munge_payload[0]);
+			__FUNCTION__, payload_bytes < 1 ? -1 : munge_payload[0]);
 		lpjs_log("%s(): Setting %s to down.\n", __FUNCTION__,
 			 node_get_hostname(node));
 		node_set_state(node, "down");
@@ -208,7 +212,6 @@ int     lpjs_dispatch_next_job(node_list_t *node_list,
 
 		lpjs_debug("%s(): Chaperone fork verification received.\n",
 			    __FUNCTION__);
-		job_set_state(job, JOB_STATE_DISPATCHED);
 		char *end;
 		pid_t chaperone_pid = strtol(munge_payload+1, &end, 10);
 		if ( *end != '\0' )
@@ -216,9 +219,20 @@ int     lpjs_dispatch_next_job(node_list_t *node_list,
 		    lpjs_log("%s(): Bug: No PID found in chaperone fork verification message.\n",
 			    __FUNCTION__);
 		}
+		lpjs_journal_dispatch(job_get_job_id(job),
+				      node_get_hostname(node), chaperone_pid);
+		job_list_set_job_state(pending_jobs, job, JOB_STATE_DISPATCHED);
 		lpjs_log("%s(): Job %lu chaperone_pid = %d\n", __FUNCTION__,
 			job_get_job_id(job), chaperone_pid);
 		job_set_chaperone_pid(job, chaperone_pid);
+		// So it can be released if canceled before checkin
+		if ( (compute_node = strdup(node_get_hostname(node))) == NULL )
+		{
+		    lpjs_log("%s(): Error: strdup() failed.\n", __FUNCTION__);
+		    exit(EX_UNAVAILABLE);
+		}
+		free(job_get_compute_node(job));
+		job_set_compute_node(job, compute_node);
 		
 		/*
 		 *  Reserve resources immediately to prevent a race
@@ -227,19 +241,149 @@ int     lpjs_dispatch_next_job(node_list_t *node_list,
 		 */
 		node_adjust_resources(node, job, NODE_RESOURCE_ALLOCATE);
 	    }
+	    free(munge_payload);
 	}
 	
 	/*
 	 *  Log submission time and job specs
 	 */
-	
-	free(matched_nodes);
     }
     
     return node_count;
 }
 
 
+/***************************************************************************
+ *  Description:
+ *      Send a new job to node and wait for the chaperone fork
+ *      verification from its compd.
+ *
+ *      If node's compd caches scripts and the script was sent to it
+ *      recently, only the script hash is sent.  If compd no longer
+ *      has it, it replies LPJS_COMPD_SCRIPT_NOT_CACHED and the job
+ *      is sent again with the script.
+ *
+ *      *munge_payload and *payload_bytes are as for lpjs_recv_munge().
+ *
+ *  Returns:
+ *      LPJS_MSG_SENT if the job was sent and a response or timeout
+ *      received, LPJS_SEND_FAILED otherwise
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Factor out from lpjs_dispatch_next_job()
+ *  2026-10-19  Jason Bacon Take buffer size from caller
+ *  2026-10-19  Jason Bacon Skip notifications forwarded by compd
+ ***************************************************************************/
+
+int     lpjs_send_new_job(job_t *job, node_t *node, const char *script_buff,
+			  const unsigned char *script_hash,
+			  char *outgoing_msg, size_t msg_size,
+			  char **munge_payload, ssize_t *payload_bytes)
+
+{
+    int         compd_msg_fd = node_get_msg_fd(node);
+    ssize_t     msg_len;
+    bool        send_script;
+    uid_t       uid;
+    gid_t       gid;
+    char        hex[SHA256_DIGEST_LEN * 2 + 1];
+    
+    send_script = ! node_script_was_sent(node, script_hash);
+    while ( true )
+    {
+	if ( (msg_len = lpjs_new_job_msg(job, node, script_buff, script_hash,
+					 send_script, outgoing_msg,
+					 msg_size)) < 0 )
+	{
+	    lpjs_log("%s(): Error: Job %lu specs and script are too large.\n",
+		     __FUNCTION__, job_get_job_id(job));
+	    return LPJS_SEND_FAILED;
+	}
+	
+	if ( lpjs_send_munge_bin(compd_msg_fd, outgoing_msg, msg_len,
+				 lpjs_dispatchd_safe_close) != LPJS_MSG_SENT )
+	{
+	    lpjs_log("%s(): Error: Failed to send job to compd.\n", __FUNCTION__);
+	    return LPJS_SEND_FAILED;
+	}
+	
+	// Notifications compd forwards meanwhile are deferred
+	*munge_payload = NULL;
+	*payload_bytes = lpjs_recv_munge_reply(compd_msg_fd, munge_payload,
+					       0, LPJS_CHAPERONE_STATUS_TIMEOUT,
+					       &uid, &gid,
+					       lpjs_dispatchd_safe_close);
+	if ( send_script || (*payload_bytes < 1) ||
+	     ((*munge_payload)[0] != LPJS_COMPD_SCRIPT_NOT_CACHED) )
+	    break;
+	
+	sha256_to_hex(script_hash, hex);
+	lpjs_log("%s(): Script %s not cached on %s, sending in full.\n",
+		 __FUNCTION__, hex, node_get_hostname(node));
+	free(*munge_payload);
+	send_script = true;
+    }
+    
+    if ( send_script && (*payload_bytes > 0) &&
+	 ((*munge_payload)[0] == LPJS_CHAPERONE_FORKED) )
+	node_note_script_sent(node, script_hash);
+    
+    return LPJS_MSG_SENT;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Build a LPJS_COMPD_REQUEST_NEW_JOB message in outgoing_msg,
+ *      which must hold msg_size + 1 bytes.  Job specs are
+ *      followed by the script, or just its hash if send_script is false,
+ *      in the binary format described in wire.h.  Compds that predate
+ *      the binary format always get text specs and the full script.
+ *
+ *  Returns:
+ *      Message length, or -1 if it does not fit
+ *
+ *  History: 
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Factor out from lpjs_dispatch_next_job()
+ *  2026-10-19  Jason Bacon Take buffer size from caller
+ ***************************************************************************/
+
+ssize_t lpjs_new_job_msg(job_t *job, node_t *node, const char *script_buff,
+			 const unsigned char *script_hash, bool send_script,
+			 char *outgoing_msg, size_t msg_size)
+
+{
+    wire_writer_t   writer;
+    ssize_t         msg_len;
+    
+    outgoing_msg[0] = LPJS_COMPD_REQUEST_NEW_JOB;
+    if ( node_get_wire_version(node) > 0 )
+    {
+	wire_writer_init(&writer, outgoing_msg + 1, msg_size);
+	job_write_to_wire(job, &writer);
+	if ( send_script )
+	    wire_put_str(&writer, WIRE_TAG_SCRIPT, script_buff);
+	// Lets compd cache the script, and is ignored by older compds
+	if ( node_get_script_cache_slots(node) > 0 )
+	    wire_put_bytes(&writer, WIRE_TAG_SCRIPT_HASH, script_hash,
+			   SHA256_DIGEST_LEN);
+	if ( (msg_len = wire_writer_len(&writer)) >= 0 )
+	    ++msg_len;
+    }
+    else
+    {
+	job_print_to_string(job, outgoing_msg + 1, msg_size);
+	lpjs_log("%s(): Job specs: %s\n", __FUNCTION__, outgoing_msg + 1);
+	msg_len = strlcat(outgoing_msg, script_buff, msg_size + 1);
+	if ( msg_len > msg_size )
+	    msg_len = -1;
+    }
+    return msg_len;
+}
+
+
 /***************************************************************************
  *  Description:
  *      Check available nodes and the job queue, and dispatch as many new
@@ -264,11 +408,27 @@ int     lpjs_dispatch_jobs(node_list_t *node_list,
 
 {
     int     nodes;
+    /*
+     *  Scratch memory for scheduling temporaries, kept for the life
+     *  of the process.  After the first few dispatches, scheduling
+     *  needs no further malloc() calls.
+     */
+    static arena_t  *scratch = NULL;
+    
+    if ( scratch == NULL )
+	// Terminates process if malloc() fails, no check required
+	scratch = arena_new(LPJS_SCHED_ARENA_BLOCK);
     
     // Dispatch as many jobs as possible before resuming
-    while ( (nodes = lpjs_dispatch_next_job(node_list, pending_jobs,
-					    running_jobs)) > 0 )
-	lpjs_log("%s(): %d nodes available.\n", __FUNCTION__, nodes);
+    do
+    {
+	// Nothing allocated for the previous job is needed anymore
+	arena_reset(scratch);
+	nodes = lpjs_dispatch_next_job(node_list, pending_jobs,
+				       running_jobs, scratch);
+	if ( nodes > 0 )
+	    lpjs_log("%s(): %d nodes available.\n", __FUNCTION__, nodes);
+    }   while ( nodes > 0 );
 
     return 0;
 }
@@ -324,64 +484,98 @@ unsigned long   lpjs_select_next_job(job_list_t *pending_jobs, job_t **job)
 
 /***************************************************************************
  *  Description:
+ *      Find nodes with enough free processors and memory for job.
+ *      Uses the node list's hot table, so node_t objects are only
+ *      touched for nodes that fit.
+ *
+ *      The array of matched nodes is allocated from scratch and
+ *      remains valid until the next arena_reset().
+ *
+ *  Returns:
+ *      The number of nodes in *matched_nodes
  *  
  *  History: 
  *  Date        Name        Modification
  *  2024-02-23  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Use node_list_find_fits()
+ *  2026-10-19  Jason Bacon Return matches in scratch arena
  ***************************************************************************/
 
 int     lpjs_match_nodes(job_t *job, node_list_t *node_list,
-			    node_list_t *matched_nodes)
+			 arena_t *scratch, node_t ***matched_nodes)
 
 {
     node_t      *node;
     unsigned    node_count,
 		c,
+		start,
+		fit_count,
+		fits[NODE_LIST_FIT_BLOCK],
+		required_processors,
 		usable_processors,   // Procs with enough mem
 		total_usable,
-		total_required;
+		total_required,
+		max_matches;
+    uint64_t    required_MiB;
+    node_totals_t   totals;
     
     lpjs_log("%s(): Job %u requires %u processors, %lu MiB / proc.\n",
 	    __FUNCTION__,
 	    job_get_job_id(job), job_get_threads_per_process(job),
 	    job_get_phys_mib_per_processor(job));
     
+    required_processors = job_get_threads_per_process(job);
+    required_MiB = (uint64_t)job_get_phys_mib_per_processor(job) *
+		   required_processors;
     total_usable = 0;
     total_required = job_get_processors_per_job(job);
-    for (c = node_count = 0;
-	 (c < node_list_get_compute_node_count(node_list)) &&
-	 (total_usable < total_required); ++c)
+    
+    // Each matched node contributes at least one processor
+    max_matches = XT_MIN(total_required,
+			 node_list_get_compute_node_count(node_list));
+    // Terminates process if malloc() fails, no check required
+    *matched_nodes = arena_alloc(scratch,
+				 (max_matches + 1) * sizeof(**matched_nodes));
+    
+    // O(1) check of cluster totals before scanning nodes
+    node_list_get_totals(node_list, &totals);
+    if ( totals.processors_up - XT_MIN(totals.processors_up_used,
+				       totals.processors_up) < total_required )
+    {
+	lpjs_log("%s(): Insufficient resources available.\n", __FUNCTION__);
+	return 0;
+    }
+    start = node_count = 0;
+    while ( (total_usable < total_required) && (node_count < max_matches) )
     {
-	node = node_list_get_compute_nodes_ae(node_list, c);
-	if ( strcmp(node_get_state(node), "up") != 0 )
-	    lpjs_log("%s(): %s is unavailable.\n",
-		    __FUNCTION__, node_get_hostname(node));
-	else
+	// No feature requirements yet
+	fit_count = node_list_find_fits(node_list, start, required_processors,
+					required_MiB, 0,
+					fits, NODE_LIST_FIT_BLOCK);
+	if ( fit_count == 0 )
+	    break;
+	
+	for (c = 0; (c < fit_count) && (total_usable < total_required) &&
+		    (node_count < max_matches); ++c)
 	{
-	    // lpjs_log("Checking %s...\n", node_get_hostname(node));
-	    usable_processors = lpjs_get_usable_processors(job, node);
-	    usable_processors = XT_MIN(usable_processors, total_required - total_usable);
-	    
-	    if ( usable_processors > 0 )
-	    {
-		lpjs_log("%s(): Using %u processors on %s.\n", __FUNCTION__,
-			usable_processors, node_get_hostname(node));
-		// FIXME: Set # processors to use on node
-		node_list_add_compute_node(matched_nodes, node);
-		total_usable += usable_processors;
-		++node_count;
-	    }
+	    node = node_list_get_compute_nodes_ae(node_list, fits[c]);
+	    usable_processors = XT_MIN(required_processors,
+				       total_required - total_usable);
+	    lpjs_log("%s(): Using %u processors on %s.\n", __FUNCTION__,
+		    usable_processors, node_get_hostname(node));
+	    // FIXME: Set # processors to use on node
+	    (*matched_nodes)[node_count++] = node;
+	    total_usable += usable_processors;
 	}
+	start = fits[fit_count - 1] + 1;
     }
     
     if ( total_usable == total_required )
     {
 	lpjs_log("%s(): Using nodes:\n", __FUNCTION__);
-	for (c = 0; c < node_list_get_compute_node_count(matched_nodes); ++c)
-	{
-	    node = node_list_get_compute_nodes_ae(matched_nodes, c);
-	    lpjs_log("%s(): %s\n", __FUNCTION__, node_get_hostname(node));
-	}
+	for (c = 0; c < node_count; ++c)
+	    lpjs_log("%s(): %s\n", __FUNCTION__,
+		     node_get_hostname((*matched_nodes)[c]));
     }
     else
 	lpjs_log("%s(): Insufficient resources available.\n", __FUNCTION__);
@@ -392,77 +586,25 @@ int     lpjs_match_nodes(job_t *job, node_list_t *node_list,
 
 /***************************************************************************
  *  Description:
- *  
- *  History: 
- *  Date        Name        Modification
- *  2024-02-23  Jason Bacon Begin
- ***************************************************************************/
-
-int     lpjs_get_usable_processors(job_t *job, node_t *node)
-
-{
-    int         required_processors,
-		available_processors,    // Total free
-		usable_processors;       // Total free with enough mem
-    size_t      available_mem;
-    
-    required_processors = job_get_threads_per_process(job);
-    available_mem = node_get_phys_MiB_available(node);
-    available_processors = node_get_processors(node) - node_get_processors_used(node);
-    lpjs_log("%s(): %s: processors = %u  mem = %lu\n", __FUNCTION__,
-	     node_get_hostname(node), available_processors, available_mem);
-    if ( available_processors >= required_processors )
-    {
-	if ( (available_mem >= job_get_phys_mib_per_processor(job) * required_processors) )
-	    usable_processors = required_processors;
-	else
-	{
-	    lpjs_log("%s(): Not enough memory available.\n", __FUNCTION__);
-	    usable_processors = 0;
-	}
-    }
-    else
-    {
-	lpjs_log("%s(): Not enough processors available.\n", __FUNCTION__);
-	usable_processors = 0;
-    }
-    return usable_processors;
-}
-
-
-/***************************************************************************
- *  Description:
+ *      Remove a job from the pending queue.  Its spool directory, if
+ *      exported, is queued for removal by lpjs_cleaner_run().
  *  
  *  Returns:
+ *      The job removed, or NULL if not found
  *
  *  History: 
  *  Date        Name        Modification
  *  2024-05-03  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Journal removal, spool directory is optional
+ *  2026-10-19  Jason Bacon Defer directory removal instead of rm -rf
  ***************************************************************************/
 
 job_t   *lpjs_remove_pending_job(job_list_t *pending_jobs, unsigned long job_id)
 
 {
-    char    pending_path[PATH_MAX + 1];
-    pid_t   pid;
-    int     status;
-    
-    if ( (pid = fork()) == 0 )
-    {
-	snprintf(pending_path, PATH_MAX + 1, "%s/%lu",
-		 LPJS_PENDING_DIR, job_id);
-	lpjs_log("%s(): Removing job %s...\n", __FUNCTION__, pending_path);
-	execlp("rm", "rm", "-rf", pending_path, NULL);
-	lpjs_log("%s(): Error: exec(rm -rf %s) failed.\n", __FUNCTION__, pending_path);
-	exit(EX_OSERR);
-    }
-    else
-    {
-	// WEXITED is implicitly set for waitpid(), but specify for readability
-	waitpid(pid, &status, WEXITED);
-	if ( status != 0 )
-	    lpjs_log("%s(): rm failed, status = %d.\n", __FUNCTION__, status);
-    }
+    lpjs_journal_complete(job_id);
+    if ( lpjs_journal_spool_export() )
+	lpjs_cleaner_add(LPJS_PENDING_DIR, job_id);
     
     return job_list_remove_job(pending_jobs, job_id);
 }
@@ -472,26 +614,9 @@ job_t   *lpjs_remove_pending_job(job_list_t *pending_jobs, unsigned long job_id)
 job_t   *lpjs_remove_running_job(job_list_t *running_jobs, unsigned long job_id)
 
 {
-    char    running_path[PATH_MAX + 1];
-    pid_t   pid;
-    int     status;
-    
-    if ( (pid = fork()) == 0 )
-    {
-	snprintf(running_path, PATH_MAX + 1, "%s/%lu",
-		 LPJS_RUNNING_DIR, job_id);
-	lpjs_log("%s(): Removing job %s...\n", __FUNCTION__, running_path);
-	execlp("rm", "rm", "-rf", running_path, NULL);
-	lpjs_log("%s(): exec(rm -rf %s) failed.\n", __FUNCTION__, running_path);
-	exit(EX_OSERR);
-    }
-    else
-    {
-	// WEXITED is implicitly set for waitpid(), but specify for readability
-	waitpid(pid, &status, WEXITED);
-	if ( status != 0 )
-	    lpjs_log("%s(): rm failed, status = %d.\n", __FUNCTION__, status);
-    }
+    lpjs_journal_complete(job_id);
+    if ( lpjs_journal_spool_export() )
+	lpjs_cleaner_add(LPJS_RUNNING_DIR, job_id);
     
     return job_list_remove_job(running_jobs, job_id);
 }
@@ -1,6 +1,12 @@
 #ifndef _LPJS_SCHEDULER_H_
 #define _LPJS_SCHEDULER_H_
 
+#include "arena.h"
+
+// Enough for a typical dispatch: script, outgoing message, node set.
+// The arena grows for larger scripts.
+#define LPJS_SCHED_ARENA_BLOCK  (2 * LPJS_JOB_MSG_SIZE(LPJS_PAYLOAD_MAX) + 65536)
+
 #include "scheduler-protos.h"
 
 #endif
@@ -0,0 +1,24 @@
+#ifndef _LPJS_SCRIPT_CACHE_PRIVATE_H_
+#define _LPJS_SCRIPT_CACHE_PRIVATE_H_
+
+#include "script-cache.h"
+
+typedef struct
+{
+    unsigned char   hash[SHA256_DIGEST_LEN];
+    char            *script;    // NULL if slot is empty
+    size_t          len;
+    unsigned long   last_used;
+}   script_cache_entry_t;
+
+struct script_cache
+{
+    script_cache_entry_t    *entries;
+    unsigned                slots;
+    size_t                  bytes;      // Total script text held
+    size_t                  bytes_max;
+    unsigned long           clock;      // Incremented on each use
+    unsigned long           hits, misses;
+};
+
+#endif  // _LPJS_SCRIPT_CACHE_PRIVATE_H_
@@ -0,0 +1,6 @@
+/* script-cache.c */
+script_cache_t *script_cache_new(unsigned slots, size_t bytes_max);
+const char *script_cache_find(script_cache_t *cache, const unsigned char *hash);
+void script_cache_add(script_cache_t *cache, const char *script, unsigned char *hash);
+void script_cache_get_stats(script_cache_t *cache, unsigned long *hits, unsigned long *misses, size_t *bytes);
+void script_cache_free(script_cache_t **cache);
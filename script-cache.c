@@ -0,0 +1,213 @@
+#include <stdio.h>
+#include <stdlib.h>         // malloc()
+#include <string.h>         // memcmp(), memcpy()
+#include <sysexits.h>
+
+#include "script-cache-private.h"
+#include "misc.h"           // lpjs_log()
+
+
+/***************************************************************************
+ *  Description:
+ *      Create an empty script cache holding up to slots scripts and
+ *      bytes_max bytes of script text
+ *
+ *  Returns:
+ *      Pointer to the new cache.  Terminates the process if malloc()
+ *      fails, so no check is required.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+script_cache_t  *script_cache_new(unsigned slots, size_t bytes_max)
+
+{
+    script_cache_t  *cache;
+
+    if ( ((cache = malloc(sizeof(*cache))) == NULL) ||
+	 ((cache->entries = calloc(slots, sizeof(*cache->entries))) == NULL) )
+    {
+	lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
+	exit(EX_UNAVAILABLE);
+    }
+    cache->slots = slots;
+    cache->bytes = 0;
+    cache->bytes_max = bytes_max;
+    cache->clock = 0;
+    cache->hits = cache->misses = 0;
+    return cache;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Look up a script by hash, marking it recently used
+ *
+ *  Returns:
+ *      The script text, valid until the next script_cache_add(),
+ *      or NULL if not cached
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+const char  *script_cache_find(script_cache_t *cache,
+			       const unsigned char *hash)
+
+{
+    unsigned    c;
+
+    for (c = 0; c < cache->slots; ++c)
+    {
+	if ( (cache->entries[c].script != NULL) &&
+	     (memcmp(cache->entries[c].hash, hash, SHA256_DIGEST_LEN) == 0) )
+	{
+	    cache->entries[c].last_used = ++cache->clock;
+	    ++cache->hits;
+	    return cache->entries[c].script;
+	}
+    }
+    ++cache->misses;
+    return NULL;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Release the script held in an entry
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static void script_cache_evict(script_cache_t *cache,
+			       script_cache_entry_t *entry)
+
+{
+    cache->bytes -= entry->len;
+    free(entry->script);
+    entry->script = NULL;
+    entry->len = 0;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Add a copy of script to the cache, evicting the least recently
+ *      used scripts as needed to stay within the limits.  The hash is
+ *      computed here rather than trusted from the sender.  Scripts too
+ *      large for the cache are not added.
+ *
+ *      hash, if not NULL, receives the SHA-256 of script.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    script_cache_add(script_cache_t *cache, const char *script,
+			 unsigned char *hash)
+
+{
+    unsigned char           digest[SHA256_DIGEST_LEN];
+    script_cache_entry_t    *entry, *lru;
+    size_t                  len = strlen(script) + 1;
+    unsigned                c;
+
+    sha256(script, len - 1, digest);
+    if ( hash != NULL )
+	memcpy(hash, digest, SHA256_DIGEST_LEN);
+    if ( (cache->slots == 0) || (len > cache->bytes_max) )
+	return;
+
+    // Already cached, e.g. dispatchd resent after a miss on another job
+    for (c = 0; c < cache->slots; ++c)
+    {
+	entry = cache->entries + c;
+	if ( (entry->script != NULL) &&
+	     (memcmp(entry->hash, digest, SHA256_DIGEST_LEN) == 0) )
+	{
+	    entry->last_used = ++cache->clock;
+	    return;
+	}
+    }
+
+    // Evict until there is an empty slot and room for the text
+    do
+    {
+	lru = NULL;
+	entry = NULL;
+	for (c = 0; c < cache->slots; ++c)
+	{
+	    if ( cache->entries[c].script == NULL )
+	    {
+		if ( entry == NULL )
+		    entry = cache->entries + c;
+	    }
+	    else if ( (lru == NULL) ||
+		      (cache->entries[c].last_used < lru->last_used) )
+		lru = cache->entries + c;
+	}
+	if ( (entry == NULL) || (cache->bytes + len > cache->bytes_max) )
+	{
+	    script_cache_evict(cache, lru);
+	    entry = NULL;
+	}
+    }   while ( entry == NULL );
+
+    if ( (entry->script = malloc(len)) == NULL )
+    {
+	lpjs_log("%s(): Error: malloc() failed.\n", __FUNCTION__);
+	exit(EX_UNAVAILABLE);
+    }
+    memcpy(entry->script, script, len);
+    memcpy(entry->hash, digest, SHA256_DIGEST_LEN);
+    entry->len = len;
+    entry->last_used = ++cache->clock;
+    cache->bytes += len;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Report cache effectiveness for the log
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    script_cache_get_stats(script_cache_t *cache, unsigned long *hits,
+			       unsigned long *misses, size_t *bytes)
+
+{
+    *hits = cache->hits;
+    *misses = cache->misses;
+    *bytes = cache->bytes;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Return all memory held by the cache and set *cache to NULL
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    script_cache_free(script_cache_t **cache)
+
+{
+    unsigned    c;
+
+    for (c = 0; c < (*cache)->slots; ++c)
+	free((*cache)->entries[c].script);
+    free((*cache)->entries);
+    free(*cache);
+    *cache = NULL;
+}
@@ -0,0 +1,24 @@
+#ifndef _LPJS_SCRIPT_CACHE_H_
+#define _LPJS_SCRIPT_CACHE_H_
+
+#include <stddef.h>     // size_t
+
+#include "sha256.h"
+
+/*
+ *  Job scripts held by lpjs_compd, identified by SHA-256 of their
+ *  content.  dispatchd sends only the hash for scripts it has already
+ *  sent to a node, and the full script again if the node reports a miss,
+ *  so the cache can evict freely.
+ */
+
+// Number of scripts advertised to dispatchd at checkin
+#define SCRIPT_CACHE_SLOTS      64
+// Total script text held, least recently used scripts are evicted first
+#define SCRIPT_CACHE_BYTES_MAX  (4 * 1024 * 1024)
+
+typedef struct script_cache script_cache_t;
+
+#include "script-cache-protos.h"
+
+#endif  // _LPJS_SCRIPT_CACHE_H_
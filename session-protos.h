@@ -0,0 +1,10 @@
+/* session.c */
+uint64_t session_siphash(const unsigned char *key, const void *data, size_t len);
+int session_random_bytes(void *buff, size_t len);
+void session_start(int fd, const unsigned char *compd_nonce, const unsigned char *dispatchd_nonce, int role, uid_t peer_uid, gid_t peer_gid);
+void session_end(int fd);
+_Bool session_active(int fd);
+int session_get_peer(int fd, uid_t *uid, gid_t *gid);
+_Bool session_is_frame(const void *buff, size_t len);
+ssize_t session_seal(int fd, const void *payload, size_t len, unsigned char *frame, size_t frame_size);
+ssize_t session_open(int fd, const unsigned char *frame, size_t frame_len, const unsigned char **payload);
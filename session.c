@@ -0,0 +1,421 @@
+#include <stdio.h>
+#include <stdlib.h>         // realloc()
+#include <string.h>         // memcpy(), memset()
+#include <sysexits.h>
+#include <fcntl.h>          // open()
+#include <unistd.h>         // read(), close()
+
+#include "session.h"
+#include "misc.h"           // lpjs_log()
+
+typedef struct
+{
+    bool            active;
+    unsigned char   send_key[SESSION_KEY_LEN];
+    unsigned char   recv_key[SESSION_KEY_LEN];
+    uint64_t        send_seq;   // Last sequence number sent
+    uint64_t        recv_seq;   // Last sequence number received
+    uid_t           peer_uid;   // munge uid from the checkin
+    gid_t           peer_gid;
+}   session_t;
+
+/*
+ *  Sessions indexed by fd, grown as needed.  A process has at most a
+ *  few hundred connections open, so a flat array is simplest.
+ */
+
+static session_t    *Sessions = NULL;
+static size_t       Sessions_size = 0;
+
+#define ROTL64(x, b)    (uint64_t)(((x) << (b)) | ((x) >> (64 - (b))))
+
+#define SIPROUND \
+    do { \
+	v0 += v1; v1 = ROTL64(v1, 13); v1 ^= v0; v0 = ROTL64(v0, 32); \
+	v2 += v3; v3 = ROTL64(v3, 16); v3 ^= v2; \
+	v0 += v3; v3 = ROTL64(v3, 21); v3 ^= v0; \
+	v2 += v1; v1 = ROTL64(v1, 17); v1 ^= v2; v2 = ROTL64(v2, 32); \
+    } while (0)
+
+static uint64_t get_le64(const unsigned char *p)
+
+{
+    uint64_t    val;
+    int         c;
+
+    for (val = 0, c = 7; c >= 0; --c)
+	val = val << 8 | p[c];
+    return val;
+}
+
+
+static void put_le64(unsigned char *p, uint64_t val)
+
+{
+    int     c;
+
+    for (c = 0; c < 8; ++c, val >>= 8)
+	p[c] = val;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Compute SipHash-2-4 of data, a fast keyed hash suitable for
+ *      authenticating short messages.
+ *
+ *  Returns:
+ *      64-bit MAC
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+uint64_t    session_siphash(const unsigned char *key, const void *data,
+			    size_t len)
+
+{
+    const unsigned char *p = data,
+			*end = p + (len & ~(size_t)7);
+    uint64_t    k0 = get_le64(key),
+		k1 = get_le64(key + 8),
+		v0 = k0 ^ 0x736f6d6570736575ULL,
+		v1 = k1 ^ 0x646f72616e646f6dULL,
+		v2 = k0 ^ 0x6c7967656e657261ULL,
+		v3 = k1 ^ 0x7465646279746573ULL,
+		m, b;
+    size_t      c;
+
+    for (; p != end; p += 8)
+    {
+	m = get_le64(p);
+	v3 ^= m;
+	SIPROUND;
+	SIPROUND;
+	v0 ^= m;
+    }
+
+    // Last block: remaining bytes and the low byte of the length
+    b = (uint64_t)len << 56;
+    for (c = 0; c < (len & 7); ++c)
+	b |= (uint64_t)p[c] << (c * 8);
+    v3 ^= b;
+    SIPROUND;
+    SIPROUND;
+    v0 ^= b;
+
+    v2 ^= 0xff;
+    SIPROUND;
+    SIPROUND;
+    SIPROUND;
+    SIPROUND;
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Fill buff with cryptographically secure random bytes
+ *
+ *  Returns:
+ *      0 on success, -1 if the system random source is unavailable
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     session_random_bytes(void *buff, size_t len)
+
+{
+    int     fd;
+    ssize_t bytes;
+
+    if ( (fd = open("/dev/urandom", O_RDONLY)) == -1 )
+    {
+	lpjs_log("%s(): Error: Cannot open /dev/urandom.\n", __FUNCTION__);
+	return -1;
+    }
+    bytes = read(fd, buff, len);
+    close(fd);
+    if ( (bytes < 0) || ((size_t)bytes != len) )
+    {
+	lpjs_log("%s(): Error: Short read from /dev/urandom.\n", __FUNCTION__);
+	return -1;
+    }
+    return 0;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Derive the key for frames sent by one end of the connection,
+ *      keyed by the compd nonce over the dispatchd nonce.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static void session_derive_key(unsigned char *key,
+			       const unsigned char *compd_nonce,
+			       const unsigned char *dispatchd_nonce,
+			       int sender_role)
+
+{
+    unsigned char   input[SESSION_NONCE_LEN + 2];
+
+    memcpy(input, dispatchd_nonce, SESSION_NONCE_LEN);
+    input[SESSION_NONCE_LEN] = sender_role;
+    input[SESSION_NONCE_LEN + 1] = 0;
+    put_le64(key, session_siphash(compd_nonce, input, sizeof(input)));
+    input[SESSION_NONCE_LEN + 1] = 1;
+    put_le64(key + 8, session_siphash(compd_nonce, input, sizeof(input)));
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Get the session structure for fd, optionally growing the table
+ *
+ *  Returns:
+ *      Pointer to the session, or NULL if fd has none and create is false
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static session_t    *session_lookup(int fd, bool create)
+
+{
+    size_t      new_size;
+    session_t   *new_sessions;
+
+    if ( fd < 0 )
+	return NULL;
+    if ( (size_t)fd >= Sessions_size )
+    {
+	if ( ! create )
+	    return NULL;
+	for (new_size = Sessions_size == 0 ? 64 : Sessions_size;
+	     new_size <= (size_t)fd; new_size *= 2)
+	    ;
+	if ( (new_sessions = realloc(Sessions, new_size * sizeof(*Sessions)))
+		== NULL )
+	{
+	    lpjs_log("%s(): Error: realloc() failed.\n", __FUNCTION__);
+	    exit(EX_UNAVAILABLE);
+	}
+	memset(new_sessions + Sessions_size, 0,
+	       (new_size - Sessions_size) * sizeof(*Sessions));
+	Sessions = new_sessions;
+	Sessions_size = new_size;
+    }
+    return Sessions + fd;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Begin authenticating frames on fd with keys derived from the
+ *      nonces exchanged in the munge-encoded checkin.  peer_uid and
+ *      peer_gid are from the munge credential of the peer's checkin
+ *      message or reply, and are reported for every frame received.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    session_start(int fd, const unsigned char *compd_nonce,
+		      const unsigned char *dispatchd_nonce, int role,
+		      uid_t peer_uid, gid_t peer_gid)
+
+{
+    // Terminates process if realloc() fails, no check required
+    session_t   *session = session_lookup(fd, true);
+    int         peer_role;
+
+    peer_role = role == SESSION_ROLE_DISPATCHD ?
+		SESSION_ROLE_COMPD : SESSION_ROLE_DISPATCHD;
+    session_derive_key(session->send_key, compd_nonce, dispatchd_nonce, role);
+    session_derive_key(session->recv_key, compd_nonce, dispatchd_nonce,
+		       peer_role);
+    session->send_seq = session->recv_seq = 0;
+    session->peer_uid = peer_uid;
+    session->peer_gid = peer_gid;
+    session->active = true;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Forget the session on fd, if any.  Must be called when fd is
+ *      closed or reused for a new connection.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    session_end(int fd)
+
+{
+    session_t   *session;
+
+    if ( (session = session_lookup(fd, false)) != NULL )
+	memset(session, 0, sizeof(*session));
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Check whether fd has an active session
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+bool    session_active(int fd)
+
+{
+    session_t   *session = session_lookup(fd, false);
+
+    return (session != NULL) && session->active;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Get the uid and gid the peer authenticated with at checkin
+ *
+ *  Returns:
+ *      0 on success, -1 if fd has no active session
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     session_get_peer(int fd, uid_t *uid, gid_t *gid)
+
+{
+    session_t   *session = session_lookup(fd, false);
+
+    if ( (session == NULL) || ! session->active )
+	return -1;
+    *uid = session->peer_uid;
+    *gid = session->peer_gid;
+    return 0;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Check whether a received message is a session frame, as opposed
+ *      to a munge credential
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+bool    session_is_frame(const void *buff, size_t len)
+
+{
+    return (len >= SESSION_OVERHEAD) &&
+	   (((const unsigned char *)buff)[0] == SESSION_FRAME_MAGIC);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Build an authenticated frame containing payload, for sending
+ *      on fd.  frame_size should be at least len + SESSION_OVERHEAD.
+ *
+ *  Returns:
+ *      Length of the frame, or -1 if fd has no session or the frame
+ *      does not fit
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+ssize_t session_seal(int fd, const void *payload, size_t len,
+		     unsigned char *frame, size_t frame_size)
+
+{
+    session_t   *session = session_lookup(fd, false);
+    uint64_t    seq, mac;
+    int         c;
+
+    if ( (session == NULL) || ! session->active ||
+	 (frame_size < SESSION_OVERHEAD) ||
+	 (len > frame_size - SESSION_OVERHEAD) )
+	return -1;
+
+    seq = ++session->send_seq;
+    frame[0] = SESSION_FRAME_MAGIC;
+    for (c = 0; c < SESSION_SEQ_LEN; ++c)
+	frame[1 + c] = seq >> ((SESSION_SEQ_LEN - 1 - c) * 8);
+    memcpy(frame + SESSION_HEADER_LEN, payload, len);
+    mac = session_siphash(session->send_key, frame, SESSION_HEADER_LEN + len);
+    put_le64(frame + SESSION_HEADER_LEN + len, mac);
+    return SESSION_OVERHEAD + len;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Verify a frame received on fd.  The payload is not copied:
+ *      *payload points into frame.
+ *
+ *  Returns:
+ *      Length of the payload, or -1 if fd has no session, or the
+ *      frame is malformed, forged, replayed, or out of order
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+ssize_t session_open(int fd, const unsigned char *frame, size_t frame_len,
+		     const unsigned char **payload)
+
+{
+    session_t   *session = session_lookup(fd, false);
+    uint64_t    seq, diff;
+    size_t      len;
+    int         c;
+
+    if ( (session == NULL) || ! session->active ||
+	 ! session_is_frame(frame, frame_len) )
+	return -1;
+
+    len = frame_len - SESSION_OVERHEAD;
+    diff = session_siphash(session->recv_key, frame, SESSION_HEADER_LEN + len)
+	   ^ get_le64(frame + SESSION_HEADER_LEN + len);
+    if ( diff != 0 )
+    {
+	lpjs_log("%s(): Error: Bad MAC on fd %d.\n", __FUNCTION__, fd);
+	return -1;
+    }
+
+    for (seq = 0, c = 0; c < SESSION_SEQ_LEN; ++c)
+	seq = seq << 8 | frame[1 + c];
+    if ( seq != session->recv_seq + 1 )
+    {
+	lpjs_log("%s(): Error: Expected sequence %llu on fd %d, got %llu.\n",
+		 __FUNCTION__, (unsigned long long)session->recv_seq + 1,
+		 fd, (unsigned long long)seq);
+	return -1;
+    }
+    session->recv_seq = seq;
+
+    *payload = frame + SESSION_HEADER_LEN;
+    return len;
+}
@@ -0,0 +1,49 @@
+#ifndef _LPJS_SESSION_H_
+#define _LPJS_SESSION_H_
+
+#include <stddef.h>     // size_t
+#include <stdint.h>     // uint64_t
+#include <sys/types.h>  // uid_t, gid_t, ssize_t
+
+#ifndef true
+#include <stdbool.h>
+#endif
+
+/*
+ *  Authenticated frames for the persistent dispatchd-compd connection.
+ *
+ *  The connection is authenticated once by the munge-encoded checkin.
+ *  Each side includes SESSION_NONCE_LEN random bytes in its checkin
+ *  message (compd) or reply (dispatchd).  munged decodes the checkin
+ *  for any local user, so the compd nonce is public.  The reply is
+ *  encoded with a munge UID restriction, so only the compd user can
+ *  decode the dispatchd nonce.  Keys derived from both nonces are
+ *  therefore known only to the two ends, and are used to authenticate
+ *  later frames with SipHash-2-4:
+ *
+ *      SESSION_FRAME_MAGIC [sequence number] [payload] [MAC]
+ *
+ *  The sequence number is 64 bits in network byte order, starting at 1
+ *  and incremented for each frame sent in each direction, so replayed,
+ *  dropped, or reordered frames are rejected.  The MAC covers
+ *  everything before it, using a separate key for each direction.
+ *
+ *  SESSION_FRAME_MAGIC cannot start a munge credential, so munge
+ *  messages can still be received on a connection with a session.
+ */
+
+#define SESSION_FRAME_MAGIC     0xb5
+#define SESSION_NONCE_LEN       16
+#define SESSION_KEY_LEN         16
+#define SESSION_SEQ_LEN         8
+#define SESSION_MAC_LEN         8
+#define SESSION_HEADER_LEN      (1 + SESSION_SEQ_LEN)
+#define SESSION_OVERHEAD        (SESSION_HEADER_LEN + SESSION_MAC_LEN)
+
+// Which end of the connection we are, determines key use
+#define SESSION_ROLE_DISPATCHD  'D'
+#define SESSION_ROLE_COMPD      'C'
+
+#include "session-protos.h"
+
+#endif  // _LPJS_SESSION_H_
@@ -0,0 +1,6 @@
+/* sha256.c */
+void sha256_init(sha256_t *ctx);
+void sha256_update(sha256_t *ctx, const void *data, size_t len);
+void sha256_final(sha256_t *ctx, unsigned char *digest);
+void sha256(const void *data, size_t len, unsigned char *digest);
+void sha256_to_hex(const unsigned char *digest, char *hex);
@@ -0,0 +1,195 @@
+#include <stdio.h>
+#include <string.h>         // memcpy()
+
+#include "sha256.h"
+
+/*
+ *  SHA-256 (FIPS 180-4), used to identify job scripts by content.
+ *  Scripts are small, so this favors simplicity over speed.
+ */
+
+static const uint32_t   K[64] =
+{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+    0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+    0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+    0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+    0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#define ROTR32(x, n)    (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void sha256_transform(sha256_t *ctx, const unsigned char *block)
+
+{
+    uint32_t    w[64], a, b, c, d, e, f, g, h, t1, t2;
+    int         i;
+
+    for (i = 0; i < 16; ++i)
+	w[i] = (uint32_t)block[i * 4] << 24 | (uint32_t)block[i * 4 + 1] << 16 |
+	       (uint32_t)block[i * 4 + 2] << 8 | block[i * 4 + 3];
+    for (; i < 64; ++i)
+	w[i] = (ROTR32(w[i - 2], 17) ^ ROTR32(w[i - 2], 19) ^ (w[i - 2] >> 10))
+	       + w[i - 7]
+	       + (ROTR32(w[i - 15], 7) ^ ROTR32(w[i - 15], 18) ^ (w[i - 15] >> 3))
+	       + w[i - 16];
+
+    a = ctx->state[0]; b = ctx->state[1]; c = ctx->state[2]; d = ctx->state[3];
+    e = ctx->state[4]; f = ctx->state[5]; g = ctx->state[6]; h = ctx->state[7];
+    for (i = 0; i < 64; ++i)
+    {
+	t1 = h + (ROTR32(e, 6) ^ ROTR32(e, 11) ^ ROTR32(e, 25))
+	     + ((e & f) ^ (~e & g)) + K[i] + w[i];
+	t2 = (ROTR32(a, 2) ^ ROTR32(a, 13) ^ ROTR32(a, 22))
+	     + ((a & b) ^ (a & c) ^ (b & c));
+	h = g; g = f; f = e; e = d + t1;
+	d = c; c = b; b = a; a = t1 + t2;
+    }
+    ctx->state[0] += a; ctx->state[1] += b; ctx->state[2] += c;
+    ctx->state[3] += d; ctx->state[4] += e; ctx->state[5] += f;
+    ctx->state[6] += g; ctx->state[7] += h;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Prepare to hash a message with sha256_update()
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    sha256_init(sha256_t *ctx)
+
+{
+    static const uint32_t   initial[8] =
+    {
+	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+	0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+
+    memcpy(ctx->state, initial, sizeof(initial));
+    ctx->total_len = 0;
+    ctx->block_len = 0;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Add data to the message being hashed
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    sha256_update(sha256_t *ctx, const void *data, size_t len)
+
+{
+    const unsigned char *p = data;
+    size_t              n;
+
+    ctx->total_len += len;
+    while ( len > 0 )
+    {
+	n = SHA256_BLOCK_LEN - ctx->block_len;
+	if ( n > len )
+	    n = len;
+	memcpy(ctx->block + ctx->block_len, p, n);
+	ctx->block_len += n;
+	p += n;
+	len -= n;
+	if ( ctx->block_len == SHA256_BLOCK_LEN )
+	{
+	    sha256_transform(ctx, ctx->block);
+	    ctx->block_len = 0;
+	}
+    }
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Finish hashing and store the SHA256_DIGEST_LEN byte digest
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    sha256_final(sha256_t *ctx, unsigned char *digest)
+
+{
+    uint64_t    bits = ctx->total_len * 8;
+    int         c;
+
+    // Pad with 0x80, zeros, and the message length in bits
+    ctx->block[ctx->block_len++] = 0x80;
+    if ( ctx->block_len > SHA256_BLOCK_LEN - 8 )
+    {
+	memset(ctx->block + ctx->block_len, 0,
+	       SHA256_BLOCK_LEN - ctx->block_len);
+	sha256_transform(ctx, ctx->block);
+	ctx->block_len = 0;
+    }
+    memset(ctx->block + ctx->block_len, 0,
+	   SHA256_BLOCK_LEN - 8 - ctx->block_len);
+    for (c = 0; c < 8; ++c)
+	ctx->block[SHA256_BLOCK_LEN - 1 - c] = bits >> (c * 8);
+    sha256_transform(ctx, ctx->block);
+
+    for (c = 0; c < 32; ++c)
+	digest[c] = ctx->state[c / 4] >> ((3 - c % 4) * 8);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Hash a complete message in one call
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    sha256(const void *data, size_t len, unsigned char *digest)
+
+{
+    sha256_t    ctx;
+
+    sha256_init(&ctx);
+    sha256_update(&ctx, data, len);
+    sha256_final(&ctx, digest);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Convert a digest to hexadecimal for log messages.  hex must
+ *      have room for SHA256_DIGEST_LEN * 2 + 1 characters.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    sha256_to_hex(const unsigned char *digest, char *hex)
+
+{
+    int     c;
+
+    for (c = 0; c < SHA256_DIGEST_LEN; ++c)
+	snprintf(hex + c * 2, 3, "%02x", digest[c]);
+}
@@ -0,0 +1,20 @@
+#ifndef _LPJS_SHA256_H_
+#define _LPJS_SHA256_H_
+
+#include <stddef.h>     // size_t
+#include <stdint.h>     // uint32_t
+
+#define SHA256_DIGEST_LEN   32
+#define SHA256_BLOCK_LEN    64
+
+typedef struct
+{
+    uint32_t        state[8];
+    uint64_t        total_len;
+    unsigned char   block[SHA256_BLOCK_LEN];
+    size_t          block_len;
+}   sha256_t;
+
+#include "sha256-protos.h"
+
+#endif  // _LPJS_SHA256_H_
@@ -0,0 +1,5 @@
+/* stream.c */
+void lpjs_stream_init(lpjs_stream_t *stream, int msg_fd, int (*close_function)(int));
+int lpjs_stream_printf(lpjs_stream_t *stream, const char *format, ...);
+int lpjs_stream_flush(lpjs_stream_t *stream);
+int lpjs_stream_finish(lpjs_stream_t *stream, _Bool eot);
@@ -0,0 +1,168 @@
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdbool.h>
+
+#include "lpjs.h"
+#include "network.h"
+#include "stream.h"
+#include "misc.h"           // lpjs_log()
+
+/*
+ *  A frame must fit in a message no larger than LPJS_MSG_LEN_MAX
+ *  after base64 encoding by munge, which expands it by 4/3.
+ */
+
+#if (LPJS_STREAM_FRAME_MAX + 1) * 4 / 3 + 4096 > LPJS_MSG_LEN_MAX
+#error "LPJS_STREAM_FRAME_MAX is too large for a munge credential"
+#endif
+
+
+/***************************************************************************
+ *  Description:
+ *      Begin a streamed response on msg_fd.  close_function is passed
+ *      through to lpjs_send_munge_pipelined() and is called if a send
+ *      fails, after which further output is discarded.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    lpjs_stream_init(lpjs_stream_t *stream, int msg_fd,
+			 int (*close_function)(int))
+
+{
+    stream->msg_fd = msg_fd;
+    stream->close_function = close_function;
+    stream->status = LPJS_MSG_SENT;
+    stream->len = 0;
+    *stream->frame = '\0';
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Append a formatted record to the stream, sending the current
+ *      frame first if the record would not fit.  Records are never
+ *      split across frames, so the receiver may process each frame
+ *      independently.  A single record larger than a frame is
+ *      truncated.
+ *
+ *  Returns:
+ *      LPJS_MSG_SENT, or the status of the first failed send
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     lpjs_stream_printf(lpjs_stream_t *stream, const char *format, ...)
+
+{
+    va_list     ap;
+    size_t      room;
+    int         len;
+
+    if ( stream->status != LPJS_MSG_SENT )
+	return stream->status;
+
+    room = LPJS_STREAM_FRAME_MAX - stream->len;
+    va_start(ap, format);
+    len = vsnprintf(stream->frame + stream->len, room + 1, format, ap);
+    va_end(ap);
+    if ( len < 0 )
+    {
+	stream->frame[stream->len] = '\0';
+	lpjs_log("%s(): Error: vsnprintf() failed.\n", __FUNCTION__);
+	return stream->status;
+    }
+
+    if ( (size_t)len > room )
+    {
+	// Send what we have and retry in an empty frame
+	if ( stream->len > 0 )
+	{
+	    stream->frame[stream->len] = '\0';
+	    if ( lpjs_stream_flush(stream) != LPJS_MSG_SENT )
+		return stream->status;
+	    va_start(ap, format);
+	    len = vsnprintf(stream->frame, LPJS_STREAM_FRAME_MAX + 1, format, ap);
+	    va_end(ap);
+	}
+	if ( len > LPJS_STREAM_FRAME_MAX )
+	{
+	    lpjs_log("%s(): Warning: Record of %d bytes truncated to %d.\n",
+		     __FUNCTION__, len, LPJS_STREAM_FRAME_MAX);
+	    len = LPJS_STREAM_FRAME_MAX;
+	}
+    }
+    stream->len += len;
+
+    return stream->status;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Send the current frame, if not empty.  If LPJS_STREAM_WINDOW
+ *      frames are then awaiting acknowledgement, wait for them, so
+ *      the sender never gets more than a window ahead of the receiver.
+ *
+ *  Returns:
+ *      LPJS_MSG_SENT, or the status of the first failed send
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     lpjs_stream_flush(lpjs_stream_t *stream)
+
+{
+    if ( (stream->status != LPJS_MSG_SENT) || (stream->len == 0) )
+	return stream->status;
+
+    stream->status = lpjs_send_munge_pipelined(stream->msg_fd, stream->frame,
+					       stream->close_function);
+    stream->len = 0;
+    *stream->frame = '\0';
+    if ( (stream->status == LPJS_MSG_SENT) &&
+	 (lpjs_acks_due(stream->msg_fd, 0) >= LPJS_STREAM_WINDOW) )
+	stream->status = lpjs_collect_acks(stream->msg_fd, true);
+
+    return stream->status;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Send the last frame, with LPJS_EOT appended if eot is true,
+ *      and wait for all acknowledgements.  If eot is false, the caller
+ *      is responsible for ending the response, e.g. with
+ *      lpjs_dispatchd_safe_close().
+ *
+ *  Returns:
+ *      LPJS_MSG_SENT, or the status of the first failed send
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     lpjs_stream_finish(lpjs_stream_t *stream, bool eot)
+
+{
+    if ( stream->status != LPJS_MSG_SENT )
+	return stream->status;
+
+    // frame has room for EOT beyond LPJS_STREAM_FRAME_MAX
+    if ( eot )
+    {
+	stream->frame[stream->len++] = LPJS_EOT;
+	stream->frame[stream->len] = '\0';
+    }
+    if ( lpjs_stream_flush(stream) == LPJS_MSG_SENT )
+	stream->status = lpjs_collect_acks(stream->msg_fd, true);
+
+    return stream->status;
+}
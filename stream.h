@@ -0,0 +1,33 @@
+#ifndef _LPJS_STREAM_H_
+#define _LPJS_STREAM_H_
+
+#include <stddef.h>     // size_t
+
+/*
+ *  Streamed responses for list-type requests such as lpjs jobs and
+ *  lpjs nodes.  Records are packed into frames of up to
+ *  LPJS_STREAM_FRAME_MAX bytes, each sent as one munge message, so
+ *  results of any size take a few messages per thousand records.
+ *
+ *  Frames are pipelined (see lpjs_send_munge_pipelined()).  Flow
+ *  control: once LPJS_STREAM_WINDOW frames are unacknowledged, the
+ *  sender waits for the receiver to catch up, so a slow client costs
+ *  dispatchd one round trip per window rather than unbounded buffering.
+ */
+
+#define LPJS_STREAM_FRAME_MAX   32768
+#define LPJS_STREAM_WINDOW      8
+
+typedef struct
+{
+    int     msg_fd;
+    int     (*close_function)(int);
+    int     status;     // LPJS_MSG_SENT until a send fails
+    size_t  len;
+    // +1 for EOT, +1 for '\0'
+    char    frame[LPJS_STREAM_FRAME_MAX + 2];
+}   lpjs_stream_t;
+
+#include "stream-protos.h"
+
+#endif  // _LPJS_STREAM_H_
@@ -6,6 +6,8 @@
  *  History: 
  *  Date        Name        Modification
  *  2021-09-28  Jason Bacon Begin
+ *  2026-10-19  Jason Bacon Compress large scripts
+ *  2026-10-19  Jason Bacon Submit many scripts over one connection
  ***************************************************************************/
 
 // System headers
@@ -18,6 +20,7 @@
 #include <sys/socket.h>
 #include <fcntl.h>          // open()
 #include <errno.h>
+#include <ctype.h>          // isspace()
 
 // Addons
 #include <munge.h>
@@ -28,9 +31,13 @@
 #include "node-list.h"
 #include "config.h"
 #include "network.h"
+#include "wire.h"
 #include "misc.h"
 #include "lpjs.h"
 
+// Longest script name in a manifest read from stdin
+#define SUBMIT_NAME_MAX     PATH_MAX
+
 char    *xt_shebang_check(const char *script_text, const char *ext)
 
 {
@@ -63,64 +70,353 @@ char    *xt_shebang_check(const char *script_text, const char *ext)
 }
 
 
-int     main (int argc, char *argv[])
+/***************************************************************************
+ *  Description:
+ *      Load a script, warn about likely mistakes, and parse its job
+ *      specs into *job
+ *
+ *  Returns:
+ *      The script text, or NULL if the script is unusable, which is
+ *      reported
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2021-09-28  Jason Bacon Begin as part of main()
+ *  2026-10-19  Jason Bacon Factor out for batch submission
+ ***************************************************************************/
+
+lpjs_buff_t *submit_load(const char *script_name, job_t **job)
 
 {
-    int     msg_fd,
-	    fd;
-    char    outgoing_msg[LPJS_JOB_MSG_MAX + 3],
-	    *script_name,
-	    *ext,
-	    *warning,
-	    job_string[JOB_STR_MAX_LEN + 1],
-	    hostname[sysconf(_SC_HOST_NAME_MAX) + 1],
-	    shared_fs_marker[PATH_MAX + 1],
-	    script_text[LPJS_SCRIPT_SIZE_MAX + 1];
-    ssize_t script_size;
+    char        *ext,
+		*warning;
+    ssize_t     script_size;
+    lpjs_buff_t *script_text;
+    
+    if ( ((ext = strrchr(script_name, '.')) == NULL) ||
+	 (strcmp(ext, ".lpjs") != 0 ) )
+	fprintf(stderr, "Warning: Script name \"%s\" should end in \".lpjs\"\n",
+		script_name);
+    
+    // Reports missing and oversized scripts via lpjs_log()
+    if ( (script_size = lpjs_script_size(script_name)) < 0 )
+	return NULL;
+    script_text = lpjs_buff_get(script_size);
+    script_size = lpjs_load_script(script_name, script_text->data,
+				   script_text->size);
+    
+    if ( (ext != NULL) &&
+	 ((warning = xt_shebang_check(script_text->data, ext)) != NULL) )
+	fputs(warning, stderr);
+    
+    if ( script_size < LPJS_SCRIPT_MIN_SIZE )
+    {
+	lpjs_log("%s(): Error: Script %s < %d chars.\n",
+		__FUNCTION__, script_name, LPJS_SCRIPT_MIN_SIZE);
+	lpjs_buff_put(&script_text);
+	return NULL;
+    }
+    
     // Terminates process if malloc() fails, no check required
-    node_list_t *node_list = node_list_new();
+    *job = job_new();
+    if ( job_parse_script(*job, script_name) != 0 )
+    {
+	job_free(job);
+	lpjs_buff_put(&script_text);
+	return NULL;
+    }
+    return script_text;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Write job specs followed by the script, in the binary format
+ *      in wire.h, to buff
+ *
+ *  Returns:
+ *      Length of the message, or -1 if it does not fit in size bytes
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Factor out from main()
+ ***************************************************************************/
+
+ssize_t submit_encode(job_t *job, const char *script_text,
+		      void *buff, size_t size)
+
+{
+    wire_writer_t   writer;
+    
+    wire_writer_init(&writer, buff, size);
+    job_write_to_wire(job, &writer);
+    wire_put_str(&writer, WIRE_TAG_SCRIPT, script_text);
+    return wire_writer_len(&writer);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Send a submit request to dispatchd and print the response
+ *
+ *  Returns:
+ *      EX_OK on success, EX_IOERR on failure
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2021-09-28  Jason Bacon Begin as part of main()
+ *  2026-10-19  Jason Bacon Factor out for batch submission
+ ***************************************************************************/
+
+int     submit_send(node_list_t *node_list, const void *msg, size_t msg_len)
+
+{
+    int     msg_fd;
+    
+    if ( (msg_fd = lpjs_connect_to_dispatchd(node_list)) == -1 )
+    {
+	perror("lpjs-submit: Failed to connect to dispatch");
+	return EX_IOERR;
+    }
+    
+    /*
+     *  Large scripts are compressed.  There is no handshake here, but
+     *  dispatchd is always upgraded before user commands (see
+     *  communication.md), so it can expand them.  Local connections
+     *  are never compressed.
+     */
+    lpjs_compress_enable(msg_fd, LPJS_COMPRESS_METHODS);
+    
+    // FIXME: Exiting here causes dispatchd to crash
+
+    if ( lpjs_send_munge_bin(msg_fd, msg, msg_len, close) != LPJS_MSG_SENT )
+    {
+	perror("lpjs-submit: Failed to send submit request to dispatch");
+	close(msg_fd);
+	return EX_IOERR;
+    }
+    
+    lpjs_print_response(msg_fd, "lpjs submit");
+    return EX_OK;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Submit one script, as a LPJS_DISPATCHD_REQUEST_SUBMIT, which
+ *      all versions of dispatchd understand
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2021-09-28  Jason Bacon Begin as part of main()
+ *  2026-10-19  Jason Bacon Factor out for batch submission
+ ***************************************************************************/
+
+int     submit_one(node_list_t *node_list, const char *script_name)
+
+{
+    lpjs_buff_t *script_text,
+		*outgoing_msg;
     job_t       *job;
-    // Shared functions may use lpjs_log
-    extern FILE *Log_stream;
+    ssize_t     msg_len;
+    int         status;
     
-    Log_stream = stderr;
+    if ( (script_text = submit_load(script_name, &job)) == NULL )
+	return EX_DATAERR;
     
-    if ( (getuid() == 0) || (geteuid() == 0) )
+    outgoing_msg = lpjs_buff_get(LPJS_JOB_MSG_SIZE(script_text->size) + 1);
+    outgoing_msg->data[0] = LPJS_DISPATCHD_REQUEST_SUBMIT;
+    if ( (msg_len = submit_encode(job, script_text->data,
+				  outgoing_msg->data + 1,
+				  outgoing_msg->size - 1)) < 0 )
     {
-	fprintf(stderr, "Cannot run jobs as root.\n");
-	return EX_USAGE;
+	fprintf(stderr, "lpjs-submit: Job specs and script are too large.\n");
+	status = EX_DATAERR;
+    }
+    else
+	status = submit_send(node_list, outgoing_msg->data, msg_len + 1);
+    
+    lpjs_buff_put(&outgoing_msg);
+    lpjs_buff_put(&script_text);
+    job_free(&job);
+    return status;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Submit many scripts, packing as many as fit within
+ *      LPJS_SUBMIT_BATCH_MAX into each LPJS_DISPATCHD_REQUEST_SUBMIT_BATCH,
+ *      so a pipeline submitting hundreds of scripts usually needs one
+ *      connection and one munge credential rather than hundreds.
+ *      Scripts that cannot be loaded are reported and skipped.
+ *
+ *  Arguments:
+ *      next_script Returns the next script name, or NULL at the end
+ *
+ *  Returns:
+ *      EX_OK if every script was submitted, an error code otherwise
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     submit_batch(node_list_t *node_list,
+		     const char *(*next_script)(void *arg), void *arg)
+
+{
+    lpjs_buff_t     *script_text,
+		    *submission,
+		    *batch;
+    wire_writer_t   writer;
+    job_t           *job;
+    const char      *script_name;
+    ssize_t         len;
+    size_t          count = 0;
+    int             status = EX_OK;
+    
+    // Room for a request code, to send alone if it fills a batch
+    submission = lpjs_buff_get(LPJS_JOB_MSG_SIZE(LPJS_SCRIPT_SIZE_MAX) + 1);
+    submission->data[0] = LPJS_DISPATCHD_REQUEST_SUBMIT;
+    batch = lpjs_buff_get(LPJS_SUBMIT_BATCH_MAX + 1);
+    batch->data[0] = LPJS_DISPATCHD_REQUEST_SUBMIT_BATCH;
+    wire_writer_init(&writer, batch->data + 1, batch->size - 1);
+    
+    while ( (script_name = next_script(arg)) != NULL )
+    {
+	if ( (script_text = submit_load(script_name, &job)) == NULL )
+	{
+	    status = EX_DATAERR;
+	    continue;
+	}
+	len = submit_encode(job, script_text->data, submission->data + 1,
+			    submission->size - 1);
+	lpjs_buff_put(&script_text);
+	job_free(&job);
+	if ( len < 0 )
+	{
+	    fprintf(stderr, "lpjs-submit: Job specs and script for %s are too large.\n",
+		    script_name);
+	    status = EX_DATAERR;
+	    continue;
+	}
+	
+	// Room for this submission and the count that ends the batch
+	if ( wire_writer_room(&writer) <
+	     len + 2 * WIRE_FIELD_HEADER_LEN + sizeof(uint64_t) )
+	{
+	    if ( count > 0 )
+	    {
+		wire_put_uint(&writer, WIRE_TAG_SUBMISSIONS, count);
+		if ( submit_send(node_list, batch->data,
+				 wire_writer_len(&writer) + 1) != EX_OK )
+		    status = EX_IOERR;
+		wire_writer_init(&writer, batch->data + 1, batch->size - 1);
+		count = 0;
+	    }
+	    // A script near LPJS_SCRIPT_SIZE_MAX fills a batch by itself
+	    if ( wire_writer_room(&writer) <
+		 len + 2 * WIRE_FIELD_HEADER_LEN + sizeof(uint64_t) )
+	    {
+		if ( submit_send(node_list, submission->data, len + 1) != EX_OK )
+		    status = EX_IOERR;
+		continue;
+	    }
+	}
+	wire_put_bytes(&writer, WIRE_TAG_SUBMISSION, submission->data + 1, len);
+	++count;
     }
     
-    if ( argc != 2 )
+    if ( count > 0 )
     {
-	fprintf (stderr, "Usage: %s script.lpjs\n", argv[0]);
-	return EX_USAGE;
+	wire_put_uint(&writer, WIRE_TAG_SUBMISSIONS, count);
+	if ( submit_send(node_list, batch->data,
+			 wire_writer_len(&writer) + 1) != EX_OK )
+	    status = EX_IOERR;
     }
-    script_name = argv[1];
+    lpjs_buff_put(&submission);
+    lpjs_buff_put(&batch);
+    return status;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Get script names from the command line, for submit_batch()
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+const char  *submit_next_arg(void *arg)
+
+{
+    char    ***argv = arg;
     
-    if ( ((ext = strchr(script_name, '.')) == NULL) ||
-	 (strcmp(ext, ".lpjs") != 0 ) )
-	fprintf(stderr, "Warning: Script name \"%s\" should end in \".lpjs\"\n",
-		script_name);
+    return **argv == NULL ? NULL : *(*argv)++;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Get script names from a manifest on stdin, one per line, for
+ *      submit_batch().  Blank lines and lines starting with '#' are
+ *      ignored.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+const char  *submit_next_line(void *arg)
+
+{
+    static char line[SUBMIT_NAME_MAX + 2];
+    char        *start,
+		*end;
     
-    script_size = lpjs_load_script(script_name, script_text,
-				   LPJS_SCRIPT_SIZE_MAX + 1);
+    while ( fgets(line, sizeof(line), stdin) != NULL )
+    {
+	for (start = line; (*start == ' ') || (*start == '\t'); ++start)
+	    ;
+	for (end = start + strlen(start);
+	     (end > start) && isspace((unsigned char)end[-1]); --end)
+	    ;
+	*end = '\0';
+	if ( (*start != '\0') && (*start != '#') )
+	    return start;
+    }
+    return NULL;
+}
+
+
+int     main (int argc, char *argv[])
+
+{
+    int     fd;
+    char    hostname[sysconf(_SC_HOST_NAME_MAX) + 1],
+	    shared_fs_marker[PATH_MAX + 1],
+	    **args;
+    // Terminates process if malloc() fails, no check required
+    node_list_t *node_list = node_list_new();
+    // Shared functions may use lpjs_log
+    extern FILE *Log_stream;
     
-    if ( (warning = xt_shebang_check(script_text, ext)) != NULL )
-	fputs(warning, stderr);
+    Log_stream = stderr;
     
-    if ( script_size > LPJS_PAYLOAD_MAX )
+    if ( (getuid() == 0) || (geteuid() == 0) )
     {
-	fprintf(stderr, "Error: Script size cannot exceed LPJS_PAYLOAD_MAX = %u\n",
-		LPJS_PAYLOAD_MAX);
-	return EX_DATAERR;
+	fprintf(stderr, "Cannot run jobs as root.\n");
+	return EX_USAGE;
     }
     
-    if ( script_size < LPJS_SCRIPT_MIN_SIZE )
+    if ( argc < 2 )
     {
-	lpjs_log("%s(): Error: Script %s < %d chars.\n",
-		__FUNCTION__, script_name, LPJS_SCRIPT_MIN_SIZE);
-	return EX_DATAERR;
+	fprintf (stderr, "Usage: %s script.lpjs [script.lpjs ...]\n", argv[0]);
+	fprintf (stderr, "       %s - < manifest\n", argv[0]);
+	return EX_USAGE;
     }
     
     /*
@@ -144,33 +440,13 @@ int     main (int argc, char *argv[])
     // Get hostname of head node
     lpjs_load_config(node_list, LPJS_CONFIG_HEAD_ONLY, stderr);
     
-    // Terminates process if malloc() fails, no check required
-    job = job_new();
-    job_parse_script(job, script_name);
-    
-    script_name = job_get_script_name(job);
-
-    if ( (msg_fd = lpjs_connect_to_dispatchd(node_list)) == -1 )
+    if ( strcmp(argv[1], "-") == 0 )
+	return submit_batch(node_list, submit_next_line, NULL);
+    else if ( argc > 2 )
     {
-	perror("lpjs-submit: Failed to connect to dispatch");
-	return EX_IOERR;
+	args = argv + 1;
+	return submit_batch(node_list, submit_next_arg, &args);
     }
-    
-    job_print_to_string(job, job_string, LPJS_PAYLOAD_MAX + 1);
-
-    snprintf(outgoing_msg, LPJS_JOB_MSG_MAX + 3, "%c%s\n%s",
-	    LPJS_DISPATCHD_REQUEST_SUBMIT, job_string, script_text);
-
-    // FIXME: Exiting here causes dispatchd to crash
-
-    if ( lpjs_send_munge(msg_fd, outgoing_msg, close) != LPJS_MSG_SENT )
-    {
-	perror("lpjs-submit: Failed to send submit request to dispatch");
-	close(msg_fd);
-	return EX_IOERR;
-    }
-    
-    lpjs_print_response(msg_fd, "lpjs submit");
-    
-    return EX_OK;
+    else
+	return submit_one(node_list, argv[1]);
 }
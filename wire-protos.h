@@ -0,0 +1,13 @@
+/* wire.c */
+void wire_writer_init(wire_writer_t *writer, void *buff, size_t size);
+void wire_put_uint(wire_writer_t *writer, unsigned tag, uint64_t val);
+void wire_put_str(wire_writer_t *writer, unsigned tag, const char *str);
+void wire_put_bytes(wire_writer_t *writer, unsigned tag, const void *bytes, size_t len);
+ssize_t wire_writer_len(wire_writer_t *writer);
+size_t wire_writer_room(wire_writer_t *writer);
+_Bool wire_is_binary(const void *buff, size_t len);
+int wire_reader_init(wire_reader_t *reader, const void *buff, size_t len);
+int wire_next_field(wire_reader_t *reader, wire_field_t *field);
+int wire_get_uint(const wire_field_t *field, uint64_t *val);
+const char *wire_get_str(const wire_field_t *field);
+int wire_find_field(const void *buff, size_t len, unsigned tag, wire_field_t *field);
@@ -0,0 +1,348 @@
+#include <stdio.h>
+#include <string.h>         // memcpy(), strlen()
+#include <sys/types.h>      // ssize_t
+
+#include "wire.h"
+
+
+/***************************************************************************
+ *  Description:
+ *      Prepare to build a binary message in buff.  The header is
+ *      written immediately, so fields can be added right away.
+ *      A request code, if any, should be stored before buff.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    wire_writer_init(wire_writer_t *writer, void *buff, size_t size)
+
+{
+    writer->buff = buff;
+    writer->size = size;
+    writer->len = 0;
+    writer->overflow = false;
+    if ( size < WIRE_HEADER_LEN )
+	writer->overflow = true;
+    else
+    {
+	writer->buff[writer->len++] = WIRE_MAGIC;
+	writer->buff[writer->len++] = WIRE_SCHEMA_VERSION;
+    }
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Append a field header, checking for room for the value as well.
+ *
+ *  Returns:
+ *      true if the header was written and value_len bytes may follow
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+static bool wire_put_header(wire_writer_t *writer, unsigned tag,
+			    size_t value_len)
+
+{
+    unsigned char   *p;
+
+    if ( writer->overflow || (value_len > UINT32_MAX) ||
+	 (writer->size - writer->len < WIRE_FIELD_HEADER_LEN + value_len) )
+    {
+	writer->overflow = true;
+	return false;
+    }
+
+    p = writer->buff + writer->len;
+    p[0] = tag >> 8;
+    p[1] = tag;
+    p[2] = value_len >> 24;
+    p[3] = value_len >> 16;
+    p[4] = value_len >> 8;
+    p[5] = value_len;
+    writer->len += WIRE_FIELD_HEADER_LEN;
+    return true;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Append an unsigned integer field, using only as many bytes
+ *      as needed.  Signed values that are never negative, such as
+ *      PIDs, are sent the same way.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    wire_put_uint(wire_writer_t *writer, unsigned tag, uint64_t val)
+
+{
+    size_t  bytes, c;
+
+    for (bytes = 1; (bytes < sizeof(val)) && (val >> (bytes * 8)) != 0;
+	 ++bytes)
+	;
+    if ( wire_put_header(writer, tag, bytes) )
+    {
+	for (c = 0; c < bytes; ++c)
+	    writer->buff[writer->len + c] = val >> ((bytes - 1 - c) * 8);
+	writer->len += bytes;
+    }
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Append a string field, including the terminating '\0'.
+ *      A NULL string is omitted, so the receiver uses its default.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    wire_put_str(wire_writer_t *writer, unsigned tag, const char *str)
+
+{
+    size_t  len;
+
+    if ( str == NULL )
+	return;
+    len = strlen(str) + 1;
+    if ( wire_put_header(writer, tag, len) )
+    {
+	memcpy(writer->buff + writer->len, str, len);
+	writer->len += len;
+    }
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Append a field of raw bytes, such as a random nonce
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+void    wire_put_bytes(wire_writer_t *writer, unsigned tag, const void *bytes,
+		       size_t len)
+
+{
+    if ( wire_put_header(writer, tag, len) )
+    {
+	memcpy(writer->buff + writer->len, bytes, len);
+	writer->len += len;
+    }
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Get the length of the message built so far
+ *
+ *  Returns:
+ *      Length in bytes, or -1 if it did not fit in the buffer
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+ssize_t wire_writer_len(wire_writer_t *writer)
+
+{
+    return writer->overflow ? -1 : (ssize_t)writer->len;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Get the space left in the buffer, so optional fields can be
+ *      skipped rather than overflowing the message
+ *
+ *  Returns:
+ *      Free bytes, including room for field headers, 0 after overflow
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+size_t  wire_writer_room(wire_writer_t *writer)
+
+{
+    return writer->overflow ? 0 : writer->size - writer->len;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Check whether a message body is in binary format, as opposed
+ *      to the legacy text formats.  buff should point past the
+ *      request code, if any.
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+bool    wire_is_binary(const void *buff, size_t len)
+
+{
+    return (len >= WIRE_HEADER_LEN) &&
+	   (((const unsigned char *)buff)[0] == WIRE_MAGIC);
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Validate the header of a binary message and prepare to read
+ *      its fields with wire_next_field().  Messages from a newer
+ *      schema version are rejected, since by definition they contain
+ *      changes older receivers cannot handle.
+ *
+ *  Returns:
+ *      WIRE_OK, WIRE_MALFORMED, or WIRE_BAD_VERSION
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     wire_reader_init(wire_reader_t *reader, const void *buff, size_t len)
+
+{
+    const unsigned char *p = buff;
+
+    if ( ! wire_is_binary(buff, len) )
+	return WIRE_MALFORMED;
+
+    reader->version = p[1];
+    reader->next = p + WIRE_HEADER_LEN;
+    reader->end = p + len;
+    if ( (reader->version == 0) || (reader->version > WIRE_SCHEMA_VERSION) )
+	return WIRE_BAD_VERSION;
+    return WIRE_OK;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Get the next field from a binary message.  The value is not
+ *      copied: field->value points into the message buffer.
+ *
+ *  Returns:
+ *      WIRE_OK, WIRE_END if there are no more fields, or
+ *      WIRE_MALFORMED if a field runs past the end of the message
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     wire_next_field(wire_reader_t *reader, wire_field_t *field)
+
+{
+    const unsigned char *p = reader->next;
+    size_t              avail = reader->end - p;
+
+    if ( avail == 0 )
+	return WIRE_END;
+    if ( avail < WIRE_FIELD_HEADER_LEN )
+	return WIRE_MALFORMED;
+
+    field->tag = (unsigned)p[0] << 8 | p[1];
+    field->len = (size_t)p[2] << 24 | (size_t)p[3] << 16 |
+		 (size_t)p[4] << 8 | p[5];
+    if ( field->len > avail - WIRE_FIELD_HEADER_LEN )
+	return WIRE_MALFORMED;
+
+    field->value = p + WIRE_FIELD_HEADER_LEN;
+    reader->next = field->value + field->len;
+    return WIRE_OK;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Decode an integer field
+ *
+ *  Returns:
+ *      WIRE_OK, or WIRE_MALFORMED if the length is not 1 to 8 bytes
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     wire_get_uint(const wire_field_t *field, uint64_t *val)
+
+{
+    size_t  c;
+
+    if ( (field->len < 1) || (field->len > sizeof(*val)) )
+	return WIRE_MALFORMED;
+    for (*val = 0, c = 0; c < field->len; ++c)
+	*val = *val << 8 | field->value[c];
+    return WIRE_OK;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Get a string field in place
+ *
+ *  Returns:
+ *      Pointer into the message buffer, or NULL if the value is not
+ *      a '\0'-terminated string
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+const char  *wire_get_str(const wire_field_t *field)
+
+{
+    if ( (field->len < 1) || (field->value[field->len - 1] != '\0') )
+	return NULL;
+    return (const char *)field->value;
+}
+
+
+/***************************************************************************
+ *  Description:
+ *      Scan a binary message for a specific field, e.g. to pick out
+ *      a message-level field after decoding a job or node.
+ *
+ *  Returns:
+ *      WIRE_OK, WIRE_END if not found, or a negative error code
+ *
+ *  History:
+ *  Date        Name        Modification
+ *  2026-10-19  Jason Bacon Begin
+ ***************************************************************************/
+
+int     wire_find_field(const void *buff, size_t len, unsigned tag,
+			wire_field_t *field)
+
+{
+    wire_reader_t   reader;
+    int             status;
+
+    if ( (status = wire_reader_init(&reader, buff, len)) != WIRE_OK )
+	return status;
+    while ( (status = wire_next_field(&reader, field)) == WIRE_OK )
+	if ( field->tag == tag )
+	    return WIRE_OK;
+    return status;
+}
@@ -0,0 +1,119 @@
+#ifndef _LPJS_WIRE_H_
+#define _LPJS_WIRE_H_
+
+#include <stddef.h>     // size_t
+#include <stdint.h>     // uint64_t
+#include <sys/types.h>  // ssize_t
+
+#ifndef true
+#include <stdbool.h>
+#endif
+
+/*
+ *  Binary message format:
+ *
+ *      [request code] WIRE_MAGIC [schema version] [field] [field] ...
+ *
+ *  Each field is a 16-bit tag, a 32-bit value length, and the value,
+ *  with tag and length in network byte order.  Integers are sent
+ *  big-endian in the fewest bytes that hold them, strings include
+ *  their terminating '\0' so the receiver can use them in place.
+ *
+ *  Receivers skip fields with tags they don't recognize, so new
+ *  optional fields can be added without changing the schema version.
+ *  A receiver that doesn't recognize a tag with WIRE_TAG_CRITICAL set
+ *  must reject the message.  Bump WIRE_SCHEMA_VERSION only for changes
+ *  that older receivers cannot safely ignore.
+ *
+ *  WIRE_MAGIC cannot start a legacy text message, which begins with a
+ *  digit or a protocol version string, so receivers can accept both
+ *  formats from peers that have not been upgraded yet.
+ */
+
+#define WIRE_MAGIC              0xb7
+#define WIRE_SCHEMA_VERSION     1
+#define WIRE_HEADER_LEN         2   // Magic + schema version
+#define WIRE_FIELD_HEADER_LEN   6   // Tag + length
+#define WIRE_TAG_CRITICAL       0x8000
+
+// Job fields
+#define WIRE_TAG_JOB_ID                 0x0001
+#define WIRE_TAG_JOB_ARRAY_INDEX        0x0002
+#define WIRE_TAG_JOB_COUNT              0x0003
+#define WIRE_TAG_JOB_PROCESSORS         0x0004
+#define WIRE_TAG_JOB_THREADS            0x0005
+#define WIRE_TAG_JOB_PHYS_MIB           0x0006
+#define WIRE_TAG_JOB_CHAPERONE_PID      0x0007
+#define WIRE_TAG_JOB_PID                0x0008
+#define WIRE_TAG_JOB_STATE              0x0009
+#define WIRE_TAG_JOB_USER_NAME          0x000a
+#define WIRE_TAG_JOB_GROUP_NAME         0x000b
+#define WIRE_TAG_JOB_SUBMIT_NODE        0x000c
+#define WIRE_TAG_JOB_SUBMIT_DIR         0x000d
+#define WIRE_TAG_JOB_SCRIPT_NAME        0x000e
+#define WIRE_TAG_JOB_COMPUTE_NODE       0x000f
+#define WIRE_TAG_JOB_LOG_DIR            0x0010
+#define WIRE_TAG_JOB_CMD_SEARCH_PATH    0x0011
+#define WIRE_TAG_JOB_PULL_COMMAND       0x0012
+#define WIRE_TAG_JOB_PUSH_COMMAND       0x0013
+#define WIRE_TAG_JOB_START_TIME         0x0014  // Seconds since the epoch
+
+// Node fields
+#define WIRE_TAG_NODE_HOSTNAME          0x0100
+#define WIRE_TAG_NODE_STATE             0x0101
+#define WIRE_TAG_NODE_PROCESSORS        0x0102
+#define WIRE_TAG_NODE_PHYS_MIB          0x0103
+#define WIRE_TAG_NODE_ZFS               0x0104
+#define WIRE_TAG_NODE_OS                0x0105
+#define WIRE_TAG_NODE_ARCH              0x0106
+#define WIRE_TAG_NODE_SCRIPT_CACHE      0x0107  // Script cache slots
+#define WIRE_TAG_NODE_LIVE_JOB          0x0108  // Nested job message
+#define WIRE_TAG_NODE_LIVE_JOBS         0x0109  // Count, after the jobs
+
+// Message fields
+#define WIRE_TAG_PROTOCOL_VERSION       0x0200
+#define WIRE_TAG_SCRIPT                 0x0201
+#define WIRE_TAG_SESSION_NONCE          0x0202  // See session.h
+#define WIRE_TAG_SCRIPT_HASH            0x0203  // SHA-256 of the script
+#define WIRE_TAG_COMPRESSION            0x0204  // LPJS_COMPRESS_* methods
+#define WIRE_TAG_SUBMISSION             0x0205  // Nested submit message
+#define WIRE_TAG_SUBMISSIONS            0x0206  // Count, after the submissions
+
+// Journal fields, see journal.h
+#define WIRE_TAG_JOURNAL_RECORD         0x0300  // LPJS_JOURNAL_* type
+#define WIRE_TAG_JOURNAL_GENERATION     0x0301
+#define WIRE_TAG_JOURNAL_NEXT_JOB_ID    0x0302
+
+// Return values
+#define WIRE_OK                 0
+#define WIRE_END                1   // No more fields
+#define WIRE_MALFORMED          -1
+#define WIRE_BAD_VERSION        -2
+#define WIRE_UNKNOWN_CRITICAL   -3
+
+typedef struct
+{
+    unsigned char   *buff;
+    size_t          size;
+    size_t          len;
+    bool            overflow;   // Ran out of room, message is unusable
+}   wire_writer_t;
+
+typedef struct
+{
+    const unsigned char *next;
+    const unsigned char *end;
+    unsigned            version;
+}   wire_reader_t;
+
+// value points into the message buffer, nothing is copied
+typedef struct
+{
+    unsigned            tag;
+    size_t              len;
+    const unsigned char *value;
+}   wire_field_t;
+
+#include "wire-protos.h"
+
+#endif  // _LPJS_WIRE_H_